@@ -404,14 +404,28 @@ public:
 	virtual bool discoverRemoteEntity(UniqueIdentifier const entityID) const noexcept = 0;
 	/** Sets automatic discovery delay. 0 (default) for no automatic discovery. */
 	virtual void setAutomaticDiscoveryDelay(std::chrono::milliseconds const delay) noexcept = 0;
+	/** Sets the maximum number of AECP commands that can be inflight for a single entity (between 1 and la::avdecc::protocol::ProtocolInterface::MaximumAecpInflightCommands). The effective number adapts to how fast each entity responds. Returns false if the value is invalid. */
+	virtual bool setMaxAecpInflightCommands(std::uint32_t const maxInflightCommands) noexcept = 0;
+	/** Sets the maximum number of entities enumerated at the same time, 0 (default) for no limit. Entities discovered while the limit is reached wait for their turn, by priority (see setEnumerationPriorities). The effective limit adapts to the AECP timeouts observed while enumerating. */
+	virtual void setMaxConcurrentEnumerations(std::uint32_t const maxConcurrentEnumerations) noexcept = 0;
+	/** Sets the identifiers of the entities to enumerate first when the number of concurrent enumerations is limited, by decreasing priority. Each identifier can either be an EntityID or an EntityModelID. Other entities are enumerated afterwards, in discovery order. */
+	virtual void setEnumerationPriorities(std::vector<UniqueIdentifier> const& priorities) noexcept = 0;
 	/** Enables the EntityModel cache */
 	virtual void enableEntityModelCache() noexcept = 0;
 	/** Disables the EntityModel cache */
 	virtual void disableEntityModelCache() noexcept = 0;
+	/** Enables persistence of the EntityModel cache in the specified (existing) directory, so that models survive a restart. Models are loaded from the directory (in the background) when an entity with a matching EntityModelID is discovered, and written to it in the background. Returns false if not supported by the library (JSON feature was not compiled). */
+	virtual bool enableEntityModelCachePersistence(std::string const& directoryPath) noexcept = 0;
+	/** Disables persistence of the EntityModel cache (waits for pending writes to complete) */
+	virtual void disableEntityModelCachePersistence() noexcept = 0;
 	/** Enables complete EntityModel (static part) enumeration. Depending on entities, it might take a much longer time to enumerate. */
 	virtual void enableFullStaticEntityModelEnumeration() noexcept = 0;
 	/** Disables complete EntityModel (static part) enumeration.*/
 	virtual void disableFullStaticEntityModelEnumeration() noexcept = 0;
+	/** Enables delta enumeration: an entity going offline is retained for 'retentionDuration', and if it comes back online in the meantime (with an ADP available_index that kept on incrementing and the same EntityModelID), its previous static model is used the same way a model from the EntityModel cache is (even if the cache is disabled or the EntityModelID is not cacheable) and only the dynamic information is queried again. A 'retentionDuration' of 0 disables delta enumeration. */
+	virtual void enableDeltaEnumeration(std::chrono::milliseconds const retentionDuration) noexcept = 0;
+	/** Disables delta enumeration (default), releasing all retained entities */
+	virtual void disableDeltaEnumeration() noexcept = 0;
 	/** Loads an EntityModel file and feed it to the EntityModel cache */
 	virtual std::tuple<avdecc::jsonSerializer::DeserializationError, std::string> loadEntityModelFile(std::string const& filePath) noexcept = 0;
 
@@ -471,9 +485,15 @@ public:
 	virtual void disconnectTalkerStream(entity::model::StreamIdentification const& talkerStream, entity::model::StreamIdentification const& listenerStream, DisconnectTalkerStreamHandler const& handler) const noexcept = 0;
 	virtual void getListenerStreamState(entity::model::StreamIdentification const& listenerStream, GetListenerStreamStateHandler const& handler) const noexcept = 0;
 
-	/** Gets a lock guarded ControlledEntity. While the returned object is in the scope, you are guaranteed to have exclusive access on the ControlledEntity. The returned guard should not be kept or held for more than a few milliseconds. */
+	/** Gets a lock guarded ControlledEntity, waiting for the entity if it is currently held by another thread. While the returned object is in the scope, you are guaranteed to have exclusive access on the ControlledEntity (other entities can still be accessed by other threads). An empty guard is returned if the entity is not online. To access several entities at once, use getControlledEntityGuards instead of nesting calls (two threads nesting guards on the same entities in a different order would deadlock). The returned guard should not be kept or held for more than a few milliseconds. */
 	virtual ControlledEntityGuard getControlledEntityGuard(UniqueIdentifier const entityID) const noexcept = 0;
 
+	/** Gets lock guarded ControlledEntities (in the same order than entityIDs, with an empty guard for the entities that are not online), all acquired at once in a deadlock-free way (never waiting for an entity while holding another one, like std::lock). Should not be called while already holding a guard. The returned guards should not be kept or held for more than a few milliseconds. */
+	virtual std::vector<ControlledEntityGuard> getControlledEntityGuards(std::vector<UniqueIdentifier> const& entityIDs) const noexcept = 0;
+
+	/** Gets the last published immutable snapshot of a ControlledEntity, without locking the entity (so it never blocks nor waits for the network thread). The first call for an entity enables the publication of its snapshots (after each batch of updates) and waits for the initial one. Returns nullptr if the entity is not online. */
+	virtual SharedControlledEntitySnapshot getControlledEntitySnapshot(UniqueIdentifier const entityID) const noexcept = 0;
+
 	/** Requests an ExclusiveAccessToken for the specified entityID. If the call succeeded (AemCommandStatus::Success), a valid token will be returned. The handler will always be called, either before the call returns or asynchronously. */
 	virtual void requestExclusiveAccess(UniqueIdentifier const entityID, ExclusiveAccessToken::AccessType const type, RequestExclusiveAccessResultHandler&& handler) const noexcept = 0;
 
@@ -487,12 +507,16 @@ public:
 	virtual std::tuple<avdecc::jsonSerializer::SerializationError, std::string> serializeAllControlledEntitiesAsJson(std::string const& filePath, entity::model::jsonSerializer::Flags const flags, std::string const& dumpSource, bool const continueOnError) const noexcept = 0;
 	/** Serializes specified ControlledEntity as JSON and save to specified file. */
 	virtual std::tuple<avdecc::jsonSerializer::SerializationError, std::string> serializeControlledEntityAsJson(UniqueIdentifier const entityID, std::string const& filePath, entity::model::jsonSerializer::Flags const flags, std::string const& dumpSource) const noexcept = 0;
+	/** Serializes all discovered ControlledEntities as a binary snapshot and save to specified file. Same content than serializeAllControlledEntitiesAsJson (BinaryFormat flag is ignored), but entities are serialized and written one at a time. If 'continueOnError' is specified and some error(s) occured, SerializationError::Incomplete will be returned. */
+	virtual std::tuple<avdecc::jsonSerializer::SerializationError, std::string> serializeAllControlledEntitiesAsSnapshot(std::string const& filePath, entity::model::jsonSerializer::Flags const flags, std::string const& dumpSource, bool const continueOnError) const noexcept = 0;
 
 	/* Model deserialization methods */
 	/** Deserializes a JSON file representing a full network state, and loads it as virtual ControlledEntities. */
 	virtual std::tuple<avdecc::jsonSerializer::DeserializationError, std::string> loadVirtualEntitiesFromJsonNetworkState(std::string const& filePath, entity::model::jsonSerializer::Flags const flags, bool const continueOnError) noexcept = 0;
 	/** Deserializes a JSON file representing an entity, and loads it as a virtual ControlledEntity. */
 	virtual std::tuple<avdecc::jsonSerializer::DeserializationError, std::string> loadVirtualEntityFromJson(std::string const& filePath, entity::model::jsonSerializer::Flags const flags) noexcept = 0;
+	/** Deserializes a binary snapshot file (see serializeAllControlledEntitiesAsSnapshot) representing a full network state, and loads it as virtual ControlledEntities. */
+	virtual std::tuple<avdecc::jsonSerializer::DeserializationError, std::string> loadVirtualEntitiesFromSnapshot(std::string const& filePath, entity::model::jsonSerializer::Flags const flags, bool const continueOnError) noexcept = 0;
 	/** Deserializes a JSON file representing a full network state, and returns the ControlledEntities without loading them. */
 	static LA_AVDECC_CONTROLLER_API std::tuple<avdecc::jsonSerializer::DeserializationError, std::string, std::vector<SharedControlledEntity>> LA_AVDECC_CONTROLLER_CALL_CONVENTION deserializeControlledEntitiesFromJsonNetworkState(std::string const& filePath, entity::model::jsonSerializer::Flags const flags, bool const continueOnError) noexcept;
 	/** Deserializes a JSON file representing an entity, and returns the ControlledEntity without loading it. */
@@ -359,6 +359,32 @@ private:
 	std::reference_wrapper<watchDog::WatchDog> _watchDog{ *_watchDogSharedPointer };
 };
 
+/* ************************************************************************** */
+/* ControlledEntitySnapshot                                                   */
+/* ************************************************************************** */
+/**
+* @brief Immutable copy of the state of a ControlledEntity.
+* @details Published by the Controller after each batch of updates of the entity (see Controller::getControlledEntitySnapshot).
+*          A snapshot is never modified once published, it can be read and kept from any thread without locking anything.
+*          The static part of the entity model is shared with the ControlledEntity (and the other snapshots), only the dynamic part is copied.
+*/
+struct ControlledEntitySnapshot
+{
+	std::uint64_t version{ 0u }; /** Incremented each time a new snapshot of the entity is published, a different version means the entity might have changed */
+	entity::Entity entity; /** ADP information */
+	ControlledEntity::CompatibilityFlags compatibilityFlags{};
+	bool isVirtual{ false };
+	model::AcquireState acquireState{ model::AcquireState::Undefined };
+	UniqueIdentifier owningControllerID{};
+	model::LockState lockState{ model::LockState::Undefined };
+	UniqueIdentifier lockingControllerID{};
+	std::optional<entity::model::MilanInfo> milanInfo{ std::nullopt };
+	entity::model::EntityTree entityTree{}; /** Entity model, empty if the entity does not support AEM or got a fatal enumeration error */
+	ControlledEntity::Diagnostics diagnostics{};
+};
+
+using SharedControlledEntitySnapshot = std::shared_ptr<ControlledEntitySnapshot const>;
+
 } // namespace controller
 } // namespace avdecc
 } // namespace la
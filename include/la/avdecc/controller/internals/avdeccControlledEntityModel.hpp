@@ -242,17 +242,17 @@ struct ClockDomainNode : public EntityModelNode
 struct ConfigurationNode : public EntityModelNode
 {
 	// Children (only set if this is the active configuration)
-	std::map<entity::model::AudioUnitIndex, AudioUnitNode> audioUnits{};
-	std::map<entity::model::StreamIndex, StreamInputNode> streamInputs{};
-	std::map<entity::model::StreamIndex, StreamOutputNode> streamOutputs{};
+	IndexedMap<entity::model::AudioUnitIndex, AudioUnitNode> audioUnits{};
+	IndexedMap<entity::model::StreamIndex, StreamInputNode> streamInputs{};
+	IndexedMap<entity::model::StreamIndex, StreamOutputNode> streamOutputs{};
 	// JackInput
 	// JackOutput
-	std::map<entity::model::AvbInterfaceIndex, AvbInterfaceNode> avbInterfaces{};
-	std::map<entity::model::ClockSourceIndex, ClockSourceNode> clockSources{};
-	std::map<entity::model::MemoryObjectIndex, MemoryObjectNode> memoryObjects{};
-	std::map<entity::model::LocaleIndex, LocaleNode> locales{};
-	std::map<entity::model::ControlIndex, ControlNode> controls{};
-	std::map<entity::model::ClockDomainIndex, ClockDomainNode> clockDomains{};
+	IndexedMap<entity::model::AvbInterfaceIndex, AvbInterfaceNode> avbInterfaces{};
+	IndexedMap<entity::model::ClockSourceIndex, ClockSourceNode> clockSources{};
+	IndexedMap<entity::model::MemoryObjectIndex, MemoryObjectNode> memoryObjects{};
+	IndexedMap<entity::model::LocaleIndex, LocaleNode> locales{};
+	IndexedMap<entity::model::ControlIndex, ControlNode> controls{};
+	IndexedMap<entity::model::ClockDomainIndex, ClockDomainNode> clockDomains{};
 
 #ifdef ENABLE_AVDECC_FEATURE_REDUNDANCY
 	std::map<VirtualIndex, RedundantStreamNode> redundantStreamInputs{};
@@ -269,7 +269,7 @@ struct ConfigurationNode : public EntityModelNode
 struct EntityNode : public EntityModelNode
 {
 	// Children
-	std::map<entity::model::ConfigurationIndex, ConfigurationNode> configurations{};
+	IndexedMap<entity::model::ConfigurationIndex, ConfigurationNode> configurations{};
 
 	// AEM Static info
 	entity::model::EntityNodeStaticModel const* staticModel{ nullptr };
@@ -0,0 +1,189 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/**
+* @file copyOnWrite.hpp
+* @author Christophe Calmejane
+* @brief Reference-counted immutable value, copied only when modified.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <memory> // shared_ptr / make_shared
+#include <type_traits>
+#include <utility> // move / exchange
+
+namespace la
+{
+namespace avdecc
+{
+/**
+* @brief Value semantic wrapper around an immutable, reference-counted instance of T.
+* @details Copying a CopyOnWrite only increments a reference count, all the copies share the same T instance until one of them is modified
+*          through getMutable() (which first makes a private copy of the value if it is shared).
+*          Default constructed CopyOnWrite share a single default constructed T (per type), so they do not allocate.
+*          Whether the value is shared is tracked by each instance (an instance owns its value exclusively until it is copied), not from the reference count:
+*          the reference count is not a synchronization point, another thread could take a copy right after it has been checked.
+*          As a consequence, an instance that has been copied once always makes a private copy on its next modification, even if the other copies have been destroyed since.
+*          Read access (including copying) is thread-safe. Like any other value type, a single CopyOnWrite must not be modified concurrently with any other access to it.
+*/
+template<typename T>
+class CopyOnWrite final
+{
+	static_assert(std::is_copy_constructible_v<T>, "CopyOnWrite value must be copy constructible");
+
+public:
+	using value_type = T;
+
+	/** Default constructor, sharing a default constructed value */
+	CopyOnWrite() noexcept
+		: _value{ getDefaultValue() }
+	{
+	}
+
+	/** Constructs from a value */
+	CopyOnWrite(T const& value)
+		: _value{ std::make_shared<T>(value) }
+		, _isExclusive{ true }
+	{
+	}
+
+	/** Constructs from a value */
+	CopyOnWrite(T&& value)
+		: _value{ std::make_shared<T>(std::move(value)) }
+		, _isExclusive{ true }
+	{
+	}
+
+	/** Replaces the value (without affecting the other copies) */
+	CopyOnWrite& operator=(T const& value)
+	{
+		_value = std::make_shared<T>(value);
+		_isExclusive = true;
+		return *this;
+	}
+
+	/** Replaces the value (without affecting the other copies) */
+	CopyOnWrite& operator=(T&& value)
+	{
+		_value = std::make_shared<T>(std::move(value));
+		_isExclusive = true;
+		return *this;
+	}
+
+	/** Read access to the (possibly shared) value */
+	T const& get() const noexcept
+	{
+		return *_value;
+	}
+
+	T const& operator*() const noexcept
+	{
+		return *_value;
+	}
+
+	T const* operator->() const noexcept
+	{
+		return _value.get();
+	}
+
+	operator T const&() const noexcept
+	{
+		return *_value;
+	}
+
+	/** Write access to the value, making a private copy first if it may be shared. Previously returned references and pointers to the shared value are left untouched (they still reference the other copies' value). */
+	T& getMutable()
+	{
+		if (!_isExclusive.load(std::memory_order_relaxed))
+		{
+			_value = std::make_shared<T>(*_value);
+			_isExclusive.store(true, std::memory_order_relaxed);
+		}
+		// The instance was created non-const by this class, and we are its only owner
+		return const_cast<T&>(*_value);
+	}
+
+	/** Returns true if the value may be shared with other CopyOnWrite instances (ie. this instance has been copied, or is a copy, since it last owned its value exclusively) */
+	bool isShared() const noexcept
+	{
+		return !_isExclusive.load(std::memory_order_relaxed);
+	}
+
+	/** Returns true if both instances share the same value (without comparing values) */
+	bool isSharedWith(CopyOnWrite const& other) const noexcept
+	{
+		return _value == other._value;
+	}
+
+	/** Copy constructor (both instances share the value) */
+	CopyOnWrite(CopyOnWrite const& other) noexcept
+		: _value{ other._value }
+	{
+		other._isExclusive.store(false, std::memory_order_relaxed);
+	}
+
+	/** Copy operator= (both instances share the value) */
+	CopyOnWrite& operator=(CopyOnWrite const& other) noexcept
+	{
+		if (this != &other)
+		{
+			_value = other._value;
+			_isExclusive.store(false, std::memory_order_relaxed);
+			other._isExclusive.store(false, std::memory_order_relaxed);
+		}
+		return *this;
+	}
+
+	/** Move constructor (moved-from instance is left with the default value) */
+	CopyOnWrite(CopyOnWrite&& other) noexcept
+		: _value{ std::exchange(other._value, getDefaultValue()) }
+		, _isExclusive{ other._isExclusive.exchange(false, std::memory_order_relaxed) }
+	{
+	}
+
+	/** Move operator= (moved-from instance is left with the default value) */
+	CopyOnWrite& operator=(CopyOnWrite&& other) noexcept
+	{
+		if (this != &other)
+		{
+			_value = std::exchange(other._value, getDefaultValue());
+			_isExclusive.store(other._isExclusive.exchange(false, std::memory_order_relaxed), std::memory_order_relaxed);
+		}
+		return *this;
+	}
+
+	// Defaulted compiler auto-generated methods
+	~CopyOnWrite() noexcept = default;
+
+private:
+	static std::shared_ptr<T const> const& getDefaultValue() noexcept
+	{
+		static auto const s_defaultValue = std::shared_ptr<T const>{ std::make_shared<T>() };
+		return s_defaultValue;
+	}
+
+	std::shared_ptr<T const> _value{};
+	mutable std::atomic_bool _isExclusive{ false }; // Only this instance references _value (set by the instance itself, cleared when it is copied, which is a read access that may happen from any thread)
+};
+
+} // namespace avdecc
+} // namespace la
@@ -34,11 +34,182 @@
 #include <functional>
 #include <thread>
 #include <future>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace la
 {
 namespace avdecc
 {
+/**
+ * @brief Move-only callable executed by an Executor.
+ * @details Callables up to InlineCaptureSize bytes (and nothrow move constructible) are stored inline, without any memory allocation.
+ *          Bigger callables are allocated on the heap.
+*/
+class ExecutorJob final
+{
+public:
+	static auto constexpr InlineCaptureSize = size_t{ 96u };
+
+	/** Returns true if the specified callable type is stored inline */
+	template<typename Callable>
+	static constexpr bool IsStoredInline = sizeof(Callable) <= InlineCaptureSize && alignof(Callable) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<Callable>;
+
+	/** Constructs an empty job */
+	ExecutorJob() noexcept = default;
+
+	/** Constructs an empty job */
+	ExecutorJob(std::nullptr_t) noexcept {}
+
+	/** Constructs a job from any callable taking no parameter */
+	template<typename Callable, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Callable>, ExecutorJob> && std::is_invocable_v<std::decay_t<Callable>&>>>
+	ExecutorJob(Callable&& callable)
+	{
+		using CallableType = std::decay_t<Callable>;
+
+		// Empty callables (nullptr function pointer, empty std::function) result in an empty job
+		if constexpr (std::is_constructible_v<bool, CallableType const&>)
+		{
+			if (!static_cast<bool>(callable))
+			{
+				return;
+			}
+		}
+
+		if constexpr (IsStoredInline<CallableType>)
+		{
+			new (&_storage) CallableType(std::forward<Callable>(callable));
+			_operations = &s_InlineOperations<CallableType>;
+		}
+		else
+		{
+			*reinterpret_cast<CallableType**>(&_storage) = new CallableType(std::forward<Callable>(callable));
+			_operations = &s_HeapOperations<CallableType>;
+		}
+	}
+
+	~ExecutorJob() noexcept
+	{
+		reset();
+	}
+
+	ExecutorJob(ExecutorJob&& other) noexcept
+	{
+		moveFrom(other);
+	}
+
+	ExecutorJob& operator=(ExecutorJob&& other) noexcept
+	{
+		if (this != &other)
+		{
+			reset();
+			moveFrom(other);
+		}
+		return *this;
+	}
+
+	ExecutorJob& operator=(std::nullptr_t) noexcept
+	{
+		reset();
+		return *this;
+	}
+
+	/** Calls the stored callable. The job must not be empty */
+	void operator()() const
+	{
+		_operations->invoke(&_storage);
+	}
+
+	/** Returns true if the job is not empty */
+	explicit operator bool() const noexcept
+	{
+		return _operations != nullptr;
+	}
+
+	friend bool operator==(ExecutorJob const& job, std::nullptr_t) noexcept
+	{
+		return !job;
+	}
+
+	friend bool operator!=(ExecutorJob const& job, std::nullptr_t) noexcept
+	{
+		return !!job;
+	}
+
+	// Deleted compiler auto-generated methods
+	ExecutorJob(ExecutorJob const&) = delete;
+	ExecutorJob& operator=(ExecutorJob const&) = delete;
+
+private:
+	using Storage = std::aligned_storage_t<InlineCaptureSize, alignof(std::max_align_t)>;
+
+	struct Operations
+	{
+		void (*invoke)(Storage* storage);
+		void (*move)(Storage* destination, Storage* source) noexcept; // Move-constructs destination from source, and destroys source
+		void (*destroy)(Storage* storage) noexcept;
+	};
+
+	template<typename CallableType>
+	static inline Operations const s_InlineOperations{
+		[](Storage* storage)
+		{
+			(*std::launder(reinterpret_cast<CallableType*>(storage)))();
+		},
+		[](Storage* destination, Storage* source) noexcept
+		{
+			auto* const callable = std::launder(reinterpret_cast<CallableType*>(source));
+			new (destination) CallableType(std::move(*callable));
+			callable->~CallableType();
+		},
+		[](Storage* storage) noexcept
+		{
+			std::launder(reinterpret_cast<CallableType*>(storage))->~CallableType();
+		},
+	};
+
+	template<typename CallableType>
+	static inline Operations const s_HeapOperations{
+		[](Storage* storage)
+		{
+			(**reinterpret_cast<CallableType**>(storage))();
+		},
+		[](Storage* destination, Storage* source) noexcept
+		{
+			*reinterpret_cast<CallableType**>(destination) = *reinterpret_cast<CallableType**>(source);
+		},
+		[](Storage* storage) noexcept
+		{
+			delete *reinterpret_cast<CallableType**>(storage);
+		},
+	};
+
+	void moveFrom(ExecutorJob& other) noexcept
+	{
+		if (other._operations != nullptr)
+		{
+			other._operations->move(&_storage, &other._storage);
+			_operations = other._operations;
+			other._operations = nullptr;
+		}
+	}
+
+	void reset() noexcept
+	{
+		if (_operations != nullptr)
+		{
+			_operations->destroy(&_storage);
+			_operations = nullptr;
+		}
+	}
+
+	// Private members
+	mutable Storage _storage; // Mutable so that a const job can call a mutable callable (as std::function does)
+	Operations const* _operations{ nullptr };
+};
+
 /**
  * @brief Executor class interface.
  * @details An Executor queues jobs and executes them in order at a later time.
@@ -47,7 +218,7 @@ class Executor
 {
 public:
 	using UniquePointer = std::unique_ptr<Executor, void (*)(Executor*)>;
-	using Job = std::function<void()>;
+	using Job = ExecutorJob;
 
 	Executor() noexcept {}
 	virtual ~Executor() noexcept {}
@@ -152,6 +323,55 @@ private:
 	virtual void destroy() noexcept = 0;
 };
 
+/**
+ * @brief An Executor that executes jobs from a lock-free dispatch queue running in a separate thread.
+ * @details Jobs are pushed to a bounded ring of preallocated slots without taking any lock, which reduces contention when multiple threads push jobs.
+ *          The executor thread spins for a short (adaptive) amount of time when the queue is empty, before parking until a new job is pushed.
+ *          If the ring is full, jobs are temporarily stored in a locked overflow queue so that pushJob never blocks nor drops a job (jobs pushed by the same thread are always executed in order).
+*/
+class ExecutorWithLockFreeDispatchQueue : public Executor
+{
+public:
+	static auto constexpr DefaultQueueCapacity = size_t{ 4096u };
+
+	/**
+	* @brief Factory method to create a new ExecutorWithLockFreeDispatchQueue.
+	* @details Creates a new ExecutorWithLockFreeDispatchQueue as a unique pointer.
+	* @param[in] name The name of the executor thread.
+	* @param[in] prio The priority of the executor thread.
+	* @param[in] queueCapacity The number of preallocated job slots (rounded up to the next power of 2).
+	* @return A new ExecutorWithLockFreeDispatchQueue as a Executor::UniquePointer.
+	*/
+	static UniquePointer create(std::optional<std::string> const& name = std::nullopt, utils::ThreadPriority const prio = utils::ThreadPriority::Normal, size_t const queueCapacity = DefaultQueueCapacity)
+	{
+		auto deleter = [](Executor* self)
+		{
+			static_cast<ExecutorWithLockFreeDispatchQueue*>(self)->destroy();
+		};
+		return UniquePointer(createRawExecutorWithLockFreeDispatchQueue(name, prio, queueCapacity), deleter);
+	}
+
+	// Deleted compiler auto-generated methods
+	ExecutorWithLockFreeDispatchQueue(ExecutorWithLockFreeDispatchQueue&&) = delete;
+	ExecutorWithLockFreeDispatchQueue(ExecutorWithLockFreeDispatchQueue const&) = delete;
+	ExecutorWithLockFreeDispatchQueue& operator=(ExecutorWithLockFreeDispatchQueue const&) = delete;
+	ExecutorWithLockFreeDispatchQueue& operator=(ExecutorWithLockFreeDispatchQueue&&) = delete;
+
+protected:
+	/** Constructor */
+	ExecutorWithLockFreeDispatchQueue() noexcept = default;
+
+	/** Destructor */
+	virtual ~ExecutorWithLockFreeDispatchQueue() noexcept = default;
+
+private:
+	/** Entry point */
+	static LA_AVDECC_API ExecutorWithLockFreeDispatchQueue* LA_AVDECC_CALL_CONVENTION createRawExecutorWithLockFreeDispatchQueue(std::optional<std::string> const& name, utils::ThreadPriority const prio, size_t const queueCapacity);
+
+	/** Destroy method for COM-like interface */
+	virtual void destroy() noexcept = 0;
+};
+
 /**
  * @brief Manager of Executors.
  * @details A singleton manager that holds Executors, referenced by a unique name.
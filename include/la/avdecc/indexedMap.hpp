@@ -0,0 +1,488 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/**
+* @file indexedMap.hpp
+* @author Christophe Calmejane
+* @brief Map-like container for dense, zero-based integer keys (descriptor indexes).
+*/
+
+#pragma once
+
+#include <cstddef> // size_t / ptrdiff_t
+#include <iterator> // forward_iterator_tag
+#include <map>
+#include <memory> // unique_ptr
+#include <stdexcept> // out_of_range
+#include <tuple> // forward_as_tuple
+#include <type_traits>
+#include <utility> // pair / piecewise_construct
+#include <vector>
+
+namespace la
+{
+namespace avdecc
+{
+/**
+* @brief Map-like container optimized for dense, zero-based unsigned integer keys.
+* @details All the methods of this class have the same meaning and specification than std::map.
+*          Keys lower than DenseLimit are addressed directly in a vector (constant time lookup),
+*          the other ones are stored in a std::map (sparse fallback), so an out-of-range key cannot make the container allocate a huge vector.
+*          Iteration is done in ascending key order and yields std::pair<Key const, T> elements (like std::map).
+*          Each element is allocated separately so references and pointers to elements remain valid until the element is erased (like std::map).
+*/
+template<typename Key, typename T, size_t DenseLimit = 1024>
+class IndexedMap
+{
+	static_assert(std::is_integral_v<Key> && std::is_unsigned_v<Key>, "IndexedMap Key must be an unsigned integral type");
+
+	using SparseStorage = std::map<Key, T>;
+	static_assert(std::is_same_v<typename SparseStorage::value_type, std::pair<Key const, T>>, "Dense and sparse elements must have the same type");
+
+public:
+	using key_type = Key;
+	using mapped_type = T;
+	using value_type = std::pair<Key const, T>;
+	using size_type = size_t;
+	using difference_type = std::ptrdiff_t;
+	using reference = value_type&;
+	using const_reference = value_type const&;
+
+	template<bool IsConst>
+	class Iterator
+	{
+		using Container = std::conditional_t<IsConst, IndexedMap const, IndexedMap>;
+		using SparseIterator = std::conditional_t<IsConst, typename SparseStorage::const_iterator, typename SparseStorage::iterator>;
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = IndexedMap::value_type;
+		using difference_type = std::ptrdiff_t;
+		using pointer = std::conditional_t<IsConst, value_type const*, value_type*>;
+		using reference = std::conditional_t<IsConst, value_type const&, value_type&>;
+
+		Iterator() noexcept = default;
+
+		/** Conversion from a non-const iterator */
+		template<bool WasConst, typename = std::enable_if_t<IsConst && !WasConst>>
+		Iterator(Iterator<WasConst> const& other) noexcept
+			: _container{ other._container }
+			, _densePosition{ other._densePosition }
+			, _sparseIterator{ other._sparseIterator }
+		{
+		}
+
+		reference operator*() const noexcept
+		{
+			if (_densePosition < _container->_dense.size())
+			{
+				return *_container->_dense[_densePosition];
+			}
+			return *_sparseIterator;
+		}
+
+		pointer operator->() const noexcept
+		{
+			return &operator*();
+		}
+
+		Iterator& operator++() noexcept
+		{
+			if (_densePosition < _container->_dense.size())
+			{
+				_densePosition = _container->nextDensePosition(_densePosition + 1);
+			}
+			else
+			{
+				++_sparseIterator;
+			}
+			return *this;
+		}
+
+		Iterator operator++(int) noexcept
+		{
+			auto tmp = *this;
+			operator++();
+			return tmp;
+		}
+
+		friend bool operator==(Iterator const& lhs, Iterator const& rhs) noexcept
+		{
+			return lhs._densePosition == rhs._densePosition && lhs._sparseIterator == rhs._sparseIterator;
+		}
+
+		friend bool operator!=(Iterator const& lhs, Iterator const& rhs) noexcept
+		{
+			return !(lhs == rhs);
+		}
+
+	private:
+		friend class IndexedMap;
+		template<bool>
+		friend class Iterator;
+
+		Iterator(Container* const container, size_t const densePosition, SparseIterator const sparseIterator) noexcept
+			: _container{ container }
+			, _densePosition{ densePosition }
+			, _sparseIterator{ sparseIterator }
+		{
+		}
+
+		Container* _container{ nullptr };
+		size_t _densePosition{ 0u };
+		SparseIterator _sparseIterator{};
+	};
+
+	using iterator = Iterator<false>;
+	using const_iterator = Iterator<true>;
+
+	/* ************************************************************************** */
+	/* Life cycle                                                                 */
+
+	/** Default constructor */
+	IndexedMap() noexcept = default;
+
+	/** Constructs the container with the content of the initializer list */
+	IndexedMap(std::initializer_list<value_type> const init)
+	{
+		for (auto const& value : init)
+		{
+			insert(value);
+		}
+	}
+
+	/** Copy constructor (deep copy) */
+	IndexedMap(IndexedMap const& other)
+		: _sparse{ other._sparse }
+		, _denseCount{ other._denseCount }
+	{
+		_dense.reserve(other._dense.size());
+		for (auto const& element : other._dense)
+		{
+			_dense.emplace_back(element ? std::make_unique<value_type>(*element) : nullptr);
+		}
+	}
+
+	/** Move constructor */
+	IndexedMap(IndexedMap&& other) noexcept
+		: _dense{ std::move(other._dense) }
+		, _sparse{ std::move(other._sparse) }
+		, _denseCount{ other._denseCount }
+	{
+		other._dense.clear();
+		other._denseCount = 0u;
+	}
+
+	/** Copy operator= */
+	IndexedMap& operator=(IndexedMap const& other)
+	{
+		if (this != &other)
+		{
+			auto copy = other;
+			swap(copy);
+		}
+		return *this;
+	}
+
+	/** Move operator= */
+	IndexedMap& operator=(IndexedMap&& other) noexcept
+	{
+		if (this != &other)
+		{
+			_dense = std::move(other._dense);
+			_sparse = std::move(other._sparse);
+			_denseCount = other._denseCount;
+			other._dense.clear();
+			other._denseCount = 0u;
+		}
+		return *this;
+	}
+
+	/** Destructor */
+	~IndexedMap() noexcept = default;
+
+	/* ************************************************************************** */
+	/* Comparison operators                                                       */
+	friend bool operator==(IndexedMap const& lhs, IndexedMap const& rhs)
+	{
+		if (lhs.size() != rhs.size())
+		{
+			return false;
+		}
+		for (auto lhsIt = lhs.begin(), rhsIt = rhs.begin(); lhsIt != lhs.end(); ++lhsIt, ++rhsIt)
+		{
+			if (lhsIt->first != rhsIt->first || !(lhsIt->second == rhsIt->second))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	friend bool operator!=(IndexedMap const& lhs, IndexedMap const& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	/* ************************************************************************** */
+	/* Element access                                                             */
+	T& at(Key const key)
+	{
+		if (auto* const element = findElement(key))
+		{
+			return element->second;
+		}
+		throw std::out_of_range("IndexedMap::at");
+	}
+
+	T const& at(Key const key) const
+	{
+		if (auto const* const element = findElement(key))
+		{
+			return element->second;
+		}
+		throw std::out_of_range("IndexedMap::at");
+	}
+
+	T& operator[](Key const key)
+	{
+		return try_emplace(key).first->second;
+	}
+
+	/* ************************************************************************** */
+	/* Iterators                                                                  */
+	iterator begin() noexcept
+	{
+		return iterator{ this, nextDensePosition(0u), _sparse.begin() };
+	}
+
+	const_iterator begin() const noexcept
+	{
+		return const_iterator{ this, nextDensePosition(0u), _sparse.begin() };
+	}
+
+	const_iterator cbegin() const noexcept
+	{
+		return begin();
+	}
+
+	iterator end() noexcept
+	{
+		return iterator{ this, _dense.size(), _sparse.end() };
+	}
+
+	const_iterator end() const noexcept
+	{
+		return const_iterator{ this, _dense.size(), _sparse.end() };
+	}
+
+	const_iterator cend() const noexcept
+	{
+		return end();
+	}
+
+	/* ************************************************************************** */
+	/* Capacity                                                                   */
+	bool empty() const noexcept
+	{
+		return size() == 0u;
+	}
+
+	size_type size() const noexcept
+	{
+		return _denseCount + _sparse.size();
+	}
+
+	/* ************************************************************************** */
+	/* Modifiers                                                                  */
+	void clear() noexcept
+	{
+		_dense.clear();
+		_sparse.clear();
+		_denseCount = 0u;
+	}
+
+	template<typename... Args>
+	std::pair<iterator, bool> try_emplace(Key const key, Args&&... args)
+	{
+		if (isDenseKey(key))
+		{
+			auto const position = static_cast<size_t>(key);
+			if (position >= _dense.size())
+			{
+				_dense.resize(position + 1u);
+			}
+			auto& element = _dense[position];
+			if (element)
+			{
+				return { makeDenseIterator(position), false };
+			}
+			element = std::make_unique<value_type>(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+			++_denseCount;
+			return { makeDenseIterator(position), true };
+		}
+
+		auto const [it, inserted] = _sparse.try_emplace(key, std::forward<Args>(args)...);
+		return { iterator{ this, _dense.size(), it }, inserted };
+	}
+
+	template<typename... Args>
+	std::pair<iterator, bool> emplace(Key const key, Args&&... args)
+	{
+		return try_emplace(key, std::forward<Args>(args)...);
+	}
+
+	std::pair<iterator, bool> insert(value_type const& value)
+	{
+		return try_emplace(value.first, value.second);
+	}
+
+	std::pair<iterator, bool> insert(value_type&& value)
+	{
+		return try_emplace(value.first, std::move(value.second));
+	}
+
+	template<typename M>
+	std::pair<iterator, bool> insert_or_assign(Key const key, M&& obj)
+	{
+		auto result = try_emplace(key, std::forward<M>(obj));
+		if (!result.second)
+		{
+			result.first->second = std::forward<M>(obj);
+		}
+		return result;
+	}
+
+	size_type erase(Key const key)
+	{
+		if (isDenseKey(key))
+		{
+			auto const position = static_cast<size_t>(key);
+			if (position < _dense.size() && _dense[position])
+			{
+				_dense[position].reset();
+				--_denseCount;
+				return 1u;
+			}
+			return 0u;
+		}
+		return _sparse.erase(key);
+	}
+
+	iterator erase(const_iterator const pos)
+	{
+		auto next = iterator{ this, pos._densePosition, _sparse.begin() };
+		if (pos._densePosition < _dense.size())
+		{
+			auto const key = pos->first;
+			++next;
+			erase(key);
+		}
+		else
+		{
+			next._sparseIterator = _sparse.erase(pos._sparseIterator);
+		}
+		return next;
+	}
+
+	void swap(IndexedMap& other) noexcept
+	{
+		_dense.swap(other._dense);
+		_sparse.swap(other._sparse);
+		std::swap(_denseCount, other._denseCount);
+	}
+
+	/* ************************************************************************** */
+	/* Lookup                                                                     */
+	iterator find(Key const key) noexcept
+	{
+		if (isDenseKey(key))
+		{
+			auto const position = static_cast<size_t>(key);
+			if (position < _dense.size() && _dense[position])
+			{
+				return makeDenseIterator(position);
+			}
+			return end();
+		}
+		return iterator{ this, _dense.size(), _sparse.find(key) };
+	}
+
+	const_iterator find(Key const key) const noexcept
+	{
+		return const_cast<IndexedMap*>(this)->find(key);
+	}
+
+	size_type count(Key const key) const noexcept
+	{
+		return findElement(key) != nullptr ? 1u : 0u;
+	}
+
+	bool contains(Key const key) const noexcept
+	{
+		return findElement(key) != nullptr;
+	}
+
+private:
+	static constexpr bool isDenseKey(Key const key) noexcept
+	{
+		return static_cast<size_t>(key) < DenseLimit;
+	}
+
+	value_type* findElement(Key const key) const noexcept
+	{
+		if (isDenseKey(key))
+		{
+			auto const position = static_cast<size_t>(key);
+			if (position < _dense.size())
+			{
+				return _dense[position].get();
+			}
+			return nullptr;
+		}
+		if (auto const it = _sparse.find(key); it != _sparse.end())
+		{
+			return const_cast<value_type*>(&*it);
+		}
+		return nullptr;
+	}
+
+	/** Returns the first used dense position starting at (and including) 'position', or _dense.size() if none */
+	size_t nextDensePosition(size_t position) const noexcept
+	{
+		while (position < _dense.size() && !_dense[position])
+		{
+			++position;
+		}
+		return position;
+	}
+
+	iterator makeDenseIterator(size_t const position) noexcept
+	{
+		return iterator{ this, position, _sparse.begin() };
+	}
+
+	std::vector<std::unique_ptr<value_type>> _dense{};
+	SparseStorage _sparse{};
+	size_t _denseCount{ 0u };
+};
+
+} // namespace avdecc
+} // namespace la
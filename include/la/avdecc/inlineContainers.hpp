@@ -0,0 +1,802 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/**
+* @file inlineContainers.hpp
+* @author Christophe Calmejane
+* @brief Vector-like and set-like containers with inline storage.
+*/
+
+#pragma once
+
+#include <algorithm> // lower_bound / equal / lexicographical_compare
+#include <cstddef> // size_t / ptrdiff_t
+#include <cstring> // memcpy / memmove
+#include <functional> // less
+#include <initializer_list>
+#include <iterator> // iterator_traits / reverse_iterator
+#include <memory> // uninitialized_fill / uninitialized_copy
+#include <new> // operator new / operator delete
+#include <stdexcept> // out_of_range
+#include <type_traits>
+#include <utility> // pair
+
+namespace la
+{
+namespace avdecc
+{
+/**
+* @brief Vector-like container storing up to InlineCapacity elements without any memory allocation.
+* @details All the methods of this class have the same meaning and specification than std::vector.
+*          Elements are stored inside the container itself as long as size() is lower or equal to InlineCapacity,
+*          the container moves them to the heap only when this capacity is exceeded.
+*          Restricted to trivially copyable types (elements are relocated using memcpy), iterators are plain pointers.
+*/
+template<typename T, size_t InlineCapacity>
+class SmallVector
+{
+	static_assert(std::is_trivially_copyable_v<T>, "SmallVector only supports trivially copyable types");
+	static_assert(InlineCapacity > 0, "SmallVector InlineCapacity must not be 0");
+
+public:
+	using value_type = T;
+	using size_type = size_t;
+	using difference_type = std::ptrdiff_t;
+	using reference = T&;
+	using const_reference = T const&;
+	using pointer = T*;
+	using const_pointer = T const*;
+	using iterator = T*;
+	using const_iterator = T const*;
+	using reverse_iterator = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+	/* ************************************************************************** */
+	/* Life cycle                                                                 */
+
+	/** Default constructor */
+	SmallVector() noexcept {}
+
+	/** Constructs the container with count default-inserted elements */
+	explicit SmallVector(size_type const count)
+	{
+		resize(count);
+	}
+
+	/** Constructs the container with count copies of value */
+	SmallVector(size_type const count, T const& value)
+	{
+		resize(count, value);
+	}
+
+	/** Constructs the container with the content of the range [first, last) */
+	template<typename InputIt, typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+	SmallVector(InputIt first, InputIt last)
+	{
+		assign(first, last);
+	}
+
+	/** Constructs the container with the content of the initializer list */
+	SmallVector(std::initializer_list<T> const init)
+	{
+		assign(init.begin(), init.end());
+	}
+
+	/** Copy constructor */
+	SmallVector(SmallVector const& other)
+	{
+		assign(other.begin(), other.end());
+	}
+
+	/** Move constructor. Heap storage is stolen, inline elements are copied */
+	SmallVector(SmallVector&& other) noexcept
+	{
+		moveFrom(std::move(other));
+	}
+
+	/** Copy operator= */
+	SmallVector& operator=(SmallVector const& other)
+	{
+		if (this != &other)
+		{
+			assign(other.begin(), other.end());
+		}
+		return *this;
+	}
+
+	/** Move operator= */
+	SmallVector& operator=(SmallVector&& other) noexcept
+	{
+		if (this != &other)
+		{
+			releaseHeap();
+			moveFrom(std::move(other));
+		}
+		return *this;
+	}
+
+	/** Initializer list operator= */
+	SmallVector& operator=(std::initializer_list<T> const init)
+	{
+		assign(init.begin(), init.end());
+		return *this;
+	}
+
+	/** Destructor */
+	~SmallVector() noexcept
+	{
+		releaseHeap();
+	}
+
+	/* ************************************************************************** */
+	/* Comparison operators                                                       */
+	friend bool operator==(SmallVector const& lhs, SmallVector const& rhs) noexcept
+	{
+		return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+	}
+
+	friend bool operator!=(SmallVector const& lhs, SmallVector const& rhs) noexcept
+	{
+		return !(lhs == rhs);
+	}
+
+	friend bool operator<(SmallVector const& lhs, SmallVector const& rhs) noexcept
+	{
+		return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+	}
+
+	/* ************************************************************************** */
+	/* Element access                                                             */
+	reference at(size_type const pos)
+	{
+		if (pos >= _size)
+		{
+			throw std::out_of_range("SmallVector::at");
+		}
+		return _data[pos];
+	}
+
+	const_reference at(size_type const pos) const
+	{
+		if (pos >= _size)
+		{
+			throw std::out_of_range("SmallVector::at");
+		}
+		return _data[pos];
+	}
+
+	reference operator[](size_type const pos) noexcept
+	{
+		return _data[pos];
+	}
+
+	const_reference operator[](size_type const pos) const noexcept
+	{
+		return _data[pos];
+	}
+
+	reference front() noexcept
+	{
+		return _data[0];
+	}
+
+	const_reference front() const noexcept
+	{
+		return _data[0];
+	}
+
+	reference back() noexcept
+	{
+		return _data[_size - 1];
+	}
+
+	const_reference back() const noexcept
+	{
+		return _data[_size - 1];
+	}
+
+	T* data() noexcept
+	{
+		return _data;
+	}
+
+	T const* data() const noexcept
+	{
+		return _data;
+	}
+
+	/* ************************************************************************** */
+	/* Iterators                                                                  */
+	iterator begin() noexcept
+	{
+		return _data;
+	}
+
+	const_iterator begin() const noexcept
+	{
+		return _data;
+	}
+
+	const_iterator cbegin() const noexcept
+	{
+		return _data;
+	}
+
+	iterator end() noexcept
+	{
+		return _data + _size;
+	}
+
+	const_iterator end() const noexcept
+	{
+		return _data + _size;
+	}
+
+	const_iterator cend() const noexcept
+	{
+		return _data + _size;
+	}
+
+	reverse_iterator rbegin() noexcept
+	{
+		return reverse_iterator{ end() };
+	}
+
+	const_reverse_iterator rbegin() const noexcept
+	{
+		return const_reverse_iterator{ end() };
+	}
+
+	reverse_iterator rend() noexcept
+	{
+		return reverse_iterator{ begin() };
+	}
+
+	const_reverse_iterator rend() const noexcept
+	{
+		return const_reverse_iterator{ begin() };
+	}
+
+	/* ************************************************************************** */
+	/* Capacity                                                                   */
+	bool empty() const noexcept
+	{
+		return _size == 0u;
+	}
+
+	size_type size() const noexcept
+	{
+		return _size;
+	}
+
+	size_type capacity() const noexcept
+	{
+		return _capacity;
+	}
+
+	static constexpr size_type inline_capacity() noexcept
+	{
+		return InlineCapacity;
+	}
+
+	size_type max_size() const noexcept
+	{
+		return static_cast<size_type>(-1) / sizeof(T);
+	}
+
+	/** Returns true if the elements are stored inside the container (no heap allocation) */
+	bool is_inline() const noexcept
+	{
+		return _data == inlineData();
+	}
+
+	void reserve(size_type const newCapacity)
+	{
+		if (newCapacity > _capacity)
+		{
+			grow(newCapacity);
+		}
+	}
+
+	/** Moves the elements back to the inline storage if they fit in it */
+	void shrink_to_fit() noexcept
+	{
+		if (!is_inline() && _size <= InlineCapacity)
+		{
+			auto* const heapData = _data;
+			std::memcpy(static_cast<void*>(inlineData()), heapData, _size * sizeof(T));
+			::operator delete(heapData);
+			_data = inlineData();
+			_capacity = InlineCapacity;
+		}
+	}
+
+	/* ************************************************************************** */
+	/* Modifiers                                                                  */
+	void clear() noexcept
+	{
+		_size = 0u;
+	}
+
+	template<typename InputIt, typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+	void assign(InputIt first, InputIt last)
+	{
+		clear();
+		insert(end(), first, last);
+	}
+
+	void assign(std::initializer_list<T> const init)
+	{
+		assign(init.begin(), init.end());
+	}
+
+	void assign(size_type const count, T const& value)
+	{
+		clear();
+		resize(count, value);
+	}
+
+	void push_back(T const& value)
+	{
+		if (_size == _capacity)
+		{
+			// value might be an element of this container, copy it before growing
+			auto const copy = value;
+			grow(nextCapacity(_size + 1));
+			new (_data + _size) T(copy);
+		}
+		else
+		{
+			new (_data + _size) T(value);
+		}
+		++_size;
+	}
+
+	template<typename... Args>
+	reference emplace_back(Args&&... args)
+	{
+		auto value = T(std::forward<Args>(args)...);
+		push_back(value);
+		return back();
+	}
+
+	void pop_back() noexcept
+	{
+		--_size;
+	}
+
+	void resize(size_type const count)
+	{
+		resize(count, T{});
+	}
+
+	void resize(size_type const count, T const& value)
+	{
+		if (count > _size)
+		{
+			reserve(count);
+			std::uninitialized_fill(_data + _size, _data + count, value);
+		}
+		_size = count;
+	}
+
+	iterator insert(const_iterator const pos, T const& value)
+	{
+		return insert(pos, size_type{ 1u }, value);
+	}
+
+	iterator insert(const_iterator const pos, size_type const count, T const& value)
+	{
+		auto const copy = value; // value might be an element of this container
+		auto* const it = makeRoom(pos, count);
+		std::uninitialized_fill(it, it + count, copy);
+		return it;
+	}
+
+	template<typename InputIt, typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+	iterator insert(const_iterator const pos, InputIt first, InputIt last)
+	{
+		auto const index = static_cast<size_type>(pos - begin());
+		if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>)
+		{
+			auto const count = static_cast<size_type>(std::distance(first, last));
+			if constexpr (std::is_convertible_v<InputIt, T const*>)
+			{
+				if (count > 0u && isInRange(first))
+				{
+					// Inserting elements of this container, copy them before making room
+					auto const copy = SmallVector(first, last);
+					return insert(pos, copy.begin(), copy.end());
+				}
+			}
+			auto* const it = makeRoom(pos, count);
+			std::uninitialized_copy(first, last, it);
+			return it;
+		}
+		else
+		{
+			for (auto i = index; first != last; ++first, ++i)
+			{
+				insert(begin() + i, *first);
+			}
+			return begin() + index;
+		}
+	}
+
+	iterator insert(const_iterator const pos, std::initializer_list<T> const init)
+	{
+		return insert(pos, init.begin(), init.end());
+	}
+
+	template<typename... Args>
+	iterator emplace(const_iterator const pos, Args&&... args)
+	{
+		return insert(pos, T(std::forward<Args>(args)...));
+	}
+
+	iterator erase(const_iterator const pos) noexcept
+	{
+		return erase(pos, pos + 1);
+	}
+
+	iterator erase(const_iterator const first, const_iterator const last) noexcept
+	{
+		auto* const it = const_cast<iterator>(first);
+		auto const count = static_cast<size_type>(last - first);
+		if (count > 0u)
+		{
+			std::memmove(static_cast<void*>(it), last, static_cast<size_type>(end() - last) * sizeof(T));
+			_size -= count;
+		}
+		return it;
+	}
+
+	void swap(SmallVector& other) noexcept
+	{
+		auto tmp = std::move(other);
+		other = std::move(*this);
+		*this = std::move(tmp);
+	}
+
+private:
+	T* inlineData() noexcept
+	{
+		return reinterpret_cast<T*>(_inlineStorage);
+	}
+
+	T const* inlineData() const noexcept
+	{
+		return reinterpret_cast<T const*>(_inlineStorage);
+	}
+
+	bool isInRange(T const* const ptr) const noexcept
+	{
+		return std::less_equal<T const*>{}(_data, ptr) && std::less<T const*>{}(ptr, _data + _size);
+	}
+
+	size_type nextCapacity(size_type const minCapacity) const noexcept
+	{
+		return std::max(minCapacity, _capacity * 2u);
+	}
+
+	void grow(size_type const newCapacity)
+	{
+		auto* const newData = static_cast<T*>(::operator new(newCapacity * sizeof(T)));
+		if (_size > 0u)
+		{
+			std::memcpy(static_cast<void*>(newData), _data, _size * sizeof(T));
+		}
+		releaseHeap();
+		_data = newData;
+		_capacity = newCapacity;
+	}
+
+	/** Shifts elements at and after pos by count positions (growing if needed), returns the iterator to the first uninitialized element */
+	iterator makeRoom(const_iterator const pos, size_type const count)
+	{
+		auto const index = static_cast<size_type>(pos - begin());
+		if (_size + count > _capacity)
+		{
+			grow(nextCapacity(_size + count));
+		}
+		auto* const it = _data + index;
+		std::memmove(static_cast<void*>(it + count), it, (_size - index) * sizeof(T));
+		_size += count;
+		return it;
+	}
+
+	void releaseHeap() noexcept
+	{
+		if (!is_inline())
+		{
+			::operator delete(_data);
+			_data = inlineData();
+			_capacity = InlineCapacity;
+		}
+	}
+
+	void moveFrom(SmallVector&& other) noexcept
+	{
+		if (other.is_inline())
+		{
+			std::memcpy(static_cast<void*>(inlineData()), other._data, other._size * sizeof(T));
+			_data = inlineData();
+			_capacity = InlineCapacity;
+		}
+		else
+		{
+			_data = other._data;
+			_capacity = other._capacity;
+			other._data = other.inlineData();
+			other._capacity = InlineCapacity;
+		}
+		_size = other._size;
+		other._size = 0u;
+	}
+
+	T* _data{ inlineData() };
+	size_type _size{ 0u };
+	size_type _capacity{ InlineCapacity };
+	alignas(T) unsigned char _inlineStorage[InlineCapacity * sizeof(T)];
+};
+
+/**
+* @brief Set-like container keeping its unique elements sorted in a SmallVector.
+* @details All the methods of this class have the same meaning and specification than std::set,
+*          lookups are binary searches over contiguous memory and up to InlineCapacity elements are stored without any memory allocation.
+*          Inserting or erasing elements invalidates iterators (like std::vector).
+*/
+template<typename T, size_t InlineCapacity, typename Compare = std::less<T>>
+class FlatSet
+{
+	using Storage = SmallVector<T, InlineCapacity>;
+
+public:
+	using key_type = T;
+	using value_type = T;
+	using size_type = size_t;
+	using difference_type = std::ptrdiff_t;
+	using key_compare = Compare;
+	using value_compare = Compare;
+	using reference = T const&;
+	using const_reference = T const&;
+	using pointer = T const*;
+	using const_pointer = T const*;
+	using iterator = typename Storage::const_iterator;
+	using const_iterator = typename Storage::const_iterator;
+	using reverse_iterator = typename Storage::const_reverse_iterator;
+	using const_reverse_iterator = typename Storage::const_reverse_iterator;
+
+	/* ************************************************************************** */
+	/* Life cycle                                                                 */
+
+	/** Default constructor */
+	FlatSet() noexcept {}
+
+	/** Constructs the container with the content of the range [first, last) */
+	template<typename InputIt>
+	FlatSet(InputIt first, InputIt last)
+	{
+		insert(first, last);
+	}
+
+	/** Constructs the container with the content of the initializer list */
+	FlatSet(std::initializer_list<T> const init)
+	{
+		insert(init.begin(), init.end());
+	}
+
+	FlatSet& operator=(std::initializer_list<T> const init)
+	{
+		clear();
+		insert(init.begin(), init.end());
+		return *this;
+	}
+
+	/* ************************************************************************** */
+	/* Comparison operators                                                       */
+	friend bool operator==(FlatSet const& lhs, FlatSet const& rhs) noexcept
+	{
+		return lhs._elements == rhs._elements;
+	}
+
+	friend bool operator!=(FlatSet const& lhs, FlatSet const& rhs) noexcept
+	{
+		return !(lhs == rhs);
+	}
+
+	friend bool operator<(FlatSet const& lhs, FlatSet const& rhs) noexcept
+	{
+		return lhs._elements < rhs._elements;
+	}
+
+	/* ************************************************************************** */
+	/* Iterators                                                                  */
+	const_iterator begin() const noexcept
+	{
+		return _elements.begin();
+	}
+
+	const_iterator cbegin() const noexcept
+	{
+		return _elements.begin();
+	}
+
+	const_iterator end() const noexcept
+	{
+		return _elements.end();
+	}
+
+	const_iterator cend() const noexcept
+	{
+		return _elements.end();
+	}
+
+	const_reverse_iterator rbegin() const noexcept
+	{
+		return _elements.rbegin();
+	}
+
+	const_reverse_iterator rend() const noexcept
+	{
+		return _elements.rend();
+	}
+
+	/* ************************************************************************** */
+	/* Capacity                                                                   */
+	bool empty() const noexcept
+	{
+		return _elements.empty();
+	}
+
+	size_type size() const noexcept
+	{
+		return _elements.size();
+	}
+
+	size_type max_size() const noexcept
+	{
+		return _elements.max_size();
+	}
+
+	void reserve(size_type const newCapacity)
+	{
+		_elements.reserve(newCapacity);
+	}
+
+	/* ************************************************************************** */
+	/* Modifiers                                                                  */
+	void clear() noexcept
+	{
+		_elements.clear();
+	}
+
+	std::pair<iterator, bool> insert(T const& value)
+	{
+		auto const it = lower_bound(value);
+		if (it != end() && !Compare{}(value, *it))
+		{
+			return { it, false };
+		}
+		return { _elements.insert(it, value), true };
+	}
+
+	/** Inserts value, the hint is ignored (used by std::inserter) */
+	iterator insert(const_iterator const /*hint*/, T const& value)
+	{
+		return insert(value).first;
+	}
+
+	template<typename InputIt>
+	void insert(InputIt first, InputIt last)
+	{
+		for (; first != last; ++first)
+		{
+			insert(*first);
+		}
+	}
+
+	void insert(std::initializer_list<T> const init)
+	{
+		insert(init.begin(), init.end());
+	}
+
+	template<typename... Args>
+	std::pair<iterator, bool> emplace(Args&&... args)
+	{
+		return insert(T(std::forward<Args>(args)...));
+	}
+
+	iterator erase(const_iterator const pos) noexcept
+	{
+		return _elements.erase(pos);
+	}
+
+	iterator erase(const_iterator const first, const_iterator const last) noexcept
+	{
+		return _elements.erase(first, last);
+	}
+
+	size_type erase(T const& value) noexcept
+	{
+		auto const it = find(value);
+		if (it == end())
+		{
+			return 0u;
+		}
+		_elements.erase(it);
+		return 1u;
+	}
+
+	void swap(FlatSet& other) noexcept
+	{
+		_elements.swap(other._elements);
+	}
+
+	/* ************************************************************************** */
+	/* Lookup                                                                     */
+	const_iterator find(T const& value) const noexcept
+	{
+		auto const it = lower_bound(value);
+		if (it != end() && !Compare{}(value, *it))
+		{
+			return it;
+		}
+		return end();
+	}
+
+	size_type count(T const& value) const noexcept
+	{
+		return find(value) != end() ? 1u : 0u;
+	}
+
+	bool contains(T const& value) const noexcept
+	{
+		return find(value) != end();
+	}
+
+	const_iterator lower_bound(T const& value) const noexcept
+	{
+		return std::lower_bound(_elements.begin(), _elements.end(), value, Compare{});
+	}
+
+	const_iterator upper_bound(T const& value) const noexcept
+	{
+		return std::upper_bound(_elements.begin(), _elements.end(), value, Compare{});
+	}
+
+	/* ************************************************************************** */
+	/* Observers                                                                  */
+	key_compare key_comp() const
+	{
+		return Compare{};
+	}
+
+	value_compare value_comp() const
+	{
+		return Compare{};
+	}
+
+private:
+	Storage _elements{};
+};
+
+} // namespace avdecc
+} // namespace la
@@ -106,6 +106,9 @@ public:
 	// TODO: Add all other AggregateEntity parameters
 	virtual entity::AggregateEntity* addAggregateEntity(std::uint16_t const progID, UniqueIdentifier const entityModelID, entity::controller::Delegate* const controllerDelegate) = 0;
 
+	/** Returns the ProtocolInterface used by the EndStation, to change its settings. WARNING: The returned pointer is only valid as long as the EndStation is alive. */
+	virtual protocol::ProtocolInterface* getProtocolInterface() noexcept = 0;
+
 	// Deleted compiler auto-generated methods
 	EndStation(EndStation&&) = delete;
 	EndStation(EndStation const&) = delete;
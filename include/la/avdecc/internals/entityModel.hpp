@@ -129,7 +129,7 @@ struct AudioUnitDescriptor
 	std::uint16_t numberOfControlBlocks{ 0u };
 	ControlBlockIndex baseControlBlock{ ControlBlockIndex(0u) };
 	SamplingRate currentSamplingRate{};
-	std::set<SamplingRate> samplingRates{};
+	SamplingRates samplingRates{};
 };
 
 /** VIDEO_UNIT Descriptor - Clause 7.2.4 */
@@ -154,9 +154,9 @@ struct StreamDescriptor
 	std::uint16_t backedupTalkerUnique{ 0u };
 	AvbInterfaceIndex avbInterfaceIndex{ AvbInterfaceIndex(0u) };
 	std::uint32_t bufferLength{ 0u };
-	std::set<StreamFormat> formats{};
+	StreamFormats formats{};
 #ifdef ENABLE_AVDECC_FEATURE_REDUNDANCY
-	std::set<StreamIndex> redundantStreams{};
+	RedundantStreams redundantStreams{};
 #endif // ENABLE_AVDECC_FEATURE_REDUNDANCY
 };
 
@@ -341,7 +341,7 @@ struct ClockDomainDescriptor
 	AvdeccFixedString objectName{};
 	LocalizedStringReference localizedDescription{};
 	ClockSourceIndex clockSourceIndex{ ClockSourceIndex(0u) };
-	std::vector<ClockSourceIndex> clockSources{};
+	ClockSources clockSources{};
 };
 
 /** CONTROL_BLOCK Descriptor - Clause 7.2.33 */
@@ -27,8 +27,9 @@
 
 #include "entityModelTreeDynamic.hpp"
 #include "entityModelTreeStatic.hpp"
+#include "la/avdecc/copyOnWrite.hpp"
+#include "la/avdecc/indexedMap.hpp"
 
-#include <map>
 #include <set>
 
 namespace la
@@ -39,107 +40,108 @@ namespace entity
 {
 namespace model
 {
+/* Static models are immutable and shared between all the copies of a tree (e.g. all the entities using the same cached EntityModel), until modified */
 struct AudioUnitNodeModels
 {
-	AudioUnitNodeStaticModel staticModel{};
+	CopyOnWrite<AudioUnitNodeStaticModel> staticModel{};
 	AudioUnitNodeDynamicModel dynamicModel{};
 };
 
 struct StreamInputNodeModels
 {
-	StreamNodeStaticModel staticModel{};
+	CopyOnWrite<StreamNodeStaticModel> staticModel{};
 	StreamInputNodeDynamicModel dynamicModel{};
 };
 
 struct StreamOutputNodeModels
 {
-	StreamNodeStaticModel staticModel{};
+	CopyOnWrite<StreamNodeStaticModel> staticModel{};
 	StreamOutputNodeDynamicModel dynamicModel{};
 };
 
 struct AvbInterfaceNodeModels
 {
-	AvbInterfaceNodeStaticModel staticModel{};
+	CopyOnWrite<AvbInterfaceNodeStaticModel> staticModel{};
 	AvbInterfaceNodeDynamicModel dynamicModel{};
 };
 
 struct ClockSourceNodeModels
 {
-	ClockSourceNodeStaticModel staticModel{};
+	CopyOnWrite<ClockSourceNodeStaticModel> staticModel{};
 	ClockSourceNodeDynamicModel dynamicModel{};
 };
 
 struct MemoryObjectNodeModels
 {
-	MemoryObjectNodeStaticModel staticModel{};
+	CopyOnWrite<MemoryObjectNodeStaticModel> staticModel{};
 	MemoryObjectNodeDynamicModel dynamicModel{};
 };
 
 struct LocaleNodeModels
 {
-	LocaleNodeStaticModel staticModel{};
+	CopyOnWrite<LocaleNodeStaticModel> staticModel{};
 };
 
 struct StringsNodeModels
 {
-	StringsNodeStaticModel staticModel{};
+	CopyOnWrite<StringsNodeStaticModel> staticModel{};
 };
 
 struct StreamPortNodeModels
 {
-	StreamPortNodeStaticModel staticModel{};
+	CopyOnWrite<StreamPortNodeStaticModel> staticModel{};
 	StreamPortNodeDynamicModel dynamicModel{};
 };
 
 struct AudioClusterNodeModels
 {
-	AudioClusterNodeStaticModel staticModel{};
+	CopyOnWrite<AudioClusterNodeStaticModel> staticModel{};
 	AudioClusterNodeDynamicModel dynamicModel{};
 };
 
 struct AudioMapNodeModels
 {
-	AudioMapNodeStaticModel staticModel{};
+	CopyOnWrite<AudioMapNodeStaticModel> staticModel{};
 };
 
 struct ControlNodeModels
 {
-	ControlNodeStaticModel staticModel{};
+	CopyOnWrite<ControlNodeStaticModel> staticModel{};
 	ControlNodeDynamicModel dynamicModel{};
 };
 
 struct ClockDomainNodeModels
 {
-	ClockDomainNodeStaticModel staticModel{};
+	CopyOnWrite<ClockDomainNodeStaticModel> staticModel{};
 	ClockDomainNodeDynamicModel dynamicModel{};
 };
 
 struct ConfigurationTree
 {
 	// Children
-	std::map<AudioUnitIndex, AudioUnitNodeModels> audioUnitModels{};
-	std::map<StreamIndex, StreamInputNodeModels> streamInputModels{};
-	std::map<StreamIndex, StreamOutputNodeModels> streamOutputModels{};
-	//std::map<JackIndex, JackNodeModels> jackInputModels{};
-	//std::map<JackIndex, JackNodeStaticModel> jackOutputModels{};
-	std::map<AvbInterfaceIndex, AvbInterfaceNodeModels> avbInterfaceModels{};
-	std::map<ClockSourceIndex, ClockSourceNodeModels> clockSourceModels{};
-	std::map<MemoryObjectIndex, MemoryObjectNodeModels> memoryObjectModels{};
-	std::map<LocaleIndex, LocaleNodeModels> localeModels{};
-	std::map<StringsIndex, StringsNodeModels> stringsModels{};
-	std::map<StreamPortIndex, StreamPortNodeModels> streamPortInputModels{};
-	std::map<StreamPortIndex, StreamPortNodeModels> streamPortOutputModels{};
-	//std::map<ExternalPortIndex, ExternalPortNodeModels> externalPortInputModels{};
-	//std::map<ExternalPortIndex, ExternalPortNodeModels> externalPortOutputModels{};
-	//std::map<InternalPortIndex, InternalPortNodeModels> internalPortInputModels{};
-	//std::map<InternalPortIndex, InternalPortNodeModels> internalPortOutputModels{};
-	std::map<ClusterIndex, AudioClusterNodeModels> audioClusterModels{};
-	std::map<MapIndex, AudioMapNodeModels> audioMapModels{};
-	std::map<ControlIndex, ControlNodeModels> controlModels{};
-	std::map<ClockDomainIndex, ClockDomainNodeModels> clockDomainModels{};
+	IndexedMap<AudioUnitIndex, AudioUnitNodeModels> audioUnitModels{};
+	IndexedMap<StreamIndex, StreamInputNodeModels> streamInputModels{};
+	IndexedMap<StreamIndex, StreamOutputNodeModels> streamOutputModels{};
+	//IndexedMap<JackIndex, JackNodeModels> jackInputModels{};
+	//IndexedMap<JackIndex, JackNodeStaticModel> jackOutputModels{};
+	IndexedMap<AvbInterfaceIndex, AvbInterfaceNodeModels> avbInterfaceModels{};
+	IndexedMap<ClockSourceIndex, ClockSourceNodeModels> clockSourceModels{};
+	IndexedMap<MemoryObjectIndex, MemoryObjectNodeModels> memoryObjectModels{};
+	IndexedMap<LocaleIndex, LocaleNodeModels> localeModels{};
+	IndexedMap<StringsIndex, StringsNodeModels> stringsModels{};
+	IndexedMap<StreamPortIndex, StreamPortNodeModels> streamPortInputModels{};
+	IndexedMap<StreamPortIndex, StreamPortNodeModels> streamPortOutputModels{};
+	//IndexedMap<ExternalPortIndex, ExternalPortNodeModels> externalPortInputModels{};
+	//IndexedMap<ExternalPortIndex, ExternalPortNodeModels> externalPortOutputModels{};
+	//IndexedMap<InternalPortIndex, InternalPortNodeModels> internalPortInputModels{};
+	//IndexedMap<InternalPortIndex, InternalPortNodeModels> internalPortOutputModels{};
+	IndexedMap<ClusterIndex, AudioClusterNodeModels> audioClusterModels{};
+	IndexedMap<MapIndex, AudioMapNodeModels> audioMapModels{};
+	IndexedMap<ControlIndex, ControlNodeModels> controlModels{};
+	IndexedMap<ClockDomainIndex, ClockDomainNodeModels> clockDomainModels{};
 
 	// AEM Static info
-	ConfigurationNodeStaticModel staticModel;
+	CopyOnWrite<ConfigurationNodeStaticModel> staticModel{};
 
 	// AEM Dynamic info
 	ConfigurationNodeDynamicModel dynamicModel;
@@ -147,13 +149,13 @@ struct ConfigurationTree
 
 struct EntityTree
 {
-	using ConfigurationTrees = std::map<ConfigurationIndex, ConfigurationTree>;
+	using ConfigurationTrees = IndexedMap<ConfigurationIndex, ConfigurationTree>;
 
 	// Children
 	ConfigurationTrees configurationTrees{};
 
 	// AEM Static info
-	EntityNodeStaticModel staticModel;
+	CopyOnWrite<EntityNodeStaticModel> staticModel{};
 
 	// AEM Dynamic info
 	EntityNodeDynamicModel dynamicModel;
@@ -26,6 +26,7 @@
 #pragma once
 
 #include "la/avdecc/utils.hpp"
+#include "la/avdecc/inlineContainers.hpp"
 
 #include "uniqueIdentifier.hpp"
 #include "exports.hpp"
@@ -312,7 +313,7 @@ struct AudioMapping
 	}
 };
 
-using AudioMappings = std::vector<AudioMapping>;
+using AudioMappings = SmallVector<AudioMapping, 8>;
 
 /** Control Type - Clause 7.3.4 */
 using ControlType = UniqueIdentifier;
@@ -802,6 +803,14 @@ private:
 	value_type _value{ NullStreamFormat };
 };
 
+/** Containers for the list fields of the descriptors, sized to hold the common cases without any memory allocation */
+using StreamFormats = FlatSet<StreamFormat, 16>;
+#ifdef ENABLE_AVDECC_FEATURE_REDUNDANCY
+using RedundantStreams = FlatSet<StreamIndex, 2>;
+#endif // ENABLE_AVDECC_FEATURE_REDUNDANCY
+using SamplingRates = FlatSet<SamplingRate, 8>;
+using ClockSources = SmallVector<ClockSourceIndex, 8>;
+
 /** Localized String Reference - Clause 7.3.6 */
 class LocalizedStringReference final
 {
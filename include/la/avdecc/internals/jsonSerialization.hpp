@@ -32,6 +32,7 @@
 
 #include <exception>
 #ifdef ENABLE_AVDECC_FEATURE_JSON
+#	include "jsonStreamWriter.hpp"
 #	include <nlohmann/json.hpp>
 #endif // ENABLE_AVDECC_FEATURE_JSON
 
@@ -147,6 +148,7 @@ using Flags = utils::EnumBitfield<Flag>;
 #ifdef ENABLE_AVDECC_FEATURE_JSON
 // Serialization methods
 LA_AVDECC_API nlohmann::json LA_AVDECC_CALL_CONVENTION createJsonObject(EntityTree const& entityTree, Flags const flags); // Throws SerializationException
+LA_AVDECC_API void LA_AVDECC_CALL_CONVENTION writeJsonObject(avdecc::jsonSerializer::StreamWriter& writer, EntityTree const& entityTree, Flags const flags); // Same output than createJsonObject, but written as it goes (only one configuration held in memory at a time). Throws SerializationException
 
 // Deserialization methods
 LA_AVDECC_API EntityTree LA_AVDECC_CALL_CONVENTION createEntityTree(nlohmann::json const& object, Flags const flags); // Throws DeserializationException
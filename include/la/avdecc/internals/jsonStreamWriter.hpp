@@ -0,0 +1,246 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @file jsonStreamWriter.hpp
+* @author Christophe Calmejane
+* @brief Incremental JSON writer, producing the same output than nlohmann::json pretty printing.
+*/
+
+#pragma once
+
+#include "la/avdecc/utils.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace la
+{
+namespace avdecc
+{
+namespace jsonSerializer
+{
+/**
+* @brief Writes a JSON document to a stream, one member at a time.
+* @details The output is byte-identical to nlohmann::json pretty printing (os << std::setw(indentStep) << object) of the same document,
+*          provided that the members of each object are written in nlohmann::json key order (lexicographic order).
+*          Any value can be a full nlohmann::json subtree, which allows a document to be streamed without ever building it completely in memory.
+*          A part of a document can also be written separately (to another stream, with the indentation 'depth' it will have in the document), then inserted using writeFormattedValue.
+*          Doesn't throw by itself, but writing a value may throw a nlohmann::json::exception (invalid UTF-8 string, for example).
+*/
+class StreamWriter final
+{
+public:
+	explicit StreamWriter(std::ostream& os, unsigned int const indentStep = 4u, size_t const depth = 0u) noexcept
+		: _os{ os }
+		, _indentStep{ indentStep }
+		, _baseDepth{ depth }
+	{
+	}
+
+	/** Returns the current indentation depth */
+	size_t getDepth() const noexcept
+	{
+		return _baseDepth + _scopes.size();
+	}
+
+	/** Starts an object (as a value) */
+	void beginObject()
+	{
+		beginValue();
+		_os.put('{');
+		_scopes.push_back(Scope{ true });
+	}
+
+	/** Ends the current object */
+	void endObject()
+	{
+		AVDECC_ASSERT(!_scopes.empty() && _scopes.back().isObject, "Not in an object");
+		endScope('}');
+	}
+
+	/** Starts an array (as a value) */
+	void beginArray()
+	{
+		beginValue();
+		_os.put('[');
+		_scopes.push_back(Scope{ false });
+	}
+
+	/** Ends the current array */
+	void endArray()
+	{
+		AVDECC_ASSERT(!_scopes.empty() && !_scopes.back().isObject, "Not in an array");
+		endScope(']');
+	}
+
+	/** Writes the key of the next member of the current object, must be followed by a value */
+	void writeKey(std::string const& key)
+	{
+		AVDECC_ASSERT(!_scopes.empty() && _scopes.back().isObject, "Not in an object");
+		AVDECC_ASSERT(!_isKeyPending, "Previous key has no value");
+		AVDECC_ASSERT(_scopes.back().isEmpty || _scopes.back().lastKey < key, "Keys must be written in lexicographic order");
+		beginMember();
+		_os << nlohmann::json(key).dump() << ": ";
+		_isKeyPending = true;
+		_scopes.back().lastKey = key;
+	}
+
+	/** Writes a value (a full subtree if it's an object or an array) */
+	void writeValue(nlohmann::json const& value)
+	{
+		beginValue();
+		auto const text = value.dump(static_cast<int>(_indentStep));
+		if (!value.is_structured() || getDepth() == 0u)
+		{
+			_os << text;
+			return;
+		}
+
+		// Indent the subtree to the current depth (string values never contain raw line feeds, they are escaped)
+		auto const indent = std::string(getDepth() * _indentStep, ' ');
+		auto start = size_t{ 0u };
+		for (auto pos = text.find('\n'); pos != std::string::npos; pos = text.find('\n', start))
+		{
+			_os.write(text.data() + start, pos + 1 - start);
+			_os << indent;
+			start = pos + 1;
+		}
+		_os.write(text.data() + start, text.size() - start);
+	}
+
+	/** Writes a value that has already been formatted for the current depth (by another StreamWriter constructed with the same indentStep and getDepth() as depth) */
+	void writeFormattedValue(std::string const& text)
+	{
+		beginValue();
+		_os << text;
+	}
+
+	/** Writes all the members of the specified object */
+	void writeMembers(nlohmann::json const& object)
+	{
+		for (auto it = object.begin(); it != object.end(); ++it)
+		{
+			writeKey(it.key());
+			writeValue(it.value());
+		}
+	}
+
+	/** Writes all the members of the specified object, plus 'streamedKey' in key order, whose value is written by 'writeStreamedValue' */
+	template<typename WriteStreamedValue>
+	void writeMembers(nlohmann::json const& object, std::string const& streamedKey, WriteStreamedValue&& writeStreamedValue)
+	{
+		AVDECC_ASSERT(object.find(streamedKey) == object.end(), "Streamed key should not be part of the object");
+		auto isStreamedKeyPending = true;
+		for (auto it = object.begin(); it != object.end(); ++it)
+		{
+			if (isStreamedKeyPending && streamedKey < it.key())
+			{
+				writeKey(streamedKey);
+				writeStreamedValue();
+				isStreamedKeyPending = false;
+			}
+			writeKey(it.key());
+			writeValue(it.value());
+		}
+		if (isStreamedKeyPending)
+		{
+			writeKey(streamedKey);
+			writeStreamedValue();
+		}
+	}
+
+	// Deleted compiler auto-generated methods
+	StreamWriter(StreamWriter const&) = delete;
+	StreamWriter(StreamWriter&&) = delete;
+	StreamWriter& operator=(StreamWriter const&) = delete;
+	StreamWriter& operator=(StreamWriter&&) = delete;
+
+private:
+	struct Scope
+	{
+		bool isObject{ false };
+		bool isEmpty{ true };
+		std::string lastKey{};
+	};
+
+	void writeIndent()
+	{
+		for (auto i = size_t{ 0u }; i < getDepth() * _indentStep; ++i)
+		{
+			_os.put(' ');
+		}
+	}
+
+	/** Writes the separator preceding a new member (or array element) of the current scope */
+	void beginMember()
+	{
+		auto& scope = _scopes.back();
+		if (!scope.isEmpty)
+		{
+			_os.put(',');
+		}
+		_os.put('\n');
+		writeIndent();
+		scope.isEmpty = false;
+	}
+
+	void beginValue()
+	{
+		if (_scopes.empty())
+		{
+			return;
+		}
+		if (_scopes.back().isObject)
+		{
+			AVDECC_ASSERT(_isKeyPending, "Object member has no key");
+			_isKeyPending = false;
+		}
+		else
+		{
+			beginMember();
+		}
+	}
+
+	void endScope(char const closingChar)
+	{
+		auto const wasEmpty = _scopes.back().isEmpty;
+		_scopes.pop_back();
+		// nlohmann::json writes empty objects and arrays on a single line
+		if (!wasEmpty)
+		{
+			_os.put('\n');
+			writeIndent();
+		}
+		_os.put(closingChar);
+	}
+
+	std::ostream& _os;
+	unsigned int const _indentStep{ 4u };
+	size_t const _baseDepth{ 0u };
+	std::vector<Scope> _scopes{};
+	bool _isKeyPending{ false };
+};
+
+} // namespace jsonSerializer
+} // namespace avdecc
+} // namespace la
@@ -33,6 +33,7 @@
 
 #include "la/avdecc/utils.hpp"
 #include "la/avdecc/avdecc.hpp"
+#include "la/avdecc/copyOnWrite.hpp"
 
 #include <nlohmann/json.hpp>
 
@@ -84,6 +85,20 @@ struct adl_serializer<std::optional<T>>
 	}
 };
 
+template<typename T>
+struct adl_serializer<la::avdecc::CopyOnWrite<T>>
+{
+	static void to_json(json& j, la::avdecc::CopyOnWrite<T> const& value)
+	{
+		j = value.get();
+	}
+	static void from_json(json const& j, la::avdecc::CopyOnWrite<T>& value)
+	{
+		// Deserialize in place, T's from_json may only set some of the fields
+		j.get_to(value.getMutable());
+	}
+};
+
 template<>
 struct adl_serializer<std::chrono::milliseconds>
 {
@@ -388,6 +403,15 @@ inline void from_json(json const& j, UniqueIdentifier& eid)
 	eid.setValue(utils::convertFromString<UniqueIdentifier::value_type>(j.get<std::string>().c_str()));
 }
 
+/* FlatSet conversion (nlohmann cannot deduce the value_type from a const pointer iterator, serialization uses the generic array conversion) */
+template<typename T, size_t InlineCapacity, typename Compare>
+void from_json(json const& j, FlatSet<T, InlineCapacity, Compare>& s)
+{
+	auto const values = j.get<std::vector<T>>();
+	s.clear();
+	s.insert(values.begin(), values.end());
+}
+
 namespace entity
 {
 namespace keyName
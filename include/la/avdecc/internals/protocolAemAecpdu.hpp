@@ -106,7 +106,7 @@ private:
 	// Aem header data
 	bool _unsolicited{ false };
 	AemCommandType _commandType{ AemCommandType::InvalidCommandType };
-	std::array<std::uint8_t, MaximumPayloadBufferLength> _commandSpecificData{};
+	std::array<std::uint8_t, MaximumPayloadBufferLength> _commandSpecificData; // Not value-initialized on purpose, only '_commandSpecificDataLength' bytes are valid
 	size_t _commandSpecificDataLength{ 0u };
 };
 
@@ -38,6 +38,7 @@
 #include <la/networkInterfaceHelper/networkInterfaceHelper.hpp>
 
 #include <unordered_map>
+#include <atomic>
 #include <memory>
 #include <string>
 #include <cstdint>
@@ -60,6 +61,12 @@ class ProtocolInterface : public la::avdecc::utils::Subject<ProtocolInterface, s
 public:
 	/** Name of the default executor used for events */
 	static auto constexpr DefaultExecutorName = "avdecc::protocol::PI";
+	/** Maximum number of received frames that can be dispatched in a single executor job (see setIngressBatching) */
+	static auto constexpr MaximumIngressBatchFrames = std::uint32_t{ 64u };
+	/** Default maximum number of AECP commands that can be inflight for a single target entity (see setMaxAecpInflightCommands) */
+	static auto constexpr DefaultMaxAecpInflightCommands = std::uint32_t{ 10u };
+	/** Highest value accepted by setMaxAecpInflightCommands */
+	static auto constexpr MaximumAecpInflightCommands = std::uint32_t{ 64u };
 
 	/** The existing types of ProtocolInterface */
 	enum class Type
@@ -69,6 +76,7 @@ public:
 		MacOSNative = 1u << 1, /**< macOS native API protocol interface - Only usable on macOS. */
 		Proxy = 1u << 2, /**< IEEE Std 1722.1 Proxy protocol interface. */
 		Virtual = 1u << 3, /**< Virtual protocol interface. */
+		TPacket = 1u << 4, /**< Linux AF_PACKET (TPACKET_V3 memory mapped ring) protocol interface - Only usable on Linux. */
 	};
 
 	/** Possible Error status returned (or thrown) by a ProtocolInterface */
@@ -247,6 +255,10 @@ public:
 	LA_AVDECC_API Error LA_AVDECC_CALL_CONVENTION unregisterVendorUniqueDelegate(VuAecpdu::ProtocolIdentifier const& protocolIdentifier) noexcept;
 	/** Unregisters all VendorUniqueDelegate. */
 	LA_AVDECC_API Error LA_AVDECC_CALL_CONVENTION unregisterAllVendorUniqueDelegates() noexcept;
+	/** Sets how many received frames (at most MaximumIngressBatchFrames) the capture thread may accumulate, and for how long, before dispatching them in a single executor job. Default is 1 frame (no batching). Not used by all kinds of ProtocolInterface. */
+	LA_AVDECC_API Error LA_AVDECC_CALL_CONVENTION setIngressBatching(std::uint32_t const maxFrames, std::chrono::microseconds const maxDelay) noexcept;
+	/** Sets the ceiling (between 1 and MaximumAecpInflightCommands) of the adaptive number of AECP commands inflight for a single target entity. The window starts at DefaultMaxAecpInflightCommands (or the ceiling, if lower), grows while the target responds in time and shrinks on timeouts. Default is DefaultMaxAecpInflightCommands. Not used by all kinds of ProtocolInterface. */
+	LA_AVDECC_API Error LA_AVDECC_CALL_CONVENTION setMaxAecpInflightCommands(std::uint32_t const maxInflightCommands) noexcept;
 
 	/* ************************************************************ */
 	/* Advertising entry points                                     */
@@ -339,6 +351,15 @@ protected:
 	/** Returns the VendorUniqueDelegate handling the specified protocolIdentifier, or nullptr if none has been registered. WARNING: Once returned, the pointed object is NOT locked. */
 	VendorUniqueDelegate* getVendorUniqueDelegate(VuAecpdu::ProtocolIdentifier const& protocolIdentifier) const noexcept;
 
+	/** Returns the maximum number of frames in an ingress batch (see setIngressBatching). */
+	std::uint32_t getIngressBatchMaxFrames() const noexcept;
+
+	/** Returns the maximum delay between the first frame of an ingress batch and its dispatch (see setIngressBatching). */
+	std::chrono::microseconds getIngressBatchMaxDelay() const noexcept;
+
+	/** Returns the ceiling of the adaptive AECP inflight window (see setMaxAecpInflightCommands). */
+	std::uint32_t getMaxAecpInflightCommands() const noexcept;
+
 	std::string const _networkInterfaceName{};
 
 private:
@@ -350,6 +371,9 @@ private:
 
 	networkInterface::MacAddress _networkInterfaceMacAddress{};
 	std::unordered_map<VuAecpdu::ProtocolIdentifier, VendorUniqueDelegate*, VuAecpdu::ProtocolIdentifier::hash> _vendorUniqueDelegates{};
+	std::atomic<std::uint32_t> _ingressBatchMaxFrames{ 1u };
+	std::atomic<std::chrono::microseconds::rep> _ingressBatchMaxDelay{ 0 };
+	std::atomic<std::uint32_t> _maxAecpInflightCommands{ DefaultMaxAecpInflightCommands };
 };
 
 /* Operator overloads */
@@ -101,7 +101,7 @@ private:
 
 	// Mvu header data
 	MvuCommandType _commandType{ MvuCommandType::InvalidCommandType };
-	std::array<std::uint8_t, MaximumPayloadBufferLength> _commandSpecificData{};
+	std::array<std::uint8_t, MaximumPayloadBufferLength> _commandSpecificData; // Not value-initialized on purpose, only '_commandSpecificDataLength' bytes are valid
 	size_t _commandSpecificDataLength{ 0u };
 };
 
@@ -31,6 +31,7 @@
 #include <la/avdecc/utils.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <typeindex>
 #include <unordered_map>
@@ -77,12 +78,198 @@ static std::string getCommonString(std::string const& lhs, std::string const& rh
 	return {};
 }
 
+/* ************************************************************************** */
+/* ControlledEntityImpl::LockInformation                                      */
+/* ************************************************************************** */
+/** Locks currently held by this thread */
+static std::vector<ControlledEntityImpl::LockInformation*>& getThreadLocks() noexcept
+{
+	static thread_local auto s_threadLocks = std::vector<ControlledEntityImpl::LockInformation*>{};
+	return s_threadLocks;
+}
+
+/** Jobs deferred by this thread until it no longer holds any lock */
+static std::vector<ControlledEntityImpl::LockInformation::DeferredJob>& getThreadDeferredJobs() noexcept
+{
+	static thread_local auto s_threadDeferredJobs = std::vector<ControlledEntityImpl::LockInformation::DeferredJob>{};
+	return s_threadDeferredJobs;
+}
+
+std::uint64_t ControlledEntityImpl::LockInformation::getNextLockOrder() noexcept
+{
+	static auto s_nextLockOrder = std::atomic<std::uint64_t>{ 0u };
+	return s_nextLockOrder++;
+}
+
+void ControlledEntityImpl::LockInformation::onLocked() noexcept
+{
+	if (_lockedCount == 0)
+	{
+		_lockingThreadID = std::this_thread::get_id();
+		getThreadLocks().push_back(this);
+	}
+	++_lockedCount;
+}
+
+void ControlledEntityImpl::LockInformation::lock() noexcept
+{
+	_lock.lock();
+	onLocked();
+}
+
+bool ControlledEntityImpl::LockInformation::tryLock() noexcept
+{
+	if (_lock.try_lock())
+	{
+		onLocked();
+		return true;
+	}
+	return false;
+}
+
+void ControlledEntityImpl::LockInformation::unlock() noexcept
+{
+	AVDECC_ASSERT(isSelfLocked(), "unlock should not be called when current thread is not the lock holder");
+
+	--_lockedCount;
+	if (_lockedCount == 0)
+	{
+		_lockingThreadID = {};
+		auto& threadLocks = getThreadLocks();
+		threadLocks.erase(std::find(threadLocks.begin(), threadLocks.end(), this));
+	}
+	_lock.unlock();
+}
+
+void ControlledEntityImpl::LockInformation::lockAll(std::uint32_t const lockedCount) noexcept
+{
+	for (auto count = 0u; count < lockedCount; ++count)
+	{
+		lock();
+	}
+}
+
+std::uint32_t ControlledEntityImpl::LockInformation::unlockAll() noexcept
+{
+	AVDECC_ASSERT(isSelfLocked(), "unlockAll should not be called when current thread is not the lock holder");
+
+	auto result = 0u;
+	[[maybe_unused]] auto const previousLockedCount = _lockedCount;
+	while (isSelfLocked())
+	{
+		unlock();
+		++result;
+	}
+
+	AVDECC_ASSERT(previousLockedCount == result, "lockedCount does not match the number of unlockings");
+	return result;
+}
+
+bool ControlledEntityImpl::LockInformation::isAnySelfLocked() noexcept
+{
+	return !getThreadLocks().empty();
+}
+
+ControlledEntityImpl::LockInformation::SelfLocks ControlledEntityImpl::LockInformation::unlockAllSelfLocked() noexcept
+{
+	auto& threadLocks = getThreadLocks();
+	auto selfLocks = SelfLocks{};
+	selfLocks.reserve(threadLocks.size());
+	while (!threadLocks.empty())
+	{
+		auto* const lockInfo = threadLocks.back();
+		selfLocks.emplace_back(lockInfo, lockInfo->unlockAll());
+	}
+	return selfLocks;
+}
+
+void ControlledEntityImpl::LockInformation::lockAllSelfLocked(SelfLocks selfLocks) noexcept
+{
+	std::sort(selfLocks.begin(), selfLocks.end(),
+		[](auto const& lhs, auto const& rhs)
+		{
+			return lhs.first->_lockOrder < rhs.first->_lockOrder;
+		});
+
+	// Wait for the first lock (nothing else is held yet), then only try the other ones: if any is not available, release what was acquired and start again (same algorithm than std::lock)
+	while (!selfLocks.empty())
+	{
+		auto const& [firstLockInfo, firstLockedCount] = selfLocks.front();
+		firstLockInfo->lockAll(firstLockedCount);
+
+		auto failedIt = std::find_if(std::next(selfLocks.begin()), selfLocks.end(),
+			[](auto const& selfLock)
+			{
+				return !selfLock.first->tryLock();
+			});
+		if (failedIt == selfLocks.end())
+		{
+			// All acquired, restore the recursive locked counts
+			for (auto it = std::next(selfLocks.begin()); it != selfLocks.end(); ++it)
+			{
+				it->first->lockAll(it->second - 1u);
+			}
+			return;
+		}
+
+		// Release the locks acquired during this attempt
+		for (auto it = std::next(selfLocks.begin()); it != failedIt; ++it)
+		{
+			it->first->unlock();
+		}
+		firstLockInfo->unlockAll();
+
+		// Start with the lock that was not available, we'll most likely wait for it
+		std::rotate(selfLocks.begin(), failedIt, selfLocks.end());
+		std::this_thread::yield();
+	}
+}
+
+void ControlledEntityImpl::LockInformation::deferUntilAllUnlocked(DeferredJob&& job) noexcept
+{
+	AVDECC_ASSERT(isAnySelfLocked(), "deferUntilAllUnlocked should only be called when current thread holds a lock");
+
+	getThreadDeferredJobs().push_back(std::move(job));
+}
+
+void ControlledEntityImpl::LockInformation::runDeferredJobs() noexcept
+{
+	static thread_local auto s_isRunning = false;
+
+	// Jobs are run by the outermost call only (releasing the entities locked by a job will call us again)
+	if (s_isRunning || isAnySelfLocked())
+	{
+		return;
+	}
+
+	s_isRunning = true;
+	auto& deferredJobs = getThreadDeferredJobs();
+	// A job might defer other jobs
+	while (!deferredJobs.empty())
+	{
+		auto jobs = std::move(deferredJobs);
+		deferredJobs.clear();
+		for (auto const& job : jobs)
+		{
+			try
+			{
+				job();
+			}
+			catch (...)
+			{
+				AVDECC_ASSERT(false, "Deferred job should not throw");
+			}
+		}
+	}
+	s_isRunning = false;
+}
+
 /* ************************************************************************** */
 /* ControlledEntityImpl                                                       */
 /* ************************************************************************** */
 /** Constructor */
-ControlledEntityImpl::ControlledEntityImpl(entity::Entity const& entity, LockInformation::SharedPointer const& sharedLock, bool const isVirtual) noexcept
-	: _sharedLock(sharedLock)
+ControlledEntityImpl::ControlledEntityImpl(entity::Entity const& entity, LockInformation::SharedPointer const& lockInformation, bool const isVirtual) noexcept
+	: _lockInformation(lockInformation)
 	, _isVirtual(isVirtual)
 	, _entity(entity)
 {
@@ -469,7 +656,7 @@ entity::model::LocaleNodeStaticModel const* ControlledEntityImpl::findLocaleNode
 
 #pragma message("TODO: Parse 'locale' parameter and find best match")
 	// Right now, return the first locale
-	return &configTree.localeModels.at(0).staticModel;
+	return &configTree.localeModels.at(0).staticModel.get();
 }
 
 entity::model::AvdeccFixedString const& ControlledEntityImpl::getLocalizedString(entity::model::LocalizedStringReference const& stringReference) const noexcept
@@ -875,12 +1062,25 @@ void ControlledEntityImpl::accept(model::EntityModelVisitor* const visitor, bool
 
 void ControlledEntityImpl::lock() noexcept
 {
-	_sharedLock->lock();
+	_lockInformation->lock();
 }
 
 void ControlledEntityImpl::unlock() noexcept
 {
-	_sharedLock->unlock();
+	_lockInformation->unlock();
+
+	// Run the work that was deferred while this thread was holding entities
+	LockInformation::runDeferredJobs();
+}
+
+bool ControlledEntityImpl::tryLock() noexcept
+{
+	return _lockInformation->tryLock();
+}
+
+std::uint64_t ControlledEntityImpl::getLockOrder() const noexcept
+{
+	return _lockInformation->getLockOrder();
 }
 
 // Const Tree getters, all throw Exception::NotSupported if EM not supported by the Entity, Exception::InvalidConfigurationIndex if configurationIndex do not exist
@@ -913,7 +1113,7 @@ entity::model::ConfigurationIndex ControlledEntityImpl::getCurrentConfigurationI
 // Const NodeModel getters, all throw Exception::NotSupported if EM not supported by the Entity, Exception::InvalidConfigurationIndex if configurationIndex do not exist, Exception::InvalidDescriptorIndex if descriptorIndex is invalid
 entity::model::EntityNodeStaticModel const& ControlledEntityImpl::getEntityNodeStaticModel() const
 {
-	return getEntityTree().staticModel;
+	return getEntityTree().staticModel.get();
 }
 
 entity::model::EntityNodeDynamicModel const& ControlledEntityImpl::getEntityNodeDynamicModel() const
@@ -923,7 +1123,7 @@ entity::model::EntityNodeDynamicModel const& ControlledEntityImpl::getEntityNode
 
 entity::model::ConfigurationNodeStaticModel const& ControlledEntityImpl::getConfigurationNodeStaticModel(entity::model::ConfigurationIndex const configurationIndex) const
 {
-	return getConfigurationTree(configurationIndex).staticModel;
+	return getConfigurationTree(configurationIndex).staticModel.get();
 }
 
 entity::model::ConfigurationNodeDynamicModel const& ControlledEntityImpl::getConfigurationNodeDynamicModel(entity::model::ConfigurationIndex const configurationIndex) const
@@ -950,6 +1150,7 @@ bool ControlledEntityImpl::hasConfigurationTree(entity::model::ConfigurationInde
 // Non-const Tree getters
 entity::model::EntityTree& ControlledEntityImpl::getEntityTree() noexcept
 {
+	_isSnapshotDirty = true;
 	return _entityTree;
 }
 
@@ -960,9 +1161,11 @@ entity::model::ConfigurationTree& ControlledEntityImpl::getConfigurationTree(ent
 }
 
 // Non-const NodeModel getters
-entity::model::EntityNodeStaticModel& ControlledEntityImpl::getEntityNodeStaticModel() noexcept
+entity::model::EntityNodeStaticModel& ControlledEntityImpl::getMutableEntityNodeStaticModel() noexcept
 {
-	return getEntityTree().staticModel;
+	auto& staticModel = getEntityTree().staticModel.getMutable();
+	onStaticModelUnshared();
+	return staticModel;
 }
 
 entity::model::EntityNodeDynamicModel& ControlledEntityImpl::getEntityNodeDynamicModel() noexcept
@@ -970,9 +1173,11 @@ entity::model::EntityNodeDynamicModel& ControlledEntityImpl::getEntityNodeDynami
 	return getEntityTree().dynamicModel;
 }
 
-entity::model::ConfigurationNodeStaticModel& ControlledEntityImpl::getConfigurationNodeStaticModel(entity::model::ConfigurationIndex const configurationIndex) noexcept
+entity::model::ConfigurationNodeStaticModel& ControlledEntityImpl::getMutableConfigurationNodeStaticModel(entity::model::ConfigurationIndex const configurationIndex) noexcept
 {
-	return getConfigurationTree(configurationIndex).staticModel;
+	auto& staticModel = getConfigurationTree(configurationIndex).staticModel.getMutable();
+	onStaticModelUnshared();
+	return staticModel;
 }
 
 entity::model::ConfigurationNodeDynamicModel& ControlledEntityImpl::getConfigurationNodeDynamicModel(entity::model::ConfigurationIndex const configurationIndex) noexcept
@@ -1038,16 +1243,19 @@ entity::model::StreamOutputCounters& ControlledEntityImpl::getStreamOutputCounte
 // Setters of the DescriptorDynamic info, default constructing if not existing
 void ControlledEntityImpl::setEntityName(entity::model::AvdeccFixedString const& name) noexcept
 {
+	_isSnapshotDirty = true;
 	_entityTree.dynamicModel.entityName = name;
 }
 
 void ControlledEntityImpl::setEntityGroupName(entity::model::AvdeccFixedString const& name) noexcept
 {
+	_isSnapshotDirty = true;
 	_entityTree.dynamicModel.groupName = name;
 }
 
 void ControlledEntityImpl::setCurrentConfiguration(entity::model::ConfigurationIndex const configurationIndex) noexcept
 {
+	_isSnapshotDirty = true;
 	_entityTree.dynamicModel.currentConfiguration = configurationIndex;
 
 	// Set isActiveConfiguration for each configuration
@@ -1293,7 +1501,9 @@ void ControlledEntityImpl::setMemoryObjectLength(entity::model::ConfigurationInd
 // Setters of the global state
 void ControlledEntityImpl::setEntity(entity::Entity const& entity) noexcept
 {
+	_isSnapshotDirty = true;
 	_entity = entity;
+	_entityUpdateTime = std::chrono::steady_clock::now();
 }
 
 ControlledEntity::InterfaceLinkStatus ControlledEntityImpl::setAvbInterfaceLinkStatus(entity::model::AvbInterfaceIndex const avbInterfaceIndex, InterfaceLinkStatus const linkStatus) noexcept
@@ -1322,25 +1532,30 @@ ControlledEntity::InterfaceLinkStatus ControlledEntityImpl::setAvbInterfaceLinkS
 
 void ControlledEntityImpl::setAcquireState(model::AcquireState const state) noexcept
 {
+	_isSnapshotDirty = true;
 	_acquireState = state;
 }
 
 void ControlledEntityImpl::setOwningController(UniqueIdentifier const controllerID) noexcept
 {
+	_isSnapshotDirty = true;
 	_owningControllerID = controllerID;
 }
 
 void ControlledEntityImpl::setLockState(model::LockState const state) noexcept
 {
+	_isSnapshotDirty = true;
 	_lockState = state;
 }
 void ControlledEntityImpl::setLockingController(UniqueIdentifier const controllerID) noexcept
 {
+	_isSnapshotDirty = true;
 	_lockingControllerID = controllerID;
 }
 
 void ControlledEntityImpl::setMilanInfo(entity::model::MilanInfo const& info) noexcept
 {
+	_isSnapshotDirty = true;
 	_milanInfo = info;
 }
 
@@ -1378,19 +1593,21 @@ void ControlledEntityImpl::setEnumerationTime(std::chrono::milliseconds const& v
 // Setters of the Diagnostics
 void ControlledEntityImpl::setDiagnostics(Diagnostics const& diags) noexcept
 {
+	_isSnapshotDirty = true;
 	_diagnostics = diags;
 }
 
 // Setters of the Model from AEM Descriptors (including DescriptorDynamic info)
 void ControlledEntityImpl::setEntityTree(entity::model::EntityTree const& entityTree) noexcept
 {
+	_isSnapshotDirty = true;
 	_entityTree = entityTree;
 }
 
 bool ControlledEntityImpl::setCachedEntityTree(entity::model::EntityTree const& cachedTree, entity::model::EntityDescriptor const& descriptor, bool const forAllConfiguration) noexcept
 {
 	// Check if static information in EntityDescriptor are identical
-	auto const& cachedDescriptor = cachedTree.staticModel;
+	auto const& cachedDescriptor = cachedTree.staticModel.get();
 	if (cachedDescriptor.vendorNameString != descriptor.vendorNameString || cachedDescriptor.modelNameString != descriptor.modelNameString)
 	{
 		LOG_CONTROLLER_WARN(_entity.getEntityID(), "EntityModelID provided by this Entity has inconsistent data in it's EntityDescriptor, not using cached AEM");
@@ -1419,6 +1636,7 @@ bool ControlledEntityImpl::setCachedEntityTree(entity::model::EntityTree const&
 
 	// Ok the static information from EntityDescriptor are identical, we cannot check more than this so we have to assume it's correct, copy the whole model
 	_entityTree = cachedTree;
+	_isSnapshotDirty = true;
 
 	// And override with the EntityDescriptor so this entity's specific fields are copied
 	setEntityDescriptor(descriptor);
@@ -1428,6 +1646,7 @@ bool ControlledEntityImpl::setCachedEntityTree(entity::model::EntityTree const&
 
 void ControlledEntityImpl::setEntityDescriptor(entity::model::EntityDescriptor const& descriptor) noexcept
 {
+	_isSnapshotDirty = true;
 	if (!AVDECC_ASSERT_WITH_RET(!_advertised, "EntityDescriptor should never be set twice on an entity. Only the dynamic part should be set again."))
 	{
 		// Wipe everything and set as enumeration error
@@ -1440,7 +1659,7 @@ void ControlledEntityImpl::setEntityDescriptor(entity::model::EntityDescriptor c
 
 	// Copy static model
 	{
-		auto& m = _entityTree.staticModel;
+		auto& m = getMutableEntityNodeStaticModel();
 		m.vendorNameString = descriptor.vendorNameString;
 		m.modelNameString = descriptor.modelNameString;
 	}
@@ -1465,7 +1684,7 @@ void ControlledEntityImpl::setConfigurationDescriptor(entity::model::Configurati
 	// Copy static model
 	{
 		// Get or create a new model::ConfigurationStaticTree for this entity
-		auto& m = getConfigurationNodeStaticModel(configurationIndex);
+		auto& m = getMutableConfigurationNodeStaticModel(configurationIndex);
 		m.localizedDescription = descriptor.localizedDescription;
 		m.descriptorCounts = descriptor.descriptorCounts;
 	}
@@ -1485,7 +1704,7 @@ void ControlledEntityImpl::setAudioUnitDescriptor(entity::model::AudioUnitDescri
 	// Copy static model
 	{
 		// Get or create a new model::AudioUnitNodeStaticModel
-		auto& m = getNodeStaticModel(configurationIndex, audioUnitIndex, &entity::model::ConfigurationTree::audioUnitModels);
+		auto& m = getMutableNodeStaticModel(configurationIndex, audioUnitIndex, &entity::model::ConfigurationTree::audioUnitModels);
 		m.localizedDescription = descriptor.localizedDescription;
 		m.clockDomainIndex = descriptor.clockDomainIndex;
 		m.numberOfStreamInputPorts = descriptor.numberOfStreamInputPorts;
@@ -1538,7 +1757,7 @@ void ControlledEntityImpl::setStreamInputDescriptor(entity::model::StreamDescrip
 	// Copy static model
 	{
 		// Get or create a new model::StreamNodeStaticModel
-		auto& m = getNodeStaticModel(configurationIndex, streamIndex, &entity::model::ConfigurationTree::streamInputModels);
+		auto& m = getMutableNodeStaticModel(configurationIndex, streamIndex, &entity::model::ConfigurationTree::streamInputModels);
 		m.localizedDescription = descriptor.localizedDescription;
 		m.clockDomainIndex = descriptor.clockDomainIndex;
 		m.streamFlags = descriptor.streamFlags;
@@ -1574,7 +1793,7 @@ void ControlledEntityImpl::setStreamOutputDescriptor(entity::model::StreamDescri
 	// Copy static model
 	{
 		// Get or create a new model::StreamNodeStaticModel
-		auto& m = getNodeStaticModel(configurationIndex, streamIndex, &entity::model::ConfigurationTree::streamOutputModels);
+		auto& m = getMutableNodeStaticModel(configurationIndex, streamIndex, &entity::model::ConfigurationTree::streamOutputModels);
 		m.localizedDescription = descriptor.localizedDescription;
 		m.clockDomainIndex = descriptor.clockDomainIndex;
 		m.streamFlags = descriptor.streamFlags;
@@ -1609,7 +1828,7 @@ void ControlledEntityImpl::setAvbInterfaceDescriptor(entity::model::AvbInterface
 	// Copy static model
 	{
 		// Get or create a new model::AvbInterfaceNodeStaticModel
-		auto& m = getNodeStaticModel(configurationIndex, interfaceIndex, &entity::model::ConfigurationTree::avbInterfaceModels);
+		auto& m = getMutableNodeStaticModel(configurationIndex, interfaceIndex, &entity::model::ConfigurationTree::avbInterfaceModels);
 		m.localizedDescription = descriptor.localizedDescription;
 		m.macAddress = descriptor.macAddress;
 		m.interfaceFlags = descriptor.interfaceFlags;
@@ -1640,7 +1859,7 @@ void ControlledEntityImpl::setClockSourceDescriptor(entity::model::ClockSourceDe
 	// Copy static model
 	{
 		// Get or create a new model::ClockSourceNodeStaticModel
-		auto& m = getNodeStaticModel(configurationIndex, clockIndex, &entity::model::ConfigurationTree::clockSourceModels);
+		auto& m = getMutableNodeStaticModel(configurationIndex, clockIndex, &entity::model::ConfigurationTree::clockSourceModels);
 		m.localizedDescription = descriptor.localizedDescription;
 		m.clockSourceType = descriptor.clockSourceType;
 		m.clockSourceLocationType = descriptor.clockSourceLocationType;
@@ -1664,7 +1883,7 @@ void ControlledEntityImpl::setMemoryObjectDescriptor(entity::model::MemoryObject
 	// Copy static model
 	{
 		// Get or create a new model::MemoryObjectNodeStaticModel
-		auto& m = getNodeStaticModel(configurationIndex, memoryObjectIndex, &entity::model::ConfigurationTree::memoryObjectModels);
+		auto& m = getMutableNodeStaticModel(configurationIndex, memoryObjectIndex, &entity::model::ConfigurationTree::memoryObjectModels);
 		m.localizedDescription = descriptor.localizedDescription;
 		m.memoryObjectType = descriptor.memoryObjectType;
 		m.targetDescriptorType = descriptor.targetDescriptorType;
@@ -1688,7 +1907,7 @@ void ControlledEntityImpl::setLocaleDescriptor(entity::model::LocaleDescriptor c
 	// Copy static model
 	{
 		// Get or create a new model::LocaleNodeStaticModel
-		auto& m = getNodeStaticModel(configurationIndex, localeIndex, &entity::model::ConfigurationTree::localeModels);
+		auto& m = getMutableNodeStaticModel(configurationIndex, localeIndex, &entity::model::ConfigurationTree::localeModels);
 		m.localeID = descriptor.localeID;
 		m.numberOfStringDescriptors = descriptor.numberOfStringDescriptors;
 		m.baseStringDescriptorIndex = descriptor.baseStringDescriptorIndex;
@@ -1700,7 +1919,7 @@ void ControlledEntityImpl::setStringsDescriptor(entity::model::StringsDescriptor
 	// Copy static model
 	{
 		// Get or create a new model::StringsNodeStaticModel
-		auto& m = getNodeStaticModel(configurationIndex, stringsIndex, &entity::model::ConfigurationTree::stringsModels);
+		auto& m = getMutableNodeStaticModel(configurationIndex, stringsIndex, &entity::model::ConfigurationTree::stringsModels);
 		m.strings = descriptor.strings;
 	}
 
@@ -1728,7 +1947,7 @@ void ControlledEntityImpl::setStreamPortInputDescriptor(entity::model::StreamPor
 	// Copy static model
 	{
 		// Get or create a new model::StreamPortNodeStaticModel
-		auto& m = getNodeStaticModel(configurationIndex, streamPortIndex, &entity::model::ConfigurationTree::streamPortInputModels);
+		auto& m = getMutableNodeStaticModel(configurationIndex, streamPortIndex, &entity::model::ConfigurationTree::streamPortInputModels);
 		m.clockDomainIndex = descriptor.clockDomainIndex;
 		m.portFlags = descriptor.portFlags;
 		m.numberOfControls = descriptor.numberOfControls;
@@ -1748,7 +1967,7 @@ void ControlledEntityImpl::setStreamPortOutputDescriptor(entity::model::StreamPo
 	// Copy static model
 	{
 		// Get or create a new model::StreamPortNodeStaticModel
-		auto& m = getNodeStaticModel(configurationIndex, streamPortIndex, &entity::model::ConfigurationTree::streamPortOutputModels);
+		auto& m = getMutableNodeStaticModel(configurationIndex, streamPortIndex, &entity::model::ConfigurationTree::streamPortOutputModels);
 		m.clockDomainIndex = descriptor.clockDomainIndex;
 		m.portFlags = descriptor.portFlags;
 		m.numberOfControls = descriptor.numberOfControls;
@@ -1768,7 +1987,7 @@ void ControlledEntityImpl::setAudioClusterDescriptor(entity::model::AudioCluster
 	// Copy static model
 	{
 		// Get or create a new model::AudioClusterNodeStaticModel
-		auto& m = getNodeStaticModel(configurationIndex, clusterIndex, &entity::model::ConfigurationTree::audioClusterModels);
+		auto& m = getMutableNodeStaticModel(configurationIndex, clusterIndex, &entity::model::ConfigurationTree::audioClusterModels);
 		m.localizedDescription = descriptor.localizedDescription;
 		m.signalType = descriptor.signalType;
 		m.signalIndex = descriptor.signalIndex;
@@ -1793,7 +2012,7 @@ void ControlledEntityImpl::setAudioMapDescriptor(entity::model::AudioMapDescript
 	// Copy static model
 	{
 		// Get or create a new model::AudioMapNodeStaticModel
-		auto& m = getNodeStaticModel(configurationIndex, mapIndex, &entity::model::ConfigurationTree::audioMapModels);
+		auto& m = getMutableNodeStaticModel(configurationIndex, mapIndex, &entity::model::ConfigurationTree::audioMapModels);
 		m.mappings = descriptor.mappings;
 	}
 }
@@ -1803,7 +2022,7 @@ void ControlledEntityImpl::setControlDescriptor(entity::model::ControlDescriptor
 	// Copy static model
 	{
 		// Get or create a new model::ControlNodeStaticModel
-		auto& m = getNodeStaticModel(configurationIndex, controlIndex, &entity::model::ConfigurationTree::controlModels);
+		auto& m = getMutableNodeStaticModel(configurationIndex, controlIndex, &entity::model::ConfigurationTree::controlModels);
 		m.localizedDescription = descriptor.localizedDescription;
 
 		m.blockLatency = descriptor.blockLatency;
@@ -1833,7 +2052,7 @@ void ControlledEntityImpl::setClockDomainDescriptor(entity::model::ClockDomainDe
 	// Copy static model
 	{
 		// Get or create a new model::ClockDomainNodeStaticModel
-		auto& m = getNodeStaticModel(configurationIndex, clockDomainIndex, &entity::model::ConfigurationTree::clockDomainModels);
+		auto& m = getMutableNodeStaticModel(configurationIndex, clockDomainIndex, &entity::model::ConfigurationTree::clockDomainModels);
 		m.localizedDescription = descriptor.localizedDescription;
 		m.clockSources = descriptor.clockSources;
 	}
@@ -1895,7 +2114,7 @@ void ControlledEntityImpl::setEndEnumerationTime(std::chrono::time_point<std::ch
 // Expected RegisterUnsol query methods
 bool ControlledEntityImpl::checkAndClearExpectedRegisterUnsol() noexcept
 {
-	AVDECC_ASSERT(_sharedLock->_lockedCount >= 0, "ControlledEntity should be locked");
+	AVDECC_ASSERT(_lockInformation->_lockedCount >= 0, "ControlledEntity should be locked");
 
 	// Ignore if we had a fatal enumeration error
 	if (_gotFatalEnumerateError)
@@ -1909,14 +2128,14 @@ bool ControlledEntityImpl::checkAndClearExpectedRegisterUnsol() noexcept
 
 void ControlledEntityImpl::setRegisterUnsolExpected() noexcept
 {
-	AVDECC_ASSERT(_sharedLock->_lockedCount >= 0, "ControlledEntity should be locked");
+	AVDECC_ASSERT(_lockInformation->_lockedCount >= 0, "ControlledEntity should be locked");
 
 	_expectedRegisterUnsol = true;
 }
 
 bool ControlledEntityImpl::gotExpectedRegisterUnsol() const noexcept
 {
-	AVDECC_ASSERT(_sharedLock->_lockedCount >= 0, "ControlledEntity should be locked");
+	AVDECC_ASSERT(_lockInformation->_lockedCount >= 0, "ControlledEntity should be locked");
 
 	return !_expectedRegisterUnsol;
 }
@@ -1939,7 +2158,7 @@ static inline ControlledEntityImpl::MilanInfoKey makeMilanInfoKey(ControlledEnti
 
 bool ControlledEntityImpl::checkAndClearExpectedMilanInfo(MilanInfoType const milanInfoType) noexcept
 {
-	AVDECC_ASSERT(_sharedLock->_lockedCount >= 0, "ControlledEntity should be locked");
+	AVDECC_ASSERT(_lockInformation->_lockedCount >= 0, "ControlledEntity should be locked");
 
 	// Ignore if we had a fatal enumeration error
 	if (_gotFatalEnumerateError)
@@ -1951,7 +2170,7 @@ bool ControlledEntityImpl::checkAndClearExpectedMilanInfo(MilanInfoType const mi
 
 void ControlledEntityImpl::setMilanInfoExpected(MilanInfoType const milanInfoType) noexcept
 {
-	AVDECC_ASSERT(_sharedLock->_lockedCount >= 0, "ControlledEntity should be locked");
+	AVDECC_ASSERT(_lockInformation->_lockedCount >= 0, "ControlledEntity should be locked");
 
 	auto const key = makeMilanInfoKey(milanInfoType);
 	_expectedMilanInfo.insert(key);
@@ -1959,7 +2178,7 @@ void ControlledEntityImpl::setMilanInfoExpected(MilanInfoType const milanInfoTyp
 
 bool ControlledEntityImpl::gotAllExpectedMilanInfo() const noexcept
 {
-	AVDECC_ASSERT(_sharedLock->_lockedCount >= 0, "ControlledEntity should be locked");
+	AVDECC_ASSERT(_lockInformation->_lockedCount >= 0, "ControlledEntity should be locked");
 
 	return _expectedMilanInfo.empty();
 }
@@ -1982,7 +2201,7 @@ static inline ControlledEntityImpl::DescriptorKey makeDescriptorKey(entity::mode
 
 bool ControlledEntityImpl::checkAndClearExpectedDescriptor(entity::model::ConfigurationIndex const configurationIndex, entity::model::DescriptorType const descriptorType, entity::model::DescriptorIndex const descriptorIndex) noexcept
 {
-	AVDECC_ASSERT(_sharedLock->_lockedCount >= 0, "ControlledEntity should be locked");
+	AVDECC_ASSERT(_lockInformation->_lockedCount >= 0, "ControlledEntity should be locked");
 
 	// Ignore if we had a fatal enumeration error
 	if (_gotFatalEnumerateError)
@@ -2000,7 +2219,7 @@ bool ControlledEntityImpl::checkAndClearExpectedDescriptor(entity::model::Config
 
 void ControlledEntityImpl::setDescriptorExpected(entity::model::ConfigurationIndex const configurationIndex, entity::model::DescriptorType const descriptorType, entity::model::DescriptorIndex const descriptorIndex) noexcept
 {
-	AVDECC_ASSERT(_sharedLock->_lockedCount >= 0, "ControlledEntity should be locked");
+	AVDECC_ASSERT(_lockInformation->_lockedCount >= 0, "ControlledEntity should be locked");
 
 	auto& conf = _expectedDescriptors[configurationIndex];
 
@@ -2010,7 +2229,7 @@ void ControlledEntityImpl::setDescriptorExpected(entity::model::ConfigurationInd
 
 bool ControlledEntityImpl::gotAllExpectedDescriptors() const noexcept
 {
-	AVDECC_ASSERT(_sharedLock->_lockedCount >= 0, "ControlledEntity should be locked");
+	AVDECC_ASSERT(_lockInformation->_lockedCount >= 0, "ControlledEntity should be locked");
 
 	for (auto const& confKV : _expectedDescriptors)
 	{
@@ -2038,7 +2257,7 @@ static inline ControlledEntityImpl::DynamicInfoKey makeDynamicInfoKey(Controlled
 
 bool ControlledEntityImpl::checkAndClearExpectedDynamicInfo(entity::model::ConfigurationIndex const configurationIndex, DynamicInfoType const dynamicInfoType, entity::model::DescriptorIndex const descriptorIndex, std::uint16_t const subIndex) noexcept
 {
-	AVDECC_ASSERT(_sharedLock->_lockedCount >= 0, "ControlledEntity should be locked");
+	AVDECC_ASSERT(_lockInformation->_lockedCount >= 0, "ControlledEntity should be locked");
 
 	// Ignore if we had a fatal enumeration error
 	if (_gotFatalEnumerateError)
@@ -2056,7 +2275,7 @@ bool ControlledEntityImpl::checkAndClearExpectedDynamicInfo(entity::model::Confi
 
 void ControlledEntityImpl::setDynamicInfoExpected(entity::model::ConfigurationIndex const configurationIndex, DynamicInfoType const dynamicInfoType, entity::model::DescriptorIndex const descriptorIndex, std::uint16_t const subIndex) noexcept
 {
-	AVDECC_ASSERT(_sharedLock->_lockedCount >= 0, "ControlledEntity should be locked");
+	AVDECC_ASSERT(_lockInformation->_lockedCount >= 0, "ControlledEntity should be locked");
 
 	auto& conf = _expectedDynamicInfo[configurationIndex];
 
@@ -2066,7 +2285,7 @@ void ControlledEntityImpl::setDynamicInfoExpected(entity::model::ConfigurationIn
 
 bool ControlledEntityImpl::gotAllExpectedDynamicInfo() const noexcept
 {
-	AVDECC_ASSERT(_sharedLock->_lockedCount >= 0, "ControlledEntity should be locked");
+	AVDECC_ASSERT(_lockInformation->_lockedCount >= 0, "ControlledEntity should be locked");
 
 	for (auto const& confKV : _expectedDynamicInfo)
 	{
@@ -2076,6 +2295,13 @@ bool ControlledEntityImpl::gotAllExpectedDynamicInfo() const noexcept
 	return true;
 }
 
+void ControlledEntityImpl::clearAllExpectedDynamicInfo() noexcept
+{
+	AVDECC_ASSERT(_lockInformation->_lockedCount >= 0, "ControlledEntity should be locked");
+
+	_expectedDynamicInfo.clear();
+}
+
 std::pair<bool, std::chrono::milliseconds> ControlledEntityImpl::getQueryDynamicInfoRetryTimer() noexcept
 {
 	++_queryDynamicInfoRetryCount;
@@ -2094,7 +2320,7 @@ static inline ControlledEntityImpl::DescriptorDynamicInfoKey makeDescriptorDynam
 
 bool ControlledEntityImpl::checkAndClearExpectedDescriptorDynamicInfo(entity::model::ConfigurationIndex const configurationIndex, DescriptorDynamicInfoType const descriptorDynamicInfoType, entity::model::DescriptorIndex const descriptorIndex) noexcept
 {
-	AVDECC_ASSERT(_sharedLock->_lockedCount >= 0, "ControlledEntity should be locked");
+	AVDECC_ASSERT(_lockInformation->_lockedCount >= 0, "ControlledEntity should be locked");
 
 	// Ignore if we had a fatal enumeration error
 	if (_gotFatalEnumerateError)
@@ -2112,7 +2338,7 @@ bool ControlledEntityImpl::checkAndClearExpectedDescriptorDynamicInfo(entity::mo
 
 void ControlledEntityImpl::setDescriptorDynamicInfoExpected(entity::model::ConfigurationIndex const configurationIndex, DescriptorDynamicInfoType const descriptorDynamicInfoType, entity::model::DescriptorIndex const descriptorIndex) noexcept
 {
-	AVDECC_ASSERT(_sharedLock->_lockedCount >= 0, "ControlledEntity should be locked");
+	AVDECC_ASSERT(_lockInformation->_lockedCount >= 0, "ControlledEntity should be locked");
 
 	auto& conf = _expectedDescriptorDynamicInfo[configurationIndex];
 
@@ -2122,14 +2348,14 @@ void ControlledEntityImpl::setDescriptorDynamicInfoExpected(entity::model::Confi
 
 void ControlledEntityImpl::clearAllExpectedDescriptorDynamicInfo() noexcept
 {
-	AVDECC_ASSERT(_sharedLock->_lockedCount >= 0, "ControlledEntity should be locked");
+	AVDECC_ASSERT(_lockInformation->_lockedCount >= 0, "ControlledEntity should be locked");
 
 	_expectedDescriptorDynamicInfo.clear();
 }
 
 bool ControlledEntityImpl::gotAllExpectedDescriptorDynamicInfo() const noexcept
 {
-	AVDECC_ASSERT(_sharedLock->_lockedCount >= 0, "ControlledEntity should be locked");
+	AVDECC_ASSERT(_lockInformation->_lockedCount >= 0, "ControlledEntity should be locked");
 
 	for (auto const& confKV : _expectedDescriptorDynamicInfo)
 	{
@@ -2151,6 +2377,7 @@ std::pair<bool, std::chrono::milliseconds> ControlledEntityImpl::getQueryDescrip
 
 entity::Entity& ControlledEntityImpl::getEntity() noexcept
 {
+	_isSnapshotDirty = true;
 	return _entity;
 }
 
@@ -2178,20 +2405,79 @@ void ControlledEntityImpl::setEnumerationSteps(EnumerationSteps const steps) noe
 {
 	AVDECC_ASSERT(_enumerationSteps.empty(), "EnumerationSteps were not empty");
 	_enumerationSteps = steps;
+	_startedEnumerationSteps.clear();
 }
 
 void ControlledEntityImpl::addEnumerationStep(EnumerationStep const step) noexcept
 {
 	_enumerationSteps.set(step);
+	// (Re)adding a step means it has to be (re)started
+	_startedEnumerationSteps.reset(step);
 }
 
 void ControlledEntityImpl::clearEnumerationStep(EnumerationStep const step) noexcept
 {
-	_enumerationSteps.reset(step);
+	// A step cannot complete before it has been started (late responses from a previous run of the step are ignored)
+	if (_startedEnumerationSteps.test(step))
+	{
+		_enumerationSteps.reset(step);
+		_startedEnumerationSteps.reset(step);
+	}
+}
+
+ControlledEntityImpl::EnumerationSteps ControlledEntityImpl::getReadyEnumerationSteps() const noexcept
+{
+	// Steps that must be completed before a step can start
+	static auto const s_Dependencies = std::unordered_map<EnumerationStep, EnumerationSteps>{
+		// MilanInfo, unsolicited notifications and static model are independent from each other
+		{ EnumerationStep::GetMilanInfo, EnumerationSteps{} },
+		{ EnumerationStep::RegisterUnsol, EnumerationSteps{} },
+		{ EnumerationStep::GetStaticModel, EnumerationSteps{} },
+		// Dynamic information requires the model, being registered to unsolicited notifications (so that no change is missed) and knowing if the entity is Milan compatible
+		{ EnumerationStep::GetDescriptorDynamicInfo, EnumerationSteps{ EnumerationStep::GetMilanInfo, EnumerationStep::RegisterUnsol, EnumerationStep::GetStaticModel } },
+		{ EnumerationStep::GetDynamicInfo, EnumerationSteps{ EnumerationStep::GetMilanInfo, EnumerationStep::RegisterUnsol, EnumerationStep::GetStaticModel } },
+	};
+
+	auto readySteps = EnumerationSteps{};
+	for (auto const step : _enumerationSteps)
+	{
+		if (_startedEnumerationSteps.test(step))
+		{
+			continue;
+		}
+		auto const depIt = s_Dependencies.find(step);
+		if (AVDECC_ASSERT_WITH_RET(depIt != s_Dependencies.end(), "Missing EnumerationStep dependencies") && (depIt->second & _enumerationSteps).empty())
+		{
+			readySteps.set(step);
+		}
+	}
+	return readySteps;
+}
+
+void ControlledEntityImpl::setEnumerationStepStarted(EnumerationStep const step) noexcept
+{
+	AVDECC_ASSERT(_enumerationSteps.test(step), "Starting an EnumerationStep that is not pending");
+	_startedEnumerationSteps.set(step);
+}
+
+std::chrono::time_point<std::chrono::steady_clock> ControlledEntityImpl::getEntityUpdateTime() const noexcept
+{
+	return _entityUpdateTime;
+}
+
+bool ControlledEntityImpl::isMilanCompatibilityRevoked() const noexcept
+{
+	return _milanCompatibilityRevoked;
+}
+
+void ControlledEntityImpl::setMilanCompatibilityRevoked() noexcept
+{
+	_milanCompatibilityRevoked = true;
 }
 
 void ControlledEntityImpl::setCompatibilityFlags(CompatibilityFlags const compatibilityFlags) noexcept
 {
+	_isSnapshotDirty = true;
 	_compatibilityFlags = compatibilityFlags;
 }
 
@@ -2202,6 +2488,7 @@ void ControlledEntityImpl::setMilanRedundant(bool const isMilanRedundant) noexce
 
 void ControlledEntityImpl::setGetFatalEnumerationError() noexcept
 {
+	_isSnapshotDirty = true;
 	LOG_CONTROLLER_ERROR(_entity.getEntityID(), "Got Fatal Enumeration Error");
 	_gotFatalEnumerateError = true;
 }
@@ -2243,9 +2530,48 @@ bool ControlledEntityImpl::isRedundantSecondaryStreamOutput(entity::model::Strea
 
 ControlledEntity::Diagnostics& ControlledEntityImpl::getDiagnostics() noexcept
 {
+	_isSnapshotDirty = true;
 	return _diagnostics;
 }
 
+// Snapshot methods
+bool ControlledEntityImpl::isSnapshotEnabled() const noexcept
+{
+	return _isSnapshotEnabled;
+}
+
+void ControlledEntityImpl::enableSnapshot() noexcept
+{
+	_isSnapshotEnabled = true;
+	_isSnapshotDirty = true;
+}
+
+void ControlledEntityImpl::publishSnapshotIfDirty() noexcept
+{
+	// Only publish when the outermost lock is released, so a batch of updates made under nested guards is published once
+	if (_isSnapshotEnabled && _isSnapshotDirty && _lockInformation->_lockedCount == 1u)
+	{
+		publishSnapshot();
+	}
+}
+
+void ControlledEntityImpl::publishSnapshot() noexcept
+{
+	AVDECC_ASSERT(_lockInformation->isSelfLocked(), "ControlledEntity should be locked");
+
+	_isSnapshotDirty = false;
+	auto const hasEntityModel = !_gotFatalEnumerateError && _entity.getEntityCapabilities().test(entity::EntityCapability::AemSupported);
+	auto snapshot = std::make_shared<ControlledEntitySnapshot const>(ControlledEntitySnapshot{ ++_snapshotVersion, _entity, getCompatibilityFlags(), _isVirtual, getAcquireState(), getOwningControllerID(), getLockState(), getLockingControllerID(), getMilanInfo(), hasEntityModel ? _entityTree : entity::model::EntityTree{}, _diagnostics });
+
+	// Readers might be loading the previous snapshot concurrently
+	std::atomic_store(&_snapshot, SharedControlledEntitySnapshot{ std::move(snapshot) });
+}
+
+SharedControlledEntitySnapshot ControlledEntityImpl::getSnapshot() const noexcept
+{
+	return std::atomic_load(&_snapshot);
+}
+
 // Static methods
 std::string ControlledEntityImpl::dynamicInfoTypeToString(DynamicInfoType const dynamicInfoType) noexcept
 {
@@ -2352,7 +2678,7 @@ class RedundantHelper : public ControlledEntityImpl
 {
 public:
 	template<typename StreamNodeType>
-	static void buildRedundancyNodesByType(ControlledEntityImpl const* const entity, la::avdecc::UniqueIdentifier entityID, std::map<entity::model::StreamIndex, StreamNodeType>& streams, std::map<model::VirtualIndex, model::RedundantStreamNode>& redundantStreams, RedundantStreamCategory& redundantPrimaryStreams, RedundantStreamCategory& redundantSecondaryStreams)
+	static void buildRedundancyNodesByType(ControlledEntityImpl const* const entity, la::avdecc::UniqueIdentifier entityID, IndexedMap<entity::model::StreamIndex, StreamNodeType>& streams, std::map<model::VirtualIndex, model::RedundantStreamNode>& redundantStreams, RedundantStreamCategory& redundantPrimaryStreams, RedundantStreamCategory& redundantSecondaryStreams)
 	{
 		for (auto& streamNodeKV : streams)
 		{
@@ -2517,7 +2843,7 @@ void ControlledEntityImpl::buildEntityModelGraph() noexcept
 		{
 			// Build root node (EntityNode)
 			initNode(_entityNode, entity::model::DescriptorType::Entity, 0);
-			_entityNode.staticModel = &_entityTree.staticModel;
+			_entityNode.staticModel = &_entityTree.staticModel.get();
 			_entityNode.dynamicModel = &_entityTree.dynamicModel;
 
 			// Build configuration nodes (ConfigurationNode)
@@ -2525,13 +2851,13 @@ void ControlledEntityImpl::buildEntityModelGraph() noexcept
 			{
 				auto& configNode = _entityNode.configurations[configIndex];
 				initNode(configNode, entity::model::DescriptorType::Configuration, configIndex);
-				configNode.staticModel = &configTree.staticModel;
+				configNode.staticModel = &configTree.staticModel.get();
 				configNode.dynamicModel = &configTree.dynamicModel;
 
 				// Build audio units (AudioUnitNode)
 				for (auto& [audioUnitIndex, audioUnitModels] : configTree.audioUnitModels)
 				{
-					auto const& audioUnitStaticModel = audioUnitModels.staticModel;
+					auto const& audioUnitStaticModel = audioUnitModels.staticModel.get();
 					auto& audioUnitDynamicModel = audioUnitModels.dynamicModel;
 
 					auto& audioUnitNode = configNode.audioUnits[audioUnitIndex];
@@ -2540,7 +2866,7 @@ void ControlledEntityImpl::buildEntityModelGraph() noexcept
 					audioUnitNode.dynamicModel = &audioUnitDynamicModel;
 
 					// Build stream port inputs and outputs (StreamPortNode)
-					auto processStreamPorts = [entity = const_cast<ControlledEntityImpl*>(this), &audioUnitNode, configIndex = configIndex /* Have to explicitly redefine configIndex due to a clang bug*/](entity::model::DescriptorType const descriptorType, std::uint16_t const numberOfStreamPorts, entity::model::StreamPortIndex const baseStreamPort)
+					auto processStreamPorts = [entity = this, &audioUnitNode, configIndex = configIndex /* Have to explicitly redefine configIndex due to a clang bug*/](entity::model::DescriptorType const descriptorType, std::uint16_t const numberOfStreamPorts, entity::model::StreamPortIndex const baseStreamPort)
 					{
 						for (auto streamPortIndexCounter = entity::model::StreamPortIndex(0); streamPortIndexCounter < numberOfStreamPorts; ++streamPortIndexCounter)
 						{
@@ -2598,7 +2924,7 @@ void ControlledEntityImpl::buildEntityModelGraph() noexcept
 				// Build stream inputs (StreamNode)
 				for (auto& [streamIndex, streamModels] : configTree.streamInputModels)
 				{
-					auto const& streamStaticModel = streamModels.staticModel;
+					auto const& streamStaticModel = streamModels.staticModel.get();
 					auto& streamDynamicModel = streamModels.dynamicModel;
 
 					auto& streamNode = configNode.streamInputs[streamIndex];
@@ -2610,7 +2936,7 @@ void ControlledEntityImpl::buildEntityModelGraph() noexcept
 				// Build stream outputs (StreamNode)
 				for (auto& [streamIndex, streamModels] : configTree.streamOutputModels)
 				{
-					auto const& streamStaticModel = streamModels.staticModel;
+					auto const& streamStaticModel = streamModels.staticModel.get();
 					auto& streamDynamicModel = streamModels.dynamicModel;
 
 					auto& streamNode = configNode.streamOutputs[streamIndex];
@@ -2622,7 +2948,7 @@ void ControlledEntityImpl::buildEntityModelGraph() noexcept
 				// Build avb interfaces (AvbInterfaceNode)
 				for (auto& [interfaceIndex, interfaceModels] : configTree.avbInterfaceModels)
 				{
-					auto const& interfaceStaticModel = interfaceModels.staticModel;
+					auto const& interfaceStaticModel = interfaceModels.staticModel.get();
 					auto& interfaceDynamicModel = interfaceModels.dynamicModel;
 
 					auto& interfaceNode = configNode.avbInterfaces[interfaceIndex];
@@ -2634,7 +2960,7 @@ void ControlledEntityImpl::buildEntityModelGraph() noexcept
 				// Build clock sources (ClockSourceNode)
 				for (auto& [sourceIndex, sourceModels] : configTree.clockSourceModels)
 				{
-					auto const& sourceStaticModel = sourceModels.staticModel;
+					auto const& sourceStaticModel = sourceModels.staticModel.get();
 					auto& sourceDynamicModel = sourceModels.dynamicModel;
 
 					auto& sourceNode = configNode.clockSources[sourceIndex];
@@ -2646,7 +2972,7 @@ void ControlledEntityImpl::buildEntityModelGraph() noexcept
 				// Build memory objects (MemoryObjectNode)
 				for (auto& [memoryObjectIndex, memoryObjectModels] : configTree.memoryObjectModels)
 				{
-					auto const& memoryObjectStaticModel = memoryObjectModels.staticModel;
+					auto const& memoryObjectStaticModel = memoryObjectModels.staticModel.get();
 					auto& memoryObjectDynamicModel = memoryObjectModels.dynamicModel;
 
 					auto& memoryObjectNode = configNode.memoryObjects[memoryObjectIndex];
@@ -2658,7 +2984,7 @@ void ControlledEntityImpl::buildEntityModelGraph() noexcept
 				// Build locales (LocaleNode)
 				for (auto const& [localeIndex, localeModels] : configTree.localeModels)
 				{
-					auto const& localeStaticModel = localeModels.staticModel;
+					auto const& localeStaticModel = localeModels.staticModel.get();
 
 					auto& localeNode = configNode.locales[localeIndex];
 					initNode(localeNode, entity::model::DescriptorType::Locale, localeIndex);
@@ -2675,7 +3001,7 @@ void ControlledEntityImpl::buildEntityModelGraph() noexcept
 						auto const stringsIt = configTree.stringsModels.find(stringsIndex);
 						if (stringsIt != configTree.stringsModels.end())
 						{
-							stringsNode.staticModel = &stringsIt->second.staticModel;
+							stringsNode.staticModel = &stringsIt->second.staticModel.get();
 						}
 					}
 				}
@@ -2683,7 +3009,7 @@ void ControlledEntityImpl::buildEntityModelGraph() noexcept
 				// Build controls (ControlNode)
 				for (auto& [controlIndex, controlModels] : configTree.controlModels)
 				{
-					auto const& controlStaticModel = controlModels.staticModel;
+					auto const& controlStaticModel = controlModels.staticModel.get();
 					auto& controlDynamicModel = controlModels.dynamicModel;
 
 					auto& controlNode = configNode.controls[controlIndex];
@@ -2695,7 +3021,7 @@ void ControlledEntityImpl::buildEntityModelGraph() noexcept
 				// Build clock domains (ClockDomainNode)
 				for (auto& [domainIndex, domainModels] : configTree.clockDomainModels)
 				{
-					auto const& domainStaticModel = domainModels.staticModel;
+					auto const& domainStaticModel = domainModels.staticModel.get();
 					auto& domainDynamicModel = domainModels.dynamicModel;
 
 					auto& domainNode = configNode.clockDomains[domainIndex];
@@ -2729,6 +3055,15 @@ void ControlledEntityImpl::buildEntityModelGraph() noexcept
 	}
 }
 
+void ControlledEntityImpl::onStaticModelUnshared() noexcept
+{
+	// Static models are only modified while enumerating, before the graph is built. Should it happen afterwards, the graph may still reference the previous (shared) instance
+	if (_entityNode.staticModel != nullptr)
+	{
+		buildEntityModelGraph();
+	}
+}
+
 bool ControlledEntityImpl::isEntityModelComplete(entity::model::EntityTree const& entityTree, std::uint16_t const configurationsCount) const noexcept
 {
 	if (configurationsCount != entityTree.configurationTrees.size())
@@ -28,6 +28,7 @@
 
 #include "la/avdecc/controller/internals/avdeccControlledEntity.hpp"
 
+#include <atomic>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -35,8 +36,10 @@
 #include <functional>
 #include <chrono>
 #include <mutex>
+#include <optional>
 #include <utility>
 #include <thread>
+#include <vector>
 
 namespace la
 {
@@ -50,65 +53,54 @@ namespace controller
 class ControlledEntityImpl : public ControlledEntity
 {
 public:
-	/** Lock Information that is shared among all ControlledEntities */
+	/**
+	* Lock Information of a ControlledEntity.
+	* Each entity has its own lock, so threads accessing different entities do not block each other.
+	* Locks are never released behind the caller's back and lock always waits for the lock.
+	* Locks are ordered (by creation), so locks acquired together (restored by lockAllSelfLocked or taken by a multi-entity guard) are always acquired in the same order.
+	* The controller never waits for an entity while holding another one: it tries to lock it and, if not available, defers the work until the thread released all its entities (see deferUntilAllUnlocked).
+	*/
 	struct LockInformation
 	{
 		using SharedPointer = std::shared_ptr<LockInformation>;
+		using SelfLocks = std::vector<std::pair<LockInformation*, std::uint32_t>>; // Locks held by a thread, with their locked count
+		using DeferredJob = std::function<void()>;
 
 		std::recursive_mutex _lock{};
 		std::uint32_t _lockedCount{ 0u };
 		std::thread::id _lockingThreadID{};
+		std::uint64_t const _lockOrder{ getNextLockOrder() };
 
-		void lock() noexcept
-		{
-			_lock.lock();
-			if (_lockedCount == 0)
-			{
-				_lockingThreadID = std::this_thread::get_id();
-			}
-			++_lockedCount;
-		}
-
-		void unlock() noexcept
-		{
-			AVDECC_ASSERT(isSelfLocked(), "unlock should not be called when current thread is not the lock holder");
-
-			--_lockedCount;
-			if (_lockedCount == 0)
-			{
-				_lockingThreadID = {};
-			}
-			_lock.unlock();
-		}
+		void lock() noexcept;
+		bool tryLock() noexcept;
+		void unlock() noexcept;
+		void lockAll(std::uint32_t const lockedCount) noexcept;
+		std::uint32_t unlockAll() noexcept;
 
-		void lockAll(std::uint32_t const lockedCount) noexcept
+		bool isSelfLocked() const noexcept
 		{
-			for (auto count = 0u; count < lockedCount; ++count)
-			{
-				lock();
-			}
+			return _lockingThreadID == std::this_thread::get_id();
 		}
 
-		std::uint32_t unlockAll() noexcept
+		std::uint64_t getLockOrder() const noexcept
 		{
-			AVDECC_ASSERT(isSelfLocked(), "unlockAll should not be called when current thread is not the lock holder");
-
-			auto result = 0u;
-			[[maybe_unused]] auto const previousLockedCount = _lockedCount;
-			while (isSelfLocked())
-			{
-				unlock();
-				++result;
-			}
-
-			AVDECC_ASSERT(previousLockedCount == result, "lockedCount does not match the number of unlockings");
-			return result;
+			return _lockOrder;
 		}
 
-		bool isSelfLocked() const noexcept
-		{
-			return _lockingThreadID == std::this_thread::get_id();
-		}
+		/** Returns true if the current thread holds the lock of any entity */
+		static bool isAnySelfLocked() noexcept;
+		/** Releases all the locks held by the current thread, returning them so they can be restored with lockAllSelfLocked */
+		static SelfLocks unlockAllSelfLocked() noexcept;
+		/** Acquires again (in lock order) locks previously released with unlockAllSelfLocked. Never waits for a lock while holding another one (backs off and retries instead), so it cannot deadlock with a thread holding several entities */
+		static void lockAllSelfLocked(SelfLocks selfLocks) noexcept;
+		/** Queues a job to be run by the current thread as soon as it no longer holds any lock (when releasing its last ControlledEntity) */
+		static void deferUntilAllUnlocked(DeferredJob&& job) noexcept;
+		/** Runs the jobs deferred by the current thread, if it no longer holds any lock */
+		static void runDeferredJobs() noexcept;
+
+	private:
+		static std::uint64_t getNextLockOrder() noexcept;
+		void onLocked() noexcept;
 	};
 
 	enum class EnumerationStep : std::uint16_t
@@ -178,7 +170,7 @@ public:
 	static_assert(sizeof(DescriptorDynamicInfoKey) >= sizeof(DescriptorDynamicInfoType) + sizeof(entity::model::DescriptorIndex), "DescriptorDynamicInfoKey size must be greater or equal to DescriptorDynamicInfoType + DescriptorIndex");
 
 	/** Constructor */
-	ControlledEntityImpl(la::avdecc::entity::Entity const& entity, LockInformation::SharedPointer const& sharedLock, bool const isVirtual) noexcept;
+	ControlledEntityImpl(la::avdecc::entity::Entity const& entity, LockInformation::SharedPointer const& lockInformation, bool const isVirtual) noexcept;
 
 	// ControlledEntity overrides
 	// Getters
@@ -234,6 +226,8 @@ public:
 
 	virtual void lock() noexcept override;
 	virtual void unlock() noexcept override;
+	bool tryLock() noexcept;
+	std::uint64_t getLockOrder() const noexcept;
 
 	virtual entity::model::StreamInputConnectionInfo const& getSinkConnectionInformation(entity::model::StreamIndex const streamIndex) const override; // Throws Exception::InvalidDescriptorIndex if streamIndex do not exist
 	virtual entity::model::AudioMappings const& getStreamPortInputAudioMappings(entity::model::StreamPortIndex const streamPortIndex) const override; // Throws Exception::InvalidDescriptorIndex if streamPortIndex do not exist
@@ -275,7 +269,7 @@ public:
 		if (it == (configTree.*Field).end())
 			throw Exception(Exception::Type::InvalidDescriptorIndex, "Invalid index");
 
-		return it->second.staticModel;
+		return it->second.staticModel.get();
 	}
 	template<typename FieldPointer, typename DescriptorIndexType>
 	auto const& getNodeDynamicModel(entity::model::ConfigurationIndex const configurationIndex, DescriptorIndexType const index, FieldPointer entity::model::ConfigurationTree::*Field) const
@@ -295,7 +289,7 @@ public:
 	template<typename FieldPointer, typename DescriptorIndexType>
 	bool hasTreeModel(entity::model::ConfigurationIndex const configurationIndex, DescriptorIndexType const index, FieldPointer entity::model::ConfigurationTree::*Field) const noexcept
 	{
-		AVDECC_ASSERT(_sharedLock->_lockedCount >= 0, "ControlledEntity should be locked");
+		AVDECC_ASSERT(_lockInformation->_lockedCount >= 0, "ControlledEntity should be locked");
 
 		if (gotFatalEnumerationError() || !_entity.getEntityCapabilities().test(entity::EntityCapability::AemSupported))
 		{
@@ -315,23 +309,33 @@ public:
 	entity::model::EntityTree& getEntityTree() noexcept;
 	entity::model::ConfigurationTree& getConfigurationTree(entity::model::ConfigurationIndex const configurationIndex) noexcept;
 
-	// Non-const NodeModel getters
-	entity::model::EntityNodeStaticModel& getEntityNodeStaticModel() noexcept;
+	// Non-const NodeModel getters (static models are shared with other entities, they are only returned as read-only, except through the getMutable methods)
+	entity::model::EntityNodeStaticModel& getMutableEntityNodeStaticModel() noexcept;
 	entity::model::EntityNodeDynamicModel& getEntityNodeDynamicModel() noexcept;
-	entity::model::ConfigurationNodeStaticModel& getConfigurationNodeStaticModel(entity::model::ConfigurationIndex const configurationIndex) noexcept;
+	entity::model::ConfigurationNodeStaticModel& getMutableConfigurationNodeStaticModel(entity::model::ConfigurationIndex const configurationIndex) noexcept;
 	entity::model::ConfigurationNodeDynamicModel& getConfigurationNodeDynamicModel(entity::model::ConfigurationIndex const configurationIndex) noexcept;
 	template<typename FieldPointer, typename DescriptorIndexType>
-	auto& getNodeStaticModel(entity::model::ConfigurationIndex const configurationIndex, DescriptorIndexType const index, FieldPointer entity::model::ConfigurationTree::*Field) noexcept
+	auto const& getNodeStaticModel(entity::model::ConfigurationIndex const configurationIndex, DescriptorIndexType const index, FieldPointer entity::model::ConfigurationTree::*Field) noexcept
+	{
+		AVDECC_ASSERT(_lockInformation->_lockedCount >= 0, "ControlledEntity should be locked");
+
+		auto& configTree = getConfigurationTree(configurationIndex);
+		return (configTree.*Field)[index].staticModel.get();
+	}
+	template<typename FieldPointer, typename DescriptorIndexType>
+	auto& getMutableNodeStaticModel(entity::model::ConfigurationIndex const configurationIndex, DescriptorIndexType const index, FieldPointer entity::model::ConfigurationTree::*Field) noexcept
 	{
-		AVDECC_ASSERT(_sharedLock->_lockedCount >= 0, "ControlledEntity should be locked");
+		AVDECC_ASSERT(_lockInformation->_lockedCount >= 0, "ControlledEntity should be locked");
 
 		auto& configTree = getConfigurationTree(configurationIndex);
-		return (configTree.*Field)[index].staticModel;
+		auto& staticModel = (configTree.*Field)[index].staticModel.getMutable();
+		onStaticModelUnshared();
+		return staticModel;
 	}
 	template<typename FieldPointer, typename DescriptorIndexType>
 	auto& getNodeDynamicModel(entity::model::ConfigurationIndex const configurationIndex, DescriptorIndexType const index, FieldPointer entity::model::ConfigurationTree::*Field) noexcept
 	{
-		AVDECC_ASSERT(_sharedLock->_lockedCount >= 0, "ControlledEntity should be locked");
+		AVDECC_ASSERT(_lockInformation->_lockedCount >= 0, "ControlledEntity should be locked");
 
 		auto& configTree = getConfigurationTree(configurationIndex);
 		return (configTree.*Field)[index].dynamicModel;
@@ -339,7 +343,7 @@ public:
 	template<typename FieldPointer>
 	auto& getModels(entity::model::ConfigurationIndex const configurationIndex, FieldPointer entity::model::ConfigurationTree::*Field) noexcept
 	{
-		AVDECC_ASSERT(_sharedLock->_lockedCount >= 0, "ControlledEntity should be locked");
+		AVDECC_ASSERT(_lockInformation->_lockedCount >= 0, "ControlledEntity should be locked");
 
 		auto& entityTree = getEntityTree();
 		auto configIt = entityTree.configurationTrees.find(configurationIndex);
@@ -459,6 +463,7 @@ public:
 	// Expected dynamic info query methods
 	bool checkAndClearExpectedDynamicInfo(entity::model::ConfigurationIndex const configurationIndex, DynamicInfoType const dynamicInfoType, entity::model::DescriptorIndex const descriptorIndex, std::uint16_t const subIndex = 0u) noexcept;
 	void setDynamicInfoExpected(entity::model::ConfigurationIndex const configurationIndex, DynamicInfoType const dynamicInfoType, entity::model::DescriptorIndex const descriptorIndex, std::uint16_t const subIndex = 0u) noexcept;
+	void clearAllExpectedDynamicInfo() noexcept;
 	bool gotAllExpectedDynamicInfo() const noexcept;
 	std::pair<bool, std::chrono::milliseconds> getQueryDynamicInfoRetryTimer() noexcept;
 
@@ -477,8 +482,13 @@ public:
 	EnumerationSteps getEnumerationSteps() const noexcept;
 	void setEnumerationSteps(EnumerationSteps const steps) noexcept;
 	void addEnumerationStep(EnumerationStep const step) noexcept;
-	void clearEnumerationStep(EnumerationStep const step) noexcept;
+	void clearEnumerationStep(EnumerationStep const step) noexcept; // Only clears a step that has been started
+	EnumerationSteps getReadyEnumerationSteps() const noexcept; // Steps not started yet, whose dependencies are all completed
+	void setEnumerationStepStarted(EnumerationStep const step) noexcept;
+	bool isMilanCompatibilityRevoked() const noexcept;
+	void setMilanCompatibilityRevoked() noexcept;
 	void setCompatibilityFlags(CompatibilityFlags const compatibilityFlags) noexcept;
+	std::chrono::time_point<std::chrono::steady_clock> getEntityUpdateTime() const noexcept; // Time the Entity (ADP) information was last set
 	void setMilanRedundant(bool const isMilanRedundant) noexcept;
 	void setGetFatalEnumerationError() noexcept;
 	void setSubscribedToUnsolicitedNotifications(bool const isSubscribed) noexcept;
@@ -490,6 +500,13 @@ public:
 	bool isRedundantSecondaryStreamOutput(entity::model::StreamIndex const streamIndex) const noexcept; // True for a Redundant Secondary Stream (false for Primary and non-redundant streams)
 	Diagnostics& getDiagnostics() noexcept;
 
+	// Snapshot methods
+	bool isSnapshotEnabled() const noexcept;
+	void enableSnapshot() noexcept; // Once enabled, a new snapshot should be published after each batch of updates
+	void publishSnapshot() noexcept; // Entity must be locked
+	void publishSnapshotIfDirty() noexcept; // Entity must be locked. Publishes a new snapshot if enabled and the entity was modified since the last one, when releasing the outermost lock
+	SharedControlledEntitySnapshot getSnapshot() const noexcept; // Doesn't require the entity to be locked (returns the last published snapshot)
+
 	// Static methods
 	static std::string dynamicInfoTypeToString(DynamicInfoType const dynamicInfoType) noexcept;
 	static std::string descriptorDynamicInfoTypeToString(DescriptorDynamicInfoType const descriptorDynamicInfoType) noexcept;
@@ -540,13 +557,14 @@ protected:
 private:
 	// Private methods
 	void buildEntityModelGraph() noexcept;
+	void onStaticModelUnshared() noexcept; // getMutable() may have replaced the static model instance referenced by the entity model graph, rebuild it
 	bool isEntityModelComplete(entity::model::EntityTree const& entityTree, std::uint16_t const configurationsCount) const noexcept;
 #ifdef ENABLE_AVDECC_FEATURE_REDUNDANCY
 	void buildRedundancyNodes(model::ConfigurationNode& configNode) noexcept;
 #endif // ENABLE_AVDECC_FEATURE_REDUNDANCY
 
 	// Private variables
-	LockInformation::SharedPointer _sharedLock{ nullptr };
+	LockInformation::SharedPointer _lockInformation{ nullptr };
 	bool const _isVirtual{ false };
 	bool _ignoreCachedEntityModel{ false };
 	std::optional<entity::model::ControlIndex> _identifyControlIndex{ std::nullopt };
@@ -556,6 +574,8 @@ private:
 	std::uint16_t _queryDynamicInfoRetryCount{ 0u };
 	std::uint16_t _queryDescriptorDynamicInfoRetryCount{ 0u };
 	EnumerationSteps _enumerationSteps{};
+	EnumerationSteps _startedEnumerationSteps{}; // Steps currently running (steps run concurrently as soon as their dependencies are completed)
+	bool _milanCompatibilityRevoked{ false }; // Entity lost Milan compatibility before its MilanInfo was retrieved
 	CompatibilityFlags _compatibilityFlags{ CompatibilityFlag::IEEE17221 }; // Entity is IEEE1722.1 compatible by default
 	bool _isMilanRedundant{ false }; // Current configuration has at least one redundant stream
 	bool _gotFatalEnumerateError{ false }; // Have we got a fatal error during entity enumeration
@@ -575,6 +595,7 @@ private:
 	std::optional<entity::model::MilanInfo> _milanInfo{ std::nullopt };
 	// Entity variables
 	entity::Entity _entity; // No NSMI, Entity has no default constructor but it has to be passed to the only constructor of this class anyway
+	std::chrono::time_point<std::chrono::steady_clock> _entityUpdateTime{ std::chrono::steady_clock::now() }; // Time _entity was last set
 	// Entity Model
 	entity::model::EntityTree _entityTree{}; // Tree of the model as represented by the AVDECC protocol
 	model::EntityNode _entityNode{}; // Model as represented by the ControlledEntity (tree of references to the model::EntityStaticTree and model::EntityDynamicTree)
@@ -595,6 +616,11 @@ private:
 	std::chrono::milliseconds _enumerationTime{};
 	// Diagnostics
 	Diagnostics _diagnostics{};
+	// Snapshot
+	std::atomic_bool _isSnapshotEnabled{ false };
+	bool _isSnapshotDirty{ false }; // Protected by the entity lock. Set by the mutating methods, cleared when a snapshot is published
+	std::uint64_t _snapshotVersion{ 0u };
+	SharedControlledEntitySnapshot _snapshot{ nullptr }; // Only accessed through std::atomic_load/std::atomic_store
 };
 
 } // namespace controller
@@ -41,107 +41,162 @@ namespace controller
 namespace jsonSerializer
 {
 /* ************************************************************ */
-/* Public methods                                               */
+/* Private methods                                              */
 /* ************************************************************ */
-json createJsonObject(ControlledEntityImpl const& entity, entity::model::jsonSerializer::Flags const flags)
+static bool isEntityModelDumped(ControlledEntityImpl const& entity, entity::model::jsonSerializer::Flags const flags) noexcept
 {
-	try
-	{
-		// Create the object
-		auto object = json{};
-		auto const& e = entity.getEntity();
+	return entity.getEntity().getEntityCapabilities().test(entity::EntityCapability::AemSupported) && (flags.test(entity::model::jsonSerializer::Flag::ProcessStaticModel) || flags.test(entity::model::jsonSerializer::Flag::ProcessDynamicModel));
+}
 
-		// Dump information of the dump itself
-		object[keyName::ControlledEntity_DumpVersion] = keyValue::ControlledEntity_DumpVersion;
+/** Creates the JSON object of the entity, optionally without its EntityModel (which is the biggest part) */
+static json dumpControlledEntity(ControlledEntityImpl const& entity, entity::model::jsonSerializer::Flags const flags, bool const dumpEntityModel)
+{
+	// Create the object
+	auto object = json{};
+	auto const& e = entity.getEntity();
 
-		// Dump ADP information
-		if (flags.test(entity::model::jsonSerializer::Flag::ProcessADP))
-		{
-			auto& adp = object[keyName::ControlledEntity_AdpInformation];
+	// Dump information of the dump itself
+	object[keyName::ControlledEntity_DumpVersion] = keyValue::ControlledEntity_DumpVersion;
+
+	// Dump ADP information
+	if (flags.test(entity::model::jsonSerializer::Flag::ProcessADP))
+	{
+		auto& adp = object[keyName::ControlledEntity_AdpInformation];
 
-			// Dump common information
-			adp[entity::keyName::Entity_CommonInformation_Node] = e.getCommonInformation();
+		// Dump common information
+		adp[entity::keyName::Entity_CommonInformation_Node] = e.getCommonInformation();
 
-			// Dump interfaces information
-			auto intfcs = json{};
-			for (auto const& [avbInterfaceIndex, intfcInfo] : e.getInterfacesInformation()) // Don't use default std::map serializer, we want to force an array of object that includes the key (AvbInterfaceIndex)
+		// Dump interfaces information
+		auto intfcs = json{};
+		for (auto const& [avbInterfaceIndex, intfcInfo] : e.getInterfacesInformation()) // Don't use default std::map serializer, we want to force an array of object that includes the key (AvbInterfaceIndex)
+		{
+			json j = intfcInfo; // Must use operator= instead of constructor to force usage of the to_json overload
+			if (avbInterfaceIndex == entity::Entity::GlobalAvbInterfaceIndex)
 			{
-				json j = intfcInfo; // Must use operator= instead of constructor to force usage of the to_json overload
-				if (avbInterfaceIndex == entity::Entity::GlobalAvbInterfaceIndex)
-				{
-					j[entity::keyName::Entity_InterfaceInformation_AvbInterfaceIndex] = nullptr;
-				}
-				else
-				{
-					j[entity::keyName::Entity_InterfaceInformation_AvbInterfaceIndex] = avbInterfaceIndex;
-				}
-				intfcs.push_back(j);
+				j[entity::keyName::Entity_InterfaceInformation_AvbInterfaceIndex] = nullptr;
+			}
+			else
+			{
+				j[entity::keyName::Entity_InterfaceInformation_AvbInterfaceIndex] = avbInterfaceIndex;
 			}
-			adp[entity::keyName::Entity_InterfaceInformation_Node] = intfcs;
+			intfcs.push_back(j);
 		}
+		adp[entity::keyName::Entity_InterfaceInformation_Node] = intfcs;
+	}
 
-		// Dump device compatibility flags
-		if (flags.test(entity::model::jsonSerializer::Flag::ProcessCompatibility))
-		{
-			object[keyName::ControlledEntity_CompatibilityFlags] = entity.getCompatibilityFlags();
-		}
+	// Dump device compatibility flags
+	if (flags.test(entity::model::jsonSerializer::Flag::ProcessCompatibility))
+	{
+		object[keyName::ControlledEntity_CompatibilityFlags] = entity.getCompatibilityFlags();
+	}
 
-		// Dump AEM if supported
-		if (e.getEntityCapabilities().test(entity::EntityCapability::AemSupported) && (flags.test(entity::model::jsonSerializer::Flag::ProcessStaticModel) || flags.test(entity::model::jsonSerializer::Flag::ProcessDynamicModel)))
+	// Dump AEM if supported
+	if (isEntityModelDumped(entity, flags))
+	{
+		// Dump model(s)
+		if (dumpEntityModel)
 		{
-			// Dump model(s)
 			object[keyName::ControlledEntity_EntityModel] = entity::model::jsonSerializer::createJsonObject(entity.getEntityTree(), flags);
-			// Dump EntityModelID
-			if (flags.test(entity::model::jsonSerializer::Flag::ProcessStaticModel))
-			{
-				object[keyName::ControlledEntity_EntityModelID] = entity.getEntity().getEntityModelID();
-			}
 		}
-
-		// Dump Milan information, if present
-		if (flags.test(entity::model::jsonSerializer::Flag::ProcessMilan))
+		// Dump EntityModelID
+		if (flags.test(entity::model::jsonSerializer::Flag::ProcessStaticModel))
 		{
-			auto const milanInfo = entity.getMilanInfo();
-			if (milanInfo)
-			{
-				object[keyName::ControlledEntity_MilanInformation] = *milanInfo;
-			}
+			object[keyName::ControlledEntity_EntityModelID] = entity.getEntity().getEntityModelID();
 		}
+	}
 
-		// Dump Entity State
-		if (flags.test(entity::model::jsonSerializer::Flag::ProcessState))
+	// Dump Milan information, if present
+	if (flags.test(entity::model::jsonSerializer::Flag::ProcessMilan))
+	{
+		auto const milanInfo = entity.getMilanInfo();
+		if (milanInfo)
 		{
-			auto& state = object[keyName::ControlledEntity_EntityState];
-			state[controller::keyName::ControlledEntityState_AcquireState] = entity.getAcquireState();
-			state[controller::keyName::ControlledEntityState_OwningControllerID] = entity.getOwningControllerID();
-			state[controller::keyName::ControlledEntityState_LockState] = entity.getLockState();
-			state[controller::keyName::ControlledEntityState_LockingControllerID] = entity.getLockingControllerID();
-			state[controller::keyName::ControlledEntityState_SubscribedUnsol] = entity.isSubscribedToUnsolicitedNotifications();
-			state[controller::keyName::ControlledEntityState_ActiveConfiguration] = entity.getCurrentConfigurationIndex();
+			object[keyName::ControlledEntity_MilanInformation] = *milanInfo;
 		}
+	}
 
-		// Dump Entity Statistics
-		if (flags.test(entity::model::jsonSerializer::Flag::ProcessStatistics))
+	// Dump Entity State
+	if (flags.test(entity::model::jsonSerializer::Flag::ProcessState))
+	{
+		auto& state = object[keyName::ControlledEntity_EntityState];
+		state[controller::keyName::ControlledEntityState_AcquireState] = entity.getAcquireState();
+		state[controller::keyName::ControlledEntityState_OwningControllerID] = entity.getOwningControllerID();
+		state[controller::keyName::ControlledEntityState_LockState] = entity.getLockState();
+		state[controller::keyName::ControlledEntityState_LockingControllerID] = entity.getLockingControllerID();
+		state[controller::keyName::ControlledEntityState_SubscribedUnsol] = entity.isSubscribedToUnsolicitedNotifications();
+		state[controller::keyName::ControlledEntityState_ActiveConfiguration] = entity.getCurrentConfigurationIndex();
+	}
+
+	// Dump Entity Statistics
+	if (flags.test(entity::model::jsonSerializer::Flag::ProcessStatistics))
+	{
+		auto& statistics = object[keyName::ControlledEntity_Statistics];
+		statistics[controller::keyName::ControlledEntityStatistics_AecpRetryCounter] = entity.getAecpRetryCounter();
+		statistics[controller::keyName::ControlledEntityStatistics_AecpTimeoutCounter] = entity.getAecpTimeoutCounter();
+		statistics[controller::keyName::ControlledEntityStatistics_AecpUnexpectedResponseCounter] = entity.getAecpUnexpectedResponseCounter();
+		statistics[controller::keyName::ControlledEntityStatistics_AecpResponseAverageTime] = entity.getAecpResponseAverageTime();
+		statistics[controller::keyName::ControlledEntityStatistics_AemAecpUnsolicitedCounter] = entity.getAemAecpUnsolicitedCounter();
+		statistics[controller::keyName::ControlledEntityStatistics_EnumerationTime] = entity.getEnumerationTime();
+	}
+
+	// Dump Entity Diagnostics
+	if (flags.test(entity::model::jsonSerializer::Flag::ProcessDiagnostics))
+	{
+		auto& diagnostics = object[keyName::ControlledEntity_Diagnostics];
+		auto const& diags = entity.getDiagnostics();
+		diagnostics[controller::keyName::ControlledEntityDiagnostics_RedundancyWarning] = diags.redundancyWarning;
+		diagnostics[controller::keyName::ControlledEntityDiagnostics_StreamInputLatencyErrors] = diags.streamInputOverLatency;
+	}
+
+	return object;
+}
+
+/* ************************************************************ */
+/* Public methods                                               */
+/* ************************************************************ */
+json createJsonObject(ControlledEntityImpl const& entity, entity::model::jsonSerializer::Flags const flags)
+{
+	try
+	{
+		return dumpControlledEntity(entity, flags, true);
+	}
+	catch (json::exception const& e)
+	{
+		AVDECC_ASSERT(false, "json::exception is not expected to be thrown here");
+		throw avdecc::jsonSerializer::SerializationException{ avdecc::jsonSerializer::SerializationError::InternalError, e.what() };
+	}
+	catch (avdecc::jsonSerializer::SerializationException const&)
+	{
+		throw; // Rethrow, this is already the correct exception type
+	}
+	catch (...)
+	{
+		AVDECC_ASSERT(false, "Exception type other than avdecc::jsonSerializer::SerializationException are not expected to be thrown here");
+		throw avdecc::jsonSerializer::SerializationException{ avdecc::jsonSerializer::SerializationError::InternalError, "Exception type other than avdecc::jsonSerializer::SerializationException are not expected to be thrown here." };
+	}
+}
+
+void writeJsonObject(avdecc::jsonSerializer::StreamWriter& writer, ControlledEntityImpl const& entity, entity::model::jsonSerializer::Flags const flags)
+{
+	try
+	{
+		// Everything but the EntityModel is small enough to be created in memory, the EntityModel is streamed in its place
+		auto const object = dumpControlledEntity(entity, flags, false);
+
+		writer.beginObject();
+		if (isEntityModelDumped(entity, flags))
 		{
-			auto& statistics = object[keyName::ControlledEntity_Statistics];
-			statistics[controller::keyName::ControlledEntityStatistics_AecpRetryCounter] = entity.getAecpRetryCounter();
-			statistics[controller::keyName::ControlledEntityStatistics_AecpTimeoutCounter] = entity.getAecpTimeoutCounter();
-			statistics[controller::keyName::ControlledEntityStatistics_AecpUnexpectedResponseCounter] = entity.getAecpUnexpectedResponseCounter();
-			statistics[controller::keyName::ControlledEntityStatistics_AecpResponseAverageTime] = entity.getAecpResponseAverageTime();
-			statistics[controller::keyName::ControlledEntityStatistics_AemAecpUnsolicitedCounter] = entity.getAemAecpUnsolicitedCounter();
-			statistics[controller::keyName::ControlledEntityStatistics_EnumerationTime] = entity.getEnumerationTime();
+			writer.writeMembers(object, keyName::ControlledEntity_EntityModel,
+				[&writer, &entity, flags]()
+				{
+					entity::model::jsonSerializer::writeJsonObject(writer, entity.getEntityTree(), flags);
+				});
 		}
-
-		// Dump Entity Diagnostics
-		if (flags.test(entity::model::jsonSerializer::Flag::ProcessDiagnostics))
+		else
 		{
-			auto& diagnostics = object[keyName::ControlledEntity_Diagnostics];
-			auto const& diags = entity.getDiagnostics();
-			diagnostics[controller::keyName::ControlledEntityDiagnostics_RedundancyWarning] = diags.redundancyWarning;
-			diagnostics[controller::keyName::ControlledEntityDiagnostics_StreamInputLatencyErrors] = diags.streamInputOverLatency;
+			writer.writeMembers(object);
 		}
-
-		return object;
+		writer.endObject();
 	}
 	catch (json::exception const& e)
 	{
@@ -44,6 +44,7 @@ namespace jsonSerializer
 {
 // Serialization methods
 json createJsonObject(ControlledEntityImpl const& entity, entity::model::jsonSerializer::Flags const flags); // Throws SerializationException
+void writeJsonObject(avdecc::jsonSerializer::StreamWriter& writer, ControlledEntityImpl const& entity, entity::model::jsonSerializer::Flags const flags); // Same output than createJsonObject, but the EntityModel is written as it goes. Throws SerializationException
 
 // Deserialization methods
 void setEntityModel(ControlledEntityImpl& entity, json const& object, entity::model::jsonSerializer::Flags flags); // Throws DeserializationException
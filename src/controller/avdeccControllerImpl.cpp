@@ -33,12 +33,17 @@
 #ifdef ENABLE_AVDECC_FEATURE_JSON
 #	include "avdeccControllerJsonTypes.hpp"
 #	include "avdeccControlledEntityJsonSerializer.hpp"
+#	include "avdeccControllerSnapshot.hpp"
 #	include <la/avdecc/internals/jsonTypes.hpp>
 #endif // ENABLE_AVDECC_FEATURE_JSON
 #include <la/avdecc/internals/streamFormatInfo.hpp>
 #include <la/avdecc/internals/entityModelControlValuesTraits.hpp>
 
+#include <algorithm>
+#include <cstdio>
 #include <fstream>
+#include <set>
+#include <sstream>
 
 // According to clarification (from IEEE1722.1 call) a device should always send the complete, up-to-date, status in a GET/SET_STREAM_INFO response (either unsolicited or not)
 // This means that we should always replace the previously stored StreamInfo data with the last one received
@@ -168,7 +173,8 @@ void ControllerImpl::addCompatibilityFlag(ControllerImpl const* const controller
 			}
 			break;
 		case ControlledEntity::CompatibilityFlag::Milan:
-			if (!newFlags.test(ControlledEntity::CompatibilityFlag::Misbehaving))
+			// Compatibility might have been lost while MilanInfo was being retrieved (enumeration steps run concurrently)
+			if (!newFlags.test(ControlledEntity::CompatibilityFlag::Misbehaving) && newFlags.test(ControlledEntity::CompatibilityFlag::IEEE17221) && !controlledEntity.isMilanCompatibilityRevoked())
 			{
 				newFlags.set(ControlledEntity::CompatibilityFlag::IEEE17221); // A Milan device is also an IEEE1722.1 compatible device
 				newFlags.set(flag);
@@ -227,6 +233,11 @@ void ControllerImpl::removeCompatibilityFlag(ControllerImpl const* const control
 			}
 			break;
 		case ControlledEntity::CompatibilityFlag::Milan:
+			// MilanInfo not retrieved yet, prevent the flag from being set afterwards
+			if (controlledEntity.getEnumerationSteps().test(ControlledEntityImpl::EnumerationStep::GetMilanInfo))
+			{
+				controlledEntity.setMilanCompatibilityRevoked();
+			}
 			// If device was Milan compliant
 			if (newFlags.test(ControlledEntity::CompatibilityFlag::Milan))
 			{
@@ -261,6 +272,11 @@ void ControllerImpl::removeCompatibilityFlag(ControllerImpl const* const control
 	}
 }
 
+bool ControllerImpl::mayBeMilanCompatible(ControlledEntityImpl const& controlledEntity) noexcept
+{
+	return controlledEntity.getCompatibilityFlags().test(ControlledEntity::CompatibilityFlag::Milan) || controlledEntity.getEnumerationSteps().test(ControlledEntityImpl::EnumerationStep::GetMilanInfo);
+}
+
 void ControllerImpl::updateUnsolicitedNotificationsSubscription(ControlledEntityImpl& controlledEntity, bool const isSubscribed) const noexcept
 {
 	AVDECC_ASSERT(_controller->isSelfLocked(), "Should only be called from the network thread (where ProtocolInterface is locked)");
@@ -438,32 +454,48 @@ void ControllerImpl::updateStreamInputInfo(ControlledEntityImpl& controlledEntit
 			// Only if the entity has been advertised, onPreAdvertiseEntity will take care of the non-advertised ones later
 			if (controlledEntity.wasAdvertised())
 			{
-				auto isOverLatency = false;
+				auto const& sink = controlledEntity.getSinkConnectionInformation(streamIndex);
 
-				// Only if Latency is greater than 0
-				if (info.msrpAccumulatedLatency > 0)
+				// Only if Latency is greater than 0 and the Stream is Connected
+				if (info.msrpAccumulatedLatency > 0 && sink.state == entity::model::StreamInputConnectionInfo::State::Connected)
 				{
-					auto const& sink = controlledEntity.getSinkConnectionInformation(streamIndex);
+					// We need the Talker we are connected to
+					runWithControlledEntityImplGuards({ controlledEntity.getEntity().getEntityID(), sink.talkerStream.entityID },
+						[this, streamIndex, talkerStream = sink.talkerStream, msrpAccumulatedLatency = info.msrpAccumulatedLatency](ControlledEntityImplGuards& entities)
+						{
+							auto& listenerEntity = entities[0];
+							auto& talkerEntity = entities[1];
 
-					// If the Stream is Connected, search for the Talker we are connected to
-					if (sink.state == entity::model::StreamInputConnectionInfo::State::Connected)
-					{
-						// Take a "scoped locked" shared copy of the ControlledEntity
-						auto talkerEntity = getControlledEntityImplGuard(sink.talkerStream.entityID, true);
+							// The Listener might have changed if the check was deferred
+							if (!listenerEntity || !listenerEntity->wasAdvertised())
+							{
+								return;
+							}
+							try
+							{
+								auto const& listenerSink = listenerEntity->getSinkConnectionInformation(streamIndex);
+								if (listenerSink.state != entity::model::StreamInputConnectionInfo::State::Connected || listenerSink.talkerStream != talkerStream)
+								{
+									return;
+								}
+							}
+							catch (ControlledEntity::Exception const&)
+							{
+								return;
+							}
 
-						if (talkerEntity)
-						{
-							auto const& talker = *talkerEntity;
+							auto isOverLatency = false;
 
 							// Only process advertised entities, onPreAdvertiseEntity will take care of the non-advertised ones later
-							if (talker.wasAdvertised())
+							if (talkerEntity && talkerEntity->wasAdvertised())
 							{
+								auto const& talker = *talkerEntity;
 								try
 								{
-									auto const& talkerStreamOutputNode = talker.getStreamOutputNode(talker.getCurrentConfigurationIndex(), sink.talkerStream.streamIndex);
+									auto const& talkerStreamOutputNode = talker.getStreamOutputNode(talker.getCurrentConfigurationIndex(), talkerStream.streamIndex);
 									if (talkerStreamOutputNode.dynamicModel && talkerStreamOutputNode.dynamicModel->streamDynamicInfo)
 									{
-										isOverLatency = info.msrpAccumulatedLatency > (*talkerStreamOutputNode.dynamicModel->streamDynamicInfo).msrpAccumulatedLatency;
+										isOverLatency = msrpAccumulatedLatency > (*talkerStreamOutputNode.dynamicModel->streamDynamicInfo).msrpAccumulatedLatency;
 									}
 								}
 								catch (ControlledEntity::Exception const&)
@@ -471,11 +503,14 @@ void ControllerImpl::updateStreamInputInfo(ControlledEntityImpl& controlledEntit
 									// Ignore Exception
 								}
 							}
-						}
-					}
-				}
 
-				updateStreamInputLatency(controlledEntity, streamIndex, isOverLatency);
+							updateStreamInputLatency(*listenerEntity, streamIndex, isOverLatency);
+						});
+				}
+				else
+				{
+					updateStreamInputLatency(controlledEntity, streamIndex, false);
+				}
 			}
 		}
 	}
@@ -1126,7 +1161,7 @@ void ControllerImpl::updateGptpInformation(ControlledEntityImpl& controlledEntit
 	for (auto& [interfaceIndex, avbInterfaceModel] : avbDescriptorModels)
 	{
 		// Match with the passed AvbInterfaceIndex, or with macAddress if passed AvbInterfaceIndex is the GlobalAvbInterfaceIndex
-		if (interfaceIndex == avbInterfaceIndex || (avbInterfaceIndex == entity::Entity::GlobalAvbInterfaceIndex && macAddress == avbInterfaceModel.staticModel.macAddress))
+		if (interfaceIndex == avbInterfaceIndex || (avbInterfaceIndex == entity::Entity::GlobalAvbInterfaceIndex && macAddress == avbInterfaceModel.staticModel->macAddress))
 		{
 			// Alter InterfaceInfo with new gPTP info
 			if (avbInterfaceModel.dynamicModel.gptpGrandmasterID != gptpGrandmasterID || avbInterfaceModel.dynamicModel.gptpDomainNumber != gptpDomainNumber)
@@ -1523,6 +1558,118 @@ void ControllerImpl::updateStreamInputLatency(ControlledEntityImpl& controlledEn
 /* ************************************************************ */
 /* Private methods                                              */
 /* ************************************************************ */
+ControllerImpl::ControlledEntityImplGuards ControllerImpl::getControlledEntityImplGuards(std::vector<UniqueIdentifier> const& entityIDs, bool const onlyIfAdvertised) const noexcept
+{
+	// Get a shared copy of the entities
+	auto entities = std::vector<SharedControlledEntityImpl>{};
+	entities.reserve(entityIDs.size());
+	for (auto const entityID : entityIDs)
+	{
+		entities.push_back(getSharedControlledEntityImplHolder(entityID, onlyIfAdvertised).release());
+	}
+
+	// Sort the entities to lock by lock order (each one only once)
+	auto toLock = std::vector<ControlledEntityImpl*>{};
+	toLock.reserve(entities.size());
+	for (auto const& entity : entities)
+	{
+		if (entity)
+		{
+			toLock.push_back(entity.get());
+		}
+	}
+	std::sort(toLock.begin(), toLock.end(),
+		[](auto const* const lhs, auto const* const rhs)
+		{
+			return lhs->getLockOrder() < rhs->getLockOrder();
+		});
+	toLock.erase(std::unique(toLock.begin(), toLock.end()), toLock.end());
+
+	// Wait for the first lock (nothing else is held yet), then only try the other ones: if any is not available, release what was acquired and start again (same algorithm than std::lock)
+	auto locked = false;
+	while (!locked && !toLock.empty())
+	{
+		auto* const firstEntity = toLock.front();
+		firstEntity->lock();
+
+		auto const failedIt = std::find_if(std::next(toLock.begin()), toLock.end(),
+			[](auto* const entity)
+			{
+				return !entity->tryLock();
+			});
+		locked = failedIt == toLock.end();
+		if (!locked)
+		{
+			// Release the locks acquired during this attempt
+			for (auto it = toLock.begin(); it != failedIt; ++it)
+			{
+				(*it)->unlock();
+			}
+
+			// Start with the lock that was not available, we'll most likely wait for it
+			std::rotate(toLock.begin(), failedIt, toLock.end());
+			std::this_thread::yield();
+		}
+	}
+
+	// All acquired, each guard takes its own (recursive) lock, then release the ones used to acquire them
+	auto guards = ControlledEntityImplGuards{};
+	guards.reserve(entities.size());
+	for (auto& entity : entities)
+	{
+		guards.emplace_back(std::move(entity), true);
+	}
+	for (auto* const entity : toLock)
+	{
+		entity->unlock();
+	}
+
+	return guards;
+}
+
+std::optional<ControllerImpl::ControlledEntityImplGuards> ControllerImpl::tryGetControlledEntityImplGuards(std::vector<UniqueIdentifier> const& entityIDs) const noexcept
+{
+	auto guards = ControlledEntityImplGuards{};
+	guards.reserve(entityIDs.size());
+	for (auto const entityID : entityIDs)
+	{
+		auto entity = getSharedControlledEntityImplHolder(entityID).release();
+		if (entity && !entity->tryLock())
+		{
+			// Already acquired ones will be released by their guard
+			return std::nullopt;
+		}
+		guards.emplace_back(std::move(entity), std::adopt_lock);
+	}
+	return guards;
+}
+
+void ControllerImpl::runWithControlledEntityImplGuards(std::vector<UniqueIdentifier> const& entityIDs, ControlledEntityImplGuardsHandler const& handler) const noexcept
+{
+	// Not holding any entity, we can wait for them
+	if (!ControlledEntityImpl::LockInformation::isAnySelfLocked())
+	{
+		auto guards = getControlledEntityImplGuards(entityIDs);
+		utils::invokeProtectedHandler(handler, guards);
+		return;
+	}
+
+	// Already holding other entities, only run now if we can get them all without waiting
+	if (auto guards = tryGetControlledEntityImplGuards(entityIDs))
+	{
+		utils::invokeProtectedHandler(handler, *guards);
+		return;
+	}
+
+	// Otherwise run once this thread released all its entities
+	ControlledEntityImpl::LockInformation::deferUntilAllUnlocked(
+		[this, entityIDs, handler]()
+		{
+			auto guards = getControlledEntityImplGuards(entityIDs);
+			utils::invokeProtectedHandler(handler, guards);
+		});
+}
+
 entity::model::ControlValues ControllerImpl::makeIdentifyControlValues(bool const isEnabled) noexcept
 {
 	auto values = entity::model::LinearValues<entity::model::LinearValueDynamic<std::uint8_t>>{};
@@ -1645,7 +1792,7 @@ void ControllerImpl::removeExclusiveAccessTokens(UniqueIdentifier const entityID
 
 bool ControllerImpl::areControlledEntitiesSelfLocked() const noexcept
 {
-	return _entitiesSharedLockInformation->isSelfLocked();
+	return ControlledEntityImpl::LockInformation::isAnySelfLocked();
 }
 
 std::tuple<model::AcquireState, UniqueIdentifier> ControllerImpl::getAcquiredInfoFromStatus(ControlledEntityImpl& entity, UniqueIdentifier const owningEntity, entity::ControllerEntity::AemCommandStatus const status, bool const releaseEntityResult) const noexcept
@@ -1794,7 +1941,7 @@ void ControllerImpl::chooseLocale(ControlledEntityImpl* const entity, entity::mo
 			if (stringsModelIt != configTree.stringsModels.end())
 			{
 				// Already in cache, no need to query (just have to copy strings to Configuration for quick access)
-				auto const& stringsStaticModel = stringsModelIt->second.staticModel;
+				auto const& stringsStaticModel = stringsModelIt->second.staticModel.get();
 				entity->setLocalizedStrings(configurationIndex, index, stringsStaticModel.strings);
 			}
 			else
@@ -2593,39 +2740,203 @@ void ControllerImpl::getDescriptorDynamicInfo(ControlledEntityImpl* const entity
 	}
 }
 
+void ControllerImpl::startEnumeration(ControlledEntityImpl* const entity) noexcept
+{
+	// Save the time we start enumeration
+	entity->setStartEnumerationTime(std::chrono::steady_clock::now());
+
+	// Check first enumeration steps
+	checkEnumerationSteps(entity);
+}
+
+void ControllerImpl::startAdmittedEnumerations(EnumerationScheduler::EntityIDs const& entityIDs) noexcept
+{
+	for (auto const entityID : entityIDs)
+	{
+		// We might be holding the entity which enumeration just ended
+		runWithControlledEntityImplGuards({ entityID },
+			[this, entityID](ControlledEntityImplGuards& entities)
+			{
+				auto& controlledEntity = entities[0];
+
+				// The entity might have gone offline in the meantime (in which case it's no longer counted as being enumerated)
+				if (controlledEntity)
+				{
+					LOG_CONTROLLER_DEBUG(entityID, "Starting delayed enumeration ({} waiting)", _enumerationScheduler.getQueuedCount());
+					startEnumeration(controlledEntity.get());
+				}
+			});
+	}
+}
+
+void ControllerImpl::onEnumerationEnded(ControlledEntityImpl& controlledEntity) noexcept
+{
+	// AECP timeouts during the enumeration are a sign of too many concurrent enumerations
+	auto const admitted = _enumerationScheduler.onEnumerationEnded(controlledEntity.getEntity().getEntityID(), controlledEntity.getAecpTimeoutCounter() != 0u);
+	startAdmittedEnumerations(admitted);
+}
+
+void ControllerImpl::setFatalEnumerationError(ControlledEntityImpl& controlledEntity) noexcept
+{
+	controlledEntity.setGetFatalEnumerationError();
+
+	// The entity will not be advertised, its enumeration is over
+	onEnumerationEnded(controlledEntity);
+}
+
+void ControllerImpl::retainOfflineEntity(SharedControlledEntityImpl const& controlledEntity) noexcept
+{
+	auto const& e = controlledEntity->getEntity();
+
+	// Only physical entities with an EntityModel (nothing to reuse otherwise)
+	if (controlledEntity->isVirtual() || controlledEntity->gotFatalEnumerationError() || !e.getEntityCapabilities().test(entity::EntityCapability::AemSupported) || !e.getEntityModelID())
+	{
+		return;
+	}
+
+	auto const now = std::chrono::steady_clock::now();
+
+	// Lock to protect _offlineEntities
+	auto const lg = std::lock_guard{ _lock };
+
+	// Delta enumeration disabled
+	if (_offlineEntitiesRetention.count() == 0)
+	{
+		return;
+	}
+
+	releaseExpiredOfflineEntities(now);
+
+	_offlineEntities[e.getEntityID()] = OfflineEntity{ controlledEntity, now };
+}
+
+void ControllerImpl::releaseExpiredOfflineEntities(std::chrono::time_point<std::chrono::steady_clock> const now) noexcept
+{
+	for (auto it = _offlineEntities.begin(); it != _offlineEntities.end(); /* Iterate inside the loop */)
+	{
+		if (now - it->second.offlineTime > _offlineEntitiesRetention)
+		{
+			it = _offlineEntities.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+std::shared_ptr<entity::model::EntityTree const> ControllerImpl::takeOfflineEntityTree(entity::Entity const& entity) noexcept
+{
+	auto const entityID = entity.getEntityID();
+	auto offlineEntity = OfflineEntity{};
+
+	{
+		// Lock to protect _offlineEntities
+		auto const lg = std::lock_guard{ _lock };
+
+		// Release expired entities (including this one, if expired)
+		releaseExpiredOfflineEntities(std::chrono::steady_clock::now());
+
+		auto const offlineEntityIt = _offlineEntities.find(entityID);
+		if (offlineEntityIt == _offlineEntities.end())
+		{
+			return {};
+		}
+
+		// A retained entity can only be used once
+		offlineEntity = std::move(offlineEntityIt->second);
+		_offlineEntities.erase(offlineEntityIt);
+	}
+
+	auto const& previousEntity = offlineEntity.controlledEntity->getEntity();
+
+	// Must be the same EntityModel
+	if (entity.getEntityModelID() != previousEntity.getEntityModelID())
+	{
+		LOG_CONTROLLER_DEBUG(entityID, "EntityModelID changed while offline, not reusing its previous model");
+		return {};
+	}
+
+	// The available_index must have kept on incrementing while the entity was offline (it's reset when the entity restarts)
+	auto hasCommonInterface = false;
+	for (auto const& [avbInterfaceIndex, information] : entity.getInterfacesInformation())
+	{
+		if (!previousEntity.hasInterfaceIndex(avbInterfaceIndex))
+		{
+			continue;
+		}
+
+		auto const& previousInformation = previousEntity.getInterfaceInformation(avbInterfaceIndex);
+		if (previousInformation.macAddress != information.macAddress)
+		{
+			LOG_CONTROLLER_DEBUG(entityID, "MacAddress changed while offline, not reusing its previous model");
+			return {};
+		}
+
+		// The ADP information we have might be older than the last advertisement received, but the entity has to advertise at least once per valid_time to stay online
+		auto const validTime = std::chrono::seconds{ 2u * std::max<std::uint8_t>(previousInformation.validTime, 1u) };
+		auto const elapsedValidTimes = static_cast<std::uint64_t>(std::max<std::chrono::steady_clock::rep>((offlineEntity.offlineTime - offlineEntity.controlledEntity->getEntityUpdateTime()) / validTime, 1) - 1);
+		auto const minimumAvailableIndex = std::uint64_t{ previousInformation.availableIndex } + elapsedValidTimes;
+		if (information.availableIndex <= minimumAvailableIndex)
+		{
+			LOG_CONTROLLER_DEBUG(entityID, "Entity available_index ({}) is not a continuation of its previous one (at least {}), entity probably restarted, not reusing its previous model", information.availableIndex, minimumAvailableIndex + 1u);
+			return {};
+		}
+		hasCommonInterface = true;
+	}
+
+	if (!hasCommonInterface)
+	{
+		return {};
+	}
+
+	// Only reuse the static part of the model, the dynamic one might have changed while the entity was offline
+	return EntityModelCache::makeStaticEntityTree(offlineEntity.controlledEntity->getEntityTree());
+}
+
 void ControllerImpl::checkEnumerationSteps(ControlledEntityImpl* const controlledEntity) noexcept
 {
 	auto& entity = *controlledEntity;
-	auto const steps = entity.getEnumerationSteps();
+	// Start all the steps whose dependencies are completed, they run concurrently (a step may complete immediately and recursively start other steps, so always check for the current state)
+	auto const startStep = [&entity](ControlledEntityImpl::EnumerationStep const step)
+	{
+		if (entity.getReadyEnumerationSteps().test(step))
+		{
+			entity.setEnumerationStepStarted(step);
+			return true;
+		}
+		return false;
+	};
 
-	// Always start with retrieving MilanInfo from the device
-	if (steps.test(ControlledEntityImpl::EnumerationStep::GetMilanInfo))
+	// Retrieve MilanInfo from the device
+	if (startStep(ControlledEntityImpl::EnumerationStep::GetMilanInfo))
 	{
 		getMilanInfo(controlledEntity);
-		return;
 	}
-	// Then register to unsolicited notifications
-	if (steps.test(ControlledEntityImpl::EnumerationStep::RegisterUnsol))
+	// Register to unsolicited notifications
+	if (startStep(ControlledEntityImpl::EnumerationStep::RegisterUnsol))
 	{
 		registerUnsol(controlledEntity);
-		return;
 	}
-	// Then get the static AEM
-	if (steps.test(ControlledEntityImpl::EnumerationStep::GetStaticModel))
+	// Get the static AEM
+	if (startStep(ControlledEntityImpl::EnumerationStep::GetStaticModel))
 	{
 		getStaticModel(controlledEntity);
-		return;
 	}
-	// Then get descriptors dynamic information, it AEM is cached
-	if (steps.test(ControlledEntityImpl::EnumerationStep::GetDescriptorDynamicInfo))
+	// Get descriptors dynamic information, if AEM is cached
+	if (startStep(ControlledEntityImpl::EnumerationStep::GetDescriptorDynamicInfo))
 	{
 		getDescriptorDynamicInfo(controlledEntity);
-		return;
 	}
-	// Finally retrieve all other dynamic information
-	if (steps.test(ControlledEntityImpl::EnumerationStep::GetDynamicInfo))
+	// Retrieve all other dynamic information (along with descriptors dynamic information, if AEM is cached)
+	if (startStep(ControlledEntityImpl::EnumerationStep::GetDynamicInfo))
 	{
 		getDynamicInfo(controlledEntity);
+	}
+
+	// Some steps are still running
+	if (!entity.getEnumerationSteps().empty())
+	{
 		return;
 	}
 
@@ -2672,6 +2983,9 @@ void ControllerImpl::checkEnumerationSteps(ControlledEntityImpl* const controlle
 			// Do some final controller related steps after advertising entity
 			onPostAdvertiseEntity(entity);
 		}
+
+		// Enumeration is over, let the next entity start its own
+		onEnumerationEnded(entity);
 	}
 }
 
@@ -3001,61 +3315,88 @@ void ControllerImpl::onPreAdvertiseEntity(ControlledEntityImpl& controlledEntity
 	{
 		AVDECC_ASSERT(_controller->isSelfLocked(), "Should only be called from the network thread (where ProtocolInterface is locked)");
 
-		try
+		// Get all the other entities
+		auto otherEntityIDs = std::vector<UniqueIdentifier>{};
 		{
-			auto const& talkerConfigurationNode = controlledEntity.getCurrentConfigurationNode();
-
 			// Lock to protect _controlledEntities
 			auto const lg = std::lock_guard{ _lock };
 
-			// Process all entities that are connected to any of our output streams
-			for (auto const& entityKV : _controlledEntities)
+			otherEntityIDs.reserve(_controlledEntities.size());
+			for (auto const& [otherEntityID, otherEntity] : _controlledEntities)
 			{
-				auto const listenerEntityID = entityKV.first;
-				auto& listenerEntity = *(entityKV.second);
-
-				// Don't process self, not yet advertised entities, nor different virtual/physical kind
-				if (listenerEntityID == entityID || !listenerEntity.wasAdvertised() || isVirtualEntity != listenerEntity.isVirtual())
+				if (otherEntityID != entityID)
 				{
-					continue;
+					otherEntityIDs.push_back(otherEntityID);
 				}
+			}
+		}
 
-				// We need the AEM to check for Listener connections
-				if (listenerEntity.getEntity().getEntityCapabilities().test(entity::EntityCapability::AemSupported))
+		// Process all entities that are connected to any of our output streams
+		for (auto const listenerEntityID : otherEntityIDs)
+		{
+			runWithControlledEntityImplGuards({ entityID, listenerEntityID },
+				[this, isVirtualEntity](ControlledEntityImplGuards& entities)
 				{
-					try
+					auto& talkerEntity = entities[0];
+					auto& listenerEntityGuard = entities[1];
+
+					// Either entity might have gone offline if the processing was deferred
+					if (!talkerEntity || !listenerEntityGuard)
+					{
+						return;
+					}
+					auto& listenerEntity = *listenerEntityGuard;
+					auto const talkerEntityID = talkerEntity->getEntity().getEntityID();
+					auto const listenerEntityID = listenerEntity.getEntity().getEntityID();
+
+					// Don't process not yet advertised entities, nor different virtual/physical kind
+					if (!listenerEntity.wasAdvertised() || isVirtualEntity != listenerEntity.isVirtual())
 					{
-						auto const& configurationNode = listenerEntity.getCurrentConfigurationNode();
+						return;
+					}
 
-						// Check each of this Listener's Input Streams
-						for (auto const& [streamIndex, streamInputNode] : configurationNode.streamInputs)
+					// We need the AEM to check for Listener connections
+					if (listenerEntity.getEntity().getEntityCapabilities().test(entity::EntityCapability::AemSupported))
+					{
+						try
 						{
-							if (streamInputNode.dynamicModel)
+							auto const& talkerConfigurationNode = talkerEntity->getCurrentConfigurationNode();
+							auto const& configurationNode = listenerEntity.getCurrentConfigurationNode();
+
+							// Check each of this Listener's Input Streams
+							for (auto const& [streamIndex, streamInputNode] : configurationNode.streamInputs)
 							{
-								// If the Stream is Connected
-								if (streamInputNode.dynamicModel->connectionInfo.state == entity::model::StreamInputConnectionInfo::State::Connected)
+								if (streamInputNode.dynamicModel)
 								{
-									// Check against all the Talker's Output Streams
-									for (auto const& [streamOutputIndex, streamOutputNode] : talkerConfigurationNode.streamOutputs)
+									// If the Stream is Connected
+									if (streamInputNode.dynamicModel->connectionInfo.state == entity::model::StreamInputConnectionInfo::State::Connected)
 									{
-										auto const talkerIdentification = entity::model::StreamIdentification{ entityID, streamOutputIndex };
-
-										// Connected to our talker
-										if (streamInputNode.dynamicModel->connectionInfo.talkerStream == talkerIdentification)
+										// Check against all the Talker's Output Streams
+										for (auto const& [streamOutputIndex, streamOutputNode] : talkerConfigurationNode.streamOutputs)
 										{
-											// We want to build an accurate list of connections, based on the known listeners (already advertised only, the other ones will update once ready to advertise themselves)
-											{
-												// Add this listener to our list of connected entities
-												controlledEntity.addStreamOutputConnection(streamOutputIndex, { listenerEntityID, streamIndex });
-												// Do not trigger onStreamOutputConnectionsChanged notification, we are just about to advertise the entity
-											}
+											auto const talkerIdentification = entity::model::StreamIdentification{ talkerEntityID, streamOutputIndex };
 
-											// Check for Latency Error (if the Listener was advertised before this Talker, it couldn't check Talker's PresentationTime, so do it now)
-											if (streamOutputNode.dynamicModel && streamOutputNode.dynamicModel->streamDynamicInfo && streamInputNode.dynamicModel->streamDynamicInfo)
+											// Connected to our talker
+											if (streamInputNode.dynamicModel->connectionInfo.talkerStream == talkerIdentification)
 											{
-												if ((*streamInputNode.dynamicModel->streamDynamicInfo).msrpAccumulatedLatency > (*streamOutputNode.dynamicModel->streamDynamicInfo).msrpAccumulatedLatency)
+												// We want to build an accurate list of connections, based on the known listeners (already advertised only, the other ones will update once ready to advertise themselves)
+												{
+													// Add this listener to our list of connected entities
+													auto const added = talkerEntity->addStreamOutputConnection(streamOutputIndex, { listenerEntityID, streamIndex });
+													// Do not trigger onStreamOutputConnectionsChanged notification if we are just about to advertise the entity (only if the processing was deferred)
+													if (added && talkerEntity->wasAdvertised())
+													{
+														notifyObserversMethod<Controller::Observer>(&Controller::Observer::onStreamOutputConnectionsChanged, this, talkerEntity.get(), streamOutputIndex, talkerEntity->getStreamOutputConnections(streamOutputIndex));
+													}
+												}
+
+												// Check for Latency Error (if the Listener was advertised before this Talker, it couldn't check Talker's PresentationTime, so do it now)
+												if (streamOutputNode.dynamicModel && streamOutputNode.dynamicModel->streamDynamicInfo && streamInputNode.dynamicModel->streamDynamicInfo)
 												{
-													updateStreamInputLatency(listenerEntity, streamIndex, true);
+													if ((*streamInputNode.dynamicModel->streamDynamicInfo).msrpAccumulatedLatency > (*streamOutputNode.dynamicModel->streamDynamicInfo).msrpAccumulatedLatency)
+													{
+														updateStreamInputLatency(listenerEntity, streamIndex, true);
+													}
 												}
 											}
 										}
@@ -3063,17 +3404,12 @@ void ControllerImpl::onPreAdvertiseEntity(ControlledEntityImpl& controlledEntity
 								}
 							}
 						}
+						catch (...)
+						{
+							AVDECC_ASSERT(false, "Unexpected exception");
+						}
 					}
-					catch (...)
-					{
-						AVDECC_ASSERT(false, "Unexpected exception");
-					}
-				}
-			}
-		}
-		catch (...)
-		{
-			AVDECC_ASSERT(false, "Unexpected exception");
+				});
 		}
 	}
 
@@ -3086,61 +3422,92 @@ void ControllerImpl::onPreAdvertiseEntity(ControlledEntityImpl& controlledEntity
 		{
 			auto const& listenerConfigurationNode = controlledEntity.getCurrentConfigurationNode();
 
-			// Lock to protect _controlledEntities
-			auto const lg = std::lock_guard{ _lock };
-
 			// Process all our input streams that are connected to another talker
 			for (auto const& [streamIndex, streamInputNode] : listenerConfigurationNode.streamInputs)
 			{
-				auto isOverLatency = false;
-
-				if (streamInputNode.dynamicModel)
+				// If the Stream is Connected, search for the Talker we are connected to
+				if (streamInputNode.dynamicModel && streamInputNode.dynamicModel->connectionInfo.state == entity::model::StreamInputConnectionInfo::State::Connected)
 				{
-					// If the Stream is Connected, search for the Talker we are connected to
-					if (streamInputNode.dynamicModel->connectionInfo.state == entity::model::StreamInputConnectionInfo::State::Connected)
+					auto const talkerStream = streamInputNode.dynamicModel->connectionInfo.talkerStream;
+
+					// Don't process self
+					if (talkerStream.entityID == entityID)
 					{
-						auto const talkerEntityID = streamInputNode.dynamicModel->connectionInfo.talkerStream.entityID;
+						continue;
+					}
 
-						if (auto const entityIt = _controlledEntities.find(talkerEntityID); entityIt != _controlledEntities.end())
+					runWithControlledEntityImplGuards({ entityID, talkerStream.entityID },
+						[this, isVirtualEntity, streamIndex = streamIndex, talkerStream](ControlledEntityImplGuards& entities)
 						{
-							auto& talkerEntity = *(entityIt->second);
+							auto& listenerEntityGuard = entities[0];
+							auto& talkerEntityGuard = entities[1];
 
-							// Don't process self, not yet advertised entities, nor different virtual/physical kind
-							if (talkerEntityID == entityID || !talkerEntity.wasAdvertised() || isVirtualEntity != talkerEntity.isVirtual())
+							// The Listener might have gone offline if the processing was deferred
+							if (!listenerEntityGuard)
 							{
-								continue;
+								return;
 							}
+							auto& listenerEntity = *listenerEntityGuard;
 
-							auto const talkerStreamIndex = streamInputNode.dynamicModel->connectionInfo.talkerStream.streamIndex;
-
-							// We want to inform the talker we are connected to (already advertised only, the other ones will update once ready to advertise themselves)
-							{
-								talkerEntity.addStreamOutputConnection(talkerStreamIndex, { entityID, streamIndex });
-								notifyObserversMethod<Controller::Observer>(&Controller::Observer::onStreamOutputConnectionsChanged, this, &talkerEntity, talkerStreamIndex, talkerEntity.getStreamOutputConnections(talkerStreamIndex));
-							}
-
-							// Check for Latency Error (if the TalkerEntity was not advertised when this listener was enumerating, it couldn't check Talker's PresentationTime, so do it now)
 							try
 							{
-								auto const& talkerStreamOutputNode = talkerEntity.getStreamOutputNode(talkerEntity.getCurrentConfigurationIndex(), talkerStreamIndex);
-								if (talkerStreamOutputNode.dynamicModel && talkerStreamOutputNode.dynamicModel->streamDynamicInfo && streamInputNode.dynamicModel->streamDynamicInfo)
+								// The Listener might have changed if the processing was deferred
+								auto const& listenerStreamInputNode = listenerEntity.getStreamInputNode(listenerEntity.getCurrentConfigurationIndex(), streamIndex);
+								if (!listenerStreamInputNode.dynamicModel || listenerStreamInputNode.dynamicModel->connectionInfo.state != entity::model::StreamInputConnectionInfo::State::Connected || listenerStreamInputNode.dynamicModel->connectionInfo.talkerStream != talkerStream)
 								{
-									if ((*streamInputNode.dynamicModel->streamDynamicInfo).msrpAccumulatedLatency > (*talkerStreamOutputNode.dynamicModel->streamDynamicInfo).msrpAccumulatedLatency)
+									return;
+								}
+
+								auto isOverLatency = false;
+
+								if (talkerEntityGuard)
+								{
+									auto& talkerEntity = *talkerEntityGuard;
+
+									// Don't process not yet advertised entities, nor different virtual/physical kind
+									if (!talkerEntity.wasAdvertised() || isVirtualEntity != talkerEntity.isVirtual())
+									{
+										return;
+									}
+
+									// We want to inform the talker we are connected to (already advertised only, the other ones will update once ready to advertise themselves)
 									{
-										isOverLatency = true;
+										talkerEntity.addStreamOutputConnection(talkerStream.streamIndex, { listenerEntity.getEntity().getEntityID(), streamIndex });
+										notifyObserversMethod<Controller::Observer>(&Controller::Observer::onStreamOutputConnectionsChanged, this, &talkerEntity, talkerStream.streamIndex, talkerEntity.getStreamOutputConnections(talkerStream.streamIndex));
+									}
+
+									// Check for Latency Error (if the TalkerEntity was not advertised when this listener was enumerating, it couldn't check Talker's PresentationTime, so do it now)
+									try
+									{
+										auto const& talkerStreamOutputNode = talkerEntity.getStreamOutputNode(talkerEntity.getCurrentConfigurationIndex(), talkerStream.streamIndex);
+										if (talkerStreamOutputNode.dynamicModel && talkerStreamOutputNode.dynamicModel->streamDynamicInfo && listenerStreamInputNode.dynamicModel->streamDynamicInfo)
+										{
+											if ((*listenerStreamInputNode.dynamicModel->streamDynamicInfo).msrpAccumulatedLatency > (*talkerStreamOutputNode.dynamicModel->streamDynamicInfo).msrpAccumulatedLatency)
+											{
+												isOverLatency = true;
+											}
+										}
+									}
+									catch (ControlledEntity::Exception const&)
+									{
+										// Ignore Exception
 									}
 								}
+
+								// We want to always set the Stream Input Latency flag
+								updateStreamInputLatency(listenerEntity, streamIndex, isOverLatency);
 							}
 							catch (ControlledEntity::Exception const&)
 							{
 								// Ignore Exception
 							}
-						}
-					}
+						});
+				}
+				else
+				{
+					// We want to always set the Stream Input Latency flag
+					updateStreamInputLatency(controlledEntity, streamIndex, false);
 				}
-
-				// We want to always set the Stream Input Latency flag
-				updateStreamInputLatency(controlledEntity, streamIndex, isOverLatency);
 			}
 		}
 		catch (...)
@@ -3187,17 +3554,20 @@ void ControllerImpl::onPreUnadvertiseEntity(ControlledEntityImpl& controlledEnti
 					// If the Stream is Connected, search for the Talker we are connected to
 					if (streamInputNode.dynamicModel->connectionInfo.state == entity::model::StreamInputConnectionInfo::State::Connected)
 					{
-						// Take a "scoped locked" shared copy of the ControlledEntity
-						auto talkerEntity = getControlledEntityImplGuard(streamInputNode.dynamicModel->connectionInfo.talkerStream.entityID, true);
+						auto const talkerStream = streamInputNode.dynamicModel->connectionInfo.talkerStream;
+						runWithControlledEntityImplGuards({ talkerStream.entityID },
+							[this, isVirtualEntity, listenerStream = entity::model::StreamIdentification{ entityID, streamIndex }, talkerStream](ControlledEntityImplGuards& entities)
+							{
+								auto& talkerEntity = entities[0];
 
-						// Only process same virtual/physical kind
-						if (talkerEntity && isVirtualEntity == talkerEntity->isVirtual())
-						{
-							auto& talker = *talkerEntity;
-							auto const talkerStreamIndex = streamInputNode.dynamicModel->connectionInfo.talkerStream.streamIndex;
-							talker.delStreamOutputConnection(talkerStreamIndex, { entityID, streamIndex });
-							notifyObserversMethod<Controller::Observer>(&Controller::Observer::onStreamOutputConnectionsChanged, this, &talker, talkerStreamIndex, talker.getStreamOutputConnections(talkerStreamIndex));
-						}
+								// Only process advertised entities of the same virtual/physical kind
+								if (talkerEntity && talkerEntity->wasAdvertised() && isVirtualEntity == talkerEntity->isVirtual())
+								{
+									auto& talker = *talkerEntity;
+									talker.delStreamOutputConnection(talkerStream.streamIndex, listenerStream);
+									notifyObserversMethod<Controller::Observer>(&Controller::Observer::onStreamOutputConnectionsChanged, this, &talker, talkerStream.streamIndex, talker.getStreamOutputConnections(talkerStream.streamIndex));
+								}
+							});
 					}
 				}
 			}
@@ -3452,7 +3822,7 @@ bool ControllerImpl::processRegisterUnsolFailureStatus(entity::ControllerEntity:
 			return true;
 		case FailureAction::NotSupported:
 			// Remove "Milan compatibility" as device does not support mandatory command
-			if (entity->getCompatibilityFlags().test(ControlledEntity::CompatibilityFlag::Milan))
+			if (mayBeMilanCompatible(*entity))
 			{
 				LOG_CONTROLLER_WARN(entityID, "Milan mandatory command not supported by the entity: REGISTER_UNSOLICITED_NOTIFICATION");
 				removeCompatibilityFlag(this, *entity, ControlledEntity::CompatibilityFlag::Milan);
@@ -3473,7 +3843,7 @@ bool ControllerImpl::processRegisterUnsolFailureStatus(entity::ControllerEntity:
 				if (action == FailureAction::TimedOut)
 				{
 					// Remove "Milan compatibility" as device does not respond to mandatory command
-					if (entity->getCompatibilityFlags().test(ControlledEntity::CompatibilityFlag::Milan))
+					if (mayBeMilanCompatible(*entity))
 					{
 						LOG_CONTROLLER_WARN(entityID, "Too many timeouts for Milan mandatory command: REGISTER_UNSOLICITED_NOTIFICATION");
 						removeCompatibilityFlag(this, *entity, ControlledEntity::CompatibilityFlag::Milan);
@@ -3612,7 +3982,7 @@ bool ControllerImpl::processGetStaticModelFailureStatus(entity::ControllerEntity
 			[[fallthrough]];
 		case FailureAction::NotSupported:
 			// Remove "Milan compatibility" as device does not support mandatory descriptor
-			if (entity->getCompatibilityFlags().test(ControlledEntity::CompatibilityFlag::Milan))
+			if (mayBeMilanCompatible(*entity))
 			{
 				LOG_CONTROLLER_WARN(entityID, "Milan mandatory descriptor not supported by the entity: {}", entity::model::descriptorTypeToString(descriptorType));
 				removeCompatibilityFlag(this, *entity, ControlledEntity::CompatibilityFlag::Milan);
@@ -3633,7 +4003,7 @@ bool ControllerImpl::processGetStaticModelFailureStatus(entity::ControllerEntity
 				if (action == FailureAction::TimedOut)
 				{
 					// Remove "Milan compatibility" as device does not respond to mandatory command
-					if (entity->getCompatibilityFlags().test(ControlledEntity::CompatibilityFlag::Milan))
+					if (mayBeMilanCompatible(*entity))
 					{
 						LOG_CONTROLLER_WARN(entityID, "Too many timeouts for Milan mandatory descriptor: {}", entity::model::descriptorTypeToString(descriptorType));
 						removeCompatibilityFlag(this, *entity, ControlledEntity::CompatibilityFlag::Milan);
@@ -4002,6 +4372,9 @@ bool ControllerImpl::processGetDescriptorDynamicInfoFailureStatus(entity::Contro
 			entity->setIgnoreCachedEntityModel();
 			entity->clearAllExpectedDescriptorDynamicInfo();
 			entity->addEnumerationStep(ControlledEntityImpl::EnumerationStep::GetStaticModel);
+			// Dynamic information may have been prefetched using the cached model, get it again once the StaticModel has been enumerated
+			entity->clearAllExpectedDynamicInfo();
+			entity->addEnumerationStep(ControlledEntityImpl::EnumerationStep::GetDynamicInfo);
 			LOG_CONTROLLER_ERROR(entityID, "Failed to use cached EntityModel (too many DescriptorDynamic query retries), falling back to full StaticModel enumeration");
 		}
 		return true;
@@ -4211,27 +4584,31 @@ void ControllerImpl::handleTalkerStreamStateNotification(entity::model::StreamId
 	// Check if Talker is valid and online so we can update the StreamConnections
 	if (talkerStream.entityID)
 	{
-		// Take a "scoped locked" shared copy of the ControlledEntity
-		auto talkerEntity = getControlledEntityImplGuard(talkerStream.entityID, true);
-
-		// Only process talkers that are already advertised. The connections list will be completed by the talker right before advertising.
-		if (talkerEntity)
-		{
-			// Update our internal cache
-			auto shouldNotify{ false }; // Only notify if we actually changed the connections list
-			if (isConnected)
+		// We might be holding the Listener
+		runWithControlledEntityImplGuards({ talkerStream.entityID },
+			[this, talkerStream, listenerStream, isConnected](ControlledEntityImplGuards& entities)
 			{
-				shouldNotify = talkerEntity->addStreamOutputConnection(talkerStream.streamIndex, listenerStream);
-			}
-			else
-			{
-				shouldNotify = talkerEntity->delStreamOutputConnection(talkerStream.streamIndex, listenerStream);
-			}
-			if (shouldNotify)
-			{
-				notifyObserversMethod<Controller::Observer>(&Controller::Observer::onStreamOutputConnectionsChanged, this, talkerEntity.get(), talkerStream.streamIndex, talkerEntity->getStreamOutputConnections(talkerStream.streamIndex));
-			}
-		}
+				auto& talkerEntity = entities[0];
+
+				// Only process talkers that are already advertised. The connections list will be completed by the talker right before advertising.
+				if (talkerEntity && talkerEntity->wasAdvertised())
+				{
+					// Update our internal cache
+					auto shouldNotify{ false }; // Only notify if we actually changed the connections list
+					if (isConnected)
+					{
+						shouldNotify = talkerEntity->addStreamOutputConnection(talkerStream.streamIndex, listenerStream);
+					}
+					else
+					{
+						shouldNotify = talkerEntity->delStreamOutputConnection(talkerStream.streamIndex, listenerStream);
+					}
+					if (shouldNotify)
+					{
+						notifyObserversMethod<Controller::Observer>(&Controller::Observer::onStreamOutputConnectionsChanged, this, talkerEntity.get(), talkerStream.streamIndex, talkerEntity->getStreamOutputConnections(talkerStream.streamIndex));
+					}
+				}
+			});
 	}
 }
 
@@ -4247,9 +4624,118 @@ void ControllerImpl::addTalkerStreamConnection(ControlledEntityImpl* const talke
 }
 
 #ifdef ENABLE_AVDECC_FEATURE_JSON
-ControllerImpl::SharedControlledEntityImpl ControllerImpl::loadControlledEntityFromJson(json const& object, entity::model::jsonSerializer::Flags const flags, ControlledEntityImpl::LockInformation::SharedPointer const& lockInfo)
+std::tuple<avdecc::jsonSerializer::SerializationError, std::string> ControllerImpl::streamAllControlledEntitiesAsJson(std::string const& filePath, entity::model::jsonSerializer::Flags const flags, std::string const& dumpSource, bool const continueOnError) const noexcept
 {
-	auto controlledEntity = createControlledEntityFromJson(object, flags, lockInfo);
+	// Indentation depth of an entity in the document (root object > entities array)
+	static constexpr auto EntityDepth = size_t{ 2u };
+
+	// Try to open the output file
+	auto const mode = std::ios::binary | std::ios::out;
+	auto ofs = std::ofstream{ filePath, mode };
+
+	// Failed to open file to writting
+	if (!ofs.is_open())
+	{
+		return { avdecc::jsonSerializer::SerializationError::AccessDenied, std::strerror(errno) };
+	}
+
+	// Don't leave a partial file behind
+	auto const failed = [&ofs, &filePath](avdecc::jsonSerializer::SerializationError const error, std::string const& errorText) -> std::tuple<avdecc::jsonSerializer::SerializationError, std::string>
+	{
+		ofs.close();
+		std::remove(filePath.c_str());
+		return { error, errorText };
+	};
+
+	try
+	{
+		auto writer = avdecc::jsonSerializer::StreamWriter{ ofs };
+		writer.beginObject();
+
+		// Dump information of the dump itself
+		{
+			auto object = json{};
+			object[jsonSerializer::keyName::Controller_DumpVersion] = jsonSerializer::keyValue::Controller_DumpVersion;
+			object[jsonSerializer::keyName::Controller_Informative_DumpSource] = dumpSource;
+			writer.writeMembers(object);
+		}
+
+		// Lock to protect _controlledEntities
+		std::lock_guard<decltype(_lock)> const lg(_lock);
+
+		// Define a comparator operator for ControlledEntities as we want to dump entities ordered by EntityID
+		auto const entityComparator = [](ControlledEntityImpl const* const& lhs, ControlledEntityImpl const* const& rhs)
+		{
+			return lhs->getEntity().getEntityID() < rhs->getEntity().getEntityID();
+		};
+		auto entities = std::set<ControlledEntityImpl const*, decltype(entityComparator)>{ entityComparator };
+
+		// Process all known entities and add them to a sorted set
+		for (auto const& entityIt : _controlledEntities)
+		{
+			entities.insert(entityIt.second.get());
+		}
+
+		auto error = avdecc::jsonSerializer::SerializationError::NoError;
+		auto errorText = std::string{};
+		auto hasEntities = false;
+		// Entity text buffer, so that an entity failing to serialize is not partially written (reused for all entities)
+		auto entityStream = std::ostringstream{};
+		// Serialize all known entities, sorted by EntityID
+		for (auto const* const entity : entities)
+		{
+			entityStream.str(std::string{});
+
+			// Try to serialize
+			try
+			{
+				auto entityWriter = avdecc::jsonSerializer::StreamWriter{ entityStream, 4u, EntityDepth };
+				jsonSerializer::writeJsonObject(entityWriter, *entity, flags);
+			}
+			catch (avdecc::jsonSerializer::SerializationException const& e)
+			{
+				if (continueOnError)
+				{
+					error = avdecc::jsonSerializer::SerializationError::Incomplete;
+					errorText = e.what();
+					continue;
+				}
+				return failed(e.getError(), e.what());
+			}
+
+			// Only create the entities array if there is at least one entity
+			if (!hasEntities)
+			{
+				writer.writeKey(jsonSerializer::keyName::Controller_Entities);
+				writer.beginArray();
+				hasEntities = true;
+			}
+			writer.writeFormattedValue(entityStream.str());
+		}
+
+		if (hasEntities)
+		{
+			writer.endArray();
+		}
+		writer.endObject();
+		ofs << std::endl;
+
+		if (!ofs.good())
+		{
+			return failed(avdecc::jsonSerializer::SerializationError::AccessDenied, "Error writing JSON file");
+		}
+
+		return { error, errorText };
+	}
+	catch (json::exception const& e)
+	{
+		return failed(avdecc::jsonSerializer::SerializationError::InternalError, e.what());
+	}
+}
+
+ControllerImpl::SharedControlledEntityImpl ControllerImpl::loadControlledEntityFromJson(json const& object, entity::model::jsonSerializer::Flags const flags)
+{
+	auto controlledEntity = createControlledEntityFromJson(object, flags);
 
 	auto& entity = *controlledEntity;
 
@@ -4323,7 +4809,7 @@ std::tuple<avdecc::jsonSerializer::DeserializationError, std::string> Controller
 	return { avdecc::jsonSerializer::DeserializationError::NoError, "" };
 }
 
-ControllerImpl::SharedControlledEntityImpl ControllerImpl::createControlledEntityFromJson(json const& object, entity::model::jsonSerializer::Flags const flags, ControlledEntityImpl::LockInformation::SharedPointer const& lockInfo)
+ControllerImpl::SharedControlledEntityImpl ControllerImpl::createControlledEntityFromJson(json const& object, entity::model::jsonSerializer::Flags const flags)
 {
 	try
 	{
@@ -4354,7 +4840,7 @@ ControllerImpl::SharedControlledEntityImpl ControllerImpl::createControlledEntit
 			}
 		}
 
-		auto controlledEntity = std::make_shared<ControlledEntityImpl>(entity::Entity{ commonInfo, intfcsInfo }, lockInfo, true);
+		auto controlledEntity = std::make_shared<ControlledEntityImpl>(entity::Entity{ commonInfo, intfcsInfo }, std::make_shared<ControlledEntityImpl::LockInformation>(), true);
 		auto& entity = *controlledEntity;
 
 		// Start Enumeration timer
@@ -4416,7 +4902,7 @@ ControllerImpl::SharedControlledEntityImpl ControllerImpl::createControlledEntit
 	}
 }
 
-std::tuple<avdecc::jsonSerializer::DeserializationError, std::string, std::vector<ControllerImpl::SharedControlledEntityImpl>> ControllerImpl::deserializeJsonNetworkState(std::string const& filePath, entity::model::jsonSerializer::Flags const flags, bool const continueOnError, ControlledEntityImpl::LockInformation::SharedPointer const& lockInfo) noexcept
+std::tuple<avdecc::jsonSerializer::DeserializationError, std::string, std::vector<ControllerImpl::SharedControlledEntityImpl>> ControllerImpl::deserializeJsonNetworkState(std::string const& filePath, entity::model::jsonSerializer::Flags const flags, bool const continueOnError) noexcept
 {
 	// Try to open the input file
 	auto const mode = std::ios::binary | std::ios::in;
@@ -4463,7 +4949,108 @@ std::tuple<avdecc::jsonSerializer::DeserializationError, std::string, std::vecto
 		{
 			try
 			{
-				auto controlledEntity = loadControlledEntityFromJson(entityObject, flags, lockInfo);
+				auto controlledEntity = loadControlledEntityFromJson(entityObject, flags);
+				controlledEntities.push_back(std::move(controlledEntity));
+			}
+			catch (avdecc::jsonSerializer::DeserializationException const& e)
+			{
+				if (continueOnError)
+				{
+					error = avdecc::jsonSerializer::DeserializationError::Incomplete;
+					errorText = e.what();
+					continue;
+				}
+				return { e.getError(), e.what(), {} };
+			}
+			// Catch json and std exceptions thrown by loadControlledEntityFromJson
+			catch (std::exception const& e)
+			{
+				if (continueOnError)
+				{
+					error = avdecc::jsonSerializer::DeserializationError::Incomplete;
+					errorText = e.what();
+					continue;
+				}
+				throw; // Rethrow
+			}
+		}
+	}
+	catch (json::type_error const& e)
+	{
+		return { avdecc::jsonSerializer::DeserializationError::InvalidValue, e.what(), {} };
+	}
+	catch (json::parse_error const& e)
+	{
+		return { avdecc::jsonSerializer::DeserializationError::ParseError, e.what(), {} };
+	}
+	catch (json::out_of_range const& e)
+	{
+		return { avdecc::jsonSerializer::DeserializationError::MissingKey, e.what(), {} };
+	}
+	catch (json::other_error const& e)
+	{
+		if (e.id == 555)
+		{
+			return { avdecc::jsonSerializer::DeserializationError::InvalidKey, e.what(), {} };
+		}
+		else
+		{
+			return { avdecc::jsonSerializer::DeserializationError::OtherError, e.what(), {} };
+		}
+	}
+	catch (json::exception const& e)
+	{
+		return { avdecc::jsonSerializer::DeserializationError::OtherError, e.what(), {} };
+	}
+	catch (std::invalid_argument const& e)
+	{
+		return { avdecc::jsonSerializer::DeserializationError::InvalidValue, e.what(), {} };
+	}
+
+	return std::make_tuple(error, errorText, controlledEntities);
+}
+
+std::tuple<avdecc::jsonSerializer::DeserializationError, std::string, std::vector<ControllerImpl::SharedControlledEntityImpl>> ControllerImpl::deserializeSnapshotNetworkState(std::string const& filePath, entity::model::jsonSerializer::Flags const flags, bool const continueOnError) noexcept
+{
+	// Try to open the input file
+	auto const mode = std::ios::binary | std::ios::in;
+	auto ifs = std::ifstream{ filePath, mode };
+
+	// Failed to open file for reading
+	if (!ifs.is_open())
+	{
+		return { avdecc::jsonSerializer::DeserializationError::AccessDenied, std::strerror(errno), {} };
+	}
+
+	auto error = avdecc::jsonSerializer::DeserializationError::NoError;
+	auto errorText = std::string{};
+	auto controlledEntities = std::vector<SharedControlledEntityImpl>{};
+
+	try
+	{
+		// Object and buffer reused for all records, only a single entity is held in memory at a time
+		auto object = json{};
+		auto buffer = std::vector<std::uint8_t>{};
+
+		snapshot::readHeader(ifs);
+
+		// Read information of the dump itself
+		if (!snapshot::readRecord(ifs, object, buffer))
+		{
+			return { avdecc::jsonSerializer::DeserializationError::MissingKey, "Missing snapshot dump information", {} };
+		}
+		auto const dumpVersion = object.at(jsonSerializer::keyName::Controller_DumpVersion).get<decltype(jsonSerializer::keyValue::Controller_DumpVersion)>();
+		if (dumpVersion != jsonSerializer::keyValue::Controller_DumpVersion)
+		{
+			return { avdecc::jsonSerializer::DeserializationError::UnsupportedDumpVersion, std::string("Unsupported dump version: ") + std::to_string(dumpVersion), {} };
+		}
+
+		// Read entities, one at a time
+		while (snapshot::readRecord(ifs, object, buffer))
+		{
+			try
+			{
+				auto controlledEntity = loadControlledEntityFromJson(object, flags);
 				controlledEntities.push_back(std::move(controlledEntity));
 			}
 			catch (avdecc::jsonSerializer::DeserializationException const& e)
@@ -4489,6 +5076,10 @@ std::tuple<avdecc::jsonSerializer::DeserializationError, std::string, std::vecto
 			}
 		}
 	}
+	catch (avdecc::jsonSerializer::DeserializationException const& e)
+	{
+		return { e.getError(), e.what(), {} };
+	}
 	catch (json::type_error const& e)
 	{
 		return { avdecc::jsonSerializer::DeserializationError::InvalidValue, e.what(), {} };
@@ -4524,7 +5115,7 @@ std::tuple<avdecc::jsonSerializer::DeserializationError, std::string, std::vecto
 	return std::make_tuple(error, errorText, controlledEntities);
 }
 
-std::tuple<avdecc::jsonSerializer::DeserializationError, std::string, ControllerImpl::SharedControlledEntityImpl> ControllerImpl::deserializeJson(std::string const& filePath, entity::model::jsonSerializer::Flags const flags, ControlledEntityImpl::LockInformation::SharedPointer const& lockInfo) noexcept
+std::tuple<avdecc::jsonSerializer::DeserializationError, std::string, ControllerImpl::SharedControlledEntityImpl> ControllerImpl::deserializeJson(std::string const& filePath, entity::model::jsonSerializer::Flags const flags) noexcept
 {
 	// Try to open the input file
 	auto const mode = std::ios::binary | std::ios::in;
@@ -4580,7 +5171,7 @@ std::tuple<avdecc::jsonSerializer::DeserializationError, std::string, Controller
 	// Try to deserialize
 	try
 	{
-		auto controlledEntity = loadControlledEntityFromJson(object, flags, lockInfo);
+		auto controlledEntity = loadControlledEntityFromJson(object, flags);
 		return { avdecc::jsonSerializer::DeserializationError::NoError, "", controlledEntity };
 	}
 	catch (avdecc::jsonSerializer::DeserializationException const& e)
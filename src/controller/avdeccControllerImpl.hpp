@@ -31,6 +31,7 @@
 #endif // ENABLE_AVDECC_FEATURE_JSON
 
 #include "avdeccControlledEntityImpl.hpp"
+#include "avdeccEnumerationScheduler.hpp"
 
 #include <string>
 #include <unordered_map>
@@ -42,6 +43,7 @@
 #include <deque>
 #include <tuple>
 #include <set>
+#include <vector>
 
 namespace la
 {
@@ -83,8 +85,15 @@ private:
 	virtual bool discoverRemoteEntities() const noexcept override;
 	virtual bool discoverRemoteEntity(UniqueIdentifier const entityID) const noexcept override;
 	virtual void setAutomaticDiscoveryDelay(std::chrono::milliseconds const delay) noexcept override;
+	virtual bool setMaxAecpInflightCommands(std::uint32_t const maxInflightCommands) noexcept override;
+	virtual void setMaxConcurrentEnumerations(std::uint32_t const maxConcurrentEnumerations) noexcept override;
+	virtual void setEnumerationPriorities(std::vector<UniqueIdentifier> const& priorities) noexcept override;
+	virtual void enableDeltaEnumeration(std::chrono::milliseconds const retentionDuration) noexcept override;
+	virtual void disableDeltaEnumeration() noexcept override;
 	virtual void enableEntityModelCache() noexcept override;
 	virtual void disableEntityModelCache() noexcept override;
+	virtual bool enableEntityModelCachePersistence(std::string const& directoryPath) noexcept override;
+	virtual void disableEntityModelCachePersistence() noexcept override;
 	virtual void enableFullStaticEntityModelEnumeration() noexcept override;
 	virtual void disableFullStaticEntityModelEnumeration() noexcept override;
 
@@ -146,6 +155,8 @@ private:
 	virtual void getListenerStreamState(entity::model::StreamIdentification const& listenerStream, GetListenerStreamStateHandler const& handler) const noexcept override;
 
 	virtual ControlledEntityGuard getControlledEntityGuard(UniqueIdentifier const entityID) const noexcept override;
+	virtual std::vector<ControlledEntityGuard> getControlledEntityGuards(std::vector<UniqueIdentifier> const& entityIDs) const noexcept override;
+	virtual SharedControlledEntitySnapshot getControlledEntitySnapshot(UniqueIdentifier const entityID) const noexcept override;
 
 	virtual void requestExclusiveAccess(UniqueIdentifier const entityID, ExclusiveAccessToken::AccessType const type, RequestExclusiveAccessResultHandler&& handler) const noexcept override;
 
@@ -155,10 +166,12 @@ private:
 	/* Model serialization methods */
 	virtual std::tuple<avdecc::jsonSerializer::SerializationError, std::string> serializeAllControlledEntitiesAsJson(std::string const& filePath, entity::model::jsonSerializer::Flags const flags, std::string const& dumpSource, bool const continueOnError) const noexcept override;
 	virtual std::tuple<avdecc::jsonSerializer::SerializationError, std::string> serializeControlledEntityAsJson(UniqueIdentifier const entityID, std::string const& filePath, entity::model::jsonSerializer::Flags const flags, std::string const& dumpSource) const noexcept override;
+	virtual std::tuple<avdecc::jsonSerializer::SerializationError, std::string> serializeAllControlledEntitiesAsSnapshot(std::string const& filePath, entity::model::jsonSerializer::Flags const flags, std::string const& dumpSource, bool const continueOnError) const noexcept override;
 
 	/* Model deserialization methods */
 	virtual std::tuple<avdecc::jsonSerializer::DeserializationError, std::string> loadVirtualEntitiesFromJsonNetworkState(std::string const& filePath, entity::model::jsonSerializer::Flags const flags, bool const continueOnError) noexcept override;
 	virtual std::tuple<avdecc::jsonSerializer::DeserializationError, std::string> loadVirtualEntityFromJson(std::string const& filePath, entity::model::jsonSerializer::Flags const flags) noexcept override;
+	virtual std::tuple<avdecc::jsonSerializer::DeserializationError, std::string> loadVirtualEntitiesFromSnapshot(std::string const& filePath, entity::model::jsonSerializer::Flags const flags, bool const continueOnError) noexcept override;
 
 	/* ************************************************************ */
 	/* Result handlers                                              */
@@ -297,6 +310,7 @@ private:
 	void updateEntity(ControlledEntityImpl& controlledEntity, entity::Entity const& entity) const noexcept;
 	static void addCompatibilityFlag(ControllerImpl const* const controller, ControlledEntityImpl& controlledEntity, ControlledEntity::CompatibilityFlag const flag) noexcept;
 	static void removeCompatibilityFlag(ControllerImpl const* const controller, ControlledEntityImpl& controlledEntity, ControlledEntity::CompatibilityFlag const flag) noexcept;
+	static bool mayBeMilanCompatible(ControlledEntityImpl const& controlledEntity) noexcept; // Entity is Milan compatible, or its MilanInfo has not been retrieved yet
 	void updateUnsolicitedNotificationsSubscription(ControlledEntityImpl& controlledEntity, bool const isSubscribed) const noexcept;
 	void updateAcquiredState(ControlledEntityImpl& controlledEntity, model::AcquireState const acquireState, UniqueIdentifier const owningEntity) const noexcept;
 	void updateLockedState(ControlledEntityImpl& controlledEntity, model::LockState const lockState, UniqueIdentifier const lockingEntity) const noexcept;
@@ -428,6 +442,13 @@ private:
 			}
 		}
 
+		// Constructor for an already locked entity, taking ownership of the lock
+		ControlledEntityImplGuard(SharedControlledEntityImpl&& entity, std::adopt_lock_t)
+			: _controlledEntity(std::move(entity))
+			, _locked(_controlledEntity != nullptr)
+		{
+		}
+
 		// Destructor
 		~ControlledEntityImplGuard()
 		{
@@ -447,6 +468,8 @@ private:
 		{
 			if (_controlledEntity && _locked)
 			{
+				// Publish the updates made while the entity was locked (if any)
+				_controlledEntity->publishSnapshotIfDirty();
 				_controlledEntity->unlock();
 				_locked = false;
 			}
@@ -456,6 +479,9 @@ private:
 		bool _locked{ false };
 	};
 
+	using ControlledEntityImplGuards = std::vector<ControlledEntityImplGuard>;
+	using ControlledEntityImplGuardsHandler = std::function<void(ControlledEntityImplGuards& entities)>;
+
 	/** A guard around a ControlledEntityImpl that guarantees it won't be destroyed while the Guard is alive. All access to the underlying object is blocked. */
 	class SharedControlledEntityImplHolder final
 	{
@@ -498,25 +524,20 @@ private:
 		SharedControlledEntityImpl _controlledEntity{ nullptr };
 	};
 
-	/** A guard around a ControllerImpl that guarantees the lock on all the ControlledEntities will be released during the lifetime of this object. When destroyed, all the locked count will be restored. */
+	/** A guard around a ControllerImpl that guarantees the locks on all the ControlledEntities held by the current thread will be released during the lifetime of this object. When destroyed, all the locked counts will be restored. */
 	class ControlledEntityUnlockerGuard final
 	{
 	public:
-		ControlledEntityUnlockerGuard(ControllerImpl const& controller) noexcept
-			: _sharedLockInformation(controller._entitiesSharedLockInformation)
-			, _wasLocked(_sharedLockInformation->isSelfLocked())
+		ControlledEntityUnlockerGuard(ControllerImpl const& /*controller*/) noexcept
+			: _selfLocks(ControlledEntityImpl::LockInformation::unlockAllSelfLocked())
 		{
-			if (_wasLocked)
-			{
-				_lockedCount = _sharedLockInformation->unlockAll();
-			}
 		}
 
 		~ControlledEntityUnlockerGuard() noexcept
 		{
-			if (_wasLocked)
+			if (!_selfLocks.empty())
 			{
-				_sharedLockInformation->lockAll(_lockedCount);
+				ControlledEntityImpl::LockInformation::lockAllSelfLocked(std::move(_selfLocks));
 			}
 		}
 
@@ -529,9 +550,7 @@ private:
 		ControlledEntityUnlockerGuard& operator=(ControlledEntityUnlockerGuard const&) = delete;
 
 	private:
-		ControlledEntityImpl::LockInformation::SharedPointer _sharedLockInformation{ nullptr };
-		bool _wasLocked{ false };
-		std::uint32_t _lockedCount{ 0u };
+		ControlledEntityImpl::LockInformation::SelfLocks _selfLocks{};
 	};
 
 	/* ************************************************************ */
@@ -567,6 +586,11 @@ private:
 		std::chrono::time_point<std::chrono::system_clock> expireTime{};
 		entity::model::ControlIndex controlIndex{};
 	};
+	struct OfflineEntity
+	{
+		SharedControlledEntityImpl controlledEntity{};
+		std::chrono::time_point<std::chrono::steady_clock> offlineTime{};
+	};
 
 	/* ************************************************************ */
 	/* Private methods                                              */
@@ -590,6 +614,13 @@ private:
 	void getStaticModel(ControlledEntityImpl* const entity) noexcept;
 	void getDynamicInfo(ControlledEntityImpl* const entity) noexcept;
 	void getDescriptorDynamicInfo(ControlledEntityImpl* const entity) noexcept;
+	void startEnumeration(ControlledEntityImpl* const entity) noexcept;
+	void startAdmittedEnumerations(EnumerationScheduler::EntityIDs const& entityIDs) noexcept;
+	void onEnumerationEnded(ControlledEntityImpl& controlledEntity) noexcept;
+	void setFatalEnumerationError(ControlledEntityImpl& controlledEntity) noexcept;
+	void retainOfflineEntity(SharedControlledEntityImpl const& controlledEntity) noexcept; // Keeps an entity that went offline (if delta enumeration is enabled), so its model can be reused if it comes back online shortly
+	std::shared_ptr<entity::model::EntityTree const> takeOfflineEntityTree(entity::Entity const& entity) noexcept; // Returns the static model of the retained entity that is coming back online, if its ADP information shows a plausible continuation
+	void releaseExpiredOfflineEntities(std::chrono::time_point<std::chrono::steady_clock> const now) noexcept; // _lock must be held
 	void checkEnumerationSteps(ControlledEntityImpl* const entity) noexcept;
 	template<entity::model::DescriptorType StreamPortType>
 	entity::model::AudioMappings validateMappings(ControlledEntityImpl& controlledEntity, entity::model::StreamPortIndex const streamPortIndex, entity::model::AudioMappings const& mappings) const noexcept
@@ -642,11 +673,13 @@ private:
 	void clearTalkerStreamConnections(ControlledEntityImpl* const talkerEntity, entity::model::StreamIndex const talkerStreamIndex) const noexcept;
 	void addTalkerStreamConnection(ControlledEntityImpl* const talkerEntity, entity::model::StreamIndex const talkerStreamIndex, entity::model::StreamIdentification const& listenerStream) const noexcept;
 #ifdef ENABLE_AVDECC_FEATURE_JSON
-	static SharedControlledEntityImpl loadControlledEntityFromJson(nlohmann::json const& object, entity::model::jsonSerializer::Flags const flags, ControlledEntityImpl::LockInformation::SharedPointer const& lockInfo);
+	std::tuple<avdecc::jsonSerializer::SerializationError, std::string> streamAllControlledEntitiesAsJson(std::string const& filePath, entity::model::jsonSerializer::Flags const flags, std::string const& dumpSource, bool const continueOnError) const noexcept;
+	static SharedControlledEntityImpl loadControlledEntityFromJson(nlohmann::json const& object, entity::model::jsonSerializer::Flags const flags);
 	std::tuple<avdecc::jsonSerializer::DeserializationError, std::string> registerVirtualControlledEntity(SharedControlledEntityImpl&& controlledEntity) noexcept;
-	static SharedControlledEntityImpl createControlledEntityFromJson(nlohmann::json const& object, entity::model::jsonSerializer::Flags const flags, ControlledEntityImpl::LockInformation::SharedPointer const& lockInfo); // Throws DeserializationException
-	static std::tuple<avdecc::jsonSerializer::DeserializationError, std::string, std::vector<SharedControlledEntityImpl>> deserializeJsonNetworkState(std::string const& filePath, entity::model::jsonSerializer::Flags const flags, bool const continueOnError, ControlledEntityImpl::LockInformation::SharedPointer const& lockInfo) noexcept;
-	static std::tuple<avdecc::jsonSerializer::DeserializationError, std::string, SharedControlledEntityImpl> deserializeJson(std::string const& filePath, entity::model::jsonSerializer::Flags const flags, ControlledEntityImpl::LockInformation::SharedPointer const& lockInfo) noexcept;
+	static SharedControlledEntityImpl createControlledEntityFromJson(nlohmann::json const& object, entity::model::jsonSerializer::Flags const flags); // Throws DeserializationException
+	static std::tuple<avdecc::jsonSerializer::DeserializationError, std::string, std::vector<SharedControlledEntityImpl>> deserializeJsonNetworkState(std::string const& filePath, entity::model::jsonSerializer::Flags const flags, bool const continueOnError) noexcept;
+	static std::tuple<avdecc::jsonSerializer::DeserializationError, std::string, std::vector<SharedControlledEntityImpl>> deserializeSnapshotNetworkState(std::string const& filePath, entity::model::jsonSerializer::Flags const flags, bool const continueOnError) noexcept;
+	static std::tuple<avdecc::jsonSerializer::DeserializationError, std::string, SharedControlledEntityImpl> deserializeJson(std::string const& filePath, entity::model::jsonSerializer::Flags const flags) noexcept;
 	static void setupDetachedVirtualControlledEntity(ControlledEntityImpl& entity) noexcept;
 #endif // ENABLE_AVDECC_FEATURE_JSON
 	entity::addressAccess::Tlv makeNextReadDeviceMemoryTlv(std::uint64_t const baseAddress, std::uint64_t const length, std::uint64_t const currentSize) const noexcept;
@@ -701,16 +734,25 @@ private:
 		return ControlledEntityImplGuard{ std::move(entity), locked };
 	}
 
+	/** Gets scoped references on several ControlledEntitiyImpl (in the same order than entityIDs, with an empty guard for the unknown ones), all locked at once in lock order without waiting for an entity while holding another one (same algorithm than std::lock). Should not be called while the current thread holds other entities (see runWithControlledEntityImplGuards) */
+	ControlledEntityImplGuards getControlledEntityImplGuards(std::vector<UniqueIdentifier> const& entityIDs, bool const onlyIfAdvertised = false) const noexcept;
+	/** Same as getControlledEntityImplGuards but never waits, returns std::nullopt if any of the entities is currently locked by another thread */
+	std::optional<ControlledEntityImplGuards> tryGetControlledEntityImplGuards(std::vector<UniqueIdentifier> const& entityIDs) const noexcept;
+	/** Calls the handler with the specified entities locked (see getControlledEntityImplGuards). If the current thread already holds other entities, it cannot wait for these ones (the thread holding them might be waiting for one of ours), so the handler is deferred until the current thread released all its entities, unless they can all be locked right away */
+	void runWithControlledEntityImplGuards(std::vector<UniqueIdentifier> const& entityIDs, ControlledEntityImplGuardsHandler const& handler) const noexcept;
+
 	/* ************************************************************ */
 	/* Private members                                              */
 	/* ************************************************************ */
 	mutable std::mutex _lock{}; // A mutex to protect all sensitive data members
-	ControlledEntityImpl::LockInformation::SharedPointer _entitiesSharedLockInformation{ std::make_shared<ControlledEntityImpl::LockInformation>() }; // The SharedLockInformation to be used by all managed ControlledEntities
 	std::unordered_map<UniqueIdentifier, SharedControlledEntityImpl, UniqueIdentifier::hash> _controlledEntities;
 	EndStation::UniquePointer _endStation{ nullptr, nullptr };
 	entity::ControllerEntity* _controller{ nullptr };
 	std::string _preferedLocale{ "en-US" };
 	bool _fullStaticModelEnumeration{ false };
+	EnumerationScheduler _enumerationScheduler{};
+	std::chrono::milliseconds _offlineEntitiesRetention{ 0 }; // Protected by _lock. How long an entity that went offline is retained for a delta enumeration (0 if disabled)
+	std::unordered_map<UniqueIdentifier, OfflineEntity, UniqueIdentifier::hash> _offlineEntities{}; // Protected by _lock
 	bool _shouldTerminate{ false };
 	DelayedQueries _delayedQueries{};
 	std::unordered_map<UniqueIdentifier, std::chrono::time_point<std::chrono::system_clock>, UniqueIdentifier::hash> _entityIdentifications{}; // Holds Entity to Controller Identification Information
@@ -24,6 +24,7 @@
 
 #include "avdeccControllerImpl.hpp"
 #include "avdeccControllerLogHelper.hpp"
+#include "avdeccEntityModelCache.hpp"
 
 namespace la
 {
@@ -72,7 +73,7 @@ void ControllerImpl::onEntityOnline(entity::controller::Interface const* const c
 		auto entityIt = _controlledEntities.find(entityID);
 		if (entityIt == _controlledEntities.end())
 		{
-			controlledEntity = _controlledEntities.insert(std::make_pair(entityID, std::make_shared<ControlledEntityImpl>(entity, _entitiesSharedLockInformation, false))).first->second;
+			controlledEntity = _controlledEntities.insert(std::make_pair(entityID, std::make_shared<ControlledEntityImpl>(entity, std::make_shared<ControlledEntityImpl::LockInformation>(), false))).first->second;
 		}
 	}
 
@@ -92,6 +93,12 @@ void ControllerImpl::onEntityOnline(entity::controller::Interface const* const c
 			steps.set(ControlledEntityImpl::EnumerationStep::RegisterUnsol);
 			steps.set(ControlledEntityImpl::EnumerationStep::GetStaticModel);
 			steps.set(ControlledEntityImpl::EnumerationStep::GetDynamicInfo);
+
+			// Start loading its model from the AEM cache persistent store (if any) in the background, it will be needed when the ENTITY descriptor is received
+			if (auto const entityModelID = entity.getEntityModelID(); entityModelID && EntityModelCache::isValidEntityModelID(entityModelID))
+			{
+				EntityModelCache::getInstance().preloadEntityTree(entityModelID);
+			}
 		}
 
 		// Currently, we have nothing more to get if the entity does not support AEM
@@ -99,11 +106,14 @@ void ControllerImpl::onEntityOnline(entity::controller::Interface const* const c
 		// Set Steps
 		controlledEntity->setEnumerationSteps(steps);
 
-		// Save the time we start enumeration
-		controlledEntity->setStartEnumerationTime(std::chrono::steady_clock::now());
+		// Wait for our turn if too many entities are already being enumerated (nothing to wait for if there is nothing to enumerate)
+		if (!steps.empty() && !_enumerationScheduler.requestEnumeration(entityID, entity.getEntityModelID()))
+		{
+			LOG_CONTROLLER_DEBUG(entityID, "onEntityOnline: Too many entities being enumerated, waiting for its turn ({} waiting)", _enumerationScheduler.getQueuedCount());
+			return;
+		}
 
-		// Check first enumeration step
-		checkEnumerationSteps(controlledEntity.get());
+		startEnumeration(controlledEntity.get());
 	}
 	else
 	{
@@ -161,6 +171,14 @@ void ControllerImpl::onEntityOffline(entity::controller::Interface const* const
 
 			notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityOffline, this, controlledEntity.get());
 			controlledEntity->setAdvertised(false);
+
+			// Keep it for a while, in case it comes back online shortly
+			retainOfflineEntity(controlledEntity);
+		}
+		else
+		{
+			// Entity was still being enumerated (or waiting for its turn), let the next one start
+			onEnumerationEnded(*controlledEntity);
 		}
 	}
 }
@@ -70,7 +70,7 @@ void ControllerImpl::onGetMilanInfoResult(entity::controller::Interface const* c
 			{
 				if (!processGetMilanModelFailureStatus(status, controlledEntity.get(), ControlledEntityImpl::MilanInfoType::MilanInfo))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::GetMilanInfo);
 					return;
 				}
@@ -108,7 +108,7 @@ void ControllerImpl::onRegisterUnsolicitedNotificationsResult(entity::controller
 			{
 				if (!processRegisterUnsolFailureStatus(status, &entity))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, &entity, QueryCommandError::RegisterUnsol);
 					return;
 				}
@@ -155,12 +155,22 @@ void ControllerImpl::onEntityDescriptorResult(entity::controller::Interface cons
 					entity.setIgnoreCachedEntityModel();
 				}
 
-				// Search in the AEM cache for the AEM of the active configuration (if not ignored)
 				auto const entityModelID = descriptor.entityModelID;
-				auto cachedModel = std::optional<entity::model::EntityTree>{ std::nullopt };
-				auto const& entityModelCache = EntityModelCache::getInstance();
+				auto cachedModel = std::shared_ptr<entity::model::EntityTree const>{};
+				if (!entity.shouldIgnoreCachedEntityModel())
+				{
+					// Entity coming back online shortly after going offline (if delta enumeration is enabled), use the static model it had before going offline
+					cachedModel = takeOfflineEntityTree(e);
+					if (cachedModel)
+					{
+						LOG_CONTROLLER_DEBUG(entityID, "Entity was offline for a short time, trying to reuse its previous model");
+					}
+				}
+
+				// Search in the AEM cache for the AEM of the active configuration (if not ignored)
+				auto& entityModelCache = EntityModelCache::getInstance();
 				// If AEM Cache is Enabled and the entity has an EntityModelID defined
-				if (!entity.shouldIgnoreCachedEntityModel() && entityModelCache.isCacheEnabled() && entityModelID)
+				if (!cachedModel && !entity.shouldIgnoreCachedEntityModel() && entityModelCache.isCacheEnabled() && entityModelID)
 				{
 					if (EntityModelCache::isValidEntityModelID(entityModelID))
 					{
@@ -191,7 +201,7 @@ void ControllerImpl::onEntityDescriptorResult(entity::controller::Interface cons
 			{
 				if (!processGetStaticModelFailureStatus(status, &entity, 0, entity::model::DescriptorType::Entity, 0))
 				{
-					entity.setGetFatalEnumerationError();
+					setFatalEnumerationError(entity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, &entity, QueryCommandError::EntityDescriptor);
 					return;
 				}
@@ -360,7 +370,7 @@ void ControllerImpl::onConfigurationDescriptorResult(entity::controller::Interfa
 			{
 				if (!processGetStaticModelFailureStatus(status, controlledEntity.get(), 0, entity::model::DescriptorType::Configuration, configurationIndex))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::ConfigurationDescriptor);
 					return;
 				}
@@ -417,7 +427,7 @@ void ControllerImpl::onAudioUnitDescriptorResult(entity::controller::Interface c
 			{
 				if (!processGetStaticModelFailureStatus(status, controlledEntity.get(), configurationIndex, entity::model::DescriptorType::AudioUnit, audioUnitIndex))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::AudioUnitDescriptor);
 					return;
 				}
@@ -453,7 +463,7 @@ void ControllerImpl::onStreamInputDescriptorResult(entity::controller::Interface
 			{
 				if (!processGetStaticModelFailureStatus(status, controlledEntity.get(), configurationIndex, entity::model::DescriptorType::StreamInput, streamIndex))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::StreamInputDescriptor);
 					return;
 				}
@@ -489,7 +499,7 @@ void ControllerImpl::onStreamOutputDescriptorResult(entity::controller::Interfac
 			{
 				if (!processGetStaticModelFailureStatus(status, controlledEntity.get(), configurationIndex, entity::model::DescriptorType::StreamOutput, streamIndex))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::StreamOutputDescriptor);
 					return;
 				}
@@ -525,7 +535,7 @@ void ControllerImpl::onAvbInterfaceDescriptorResult(entity::controller::Interfac
 			{
 				if (!processGetStaticModelFailureStatus(status, controlledEntity.get(), configurationIndex, entity::model::DescriptorType::AvbInterface, interfaceIndex))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::AvbInterfaceDescriptor);
 					return;
 				}
@@ -561,7 +571,7 @@ void ControllerImpl::onClockSourceDescriptorResult(entity::controller::Interface
 			{
 				if (!processGetStaticModelFailureStatus(status, controlledEntity.get(), configurationIndex, entity::model::DescriptorType::ClockSource, clockIndex))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::ClockSourceDescriptor);
 					return;
 				}
@@ -597,7 +607,7 @@ void ControllerImpl::onMemoryObjectDescriptorResult(entity::controller::Interfac
 			{
 				if (!processGetStaticModelFailureStatus(status, controlledEntity.get(), configurationIndex, entity::model::DescriptorType::MemoryObject, memoryObjectIndex))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::MemoryObjectDescriptor);
 					return;
 				}
@@ -631,8 +641,8 @@ void ControllerImpl::onLocaleDescriptorResult(entity::controller::Interface cons
 				auto const& configTree = controlledEntity->getConfigurationTree(configurationIndex);
 				std::uint16_t countLocales{ 0u };
 				{
-					auto const localeIt = configTree.staticModel.descriptorCounts.find(entity::model::DescriptorType::Locale);
-					if (localeIt != configTree.staticModel.descriptorCounts.end())
+					auto const localeIt = configTree.staticModel->descriptorCounts.find(entity::model::DescriptorType::Locale);
+					if (localeIt != configTree.staticModel->descriptorCounts.end())
 						countLocales = localeIt->second;
 				}
 				auto const allLocalesLoaded = configTree.localeModels.size() == countLocales;
@@ -652,7 +662,7 @@ void ControllerImpl::onLocaleDescriptorResult(entity::controller::Interface cons
 			{
 				if (!processGetStaticModelFailureStatus(status, controlledEntity.get(), configurationIndex, entity::model::DescriptorType::Locale, localeIndex))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::LocaleDescriptor);
 					return;
 				}
@@ -688,7 +698,7 @@ void ControllerImpl::onStringsDescriptorResult(entity::controller::Interface con
 			{
 				if (!processGetStaticModelFailureStatus(status, controlledEntity.get(), configurationIndex, entity::model::DescriptorType::Strings, stringsIndex))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::StringsDescriptor);
 					return;
 				}
@@ -743,7 +753,7 @@ void ControllerImpl::onStreamPortInputDescriptorResult(entity::controller::Inter
 			{
 				if (!processGetStaticModelFailureStatus(status, controlledEntity.get(), configurationIndex, entity::model::DescriptorType::StreamPortInput, streamPortIndex))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::StreamPortInputDescriptor);
 					return;
 				}
@@ -798,7 +808,7 @@ void ControllerImpl::onStreamPortOutputDescriptorResult(entity::controller::Inte
 			{
 				if (!processGetStaticModelFailureStatus(status, controlledEntity.get(), configurationIndex, entity::model::DescriptorType::StreamPortOutput, streamPortIndex))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::StreamPortOutputDescriptor);
 					return;
 				}
@@ -834,7 +844,7 @@ void ControllerImpl::onAudioClusterDescriptorResult(entity::controller::Interfac
 			{
 				if (!processGetStaticModelFailureStatus(status, controlledEntity.get(), configurationIndex, entity::model::DescriptorType::AudioCluster, clusterIndex))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::AudioClusterDescriptor);
 					return;
 				}
@@ -870,7 +880,7 @@ void ControllerImpl::onAudioMapDescriptorResult(entity::controller::Interface co
 			{
 				if (!processGetStaticModelFailureStatus(status, controlledEntity.get(), configurationIndex, entity::model::DescriptorType::AudioMap, mapIndex))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::AudioMapDescriptor);
 					return;
 				}
@@ -906,7 +916,7 @@ void ControllerImpl::onControlDescriptorResult(entity::controller::Interface con
 			{
 				if (!processGetStaticModelFailureStatus(status, controlledEntity.get(), configurationIndex, entity::model::DescriptorType::Control, controlIndex))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::ControlDescriptor);
 					return;
 				}
@@ -942,7 +952,7 @@ void ControllerImpl::onClockDomainDescriptorResult(entity::controller::Interface
 			{
 				if (!processGetStaticModelFailureStatus(status, controlledEntity.get(), configurationIndex, entity::model::DescriptorType::ClockDomain, clockDomainIndex))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::ClockDomainDescriptor);
 					return;
 				}
@@ -979,7 +989,7 @@ void ControllerImpl::onGetStreamInputInfoResult(entity::controller::Interface co
 			{
 				if (!processGetAecpDynamicInfoFailureStatus(status, controlledEntity.get(), configurationIndex, ControlledEntityImpl::DynamicInfoType::InputStreamInfo, streamIndex, 0u, false))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::ListenerStreamInfo);
 					return;
 				}
@@ -1016,7 +1026,7 @@ void ControllerImpl::onGetStreamOutputInfoResult(entity::controller::Interface c
 			{
 				if (!processGetAecpDynamicInfoFailureStatus(status, controlledEntity.get(), configurationIndex, ControlledEntityImpl::DynamicInfoType::OutputStreamInfo, streamIndex, 0u, false))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::TalkerStreamInfo);
 					return;
 				}
@@ -1052,7 +1062,7 @@ void ControllerImpl::onGetAcquiredStateResult(entity::controller::Interface cons
 			{
 				if (!processGetAecpDynamicInfoFailureStatus(status, controlledEntity.get(), 0u, ControlledEntityImpl::DynamicInfoType::AcquiredState, 0u, 0u, true))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::AcquiredState);
 					return;
 				}
@@ -1091,7 +1101,7 @@ void ControllerImpl::onGetLockedStateResult(entity::controller::Interface const*
 			{
 				if (!processGetAecpDynamicInfoFailureStatus(status, controlledEntity.get(), 0u, ControlledEntityImpl::DynamicInfoType::LockedState, 0u, 0u, false))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::LockedState);
 					return;
 				}
@@ -1148,7 +1158,7 @@ void ControllerImpl::onGetStreamPortInputAudioMapResult(entity::controller::Inte
 			{
 				if (!processGetAecpDynamicInfoFailureStatus(status, controlledEntity.get(), configurationIndex, ControlledEntityImpl::DynamicInfoType::InputStreamAudioMappings, streamPortIndex, mapIndex, false))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::StreamInputAudioMap);
 					return;
 				}
@@ -1156,7 +1166,7 @@ void ControllerImpl::onGetStreamPortInputAudioMapResult(entity::controller::Inte
 				// If we are requesting the dynamic mappings it's because no audio map was defined. This command should never return NotImplement nor NotSupported
 				if (status == entity::ControllerEntity::AemCommandStatus::NotImplemented || status == entity::ControllerEntity::AemCommandStatus::NotSupported)
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::StreamInputAudioMap);
 					return;
 				}
@@ -1211,7 +1221,7 @@ void ControllerImpl::onGetStreamPortOutputAudioMapResult(entity::controller::Int
 			{
 				if (!processGetAecpDynamicInfoFailureStatus(status, controlledEntity.get(), configurationIndex, ControlledEntityImpl::DynamicInfoType::OutputStreamAudioMappings, streamPortIndex, mapIndex, false))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::StreamOutputAudioMap);
 					return;
 				}
@@ -1219,7 +1229,7 @@ void ControllerImpl::onGetStreamPortOutputAudioMapResult(entity::controller::Int
 				// If we are requesting the dynamic mappings it's because no audio map was defined. This command should never return NotImplement nor NotSupported
 				if (status == entity::ControllerEntity::AemCommandStatus::NotImplemented || status == entity::ControllerEntity::AemCommandStatus::NotSupported)
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::StreamOutputAudioMap);
 					return;
 				}
@@ -1258,7 +1268,7 @@ void ControllerImpl::onGetAvbInfoResult(entity::controller::Interface const* con
 			{
 				if (!processGetAecpDynamicInfoFailureStatus(status, controlledEntity.get(), configurationIndex, ControlledEntityImpl::DynamicInfoType::GetAvbInfo, avbInterfaceIndex, 0u, false))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::AvbInfo);
 					return;
 				}
@@ -1317,7 +1327,7 @@ void ControllerImpl::onGetAsPathResult(entity::controller::Interface const* cons
 			{
 				if (!processGetAecpDynamicInfoFailureStatus(status, controlledEntity.get(), configurationIndex, ControlledEntityImpl::DynamicInfoType::GetAsPath, avbInterfaceIndex, 0u, false))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::AsPath);
 					return;
 				}
@@ -1356,7 +1366,7 @@ void ControllerImpl::onGetEntityCountersResult(entity::controller::Interface con
 			{
 				if (!processGetAecpDynamicInfoFailureStatus(status, controlledEntity.get(), 0u, ControlledEntityImpl::DynamicInfoType::GetEntityCounters, 0u, 0u, true))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::EntityCounters);
 					return;
 				}
@@ -1405,7 +1415,7 @@ void ControllerImpl::onGetAvbInterfaceCountersResult(entity::controller::Interfa
 			{
 				if (!processGetAecpDynamicInfoFailureStatus(status, controlledEntity.get(), configurationIndex, ControlledEntityImpl::DynamicInfoType::GetAvbInterfaceCounters, avbInterfaceIndex, 0u, false))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::AvbInterfaceCounters);
 					return;
 				}
@@ -1454,7 +1464,7 @@ void ControllerImpl::onGetClockDomainCountersResult(entity::controller::Interfac
 			{
 				if (!processGetAecpDynamicInfoFailureStatus(status, controlledEntity.get(), configurationIndex, ControlledEntityImpl::DynamicInfoType::GetClockDomainCounters, clockDomainIndex, 0u, false))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::ClockDomainCounters);
 					return;
 				}
@@ -1503,7 +1513,7 @@ void ControllerImpl::onGetStreamInputCountersResult(entity::controller::Interfac
 			{
 				if (!processGetAecpDynamicInfoFailureStatus(status, controlledEntity.get(), configurationIndex, ControlledEntityImpl::DynamicInfoType::GetStreamInputCounters, streamIndex, 0u, false))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::StreamInputCounters);
 					return;
 				}
@@ -1552,7 +1562,7 @@ void ControllerImpl::onGetStreamOutputCountersResult(entity::controller::Interfa
 			{
 				if (!processGetAecpDynamicInfoFailureStatus(status, controlledEntity.get(), configurationIndex, ControlledEntityImpl::DynamicInfoType::GetStreamOutputCounters, streamIndex, 0u, false))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::StreamOutputCounters);
 					return;
 				}
@@ -1588,7 +1598,7 @@ void ControllerImpl::onConfigurationNameResult(entity::controller::Interface con
 			{
 				if (!processGetDescriptorDynamicInfoFailureStatus(status, controlledEntity.get(), configurationIndex, ControlledEntityImpl::DescriptorDynamicInfoType::ConfigurationName, 0u, false))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::ConfigurationName);
 					return;
 				}
@@ -1624,7 +1634,7 @@ void ControllerImpl::onAudioUnitNameResult(entity::controller::Interface const*
 			{
 				if (!processGetDescriptorDynamicInfoFailureStatus(status, controlledEntity.get(), configurationIndex, ControlledEntityImpl::DescriptorDynamicInfoType::AudioUnitName, audioUnitIndex, false))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::AudioUnitName);
 					return;
 				}
@@ -1660,7 +1670,7 @@ void ControllerImpl::onAudioUnitSamplingRateResult(entity::controller::Interface
 			{
 				if (!processGetDescriptorDynamicInfoFailureStatus(status, controlledEntity.get(), configurationIndex, ControlledEntityImpl::DescriptorDynamicInfoType::AudioUnitSamplingRate, audioUnitIndex, false))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::AudioUnitSamplingRate);
 					return;
 				}
@@ -1696,7 +1706,7 @@ void ControllerImpl::onInputStreamNameResult(entity::controller::Interface const
 			{
 				if (!processGetDescriptorDynamicInfoFailureStatus(status, controlledEntity.get(), configurationIndex, ControlledEntityImpl::DescriptorDynamicInfoType::InputStreamName, streamIndex, false))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::InputStreamName);
 					return;
 				}
@@ -1733,7 +1743,7 @@ void ControllerImpl::onInputStreamFormatResult(entity::controller::Interface con
 			{
 				if (!processGetDescriptorDynamicInfoFailureStatus(status, controlledEntity.get(), configurationIndex, ControlledEntityImpl::DescriptorDynamicInfoType::InputStreamFormat, streamIndex, false))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::InputStreamFormat);
 					return;
 				}
@@ -1769,7 +1779,7 @@ void ControllerImpl::onOutputStreamNameResult(entity::controller::Interface cons
 			{
 				if (!processGetDescriptorDynamicInfoFailureStatus(status, controlledEntity.get(), configurationIndex, ControlledEntityImpl::DescriptorDynamicInfoType::OutputStreamName, streamIndex, false))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::OutputStreamName);
 					return;
 				}
@@ -1806,7 +1816,7 @@ void ControllerImpl::onOutputStreamFormatResult(entity::controller::Interface co
 			{
 				if (!processGetDescriptorDynamicInfoFailureStatus(status, controlledEntity.get(), configurationIndex, ControlledEntityImpl::DescriptorDynamicInfoType::OutputStreamFormat, streamIndex, false))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::OutputStreamFormat);
 					return;
 				}
@@ -1842,7 +1852,7 @@ void ControllerImpl::onAvbInterfaceNameResult(entity::controller::Interface cons
 			{
 				if (!processGetDescriptorDynamicInfoFailureStatus(status, controlledEntity.get(), configurationIndex, ControlledEntityImpl::DescriptorDynamicInfoType::AvbInterfaceName, avbInterfaceIndex, false))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::AvbInterfaceName);
 					return;
 				}
@@ -1878,7 +1888,7 @@ void ControllerImpl::onClockSourceNameResult(entity::controller::Interface const
 			{
 				if (!processGetDescriptorDynamicInfoFailureStatus(status, controlledEntity.get(), configurationIndex, ControlledEntityImpl::DescriptorDynamicInfoType::ClockSourceName, clockSourceIndex, false))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::ClockSourceName);
 					return;
 				}
@@ -1914,7 +1924,7 @@ void ControllerImpl::onMemoryObjectNameResult(entity::controller::Interface cons
 			{
 				if (!processGetDescriptorDynamicInfoFailureStatus(status, controlledEntity.get(), configurationIndex, ControlledEntityImpl::DescriptorDynamicInfoType::MemoryObjectName, memoryObjectIndex, false))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::MemoryObjectName);
 					return;
 				}
@@ -1950,7 +1960,7 @@ void ControllerImpl::onMemoryObjectLengthResult(entity::controller::Interface co
 			{
 				if (!processGetDescriptorDynamicInfoFailureStatus(status, controlledEntity.get(), configurationIndex, ControlledEntityImpl::DescriptorDynamicInfoType::MemoryObjectLength, memoryObjectIndex, true))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::MemoryObjectLength);
 					return;
 				}
@@ -1986,7 +1996,7 @@ void ControllerImpl::onAudioClusterNameResult(entity::controller::Interface cons
 			{
 				if (!processGetDescriptorDynamicInfoFailureStatus(status, controlledEntity.get(), configurationIndex, ControlledEntityImpl::DescriptorDynamicInfoType::AudioClusterName, audioClusterIndex, false))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::AudioClusterName);
 					return;
 				}
@@ -2022,7 +2032,7 @@ void ControllerImpl::onControlNameResult(entity::controller::Interface const* co
 			{
 				if (!processGetDescriptorDynamicInfoFailureStatus(status, controlledEntity.get(), configurationIndex, ControlledEntityImpl::DescriptorDynamicInfoType::ControlName, controlIndex, false))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::ControlName);
 					return;
 				}
@@ -2063,7 +2073,7 @@ void ControllerImpl::onControlValuesResult(entity::controller::Interface const*
 
 			if (!st && !processGetDescriptorDynamicInfoFailureStatus(st, controlledEntity.get(), configurationIndex, ControlledEntityImpl::DescriptorDynamicInfoType::ControlValues, controlIndex, false))
 			{
-				controlledEntity->setGetFatalEnumerationError();
+				setFatalEnumerationError(*controlledEntity);
 				notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::ControlValues);
 				return;
 			}
@@ -2098,7 +2108,7 @@ void ControllerImpl::onClockDomainNameResult(entity::controller::Interface const
 			{
 				if (!processGetDescriptorDynamicInfoFailureStatus(status, controlledEntity.get(), configurationIndex, ControlledEntityImpl::DescriptorDynamicInfoType::ClockDomainName, clockDomainIndex, false))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::ClockDomainName);
 					return;
 				}
@@ -2134,7 +2144,7 @@ void ControllerImpl::onClockDomainSourceIndexResult(entity::controller::Interfac
 			{
 				if (!processGetDescriptorDynamicInfoFailureStatus(status, controlledEntity.get(), configurationIndex, ControlledEntityImpl::DescriptorDynamicInfoType::ClockDomainSourceIndex, clockDomainIndex, false))
 				{
-					controlledEntity->setGetFatalEnumerationError();
+					setFatalEnumerationError(*controlledEntity);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, controlledEntity.get(), QueryCommandError::ClockDomainSourceIndex);
 					return;
 				}
@@ -2197,7 +2207,7 @@ void ControllerImpl::onGetTalkerStreamStateResult(entity::controller::Interface
 			{
 				if (!processGetAcmpDynamicInfoFailureStatus(status, &talker, configurationIndex, ControlledEntityImpl::DynamicInfoType::OutputStreamState, talkerStream.streamIndex, false))
 				{
-					talker.setGetFatalEnumerationError();
+					setFatalEnumerationError(talker);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, &talker, QueryCommandError::TalkerStreamState);
 					return;
 				}
@@ -2239,7 +2249,7 @@ void ControllerImpl::onGetListenerStreamStateResult(entity::controller::Interfac
 			{
 				if (!processGetAcmpDynamicInfoFailureStatus(status, listener.get(), configurationIndex, ControlledEntityImpl::DynamicInfoType::InputStreamState, listenerStream.streamIndex, false))
 				{
-					listener->setGetFatalEnumerationError();
+					setFatalEnumerationError(*listener);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, listener.get(), QueryCommandError::ListenerStreamState);
 					return;
 				}
@@ -2275,7 +2285,7 @@ void ControllerImpl::onGetTalkerStreamConnectionResult(entity::controller::Inter
 			{
 				if (!processGetAcmpDynamicInfoFailureStatus(status, talker.get(), configurationIndex, ControlledEntityImpl::DynamicInfoType::OutputStreamConnection, talkerStream, connectionIndex, true))
 				{
-					talker->setGetFatalEnumerationError();
+					setFatalEnumerationError(*talker);
 					notifyObserversMethod<Controller::Observer>(&Controller::Observer::onEntityQueryError, this, talker.get(), QueryCommandError::TalkerStreamConnection);
 					return;
 				}
@@ -28,6 +28,7 @@
 #ifdef ENABLE_AVDECC_FEATURE_JSON
 #	include "avdeccControllerJsonTypes.hpp"
 #	include "avdeccControlledEntityJsonSerializer.hpp"
+#	include "avdeccControllerSnapshot.hpp"
 #endif // ENABLE_AVDECC_FEATURE_JSON
 
 #ifdef ENABLE_AVDECC_FEATURE_JSON
@@ -39,6 +40,7 @@
 #include <cstdlib> // free / malloc
 #include <cstring> // strerror
 #include <cerrno> // errno
+#include <cstdio> // remove
 #include <unordered_set>
 #include <set>
 #include <fstream>
@@ -199,6 +201,14 @@ ControllerImpl::ControllerImpl(protocol::ProtocolInterface::Type const protocolI
 					controllerIdentificationsStopped.clear();
 				}
 
+				// Release the offline entities retained for a delta enumeration that expired
+				{
+					// Lock to protect _offlineEntities
+					auto const lg = std::lock_guard{ _lock };
+
+					releaseExpiredOfflineEntities(std::chrono::steady_clock::now());
+				}
+
 				// Delayed Queries
 				{
 					// Check all delayed queries if we need to send any of them, and copy them so we can send outside the loop
@@ -418,6 +428,41 @@ void ControllerImpl::setAutomaticDiscoveryDelay(std::chrono::milliseconds const
 	}
 }
 
+bool ControllerImpl::setMaxAecpInflightCommands(std::uint32_t const maxInflightCommands) noexcept
+{
+	if (!!_endStation->getProtocolInterface()->setMaxAecpInflightCommands(maxInflightCommands))
+	{
+		return false;
+	}
+	LOG_CONTROLLER_INFO(_controller->getEntityID(), "Controller maximum AECP inflight commands set to {}", maxInflightCommands);
+	return true;
+}
+
+void ControllerImpl::setMaxConcurrentEnumerations(std::uint32_t const maxConcurrentEnumerations) noexcept
+{
+	auto const admitted = _enumerationScheduler.setMaxConcurrentEnumerations(maxConcurrentEnumerations);
+	if (maxConcurrentEnumerations == 0u)
+	{
+		LOG_CONTROLLER_INFO(_controller->getEntityID(), "Controller concurrent enumerations not limited");
+	}
+	else
+	{
+		LOG_CONTROLLER_INFO(_controller->getEntityID(), "Controller maximum concurrent enumerations set to {}", maxConcurrentEnumerations);
+	}
+
+	// Start the enumeration of the entities that no longer have to wait
+	if (!admitted.empty())
+	{
+		auto const lg = std::lock_guard{ *_controller }; // Lock the Controller itself (thus, lock it's ProtocolInterface), to simulate being called from a Networking Thread. THIS IS A HACK!
+		startAdmittedEnumerations(admitted);
+	}
+}
+
+void ControllerImpl::setEnumerationPriorities(std::vector<UniqueIdentifier> const& priorities) noexcept
+{
+	_enumerationScheduler.setPriorities(priorities);
+}
+
 void ControllerImpl::enableEntityModelCache() noexcept
 {
 	EntityModelCache::getInstance().enableCache();
@@ -430,6 +475,23 @@ void ControllerImpl::disableEntityModelCache() noexcept
 	LOG_CONTROLLER_INFO(_controller->getEntityID(), "AEM-CACHE Disabled");
 }
 
+bool ControllerImpl::enableEntityModelCachePersistence(std::string const& directoryPath) noexcept
+{
+	if (!EntityModelCache::getInstance().enablePersistence(directoryPath))
+	{
+		LOG_CONTROLLER_WARN(_controller->getEntityID(), "AEM-CACHE Persistence not supported or invalid directory: {}", directoryPath);
+		return false;
+	}
+	LOG_CONTROLLER_INFO(_controller->getEntityID(), "AEM-CACHE Persistence Enabled in {}", directoryPath);
+	return true;
+}
+
+void ControllerImpl::disableEntityModelCachePersistence() noexcept
+{
+	EntityModelCache::getInstance().disablePersistence();
+	LOG_CONTROLLER_INFO(_controller->getEntityID(), "AEM-CACHE Persistence Disabled");
+}
+
 void ControllerImpl::enableFullStaticEntityModelEnumeration() noexcept
 {
 	_fullStaticModelEnumeration = true;
@@ -440,6 +502,32 @@ void ControllerImpl::disableFullStaticEntityModelEnumeration() noexcept
 	_fullStaticModelEnumeration = false;
 }
 
+void ControllerImpl::enableDeltaEnumeration(std::chrono::milliseconds const retentionDuration) noexcept
+{
+	// Nothing can be retained
+	if (retentionDuration.count() <= 0)
+	{
+		disableDeltaEnumeration();
+		return;
+	}
+
+	// Lock to protect _offlineEntities
+	auto const lg = std::lock_guard{ _lock };
+
+	_offlineEntitiesRetention = retentionDuration;
+	LOG_CONTROLLER_INFO(_controller->getEntityID(), "Delta enumeration enabled, offline entities retained for {} msec", retentionDuration.count());
+}
+
+void ControllerImpl::disableDeltaEnumeration() noexcept
+{
+	// Lock to protect _offlineEntities
+	auto const lg = std::lock_guard{ _lock };
+
+	_offlineEntitiesRetention = std::chrono::milliseconds{ 0 };
+	_offlineEntities.clear();
+	LOG_CONTROLLER_INFO(_controller->getEntityID(), "Delta enumeration disabled");
+}
+
 std::tuple<avdecc::jsonSerializer::DeserializationError, std::string> ControllerImpl::loadEntityModelFile(std::string const& /*filePath*/) noexcept
 {
 	// TODO:
@@ -2437,9 +2525,10 @@ void ControllerImpl::connectStream(entity::model::StreamIdentification const& ta
 			{
 				LOG_CONTROLLER_TRACE(UniqueIdentifier::getNullUniqueIdentifier(), "User connectStream (TalkerID={} TalkerIndex={} ListenerID={} ListenerIndex={}): {}", utils::toHexString(talkerStream.entityID, true), talkerStream.streamIndex, utils::toHexString(listenerStream.entityID, true), listenerStream.streamIndex, entity::ControllerEntity::statusToString(status));
 
-				// Take a "scoped locked" shared copy of the ControlledEntities
-				auto listener = getControlledEntityImplGuard(listenerStream.entityID);
-				auto talker = getControlledEntityImplGuard(talkerStream.entityID);
+				// Take a "scoped locked" shared copy of the ControlledEntities (both at once)
+				auto entities = getControlledEntityImplGuards({ listenerStream.entityID, talkerStream.entityID });
+				auto& listener = entities[0];
+				auto& talker = entities[1];
 
 				if (!!status)
 				{
@@ -2570,9 +2659,10 @@ void ControllerImpl::getListenerStreamState(entity::model::StreamIdentification
 			{
 				LOG_CONTROLLER_TRACE(UniqueIdentifier::getNullUniqueIdentifier(), "User getListenerStreamState (TalkerID={} TalkerIndex={} ListenerID={} ListenerIndex={}): {}", utils::toHexString(talkerStream.entityID, true), talkerStream.streamIndex, utils::toHexString(listenerStream.entityID, true), listenerStream.streamIndex, entity::ControllerEntity::statusToString(status));
 
-				// Take a "scoped locked" shared copy of the ControlledEntities
-				auto listener = getControlledEntityImplGuard(listenerStream.entityID);
-				auto talker = getControlledEntityImplGuard(talkerStream.entityID);
+				// Take a "scoped locked" shared copy of the ControlledEntities (both at once)
+				auto entities = getControlledEntityImplGuards({ listenerStream.entityID, talkerStream.entityID });
+				auto& listener = entities[0];
+				auto& talker = entities[1];
 
 				if (!!status)
 				{
@@ -2601,6 +2691,51 @@ ControlledEntityGuard ControllerImpl::getControlledEntityGuard(UniqueIdentifier
 	return {};
 }
 
+std::vector<ControlledEntityGuard> ControllerImpl::getControlledEntityGuards(std::vector<UniqueIdentifier> const& entityIDs) const noexcept
+{
+	// Take a "scoped locked" shared copy of all the ControlledEntities (at once)
+	auto entities = getControlledEntityImplGuards(entityIDs, true);
+
+	auto guards = std::vector<ControlledEntityGuard>{};
+	guards.reserve(entities.size());
+	for (auto& entity : entities)
+	{
+		guards.push_back(ControlledEntityGuard{ entity.release() });
+	}
+	return guards;
+}
+
+SharedControlledEntitySnapshot ControllerImpl::getControlledEntitySnapshot(UniqueIdentifier const entityID) const noexcept
+{
+	// Get a shared copy of the ControlledEntity so it stays alive while in the scope (without locking it)
+	auto const controlledEntity = getSharedControlledEntityImplHolder(entityID, true).release();
+	if (!controlledEntity)
+	{
+		return {};
+	}
+
+	// Already published
+	if (auto snapshot = controlledEntity->getSnapshot())
+	{
+		return snapshot;
+	}
+
+	// First request for this entity, enable snapshots and publish the initial one now (the guard only publishes when releasing the outermost lock, which might not be this one)
+	auto entity = getControlledEntityImplGuard(entityID, true);
+	if (!entity)
+	{
+		return {};
+	}
+
+	// Another thread might have published it while we were waiting for the lock
+	if (!entity->isSnapshotEnabled())
+	{
+		entity->enableSnapshot();
+		entity->publishSnapshot();
+	}
+	return entity->getSnapshot();
+}
+
 void ControllerImpl::requestExclusiveAccess(UniqueIdentifier const entityID, ExclusiveAccessToken::AccessType const type, RequestExclusiveAccessResultHandler&& handler) const noexcept
 {
 	// Helper lambda
@@ -2672,6 +2807,12 @@ std::tuple<avdecc::jsonSerializer::SerializationError, std::string> ControllerIm
 
 #else // ENABLE_AVDECC_FEATURE_JSON
 
+	// Text format is streamed, entities are written one at a time
+	if (!flags.test(entity::model::jsonSerializer::Flag::BinaryFormat))
+	{
+		return streamAllControlledEntitiesAsJson(filePath, flags, dumpSource, continueOnError);
+	}
+
 	// Create the object
 	auto object = json{};
 
@@ -2730,15 +2871,8 @@ std::tuple<avdecc::jsonSerializer::SerializationError, std::string> ControllerIm
 	}
 
 	// Everything is fine, write the JSON object to disk
-	if (flags.test(entity::model::jsonSerializer::Flag::BinaryFormat))
-	{
-		auto const binary = json::to_msgpack(object);
-		ofs.write(reinterpret_cast<char const*>(binary.data()), binary.size() * sizeof(decltype(binary)::value_type));
-	}
-	else
-	{
-		ofs << std::setw(4) << object << std::endl;
-	}
+	auto const binary = json::to_msgpack(object);
+	ofs.write(reinterpret_cast<char const*>(binary.data()), binary.size() * sizeof(decltype(binary)::value_type));
 
 	return { error, errorText };
 #endif // ENABLE_AVDECC_FEATURE_JSON
@@ -2797,6 +2931,103 @@ std::tuple<avdecc::jsonSerializer::SerializationError, std::string> ControllerIm
 #endif // ENABLE_AVDECC_FEATURE_JSON
 }
 
+std::tuple<avdecc::jsonSerializer::SerializationError, std::string> ControllerImpl::serializeAllControlledEntitiesAsSnapshot([[maybe_unused]] std::string const& filePath, [[maybe_unused]] entity::model::jsonSerializer::Flags const flags, [[maybe_unused]] std::string const& dumpSource, [[maybe_unused]] bool const continueOnError) const noexcept
+{
+#ifndef ENABLE_AVDECC_FEATURE_JSON
+	return { avdecc::jsonSerializer::SerializationError::NotSupported, "Serialization feature not supported by the library (was not compiled)" };
+
+#else // ENABLE_AVDECC_FEATURE_JSON
+
+	// Try to open the output file
+	auto const mode = std::ios::binary | std::ios::out;
+	auto ofs = std::ofstream{ filePath, mode };
+
+	// Failed to open file to writting
+	if (!ofs.is_open())
+	{
+		return { avdecc::jsonSerializer::SerializationError::AccessDenied, std::strerror(errno) };
+	}
+
+	// Don't leave a partial file behind
+	auto const failed = [&ofs, &filePath](avdecc::jsonSerializer::SerializationError const error, std::string const& errorText) -> std::tuple<avdecc::jsonSerializer::SerializationError, std::string>
+	{
+		ofs.close();
+		std::remove(filePath.c_str());
+		return { error, errorText };
+	};
+
+	// Buffer reused for all records, only a single entity is held in memory at a time
+	auto buffer = std::vector<std::uint8_t>{};
+
+	try
+	{
+		snapshot::writeHeader(ofs);
+
+		// Dump information of the dump itself
+		{
+			auto object = json{};
+			object[jsonSerializer::keyName::Controller_DumpVersion] = jsonSerializer::keyValue::Controller_DumpVersion;
+			object[jsonSerializer::keyName::Controller_Informative_DumpSource] = dumpSource;
+			snapshot::writeRecord(ofs, object, buffer);
+		}
+
+		// Lock to protect _controlledEntities
+		std::lock_guard<decltype(_lock)> const lg(_lock);
+
+		// Define a comparator operator for ControlledEntities as we want to dump entities ordered by EntityID
+		auto const entityComparator = [](ControlledEntityImpl const* const& lhs, ControlledEntityImpl const* const& rhs)
+		{
+			return lhs->getEntity().getEntityID() < rhs->getEntity().getEntityID();
+		};
+		auto entities = std::set<ControlledEntityImpl const*, decltype(entityComparator)>{ entityComparator };
+
+		// Process all known entities and add them to a sorted set
+		for (auto const& entityIt : _controlledEntities)
+		{
+			entities.insert(entityIt.second.get());
+		}
+
+		auto error = avdecc::jsonSerializer::SerializationError::NoError;
+		auto errorText = std::string{};
+		// Serialize and write all known entities, one at a time, sorted by EntityID
+		for (auto const* const entity : entities)
+		{
+			try
+			{
+				snapshot::writeRecord(ofs, jsonSerializer::createJsonObject(*entity, flags), buffer);
+			}
+			catch (avdecc::jsonSerializer::SerializationException const& e)
+			{
+				if (continueOnError)
+				{
+					error = avdecc::jsonSerializer::SerializationError::Incomplete;
+					errorText = e.what();
+					continue;
+				}
+				return failed(e.getError(), e.what());
+			}
+		}
+
+		snapshot::writeEndRecord(ofs);
+
+		if (!ofs.good())
+		{
+			return failed(avdecc::jsonSerializer::SerializationError::AccessDenied, "Error writing snapshot file");
+		}
+
+		return { error, errorText };
+	}
+	catch (avdecc::jsonSerializer::SerializationException const& e)
+	{
+		return failed(e.getError(), e.what());
+	}
+	catch (json::exception const& e)
+	{
+		return failed(avdecc::jsonSerializer::SerializationError::InternalError, e.what());
+	}
+#endif // ENABLE_AVDECC_FEATURE_JSON
+}
+
 /* Model deserialization methods */
 std::tuple<avdecc::jsonSerializer::DeserializationError, std::string> ControllerImpl::loadVirtualEntitiesFromJsonNetworkState([[maybe_unused]] std::string const& filePath, [[maybe_unused]] entity::model::jsonSerializer::Flags const flags, [[maybe_unused]] bool const continueOnError) noexcept
 {
@@ -2805,7 +3036,34 @@ std::tuple<avdecc::jsonSerializer::DeserializationError, std::string> Controller
 
 #else // ENABLE_AVDECC_FEATURE_JSON
 
-	auto [error, errorText, controlledEntities] = deserializeJsonNetworkState(filePath, flags, continueOnError, _entitiesSharedLockInformation);
+	auto [error, errorText, controlledEntities] = deserializeJsonNetworkState(filePath, flags, continueOnError);
+
+	for (auto& controlledEntity : controlledEntities)
+	{
+		auto const [err, errTxt] = registerVirtualControlledEntity(std::move(controlledEntity));
+		if (!!err)
+		{
+			if (continueOnError)
+			{
+				error = err;
+				errorText = errTxt;
+				continue;
+			}
+			return { err, errTxt };
+		}
+	}
+	return { error, errorText };
+#endif // ENABLE_AVDECC_FEATURE_JSON
+}
+
+std::tuple<avdecc::jsonSerializer::DeserializationError, std::string> ControllerImpl::loadVirtualEntitiesFromSnapshot([[maybe_unused]] std::string const& filePath, [[maybe_unused]] entity::model::jsonSerializer::Flags const flags, [[maybe_unused]] bool const continueOnError) noexcept
+{
+#ifndef ENABLE_AVDECC_FEATURE_JSON
+	return { avdecc::jsonSerializer::DeserializationError::NotSupported, "Deserialization feature not supported by the library (was not compiled)" };
+
+#else // ENABLE_AVDECC_FEATURE_JSON
+
+	auto [error, errorText, controlledEntities] = deserializeSnapshotNetworkState(filePath, flags, continueOnError);
 
 	for (auto& controlledEntity : controlledEntities)
 	{
@@ -2832,7 +3090,7 @@ std::tuple<avdecc::jsonSerializer::DeserializationError, std::string> Controller
 
 #else // ENABLE_AVDECC_FEATURE_JSON
 
-	auto [error, errorText, controlledEntity] = deserializeJson(filePath, flags, _entitiesSharedLockInformation);
+	auto [error, errorText, controlledEntity] = deserializeJson(filePath, flags);
 	if (!error)
 	{
 		return registerVirtualControlledEntity(std::move(controlledEntity));
@@ -2851,7 +3109,7 @@ std::tuple<avdecc::jsonSerializer::DeserializationError, std::string, std::vecto
 
 #else // ENABLE_AVDECC_FEATURE_JSON
 
-	auto [error, errorText, controlledEntities] = deserializeJsonNetworkState(filePath, flags, continueOnError, std::make_shared<ControlledEntityImpl::LockInformation>());
+	auto [error, errorText, controlledEntities] = deserializeJsonNetworkState(filePath, flags, continueOnError);
 	auto entities = std::vector<SharedControlledEntity>{};
 
 	for (auto& controlledEntity : controlledEntities)
@@ -2872,7 +3130,7 @@ std::tuple<avdecc::jsonSerializer::DeserializationError, std::string, SharedCont
 
 #else // ENABLE_AVDECC_FEATURE_JSON
 
-	auto [error, errorText, controlledEntity] = deserializeJson(filePath, flags, std::make_shared<ControlledEntityImpl::LockInformation>());
+	auto [error, errorText, controlledEntity] = deserializeJson(filePath, flags);
 	if (!error)
 	{
 		// We need to run some setup on a detached virtual entity
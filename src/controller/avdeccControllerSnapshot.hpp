@@ -0,0 +1,152 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @file avdeccControllerSnapshot.hpp
+* @author Christophe Calmejane
+* @brief Binary network state snapshot, streamed one record at a time.
+*/
+
+#pragma once
+
+#include <la/avdecc/internals/jsonSerialization.hpp>
+#include <la/avdecc/internals/endian.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace la
+{
+namespace avdecc
+{
+namespace controller
+{
+namespace snapshot
+{
+/*
+* Snapshot file layout (sizes in network order):
+*  - Magic 'AVNS' (4 bytes)
+*  - Format version (4 bytes)
+*  - Records, each one being the size of a MessagePack encoded object (4 bytes) followed by the object:
+*    - Dump information (same keys than the JSON network state)
+*    - One record per entity (same object than a JSON network state entity)
+*    - Empty record marking the end of the snapshot
+*/
+constexpr auto Magic = std::array<char, 4>{ 'A', 'V', 'N', 'S' };
+constexpr auto FormatVersion = std::uint32_t{ 1u };
+constexpr auto MaxRecordSize = std::uint32_t{ 64u * 1024u * 1024u }; // Largest record accepted when reading (an entity record is usually a few hundred KB)
+constexpr auto ReadChunkSize = std::uint32_t{ 1024u * 1024u }; // Records are read by chunks, so a corrupt size cannot allocate more than what the stream actually contains
+
+inline void writeSize(std::ostream& os, std::uint32_t const size)
+{
+	auto const packed = AVDECC_PACK_DWORD(size);
+	os.write(reinterpret_cast<char const*>(&packed), sizeof(packed));
+}
+
+inline void writeHeader(std::ostream& os)
+{
+	os.write(Magic.data(), Magic.size());
+	writeSize(os, FormatVersion);
+}
+
+/** Writes a record, using 'buffer' as scratch memory (so it can be reused from one record to the next). Throws SerializationException. */
+inline void writeRecord(std::ostream& os, nlohmann::json const& object, std::vector<std::uint8_t>& buffer)
+{
+	buffer.clear();
+	nlohmann::json::to_msgpack(object, buffer);
+	if (buffer.empty() || buffer.size() > std::numeric_limits<std::uint32_t>::max())
+	{
+		throw avdecc::jsonSerializer::SerializationException{ avdecc::jsonSerializer::SerializationError::InternalError, "Invalid snapshot record size" };
+	}
+	writeSize(os, static_cast<std::uint32_t>(buffer.size()));
+	os.write(reinterpret_cast<char const*>(buffer.data()), buffer.size());
+}
+
+inline void writeEndRecord(std::ostream& os)
+{
+	writeSize(os, 0u);
+}
+
+/** Reads and validates the snapshot header. Throws DeserializationException. */
+inline void readHeader(std::istream& is)
+{
+	auto magic = decltype(Magic){};
+	auto version = std::uint32_t{ 0u };
+	is.read(magic.data(), magic.size());
+	is.read(reinterpret_cast<char*>(&version), sizeof(version));
+	if (!is.good() || magic != Magic)
+	{
+		throw avdecc::jsonSerializer::DeserializationException{ avdecc::jsonSerializer::DeserializationError::ParseError, "Not a network state snapshot" };
+	}
+	if (AVDECC_UNPACK_DWORD(version) != FormatVersion)
+	{
+		throw avdecc::jsonSerializer::DeserializationException{ avdecc::jsonSerializer::DeserializationError::UnsupportedDumpVersion, "Unsupported snapshot version: " + std::to_string(AVDECC_UNPACK_DWORD(version)) };
+	}
+}
+
+/** Reads the next record into 'object', using 'buffer' as scratch memory. Returns false when the end of the snapshot is reached. Throws DeserializationException (truncated snapshot or invalid record size) and nlohmann::json::exception (invalid record). */
+inline bool readRecord(std::istream& is, nlohmann::json& object, std::vector<std::uint8_t>& buffer)
+{
+	auto size = std::uint32_t{ 0u };
+	is.read(reinterpret_cast<char*>(&size), sizeof(size));
+	if (!is.good())
+	{
+		throw avdecc::jsonSerializer::DeserializationException{ avdecc::jsonSerializer::DeserializationError::FileReadError, "Truncated snapshot" };
+	}
+	size = AVDECC_UNPACK_DWORD(size);
+	if (size == 0u)
+	{
+		return false;
+	}
+
+	if (size > MaxRecordSize)
+	{
+		throw avdecc::jsonSerializer::DeserializationException{ avdecc::jsonSerializer::DeserializationError::ParseError, "Invalid snapshot record size: " + std::to_string(size) };
+	}
+
+	buffer.clear();
+	auto remaining = size;
+	while (remaining != 0u)
+	{
+		auto const chunkSize = std::min(remaining, ReadChunkSize);
+		auto const offset = buffer.size();
+		buffer.resize(offset + chunkSize);
+		is.read(reinterpret_cast<char*>(buffer.data() + offset), chunkSize);
+		if (!is.good())
+		{
+			throw avdecc::jsonSerializer::DeserializationException{ avdecc::jsonSerializer::DeserializationError::FileReadError, "Truncated snapshot" };
+		}
+		remaining -= chunkSize;
+	}
+	object = nlohmann::json::from_msgpack(buffer);
+	return true;
+}
+
+} // namespace snapshot
+} // namespace controller
+} // namespace avdecc
+} // namespace la
@@ -0,0 +1,607 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @file avdeccEntityModelCache.cpp
+* @author Christophe Calmejane
+*/
+
+#include "avdeccEntityModelCache.hpp"
+
+#include <la/avdecc/internals/endian.hpp>
+#include <la/avdecc/utils.hpp>
+#ifdef ENABLE_AVDECC_FEATURE_JSON
+#	include <la/avdecc/internals/jsonSerialization.hpp>
+#endif // ENABLE_AVDECC_FEATURE_JSON
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#ifdef ENABLE_AVDECC_FEATURE_JSON
+#	ifdef _WIN32
+#		include <Windows.h>
+#	else // !_WIN32
+#		include <fcntl.h>
+#		include <sys/mman.h>
+#		include <sys/stat.h>
+#		include <unistd.h>
+#	endif // _WIN32
+#endif // ENABLE_AVDECC_FEATURE_JSON
+
+namespace la
+{
+namespace avdecc
+{
+namespace controller
+{
+#ifdef ENABLE_AVDECC_FEATURE_JSON
+namespace
+{
+/*
+* Persistent store file layout (all values in network order):
+*  - Magic 'AEMC' (4 bytes)
+*  - Format version (4 bytes), see EntityModelCache::PersistentFormatVersion
+*  - EntityModelID (8 bytes)
+*  - Payload length (4 bytes)
+*  - Payload CRC-32 (4 bytes)
+*  - Payload: static EntityModel serialized in binary format (MessagePack)
+*/
+constexpr auto FileMagic = std::array<std::uint8_t, 4>{ 'A', 'E', 'M', 'C' };
+constexpr auto FileHeaderSize = size_t{ 24u };
+constexpr auto SerializationFlags = entity::model::jsonSerializer::Flags{ entity::model::jsonSerializer::Flag::ProcessStaticModel, entity::model::jsonSerializer::Flag::BinaryFormat, entity::model::jsonSerializer::Flag::IgnoreAEMSanityChecks };
+
+constexpr std::array<std::uint32_t, 256> makeCrc32Table() noexcept
+{
+	auto table = std::array<std::uint32_t, 256>{};
+	for (auto i = std::uint32_t{ 0u }; i < 256u; ++i)
+	{
+		auto crc = i;
+		for (auto bit = 0; bit < 8; ++bit)
+		{
+			crc = (crc & 1u) ? (0xEDB88320u ^ (crc >> 1)) : (crc >> 1);
+		}
+		table[i] = crc;
+	}
+	return table;
+}
+
+std::uint32_t computeCrc32(std::uint8_t const* const data, size_t const size) noexcept
+{
+	static constexpr auto s_table = makeCrc32Table();
+
+	auto crc = std::uint32_t{ 0xFFFFFFFFu };
+	for (auto i = size_t{ 0u }; i < size; ++i)
+	{
+		crc = s_table[(crc ^ data[i]) & 0xFFu] ^ (crc >> 8);
+	}
+	return crc ^ 0xFFFFFFFFu;
+}
+
+template<typename T>
+void writeValue(std::uint8_t*& ptr, T const value) noexcept
+{
+	auto const packed = AVDECC_PACK_TYPE(value, T);
+	std::memcpy(ptr, &packed, sizeof(T));
+	ptr += sizeof(T);
+}
+
+template<typename T>
+T readValue(std::uint8_t const*& ptr) noexcept
+{
+	auto value = T{};
+	std::memcpy(&value, ptr, sizeof(T));
+	ptr += sizeof(T);
+	return AVDECC_UNPACK_TYPE(value, T);
+}
+
+/** Descriptor counts of the configurations are not part of the serialized model, rebuild the top level ones from the tree */
+void rebuildDescriptorCounts(entity::model::EntityTree& tree) noexcept
+{
+	for (auto& [configIndex, configTree] : tree.configurationTrees)
+	{
+		auto& descriptorCounts = configTree.staticModel.getMutable().descriptorCounts;
+		auto const setCount = [&descriptorCounts](entity::model::DescriptorType const descriptorType, auto const& models)
+		{
+			if (!models.empty())
+			{
+				descriptorCounts[descriptorType] = static_cast<std::uint16_t>(models.size());
+			}
+		};
+
+		setCount(entity::model::DescriptorType::AudioUnit, configTree.audioUnitModels);
+		setCount(entity::model::DescriptorType::StreamInput, configTree.streamInputModels);
+		setCount(entity::model::DescriptorType::StreamOutput, configTree.streamOutputModels);
+		setCount(entity::model::DescriptorType::AvbInterface, configTree.avbInterfaceModels);
+		setCount(entity::model::DescriptorType::ClockSource, configTree.clockSourceModels);
+		setCount(entity::model::DescriptorType::MemoryObject, configTree.memoryObjectModels);
+		setCount(entity::model::DescriptorType::Locale, configTree.localeModels);
+		setCount(entity::model::DescriptorType::Control, configTree.controlModels);
+		setCount(entity::model::DescriptorType::ClockDomain, configTree.clockDomainModels);
+	}
+}
+
+/** Read-only memory mapping of a whole file */
+class MappedFile final
+{
+public:
+	explicit MappedFile(std::string const& filePath) noexcept
+	{
+#	ifdef _WIN32
+		auto const file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return;
+		}
+		auto fileSize = LARGE_INTEGER{};
+		if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+		{
+			if (auto const mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr); mapping != nullptr)
+			{
+				if (auto* const view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0); view != nullptr)
+				{
+					_data = static_cast<std::uint8_t const*>(view);
+					_size = static_cast<size_t>(fileSize.QuadPart);
+				}
+				CloseHandle(mapping);
+			}
+		}
+		CloseHandle(file);
+#	else // !_WIN32
+		auto const fd = ::open(filePath.c_str(), O_RDONLY);
+		if (fd == -1)
+		{
+			return;
+		}
+		struct stat st;
+		if (::fstat(fd, &st) == 0 && st.st_size > 0)
+		{
+			if (auto* const addr = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0); addr != MAP_FAILED)
+			{
+				_data = static_cast<std::uint8_t const*>(addr);
+				_size = static_cast<size_t>(st.st_size);
+			}
+		}
+		::close(fd);
+#	endif // _WIN32
+	}
+
+	~MappedFile() noexcept
+	{
+		if (_data != nullptr)
+		{
+#	ifdef _WIN32
+			UnmapViewOfFile(_data);
+#	else // !_WIN32
+			::munmap(const_cast<std::uint8_t*>(_data), _size);
+#	endif // _WIN32
+		}
+	}
+
+	std::uint8_t const* data() const noexcept
+	{
+		return _data;
+	}
+
+	size_t size() const noexcept
+	{
+		return _size;
+	}
+
+	// Deleted compiler auto-generated methods
+	MappedFile(MappedFile&&) = delete;
+	MappedFile(MappedFile const&) = delete;
+	MappedFile& operator=(MappedFile const&) = delete;
+	MappedFile& operator=(MappedFile&&) = delete;
+
+private:
+	std::uint8_t const* _data{ nullptr };
+	size_t _size{ 0u };
+};
+
+} // namespace
+#endif // ENABLE_AVDECC_FEATURE_JSON
+
+EntityModelCache::~EntityModelCache() noexcept
+{
+	stopPersistentStoreThread();
+}
+
+std::shared_ptr<entity::model::EntityTree const> EntityModelCache::getCachedEntityTree(UniqueIdentifier const entityModelID) noexcept
+{
+	AVDECC_ASSERT(_isEnabled, "Should not call AEM cache if cache is not enabled");
+	AVDECC_ASSERT(entityModelID, "Should not call AEM cache if EntityModelID is invalid");
+	auto const lg = std::lock_guard{ _lock };
+
+	if (_isEnabled && entityModelID)
+	{
+		auto const entityModelIt = _modelCache.find(entityModelID);
+		if (entityModelIt != _modelCache.end())
+		{
+			return entityModelIt->second;
+		}
+	}
+
+	return nullptr;
+}
+
+void EntityModelCache::preloadEntityTree(UniqueIdentifier const entityModelID) noexcept
+{
+	auto const lg = std::lock_guard{ _lock };
+
+	// Nothing to load if not persistent, already in memory, known to be missing from the persistent store, or already being loaded
+	if (!_isEnabled || !entityModelID || _persistentDirectory.empty() || _modelCache.count(entityModelID) != 0 || _persistentMisses.count(entityModelID) != 0 || std::find(_pendingLoads.begin(), _pendingLoads.end(), entityModelID) != _pendingLoads.end())
+	{
+		return;
+	}
+
+	_pendingLoads.push_back(entityModelID);
+	_persistentStoreCondition.notify_one();
+}
+
+std::shared_ptr<entity::model::EntityTree const> EntityModelCache::makeStaticEntityTree(entity::model::EntityTree const& tree) noexcept
+{
+	// Make a copy of the passed tree as we want to remove all the dynamic part from it (static models are not copied, only shared)
+	auto staticTree = std::make_shared<entity::model::EntityTree>(tree);
+
+	// Wipe all the dynamic model
+	staticTree->dynamicModel = {};
+	for (auto& configKV : staticTree->configurationTrees)
+	{
+		auto& config = configKV.second;
+		config.dynamicModel = {};
+		for (auto& KV : config.audioUnitModels)
+		{
+			KV.second.dynamicModel = {};
+		}
+		for (auto& KV : config.streamInputModels)
+		{
+			KV.second.dynamicModel = {};
+		}
+		for (auto& KV : config.streamOutputModels)
+		{
+			KV.second.dynamicModel = {};
+		}
+		for (auto& KV : config.avbInterfaceModels)
+		{
+			KV.second.dynamicModel = {};
+		}
+		for (auto& KV : config.clockSourceModels)
+		{
+			KV.second.dynamicModel = {};
+		}
+		for (auto& KV : config.memoryObjectModels)
+		{
+			KV.second.dynamicModel = {};
+		}
+		// LocaleNodeModel doesn't have dynamic model
+		// StringsNodeModel doesn't have dynamic model
+		for (auto& KV : config.streamPortInputModels)
+		{
+			KV.second.dynamicModel = {};
+		}
+		for (auto& KV : config.streamPortOutputModels)
+		{
+			KV.second.dynamicModel = {};
+		}
+		for (auto& KV : config.audioClusterModels)
+		{
+			KV.second.dynamicModel = {};
+		}
+		// AudioMapNodeModel doesn't have dynamic model
+		for (auto& KV : config.controlModels)
+		{
+			KV.second.dynamicModel = {};
+		}
+		for (auto& KV : config.clockDomainModels)
+		{
+			KV.second.dynamicModel = {};
+		}
+	}
+
+	return staticTree;
+}
+
+void EntityModelCache::cacheEntityTree(UniqueIdentifier const entityModelID, entity::model::EntityTree const& tree) noexcept
+{
+	AVDECC_ASSERT(_isEnabled, "Should not call AEM cache if cache is not enabled");
+	AVDECC_ASSERT(entityModelID, "Should not call AEM cache if EntityModelID is invalid");
+	auto const lg = std::lock_guard{ _lock };
+
+	if (_isEnabled && entityModelID)
+	{
+		// Cache the EntityModel but only if not already in cache
+		if (_modelCache.count(entityModelID) == 0)
+		{
+			auto cachedTree = makeStaticEntityTree(tree);
+
+			// Queue it for the persistent store (tree is immutable from now on, it can safely be serialized from the writer thread)
+			if (!_persistentDirectory.empty())
+			{
+				_pendingWrites.push_back(PendingWrite{ getPersistentFilePath(_persistentDirectory, entityModelID), entityModelID, cachedTree });
+				_persistentMisses.erase(entityModelID);
+				_persistentStoreCondition.notify_one();
+			}
+
+			// Move it to the cache
+			_modelCache.insert(std::make_pair(entityModelID, std::move(cachedTree)));
+		}
+	}
+}
+
+bool EntityModelCache::enablePersistence([[maybe_unused]] std::string const& directoryPath) noexcept
+{
+#ifndef ENABLE_AVDECC_FEATURE_JSON
+	return false;
+
+#else // ENABLE_AVDECC_FEATURE_JSON
+	if (directoryPath.empty())
+	{
+		return false;
+	}
+
+	auto const persistentStoreLg = std::lock_guard{ _persistentStoreThreadLock };
+	auto const lg = std::lock_guard{ _lock };
+
+	if (!_persistentStoreThread.joinable())
+	{
+		try
+		{
+			_shouldTerminatePersistentStore = false;
+			_persistentStoreThread = std::thread{ &EntityModelCache::persistentStoreThread, this };
+		}
+		catch (...)
+		{
+			return false;
+		}
+	}
+
+	_persistentDirectory = directoryPath;
+	_persistentMisses.clear();
+
+	return true;
+#endif // ENABLE_AVDECC_FEATURE_JSON
+}
+
+void EntityModelCache::disablePersistence() noexcept
+{
+	{
+		auto const lg = std::lock_guard{ _lock };
+
+		_persistentDirectory.clear();
+		_persistentMisses.clear();
+		_pendingLoads.clear();
+	}
+
+	stopPersistentStoreThread();
+}
+
+void EntityModelCache::flushPersistentStore() noexcept
+{
+	auto lock = std::unique_lock{ _lock };
+
+	_flushCondition.wait(lock,
+		[this]
+		{
+			return _pendingLoads.empty() && _pendingWrites.empty();
+		});
+}
+
+std::string EntityModelCache::getPersistentFilePath(std::string const& directoryPath, UniqueIdentifier const entityModelID) noexcept
+{
+	// Strip the "0x" prefix from the file name
+	return directoryPath + "/" + utils::toHexString(entityModelID, true, true).substr(2) + PersistentFileExtension;
+}
+
+bool EntityModelCache::writePersistentFile([[maybe_unused]] std::string const& filePath, [[maybe_unused]] UniqueIdentifier const entityModelID, [[maybe_unused]] entity::model::EntityTree const& tree) noexcept
+{
+#ifndef ENABLE_AVDECC_FEATURE_JSON
+	return false;
+
+#else // ENABLE_AVDECC_FEATURE_JSON
+	try
+	{
+		auto const payload = nlohmann::json::to_msgpack(entity::model::jsonSerializer::createJsonObject(tree, SerializationFlags));
+		if (payload.size() > std::numeric_limits<std::uint32_t>::max())
+		{
+			return false;
+		}
+
+		auto header = std::array<std::uint8_t, FileHeaderSize>{};
+		auto* ptr = header.data();
+		std::memcpy(ptr, FileMagic.data(), FileMagic.size());
+		ptr += FileMagic.size();
+		writeValue(ptr, PersistentFormatVersion);
+		writeValue(ptr, entityModelID.getValue());
+		writeValue(ptr, static_cast<std::uint32_t>(payload.size()));
+		writeValue(ptr, computeCrc32(payload.data(), payload.size()));
+
+		// Write to a temporary file first, then rename it so that readers never see a partially written file
+		auto const tempFilePath = filePath + ".tmp";
+		{
+			auto ofs = std::ofstream{ tempFilePath, std::ios::binary | std::ios::out | std::ios::trunc };
+			if (!ofs.is_open())
+			{
+				return false;
+			}
+			ofs.write(reinterpret_cast<char const*>(header.data()), header.size());
+			ofs.write(reinterpret_cast<char const*>(payload.data()), payload.size());
+			if (!ofs.good())
+			{
+				ofs.close();
+				std::remove(tempFilePath.c_str());
+				return false;
+			}
+		}
+
+#	ifdef _WIN32
+		// std::rename does not replace an existing file on Windows
+		std::remove(filePath.c_str());
+#	endif // _WIN32
+		if (std::rename(tempFilePath.c_str(), filePath.c_str()) != 0)
+		{
+			std::remove(tempFilePath.c_str());
+			return false;
+		}
+
+		return true;
+	}
+	catch (...)
+	{
+		return false;
+	}
+#endif // ENABLE_AVDECC_FEATURE_JSON
+}
+
+std::shared_ptr<entity::model::EntityTree const> EntityModelCache::readPersistentFile([[maybe_unused]] std::string const& filePath, [[maybe_unused]] UniqueIdentifier const entityModelID) noexcept
+{
+#ifndef ENABLE_AVDECC_FEATURE_JSON
+	return nullptr;
+
+#else // ENABLE_AVDECC_FEATURE_JSON
+	auto const file = MappedFile{ filePath };
+	if (file.size() < FileHeaderSize)
+	{
+		return nullptr;
+	}
+
+	// Validate the header
+	auto const* ptr = file.data();
+	if (std::memcmp(ptr, FileMagic.data(), FileMagic.size()) != 0)
+	{
+		return nullptr;
+	}
+	ptr += FileMagic.size();
+	auto const formatVersion = readValue<std::uint32_t>(ptr);
+	auto const fileEntityModelID = readValue<UniqueIdentifier::value_type>(ptr);
+	auto const payloadSize = readValue<std::uint32_t>(ptr);
+	auto const payloadCrc = readValue<std::uint32_t>(ptr);
+	if (formatVersion != PersistentFormatVersion || fileEntityModelID != entityModelID.getValue() || payloadSize != (file.size() - FileHeaderSize))
+	{
+		return nullptr;
+	}
+
+	// Validate the payload
+	if (computeCrc32(ptr, payloadSize) != payloadCrc)
+	{
+		return nullptr;
+	}
+
+	try
+	{
+		auto const object = nlohmann::json::from_msgpack(ptr, ptr + payloadSize);
+		auto tree = std::make_shared<entity::model::EntityTree>(entity::model::jsonSerializer::createEntityTree(object, SerializationFlags));
+		rebuildDescriptorCounts(*tree);
+		return tree;
+	}
+	catch (...)
+	{
+		return nullptr;
+	}
+#endif // ENABLE_AVDECC_FEATURE_JSON
+}
+
+void EntityModelCache::stopPersistentStoreThread() noexcept
+{
+	auto const persistentStoreLg = std::lock_guard{ _persistentStoreThreadLock };
+
+	{
+		auto const lg = std::lock_guard{ _lock };
+		_shouldTerminatePersistentStore = true;
+		_persistentStoreCondition.notify_all();
+	}
+
+	// Wait for the thread to write all its pending trees
+	if (_persistentStoreThread.joinable())
+	{
+		_persistentStoreThread.join();
+	}
+}
+
+void EntityModelCache::persistentStoreThread() noexcept
+{
+	utils::setCurrentThreadName("avdecc::EntityModelCache");
+
+	auto lock = std::unique_lock{ _lock };
+	while (true)
+	{
+		_persistentStoreCondition.wait(lock,
+			[this]
+			{
+				return _shouldTerminatePersistentStore || !_pendingLoads.empty() || !_pendingWrites.empty();
+			});
+
+		// Loads first, an entity is probably being enumerated (no need to load anything if we are terminating)
+		if (!_pendingLoads.empty() && !_shouldTerminatePersistentStore)
+		{
+			// Read the file without holding the lock (the element stays in the queue until loaded, for preloadEntityTree and flushPersistentStore)
+			auto const entityModelID = _pendingLoads.front();
+			auto const filePath = getPersistentFilePath(_persistentDirectory, entityModelID);
+			lock.unlock();
+			auto tree = readPersistentFile(filePath, entityModelID);
+			lock.lock();
+
+			// Persistence might have been disabled in the meantime
+			if (!_pendingLoads.empty() && _pendingLoads.front() == entityModelID)
+			{
+				_pendingLoads.pop_front();
+				if (tree)
+				{
+					// Enumeration of an entity might have cached the same model in the meantime, keep that one
+					_modelCache.emplace(entityModelID, std::move(tree));
+				}
+				else
+				{
+					_persistentMisses.insert(entityModelID);
+				}
+			}
+		}
+		else
+		{
+			_pendingLoads.clear();
+
+			// Only terminate once everything has been written
+			if (_pendingWrites.empty())
+			{
+				_flushCondition.notify_all();
+				break;
+			}
+
+			// Write the file without holding the lock (the element stays in the queue until written, for flushPersistentStore)
+			auto const pending = _pendingWrites.front();
+			lock.unlock();
+			writePersistentFile(pending.filePath, pending.entityModelID, *pending.tree);
+			lock.lock();
+
+			_pendingWrites.pop_front();
+		}
+
+		if (_pendingLoads.empty() && _pendingWrites.empty())
+		{
+			_flushCondition.notify_all();
+		}
+	}
+}
+
+} // namespace controller
+} // namespace avdecc
+} // namespace la
@@ -26,11 +26,17 @@
 
 #include <la/avdecc/internals/entityModelTree.hpp>
 
-#include "avdeccControllerLogHelper.hpp"
+#include <la/avdecc/utils.hpp>
 
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <unordered_map>
+#include <unordered_set>
+#include <memory>
 #include <mutex>
-#include <optional>
+#include <string>
+#include <thread>
 
 namespace la
 {
@@ -41,12 +47,25 @@ namespace controller
 class EntityModelCache final
 {
 public:
+	/** Persistent store file format version, to be incremented each time the file layout or the EntityModel serialization changes */
+	static constexpr std::uint32_t PersistentFormatVersion = 1u;
+	static constexpr auto PersistentFileExtension = ".aemcache";
+
 	static EntityModelCache& getInstance() noexcept
 	{
 		static EntityModelCache s_instance{};
 		return s_instance;
 	}
 
+	EntityModelCache() noexcept = default;
+	~EntityModelCache() noexcept;
+
+	// Deleted compiler auto-generated methods
+	EntityModelCache(EntityModelCache&&) = delete;
+	EntityModelCache(EntityModelCache const&) = delete;
+	EntityModelCache& operator=(EntityModelCache const&) = delete;
+	EntityModelCache& operator=(EntityModelCache&&) = delete;
+
 	bool isCacheEnabled() const noexcept
 	{
 		auto const lg = std::lock_guard{ _lock };
@@ -68,97 +87,35 @@ public:
 		_isEnabled = false;
 	}
 
-	std::optional<entity::model::EntityTree> getCachedEntityTree(UniqueIdentifier const entityModelID) const noexcept
-	{
-		AVDECC_ASSERT(_isEnabled, "Should not call AEM cache if cache is not enabled");
-		AVDECC_ASSERT(entityModelID, "Should not call AEM cache if EntityModelID is invalid");
-		auto const lg = std::lock_guard{ _lock };
+	/** Returns the cached EntityTree (only containing the static models) for the specified EntityModelID, or nullptr if not in cache. The returned tree is immutable, its static models are shared with all the entities using it. Only looks in memory, the persistent store is never read from the calling thread (see preloadEntityTree). */
+	std::shared_ptr<entity::model::EntityTree const> getCachedEntityTree(UniqueIdentifier const entityModelID) noexcept;
 
-		if (_isEnabled && entityModelID)
-		{
-			if (auto const entityModelIt = _modelCache.find(entityModelID); entityModelIt != _modelCache.end())
-			{
-				return entityModelIt->second;
-			}
-		}
+	/** If persistence is enabled and the EntityTree for the specified EntityModelID is not in memory, requests the background thread to load it from the persistent store. Never blocks on the persistent store. */
+	void preloadEntityTree(UniqueIdentifier const entityModelID) noexcept;
 
-		return std::nullopt;
-	}
+	/** Caches the static part of the specified EntityTree (if not already in cache). If persistence is enabled, the tree is also written to the persistent store from a background thread. */
+	void cacheEntityTree(UniqueIdentifier const entityModelID, entity::model::EntityTree const& tree) noexcept;
 
-	void cacheEntityTree(UniqueIdentifier const entityModelID, entity::model::EntityTree const& tree) noexcept
-	{
-		AVDECC_ASSERT(_isEnabled, "Should not call AEM cache if cache is not enabled");
-		AVDECC_ASSERT(entityModelID, "Should not call AEM cache if EntityModelID is invalid");
-		auto const lg = std::lock_guard{ _lock };
+	/** Returns a copy of the specified EntityTree with all its dynamic models wiped (static models are shared, not copied) */
+	static std::shared_ptr<entity::model::EntityTree const> makeStaticEntityTree(entity::model::EntityTree const& tree) noexcept;
 
-		if (_isEnabled && entityModelID)
-		{
-			// Cache the EntityModel but only if not already in cache
-			if (_modelCache.count(entityModelID) == 0)
-			{
-				// Make a copy of the passed tree as we want to remove all the dynamic part from it
-				auto cachedTree = tree;
-
-				// Wipe all the dynamic model
-				cachedTree.dynamicModel = {};
-				for (auto& configKV : cachedTree.configurationTrees)
-				{
-					auto& config = configKV.second;
-					config.dynamicModel = {};
-					for (auto& KV : config.audioUnitModels)
-					{
-						KV.second.dynamicModel = {};
-					}
-					for (auto& KV : config.streamInputModels)
-					{
-						KV.second.dynamicModel = {};
-					}
-					for (auto& KV : config.streamOutputModels)
-					{
-						KV.second.dynamicModel = {};
-					}
-					for (auto& KV : config.avbInterfaceModels)
-					{
-						KV.second.dynamicModel = {};
-					}
-					for (auto& KV : config.clockSourceModels)
-					{
-						KV.second.dynamicModel = {};
-					}
-					for (auto& KV : config.memoryObjectModels)
-					{
-						KV.second.dynamicModel = {};
-					}
-					// LocaleNodeModel doesn't have dynamic model
-					// StringsNodeModel doesn't have dynamic model
-					for (auto& KV : config.streamPortInputModels)
-					{
-						KV.second.dynamicModel = {};
-					}
-					for (auto& KV : config.streamPortOutputModels)
-					{
-						KV.second.dynamicModel = {};
-					}
-					for (auto& KV : config.audioClusterModels)
-					{
-						KV.second.dynamicModel = {};
-					}
-					// AudioMapNodeModel doesn't have dynamic model
-					for (auto& KV : config.controlModels)
-					{
-						KV.second.dynamicModel = {};
-					}
-					for (auto& KV : config.clockDomainModels)
-					{
-						KV.second.dynamicModel = {};
-					}
-				}
-
-				// Move it to the cache
-				_modelCache.insert(std::make_pair(entityModelID, std::move(cachedTree)));
-			}
-		}
-	}
+	/** Enables persistence of the cache in the specified (existing) directory, one file per EntityModelID. Returns false if persistence is not supported (JSON feature not compiled) or the background thread could not be started. */
+	bool enablePersistence(std::string const& directoryPath) noexcept;
+
+	/** Disables persistence of the cache, after all pending writes have completed. Models already loaded in memory are kept. */
+	void disablePersistence() noexcept;
+
+	/** Blocks until all pending loads from and writes to the persistent store have completed */
+	void flushPersistentStore() noexcept;
+
+	/** Returns the path of the persistent store file for the specified EntityModelID */
+	static std::string getPersistentFilePath(std::string const& directoryPath, UniqueIdentifier const entityModelID) noexcept;
+
+	/** Writes the specified EntityTree to the specified file. Returns false on failure. */
+	static bool writePersistentFile(std::string const& filePath, UniqueIdentifier const entityModelID, entity::model::EntityTree const& tree) noexcept;
+
+	/** Reads an EntityTree from the specified file (memory mapped), checking the format version, the EntityModelID and the checksum. Returns nullptr on failure. */
+	static std::shared_ptr<entity::model::EntityTree const> readPersistentFile(std::string const& filePath, UniqueIdentifier const entityModelID) noexcept;
 
 	static inline bool isValidEntityModelID(UniqueIdentifier const entityModelID) noexcept
 	{
@@ -170,7 +127,7 @@ public:
 	{
 		// Check TOP LEVEL descriptors count. If the declared count does not match what is stored in the tree, it probably means we didn't have a valid tree for this configuration (model was only partially stored)
 		// Currently, we don't want to check more deeply as we trust both the AEM loader and the enumeration state machine to give us a valid model
-		auto const& descriptorCounts = configTree.staticModel.descriptorCounts;
+		auto const& descriptorCounts = configTree.staticModel->descriptorCounts;
 		if (!validateDescriptorCount(descriptorCounts, entity::model::DescriptorType::AudioUnit, configTree.audioUnitModels))
 		{
 			return false;
@@ -218,9 +175,29 @@ private:
 		return tree.size() == count;
 	}
 
+	struct PendingWrite
+	{
+		std::string filePath{};
+		UniqueIdentifier entityModelID{};
+		std::shared_ptr<entity::model::EntityTree const> tree{};
+	};
+
+	void stopPersistentStoreThread() noexcept;
+	void persistentStoreThread() noexcept;
+
 	mutable std::mutex _lock{};
-	std::unordered_map<UniqueIdentifier, entity::model::EntityTree, la::avdecc::UniqueIdentifier::hash> _modelCache{};
+	std::unordered_map<UniqueIdentifier, std::shared_ptr<entity::model::EntityTree const>, la::avdecc::UniqueIdentifier::hash> _modelCache{};
 	bool _isEnabled{ false };
+	// Persistent store
+	std::string _persistentDirectory{};
+	std::unordered_set<UniqueIdentifier, la::avdecc::UniqueIdentifier::hash> _persistentMisses{}; // EntityModelIDs not found (or invalid) in the persistent store, not looked up again
+	std::deque<UniqueIdentifier> _pendingLoads{}; // Front element is the one being loaded
+	std::deque<PendingWrite> _pendingWrites{}; // Front element is the one being written
+	std::condition_variable _persistentStoreCondition{};
+	std::condition_variable _flushCondition{};
+	std::mutex _persistentStoreThreadLock{}; // Serializes starting and stopping the background thread (always taken before _lock)
+	std::thread _persistentStoreThread{};
+	bool _shouldTerminatePersistentStore{ false };
 };
 
 } // namespace controller
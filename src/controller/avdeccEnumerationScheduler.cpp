@@ -0,0 +1,201 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @file avdeccEnumerationScheduler.cpp
+* @author Christophe Calmejane
+*/
+
+#include "avdeccEnumerationScheduler.hpp"
+
+#include <algorithm>
+
+namespace la
+{
+namespace avdecc
+{
+namespace controller
+{
+EnumerationScheduler::EntityIDs EnumerationScheduler::setMaxConcurrentEnumerations(std::uint32_t const maxConcurrentEnumerations) noexcept
+{
+	auto const lg = std::lock_guard{ _lock };
+
+	_maxConcurrentEnumerations = maxConcurrentEnumerations;
+	_limit = maxConcurrentEnumerations;
+	// Allow an immediate decrease on the first enumeration that times out
+	_endedSinceDecrease = _limit;
+	_endedWithoutTimeout = 0u;
+
+	return admitQueued();
+}
+
+std::uint32_t EnumerationScheduler::getMaxConcurrentEnumerations() const noexcept
+{
+	auto const lg = std::lock_guard{ _lock };
+
+	return _maxConcurrentEnumerations;
+}
+
+std::uint32_t EnumerationScheduler::getConcurrentEnumerationsLimit() const noexcept
+{
+	auto const lg = std::lock_guard{ _lock };
+
+	return _limit;
+}
+
+void EnumerationScheduler::setPriorities(EntityIDs const& priorities) noexcept
+{
+	auto const lg = std::lock_guard{ _lock };
+
+	_priorities = priorities;
+
+	// Update the priority of already queued entities
+	for (auto& queued : _queue)
+	{
+		queued.priority = getPriority(queued.entityID, queued.entityModelID);
+	}
+}
+
+bool EnumerationScheduler::requestEnumeration(UniqueIdentifier const entityID, UniqueIdentifier const entityModelID) noexcept
+{
+	auto const lg = std::lock_guard{ _lock };
+
+	// Only queue if other entities are already waiting (so that they keep their turn) or if the limit is reached
+	if (_queue.empty() && isBelowLimit())
+	{
+		_enumerating.insert(entityID);
+		return true;
+	}
+
+	_queue.push_back(QueuedEntity{ entityID, entityModelID, getPriority(entityID, entityModelID), _nextSequence++ });
+	return false;
+}
+
+EnumerationScheduler::EntityIDs EnumerationScheduler::onEnumerationEnded(UniqueIdentifier const entityID, bool const gotTimeouts) noexcept
+{
+	auto const lg = std::lock_guard{ _lock };
+
+	// Entity was still waiting for its turn
+	if (auto const queuedIt = std::find_if(_queue.begin(), _queue.end(),
+				[entityID](auto const& queued)
+				{
+					return queued.entityID == entityID;
+				});
+			queuedIt != _queue.end())
+	{
+		_queue.erase(queuedIt);
+		return {};
+	}
+
+	// Unknown entity (enumerated without admission control, or already ended)
+	if (_enumerating.erase(entityID) == 0u)
+	{
+		return {};
+	}
+
+	// Adapt the limit to the observed timeouts
+	if (_maxConcurrentEnumerations != 0u)
+	{
+		++_endedSinceDecrease;
+		if (gotTimeouts)
+		{
+			_endedWithoutTimeout = 0u;
+			// Only decrease once per window, the enumerations running at the time of the decrease probably got the same timeouts
+			if (_endedSinceDecrease >= _limit)
+			{
+				_limit = std::max(1u, _limit / 2u);
+				_endedSinceDecrease = 0u;
+			}
+		}
+		else
+		{
+			++_endedWithoutTimeout;
+			if (_endedWithoutTimeout >= _limit && _limit < _maxConcurrentEnumerations)
+			{
+				++_limit;
+				_endedWithoutTimeout = 0u;
+			}
+		}
+	}
+
+	return admitQueued();
+}
+
+size_t EnumerationScheduler::getEnumeratingCount() const noexcept
+{
+	auto const lg = std::lock_guard{ _lock };
+
+	return _enumerating.size();
+}
+
+size_t EnumerationScheduler::getQueuedCount() const noexcept
+{
+	auto const lg = std::lock_guard{ _lock };
+
+	return _queue.size();
+}
+
+size_t EnumerationScheduler::getPriority(UniqueIdentifier const entityID, UniqueIdentifier const entityModelID) const noexcept
+{
+	auto priority = _priorities.size();
+
+	for (auto index = size_t{ 0u }; index < _priorities.size(); ++index)
+	{
+		auto const& identifier = _priorities[index];
+		// EntityID takes precedence over EntityModelID
+		if (identifier == entityID)
+		{
+			return index;
+		}
+		if (entityModelID && identifier == entityModelID)
+		{
+			priority = std::min(priority, index);
+		}
+	}
+
+	return priority;
+}
+
+bool EnumerationScheduler::isBelowLimit() const noexcept
+{
+	return _limit == 0u || _enumerating.size() < _limit;
+}
+
+EnumerationScheduler::EntityIDs EnumerationScheduler::admitQueued() noexcept
+{
+	auto admitted = EntityIDs{};
+
+	while (!_queue.empty() && isBelowLimit())
+	{
+		auto const nextIt = std::min_element(_queue.begin(), _queue.end(),
+			[](auto const& lhs, auto const& rhs)
+			{
+				return lhs.priority < rhs.priority || (lhs.priority == rhs.priority && lhs.sequence < rhs.sequence);
+			});
+		_enumerating.insert(nextIt->entityID);
+		admitted.push_back(nextIt->entityID);
+		_queue.erase(nextIt);
+	}
+
+	return admitted;
+}
+
+} // namespace controller
+} // namespace avdecc
+} // namespace la
@@ -0,0 +1,104 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @file avdeccEnumerationScheduler.hpp
+* @author Christophe Calmejane
+* @brief Admission control of entities enumeration.
+*/
+
+#pragma once
+
+#include <la/avdecc/utils.hpp>
+#include <la/avdecc/internals/uniqueIdentifier.hpp>
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+namespace la
+{
+namespace avdecc
+{
+namespace controller
+{
+/**
+* @brief Limits the number of entities being enumerated at the same time.
+* @details Entities requesting an enumeration while the limit is reached are queued, and admitted by priority order (then by request order) when another enumeration ends.
+*          The effective limit adapts to the observed AECP timeouts, like a congestion window: it is halved (at most once per window of enumerations) when an enumeration got timeouts,
+*          and grows back by one (up to the configured maximum) after each window of enumerations without timeout.
+*          Thread-safe.
+*/
+class EnumerationScheduler final
+{
+public:
+	using EntityIDs = std::vector<UniqueIdentifier>;
+
+	/** Sets the maximum number of entities enumerated at the same time (0 for no limit), and resets the effective limit to it. Returns the queued entities that are now admitted, the caller has to start their enumeration. */
+	EntityIDs setMaxConcurrentEnumerations(std::uint32_t const maxConcurrentEnumerations) noexcept;
+
+	/** Returns the configured maximum number of entities enumerated at the same time (0 for no limit) */
+	std::uint32_t getMaxConcurrentEnumerations() const noexcept;
+
+	/** Returns the current (adapted) limit of entities enumerated at the same time (0 for no limit) */
+	std::uint32_t getConcurrentEnumerationsLimit() const noexcept;
+
+	/** Sets the identifiers of the entities to enumerate first, by decreasing priority. An identifier can either be an EntityID or an EntityModelID (EntityID takes precedence). */
+	void setPriorities(EntityIDs const& priorities) noexcept;
+
+	/** Requests the enumeration of an entity. Returns true if the enumeration can start right away, otherwise the entity is queued until it's admitted (returned by onEnumerationEnded or setMaxConcurrentEnumerations). */
+	bool requestEnumeration(UniqueIdentifier const entityID, UniqueIdentifier const entityModelID) noexcept;
+
+	/** Notifies the enumeration of an entity is over (completed, failed, or entity went offline, whether it was admitted or still queued). Returns the queued entities that are now admitted, the caller has to start their enumeration. */
+	EntityIDs onEnumerationEnded(UniqueIdentifier const entityID, bool const gotTimeouts) noexcept;
+
+	/** Returns the number of entities currently being enumerated */
+	size_t getEnumeratingCount() const noexcept;
+
+	/** Returns the number of entities waiting to be enumerated */
+	size_t getQueuedCount() const noexcept;
+
+private:
+	struct QueuedEntity
+	{
+		UniqueIdentifier entityID{};
+		UniqueIdentifier entityModelID{};
+		size_t priority{ 0u }; // Lower is higher priority
+		std::uint64_t sequence{ 0u }; // Request order, for entities with the same priority
+	};
+
+	size_t getPriority(UniqueIdentifier const entityID, UniqueIdentifier const entityModelID) const noexcept;
+	bool isBelowLimit() const noexcept;
+	EntityIDs admitQueued() noexcept;
+
+	mutable std::mutex _lock{};
+	std::uint32_t _maxConcurrentEnumerations{ 0u };
+	std::uint32_t _limit{ 0u };
+	std::uint32_t _endedSinceDecrease{ 0u }; // Enumerations ended since the limit was last decreased
+	std::uint32_t _endedWithoutTimeout{ 0u }; // Consecutive enumerations ended without timeout since the limit was last changed
+	EntityIDs _priorities{};
+	std::unordered_set<UniqueIdentifier, UniqueIdentifier::hash> _enumerating{};
+	std::vector<QueuedEntity> _queue{};
+	std::uint64_t _nextSequence{ 0u };
+};
+
+} // namespace controller
+} // namespace avdecc
+} // namespace la
@@ -119,6 +119,11 @@ entity::AggregateEntity* EndStationImpl::addAggregateEntity(std::uint16_t const
 	return aggregatePtr;
 }
 
+protocol::ProtocolInterface* EndStationImpl::getProtocolInterface() noexcept
+{
+	return _protocolInterface.get();
+}
+
 /** Destroy method for COM-like interface */
 void EndStationImpl::destroy() noexcept
 {
@@ -131,7 +136,11 @@ EndStation* LA_AVDECC_CALL_CONVENTION EndStation::createRawEndStation(protocol::
 	try
 	{
 		// We must create the executor before creating ProtocolInterface (function parameters sequencing is still undefined in c++20, so we force creation in a preceding expression)
+#ifdef ENABLE_AVDECC_LOCKFREE_EXECUTOR
+		auto executorWrapper = ExecutorManager::getInstance().registerExecutor(protocol::ProtocolInterface::DefaultExecutorName, ExecutorWithLockFreeDispatchQueue::create(protocol::ProtocolInterface::DefaultExecutorName, utils::ThreadPriority::Highest));
+#else // !ENABLE_AVDECC_LOCKFREE_EXECUTOR
 		auto executorWrapper = ExecutorManager::getInstance().registerExecutor(protocol::ProtocolInterface::DefaultExecutorName, ExecutorWithDispatchQueue::create(protocol::ProtocolInterface::DefaultExecutorName, utils::ThreadPriority::Highest));
+#endif // ENABLE_AVDECC_LOCKFREE_EXECUTOR
 		return new EndStationImpl(std::move(executorWrapper), protocol::ProtocolInterface::create(protocolInterfaceType, networkInterfaceName));
 	}
 	catch (protocol::ProtocolInterface::Exception const& e)
@@ -30,6 +30,7 @@
 
 #include "controllerCapabilityDelegate.hpp"
 #include "protocol/protocolAemPayloads.hpp"
+#include "protocol/protocolDispatchTable.hpp"
 #include "protocol/protocolMvuPayloads.hpp"
 
 #include <exception>
@@ -55,6 +56,13 @@ static model::AsPath const s_emptyAsPath{}; // Empty AsPath used by timeout call
 static model::AvdeccFixedString const s_emptyAvdeccFixedString{}; // Empty AvdeccFixedString used by timeout callback (needs a ref to a std::string)
 static model::MilanInfo const s_emptyMilanInfo{}; // Empty MilanInfo used by timeout callback (need a ref to a MilanInfo)
 
+/* ************************************************************************** */
+/* Dispatch tables sizes                                                      */
+/* ************************************************************************** */
+static constexpr auto AemCommandTypeTableSize = size_t{ 0x004b }; // Highest standard AEM command_type (GET_STREAM_BACKUP) + 1
+static constexpr auto MvuCommandTypeTableSize = size_t{ 16u }; // Enough for all currently defined MVU command_type
+static constexpr auto AcmpMessageTypeTableSize = size_t{ 16u }; // ACMP message_type is a 4 bits field
+
 /* ************************************************************************** */
 /* Exceptions                                                                 */
 /* ************************************************************************** */
@@ -1998,7 +2006,14 @@ void CapabilityDelegate::processAemAecpResponse(protocol::AemCommandType const c
 		return;
 	}
 
-	static std::unordered_map<protocol::AemCommandType::value_type, std::function<void(controller::Delegate* const delegate, Interface const* const controllerInterface, LocalEntity::AemCommandStatus const status, protocol::AemAecpdu const& aem, LocalEntityImpl<>::AnswerCallback const& answerCallback, LocalEntityImpl<>::AnswerCallback::Callback const& protocolViolationCallback)>> s_Dispatch
+	// Nobody to notify (no handler for this response, and no delegate for an unsolicited one), don't bother deserializing the payload
+	if (!answerCallback.hasHandler() && (!aem.getUnsolicited() || _controllerDelegate == nullptr))
+	{
+		return;
+	}
+
+	using DispatchHandler = void (*)(controller::Delegate* const delegate, Interface const* const controllerInterface, LocalEntity::AemCommandStatus const status, protocol::AemAecpdu const& aem, LocalEntityImpl<>::AnswerCallback const& answerCallback, LocalEntityImpl<>::AnswerCallback::Callback const& protocolViolationCallback);
+	static auto const s_Dispatch = protocol::DispatchTable<protocol::AemCommandType::value_type, DispatchHandler, AemCommandTypeTableSize>
 	{
 		// Acquire Entity
 		{ protocol::AemCommandType::AcquireEntity.getValue(), [](controller::Delegate* const delegate, Interface const* const controllerInterface, LocalEntity::AemCommandStatus const status, protocol::AemAecpdu const& aem, LocalEntityImpl<>::AnswerCallback const& answerCallback, LocalEntityImpl<>::AnswerCallback::Callback const& protocolViolationCallback)
@@ -3313,8 +3328,8 @@ void CapabilityDelegate::processAemAecpResponse(protocol::AemCommandType const c
 		// Get Stream Backup
 	};
 
-	auto const& it = s_Dispatch.find(responseCommandType.getValue());
-	if (it == s_Dispatch.end())
+	auto const handler = s_Dispatch.find(responseCommandType.getValue());
+	if (handler == nullptr)
 	{
 		// If this is an unsolicited notification, simply log we do not handle the message
 		if (aem.getUnsolicited())
@@ -3350,7 +3365,7 @@ void CapabilityDelegate::processAemAecpResponse(protocol::AemCommandType const c
 
 		try
 		{
-			it->second(_controllerDelegate, &_controllerInterface, status, aem, answerCallback, protocolViolationCallback);
+			handler(_controllerDelegate, &_controllerInterface, status, aem, answerCallback, protocolViolationCallback);
 		}
 		catch (protocol::aemPayload::IncorrectPayloadSizeException const& e)
 		{
@@ -3403,7 +3418,8 @@ void CapabilityDelegate::processMvuAecpResponse(protocol::MvuCommandType const c
 		return;
 	}
 
-	static std::unordered_map<protocol::MvuCommandType::value_type, std::function<void(controller::Delegate* const delegate, Interface const* const controllerInterface, LocalEntity::MvuCommandStatus const status, protocol::MvuAecpdu const& mvu, LocalEntityImpl<>::AnswerCallback const& answerCallback, LocalEntityImpl<>::AnswerCallback::Callback const& protocolViolationCallback)>> s_Dispatch{
+	using DispatchHandler = void (*)(controller::Delegate* const delegate, Interface const* const controllerInterface, LocalEntity::MvuCommandStatus const status, protocol::MvuAecpdu const& mvu, LocalEntityImpl<>::AnswerCallback const& answerCallback, LocalEntityImpl<>::AnswerCallback::Callback const& protocolViolationCallback);
+	static auto const s_Dispatch = protocol::DispatchTable<protocol::MvuCommandType::value_type, DispatchHandler, MvuCommandTypeTableSize>{
 		// Get Milan Info
 		{ protocol::MvuCommandType::GetMilanInfo.getValue(),
 			[](controller::Delegate* const /*delegate*/, Interface const* const controllerInterface, LocalEntity::MvuCommandStatus const status, protocol::MvuAecpdu const& mvu, LocalEntityImpl<>::AnswerCallback const& answerCallback, LocalEntityImpl<>::AnswerCallback::Callback const& protocolViolationCallback)
@@ -3422,8 +3438,8 @@ void CapabilityDelegate::processMvuAecpResponse(protocol::MvuCommandType const c
 			} },
 	};
 
-	auto const& it = s_Dispatch.find(responseCommandType.getValue());
-	if (it == s_Dispatch.end())
+	auto const handler = s_Dispatch.find(responseCommandType.getValue());
+	if (handler == nullptr)
 	{
 		// It's an expected response, this is an internal error since we sent a command and didn't implement the code to handle the response
 		LOG_CONTROLLER_ENTITY_ERROR(mvu.getTargetEntityID(), "Failed to process MVU response: Unhandled command type {} ({})", std::string(responseCommandType), utils::toHexString(responseCommandType.getValue()));
@@ -3433,7 +3449,7 @@ void CapabilityDelegate::processMvuAecpResponse(protocol::MvuCommandType const c
 	{
 		try
 		{
-			it->second(_controllerDelegate, &_controllerInterface, status, mvu, answerCallback, protocolViolationCallback);
+			handler(_controllerDelegate, &_controllerInterface, status, mvu, answerCallback, protocolViolationCallback);
 		}
 		catch ([[maybe_unused]] protocol::mvuPayload::IncorrectPayloadSizeException const& e)
 		{
@@ -3462,7 +3478,8 @@ void CapabilityDelegate::processAcmpResponse(protocol::Acmpdu const* const respo
 	auto const status = static_cast<LocalEntity::ControlStatus>(acmp.getStatus().getValue()); // We have to convert protocol status to our extended status
 	auto const protocolViolationCallback = std::bind(onErrorCallback, LocalEntity::ControlStatus::BaseProtocolViolation);
 
-	static std::unordered_map<protocol::AcmpMessageType::value_type, std::function<void(controller::Delegate* const delegate, Interface const* const controllerInterface, LocalEntity::ControlStatus const status, protocol::Acmpdu const& acmp, LocalEntityImpl<>::AnswerCallback const& answerCallback, LocalEntityImpl<>::AnswerCallback::Callback const& protocolViolationCallback, bool const sniffed)>> s_Dispatch{
+	using DispatchHandler = void (*)(controller::Delegate* const delegate, Interface const* const controllerInterface, LocalEntity::ControlStatus const status, protocol::Acmpdu const& acmp, LocalEntityImpl<>::AnswerCallback const& answerCallback, LocalEntityImpl<>::AnswerCallback::Callback const& protocolViolationCallback, bool const sniffed);
+	static auto const s_Dispatch = protocol::DispatchTable<protocol::AcmpMessageType::value_type, DispatchHandler, AcmpMessageTypeTableSize>{
 		// Connect TX response
 		{ protocol::AcmpMessageType::ConnectTxResponse.getValue(),
 			[](controller::Delegate* const delegate, Interface const* const controllerInterface, LocalEntity::ControlStatus const status, protocol::Acmpdu const& acmp, LocalEntityImpl<>::AnswerCallback const& /*answerCallback*/, LocalEntityImpl<>::AnswerCallback::Callback const& /*protocolViolationCallback*/, bool const sniffed)
@@ -3572,8 +3589,8 @@ void CapabilityDelegate::processAcmpResponse(protocol::Acmpdu const* const respo
 			} },
 	};
 
-	auto const& it = s_Dispatch.find(acmp.getMessageType().getValue());
-	if (it == s_Dispatch.end())
+	auto const handler = s_Dispatch.find(acmp.getMessageType().getValue());
+	if (handler == nullptr)
 	{
 		// If this is a sniffed message, simply log we do not handle the message
 		if (sniffed)
@@ -3591,7 +3608,7 @@ void CapabilityDelegate::processAcmpResponse(protocol::Acmpdu const* const respo
 	{
 		try
 		{
-			it->second(_controllerDelegate, &_controllerInterface, status, acmp, answerCallback, protocolViolationCallback, sniffed);
+			handler(_controllerDelegate, &_controllerInterface, status, acmp, answerCallback, protocolViolationCallback, sniffed);
 		}
 		catch ([[maybe_unused]] std::exception const& e) // Mainly unpacking errors
 		{
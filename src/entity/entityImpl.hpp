@@ -184,6 +184,11 @@ public:
 			, _hash{ typeid(T).hash_code() }
 		{
 		}
+		/** Returns true if a handler has to be called with the answer */
+		bool hasHandler() const noexcept
+		{
+			return !!_onAnswer;
+		}
 		// Call operator
 		template<typename T, typename... Ts>
 		void invoke(Callback const& errorCallback, Ts&&... params) const noexcept
@@ -188,7 +188,7 @@ json dumpStreamPortModels(Context& c, ConfigurationTree const& configTree, Flags
 		auto streamPort = json{};
 
 		// Dump Static model
-		auto const& staticModel = streamPortModels.staticModel;
+		auto const& staticModel = streamPortModels.staticModel.get();
 		if (flags.test(Flag::ProcessStaticModel))
 		{
 			// Dump StreamPort Descriptor Model
@@ -239,7 +239,7 @@ json dumpAudioUnitModels(Context& c, ConfigurationTree const& configTree, Flags
 		auto audioUnit = json{};
 
 		// Dump Static model
-		auto const& staticModel = audioUnitModels.staticModel;
+		auto const& staticModel = audioUnitModels.staticModel.get();
 		if (flags.test(Flag::ProcessStaticModel))
 		{
 			// Dump AudioUnit Descriptor Model
@@ -290,7 +290,7 @@ json dumpLocaleModels(Context& c, ConfigurationTree const& configTree, Flags con
 		auto locale = json{};
 
 		// Dump Static model
-		auto const& staticModel = localeModels.staticModel;
+		auto const& staticModel = localeModels.staticModel.get();
 		if (flags.test(Flag::ProcessStaticModel))
 		{
 			// Dump Locale Descriptor Model
@@ -309,93 +309,98 @@ json dumpLocaleModels(Context& c, ConfigurationTree const& configTree, Flags con
 	return locales;
 }
 
-json dumpConfigurationTrees(std::map<ConfigurationIndex, ConfigurationTree> const& configTrees, Flags const flags, bool& gotSanityCheckError)
+json dumpConfigurationTree(ConfigurationIndex const configIndex, ConfigurationTree const& configTree, Flags const flags, ConfigurationIndex& nextExpectedConfigurationIndex, bool& gotSanityCheckError)
 {
-	auto configs = json{};
-	auto nextExpectedConfigurationIndex = ConfigurationIndex{ 0u };
+	// Start a new Context now, DescriptorIndexes start at 0 for each new configuration
+	auto c = Context{};
 
-	for (auto const& [configIndex, configTree] : configTrees)
+	if (configIndex != nextExpectedConfigurationIndex)
 	{
-		// Start a new Context now, DescriptorIndexes start at 0 for each new configuration
-		auto c = Context{};
-
-		if (configIndex != nextExpectedConfigurationIndex)
+		if (!flags.test(Flag::IgnoreAEMSanityChecks))
 		{
-			if (!flags.test(Flag::IgnoreAEMSanityChecks))
-			{
-				throw avdecc::jsonSerializer::SerializationException{ avdecc::jsonSerializer::SerializationError::InvalidDescriptorIndex, "Invalid Configuration Descriptor Index: " + std::to_string(configIndex) + " but expected " + std::to_string(nextExpectedConfigurationIndex) };
-			}
-			else
-			{
-				c.getSanityCheckError = true;
-			}
+			throw avdecc::jsonSerializer::SerializationException{ avdecc::jsonSerializer::SerializationError::InvalidDescriptorIndex, "Invalid Configuration Descriptor Index: " + std::to_string(configIndex) + " but expected " + std::to_string(nextExpectedConfigurationIndex) };
 		}
-		++nextExpectedConfigurationIndex;
-
-		auto config = json{};
-		auto dumpFlags = flags;
-
-		// Dump Static model
-		if (flags.test(Flag::ProcessStaticModel))
+		else
 		{
-			// Dump Configuration Descriptor Model
-			config[keyName::Node_StaticInformation] = configTree.staticModel;
+			c.getSanityCheckError = true;
 		}
+	}
+	++nextExpectedConfigurationIndex;
 
-		// Dump Dynamic model
-		if (flags.test(Flag::ProcessDynamicModel))
+	auto config = json{};
+	auto dumpFlags = flags;
+
+	// Dump Static model
+	if (flags.test(Flag::ProcessStaticModel))
+	{
+		// Dump Configuration Descriptor Model
+		config[keyName::Node_StaticInformation] = configTree.staticModel;
+	}
+
+	// Dump Dynamic model
+	if (flags.test(Flag::ProcessDynamicModel))
+	{
+		// Dump Configuration Descriptor Model
+		config[keyName::Node_DynamicInformation] = configTree.dynamicModel;
+		// This is not the active configuration, we don't want to dump the Dynamic Part as it might not be accurate
+		if (!configTree.dynamicModel.isActiveConfiguration)
 		{
-			// Dump Configuration Descriptor Model
-			config[keyName::Node_DynamicInformation] = configTree.dynamicModel;
-			// This is not the active configuration, we don't want to dump the Dynamic Part as it might not be accurate
-			if (!configTree.dynamicModel.isActiveConfiguration)
-			{
-				dumpFlags.reset(Flag::ProcessDynamicModel);
-			}
+			dumpFlags.reset(Flag::ProcessDynamicModel);
 		}
+	}
 
-		// Dump AudioUnits
-		config[keyName::NodeName_AudioUnitDescriptors] = dumpAudioUnitModels(c, configTree, dumpFlags);
+	// Dump AudioUnits
+	config[keyName::NodeName_AudioUnitDescriptors] = dumpAudioUnitModels(c, configTree, dumpFlags);
 
-		// Dump StreamInputs
-		config[keyName::NodeName_StreamInputDescriptors] = dumpLeafModels(c, configTree, dumpFlags, &ConfigurationTree::streamInputModels, c.nextExpectedStreamInputIndex, "StreamInput", 0, configTree.streamInputModels.size());
+	// Dump StreamInputs
+	config[keyName::NodeName_StreamInputDescriptors] = dumpLeafModels(c, configTree, dumpFlags, &ConfigurationTree::streamInputModels, c.nextExpectedStreamInputIndex, "StreamInput", 0, configTree.streamInputModels.size());
 
-		// Dump StreamOutputs
-		config[keyName::NodeName_StreamOutputDescriptors] = dumpLeafModels(c, configTree, dumpFlags, &ConfigurationTree::streamOutputModels, c.nextExpectedStreamOutputIndex, "StreamOutput", 0, configTree.streamOutputModels.size());
+	// Dump StreamOutputs
+	config[keyName::NodeName_StreamOutputDescriptors] = dumpLeafModels(c, configTree, dumpFlags, &ConfigurationTree::streamOutputModels, c.nextExpectedStreamOutputIndex, "StreamOutput", 0, configTree.streamOutputModels.size());
 
-		// Dump AvbInterfaces
-		config[keyName::NodeName_AvbInterfaceDescriptors] = dumpLeafModels(c, configTree, dumpFlags, &ConfigurationTree::avbInterfaceModels, c.nextExpectedAvbInterfaceIndex, "AvbInterface", 0, configTree.avbInterfaceModels.size());
+	// Dump AvbInterfaces
+	config[keyName::NodeName_AvbInterfaceDescriptors] = dumpLeafModels(c, configTree, dumpFlags, &ConfigurationTree::avbInterfaceModels, c.nextExpectedAvbInterfaceIndex, "AvbInterface", 0, configTree.avbInterfaceModels.size());
 
-		// Dump ClockSources
-		config[keyName::NodeName_ClockSourceDescriptors] = dumpLeafModels(c, configTree, dumpFlags, &ConfigurationTree::clockSourceModels, c.nextExpectedClockSourceIndex, "ClockSource", 0, configTree.clockSourceModels.size());
+	// Dump ClockSources
+	config[keyName::NodeName_ClockSourceDescriptors] = dumpLeafModels(c, configTree, dumpFlags, &ConfigurationTree::clockSourceModels, c.nextExpectedClockSourceIndex, "ClockSource", 0, configTree.clockSourceModels.size());
 
-		// Dump MemoryObjects
-		config[keyName::NodeName_MemoryObjectDescriptors] = dumpLeafModels(c, configTree, dumpFlags, &ConfigurationTree::memoryObjectModels, c.nextExpectedMemoryObjectIndex, "MemoryObject", 0, configTree.memoryObjectModels.size());
+	// Dump MemoryObjects
+	config[keyName::NodeName_MemoryObjectDescriptors] = dumpLeafModels(c, configTree, dumpFlags, &ConfigurationTree::memoryObjectModels, c.nextExpectedMemoryObjectIndex, "MemoryObject", 0, configTree.memoryObjectModels.size());
 
-		// Dump Locales
-		config[keyName::NodeName_LocaleDescriptors] = dumpLocaleModels(c, configTree, dumpFlags);
+	// Dump Locales
+	config[keyName::NodeName_LocaleDescriptors] = dumpLocaleModels(c, configTree, dumpFlags);
 
-		// Dump Controls
-		config[keyName::NodeName_ControlDescriptors] = dumpLeafModels(c, configTree, dumpFlags, &ConfigurationTree::controlModels, c.nextExpectedControlIndex, "Control", 0, configTree.controlModels.size());
+	// Dump Controls
+	config[keyName::NodeName_ControlDescriptors] = dumpLeafModels(c, configTree, dumpFlags, &ConfigurationTree::controlModels, c.nextExpectedControlIndex, "Control", 0, configTree.controlModels.size());
 
-		// Dump ClockDomains
-		config[keyName::NodeName_ClockDomainDescriptors] = dumpLeafModels(c, configTree, dumpFlags, &ConfigurationTree::clockDomainModels, c.nextExpectedClockDomainIndex, "ClockDomain", 0, configTree.clockDomainModels.size());
+	// Dump ClockDomains
+	config[keyName::NodeName_ClockDomainDescriptors] = dumpLeafModels(c, configTree, dumpFlags, &ConfigurationTree::clockDomainModels, c.nextExpectedClockDomainIndex, "ClockDomain", 0, configTree.clockDomainModels.size());
 
-		// Dump informative DescriptorIndex
-		config[model::keyName::Node_Informative_Index] = configIndex;
+	// Dump informative DescriptorIndex
+	config[model::keyName::Node_Informative_Index] = configIndex;
 
-		configs.push_back(std::move(config));
+	if (c.getSanityCheckError)
+	{
+		gotSanityCheckError = true;
+	}
 
-		if (c.getSanityCheckError)
-		{
-			gotSanityCheckError = true;
-		}
+	return config;
+}
+
+json dumpConfigurationTrees(EntityTree::ConfigurationTrees const& configTrees, Flags const flags, bool& gotSanityCheckError)
+{
+	auto configs = json{};
+	auto nextExpectedConfigurationIndex = ConfigurationIndex{ 0u };
+
+	for (auto const& [configIndex, configTree] : configTrees)
+	{
+		configs.push_back(dumpConfigurationTree(configIndex, configTree, flags, nextExpectedConfigurationIndex, gotSanityCheckError));
 	}
 
 	return configs;
 }
 
-json dumpEntityTree(EntityTree const& entityTree, Flags const flags, bool& gotSanityCheckError)
+json dumpEntityDescriptor(EntityTree const& entityTree, Flags const flags)
 {
 	auto entity = json{};
 
@@ -411,6 +416,13 @@ json dumpEntityTree(EntityTree const& entityTree, Flags const flags, bool& gotSa
 		entity[keyName::Node_DynamicInformation] = entityTree.dynamicModel;
 	}
 
+	return entity;
+}
+
+json dumpEntityTree(EntityTree const& entityTree, Flags const flags, bool& gotSanityCheckError)
+{
+	auto entity = dumpEntityDescriptor(entityTree, flags);
+
 	// Dump Configurations
 	entity[keyName::NodeName_ConfigurationDescriptors] = dumpConfigurationTrees(entityTree.configurationTrees, flags, gotSanityCheckError);
 
@@ -451,6 +463,63 @@ json LA_AVDECC_CALL_CONVENTION createJsonObject(EntityTree const& entityTree, Fl
 	}
 }
 
+void LA_AVDECC_CALL_CONVENTION writeJsonObject(avdecc::jsonSerializer::StreamWriter& writer, EntityTree const& entityTree, Flags const flags)
+{
+	try
+	{
+		auto gotSanityCheckError = false;
+
+		writer.beginObject();
+
+		writer.writeKey(keyName::NodeName_EntityDescriptor);
+		writer.beginObject();
+		writer.writeMembers(dumpEntityDescriptor(entityTree, flags), keyName::NodeName_ConfigurationDescriptors,
+			[&writer, &entityTree, flags, &gotSanityCheckError]()
+			{
+				// Same value than dumpConfigurationTrees (null if there is no configuration)
+				if (entityTree.configurationTrees.empty())
+				{
+					writer.writeValue(nullptr);
+					return;
+				}
+
+				// Dump Configurations, one at a time
+				auto nextExpectedConfigurationIndex = ConfigurationIndex{ 0u };
+				writer.beginArray();
+				for (auto const& [configIndex, configTree] : entityTree.configurationTrees)
+				{
+					writer.writeValue(dumpConfigurationTree(configIndex, configTree, flags, nextExpectedConfigurationIndex, gotSanityCheckError));
+				}
+				writer.endArray();
+			});
+		writer.endObject();
+
+		// If sanity checks failed
+		if (gotSanityCheckError)
+		{
+			writer.writeKey(keyName::Node_NotCompliant);
+			writer.writeValue(true);
+		}
+
+		writer.endObject();
+	}
+	catch (json::exception const& e)
+	{
+		AVDECC_ASSERT(false, "json::exception is not expected to be thrown here");
+		throw avdecc::jsonSerializer::SerializationException{ avdecc::jsonSerializer::SerializationError::InternalError, e.what() };
+	}
+	catch (avdecc::jsonSerializer::SerializationException const&)
+	{
+		throw; // Rethrow, this is already the correct exception type
+	}
+	catch (...)
+	{
+		// Check that only SerializationException exception type propagate outside the shared library, otherwise it will be sliced and the caller won't be able to catch it properly (on macOS)
+		AVDECC_ASSERT(false, "Exception type other than avdecc::jsonSerializer::SerializationException should not propagate");
+		throw avdecc::jsonSerializer::SerializationException{ avdecc::jsonSerializer::SerializationError::InternalError, "Exception type other than avdecc::jsonSerializer::SerializationException should not propagate." };
+	}
+}
+
 /* ************************************************************ */
 /* Load methods                                                 */
 /* ************************************************************ */
@@ -539,8 +608,9 @@ void readStreamPortModels(json const& object, Flags const flags, std::string con
 		if (flags.test(Flag::ProcessStaticModel))
 		{
 			// Get base cluster and map descriptor index
-			modelTree.staticModel.baseCluster = c.nextExpectedAudioClusterIndex;
-			modelTree.staticModel.baseMap = c.nextExpectedAudioMapIndex;
+			auto& staticModel = modelTree.staticModel.getMutable();
+			staticModel.baseCluster = c.nextExpectedAudioClusterIndex;
+			staticModel.baseMap = c.nextExpectedAudioMapIndex;
 
 			if constexpr (isStaticModelOptional)
 			{
@@ -577,9 +647,10 @@ void readStreamPortModels(json const& object, Flags const flags, std::string con
 		if (flags.test(Flag::ProcessStaticModel))
 		{
 			// Get number of cluster and map descriptors that were read
-			modelTree.staticModel.numberOfClusters = c.nextExpectedAudioClusterIndex - modelTree.staticModel.baseCluster;
-			modelTree.staticModel.numberOfMaps = c.nextExpectedAudioMapIndex - modelTree.staticModel.baseMap;
-			modelTree.staticModel.hasDynamicAudioMap = modelTree.staticModel.numberOfMaps == 0;
+			auto& staticModel = modelTree.staticModel.getMutable();
+			staticModel.numberOfClusters = c.nextExpectedAudioClusterIndex - staticModel.baseCluster;
+			staticModel.numberOfMaps = c.nextExpectedAudioMapIndex - staticModel.baseMap;
+			staticModel.hasDynamicAudioMap = staticModel.numberOfMaps == 0;
 		}
 
 		modelTrees[currentIndex++] = std::move(modelTree);
@@ -596,8 +667,9 @@ void readAudioUnitModels(json const& object, Flags const flags, Context& c, Conf
 		if (flags.test(Flag::ProcessStaticModel))
 		{
 			// Get base stream port descriptor index
-			audioUnitTree.staticModel.baseStreamInputPort = c.nextExpectedStreamPortInputIndex;
-			audioUnitTree.staticModel.baseStreamOutputPort = c.nextExpectedStreamPortOutputIndex;
+			auto& staticModel = audioUnitTree.staticModel.getMutable();
+			staticModel.baseStreamInputPort = c.nextExpectedStreamPortInputIndex;
+			staticModel.baseStreamOutputPort = c.nextExpectedStreamPortOutputIndex;
 
 			j.at(keyName::Node_StaticInformation).get_to(audioUnitTree.staticModel);
 		}
@@ -617,8 +689,9 @@ void readAudioUnitModels(json const& object, Flags const flags, Context& c, Conf
 		if (flags.test(Flag::ProcessStaticModel))
 		{
 			// Get number of stream port descriptors that were read
-			audioUnitTree.staticModel.numberOfStreamInputPorts = c.nextExpectedStreamPortInputIndex - audioUnitTree.staticModel.baseStreamInputPort;
-			audioUnitTree.staticModel.numberOfStreamOutputPorts = c.nextExpectedStreamPortOutputIndex - audioUnitTree.staticModel.baseStreamOutputPort;
+			auto& staticModel = audioUnitTree.staticModel.getMutable();
+			staticModel.numberOfStreamInputPorts = c.nextExpectedStreamPortInputIndex - staticModel.baseStreamInputPort;
+			staticModel.numberOfStreamOutputPorts = c.nextExpectedStreamPortOutputIndex - staticModel.baseStreamOutputPort;
 		}
 
 		config.audioUnitModels[c.nextExpectedAudioUnitIndex++] = std::move(audioUnitTree);
@@ -637,13 +710,14 @@ void readLocaleModels(json const& object, Flags const flags, Context& c, Configu
 			j.at(keyName::Node_StaticInformation).get_to(localeTree.staticModel);
 
 			// Get base strings descriptor index
-			localeTree.staticModel.baseStringDescriptorIndex = c.nextExpectedStringsIndex;
+			localeTree.staticModel.getMutable().baseStringDescriptorIndex = c.nextExpectedStringsIndex;
 
 			// Read Strings
 			readLeafModels<true, false, true, false>(j, flags, keyName::NodeName_StringsDescriptors, c.nextExpectedStringsIndex, config.stringsModels, ignoreDynamicModel);
 
 			// Get number of strings descriptors that were read
-			localeTree.staticModel.numberOfStringDescriptors = c.nextExpectedStringsIndex - localeTree.staticModel.baseStringDescriptorIndex;
+			auto& staticModel = localeTree.staticModel.getMutable();
+			staticModel.numberOfStringDescriptors = c.nextExpectedStringsIndex - staticModel.baseStringDescriptorIndex;
 		}
 
 		config.localeModels[c.nextExpectedLocaleIndex++] = std::move(localeTree);
@@ -34,6 +34,9 @@
 #include <future>
 #include <utility>
 #include <unordered_map>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
 
 namespace la
 {
@@ -294,6 +297,368 @@ ExecutorWithDispatchQueue* LA_AVDECC_CALL_CONVENTION ExecutorWithDispatchQueue::
 	return new ExecutorWithDispatchQueueImpl(name, prio);
 }
 
+class ExecutorWithLockFreeDispatchQueueImpl final : public ExecutorWithLockFreeDispatchQueue
+{
+public:
+	ExecutorWithLockFreeDispatchQueueImpl(std::optional<std::string> const& name, utils::ThreadPriority const prio, size_t const queueCapacity) noexcept
+		: ExecutorWithLockFreeDispatchQueue{}
+		, _slots(computeCapacity(queueCapacity))
+		, _mask{ _slots.size() - 1u }
+	{
+		// Initialize the sequence of each slot (a slot is free for position 'pos' when its sequence equals 'pos')
+		for (auto i = size_t{ 0u }; i < _slots.size(); ++i)
+		{
+			_slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+
+		auto constructionComplete = std::promise<void>{};
+
+		_executorThread = std::thread(
+			[this, prio, name, &constructionComplete]
+			{
+				// Set the name of the thread, if specified
+				if (name.has_value())
+				{
+					utils::setCurrentThreadName("Executor: " + *name);
+				}
+				// Set the priority of the thread
+				utils::setCurrentThreadPriority(prio);
+
+				// Signal that the thread is ready
+				constructionComplete.set_value();
+
+				// Run the thread, until termination is requested
+				auto spinCount = MinSpinCount;
+				while (!_shouldTerminate)
+				{
+					// Process all available jobs
+					if (processJobs())
+					{
+						continue;
+					}
+
+					// Queue is empty, spin for a while before parking the thread (pointless on a single core, producers could not run)
+					auto jobAvailable = false;
+					for (auto spin = std::uint32_t{ 0u }; spin < spinCount && _canSpin && !_shouldTerminate; ++spin)
+					{
+						if (hasPendingJobs())
+						{
+							jobAvailable = true;
+							break;
+						}
+						std::this_thread::yield();
+					}
+
+					// Adapt the spin count: spin longer if spinning was useful, shorter otherwise
+					if (jobAvailable)
+					{
+						spinCount = std::min(spinCount * 2u, MaxSpinCount);
+						continue;
+					}
+					spinCount = std::max(spinCount / 2u, MinSpinCount);
+
+					// Park the thread until a job is pushed
+					{
+						auto lock = std::unique_lock{ _parkLock };
+						while (true)
+						{
+							// Flag must be set again before each check, it might have been reset by a producer whose job is not the next one to be processed
+							_parked.store(true, std::memory_order_relaxed);
+							std::atomic_thread_fence(std::memory_order_seq_cst); // Pairs with the fence in pushJob
+							if (_shouldTerminate || hasPendingJobs())
+							{
+								break;
+							}
+							_parkCondVar.wait(lock);
+						}
+						_parked.store(false, std::memory_order_relaxed);
+					}
+				}
+
+				// Discard remaining jobs
+				discardJobs();
+
+				// Notify that no job will be processed anymore
+				{
+					auto const lg = std::lock_guard{ _flushLock };
+					_executorStopped = true;
+				}
+				_flushCondVar.notify_all();
+			});
+
+		// Wait for thread running promise
+		constructionComplete.get_future().wait();
+	}
+
+	virtual ~ExecutorWithLockFreeDispatchQueueImpl() noexcept
+	{
+		// Properly terminate the executor thread
+		terminate();
+	}
+
+	// Executor overrides
+	virtual void pushJob(Job&& job) noexcept override
+	{
+		// Check for termination
+		if (_shouldTerminate)
+		{
+			return;
+		}
+
+		// Enqueue the job, using the overflow queue if the ring is full (or if the overflow queue is not empty yet, to preserve ordering)
+		if (_overflowCount.load(std::memory_order_acquire) != 0u || !tryPush(std::move(job)))
+		{
+			auto const lg = std::lock_guard{ _overflowLock };
+			_overflowJobs.push_back(std::move(job));
+			_overflowCount.store(_overflowJobs.size(), std::memory_order_release);
+		}
+
+		// Wake up the executor thread, if parked
+		std::atomic_thread_fence(std::memory_order_seq_cst); // Pairs with the fence in the executor thread
+		if (_parked.load(std::memory_order_relaxed) && _parked.exchange(false, std::memory_order_relaxed))
+		{
+			{
+				auto const lg = std::lock_guard{ _parkLock };
+			}
+			_parkCondVar.notify_one();
+		}
+	}
+
+	virtual void flush() noexcept override
+	{
+		// Push a marker job and wait for it to be processed, all jobs pushed before the marker will have been processed
+		auto flushed = false;
+		pushJob(
+			[this, &flushed]()
+			{
+				{
+					auto const lg = std::lock_guard{ _flushLock };
+					flushed = true;
+				}
+				_flushCondVar.notify_all();
+			});
+
+		auto lock = std::unique_lock{ _flushLock };
+		_flushCondVar.wait(lock,
+			[this, &flushed]
+			{
+				return flushed || _executorStopped;
+			});
+	}
+
+	virtual void terminate(bool const flushJobs = true) noexcept override
+	{
+		// Prevent concurrent termination
+		auto const lg = std::lock_guard{ _terminateLock };
+
+		// Flush jobs if requested (otherwise they will be discarded by the executor thread)
+		if (flushJobs && !_shouldTerminate)
+		{
+			flush();
+		}
+
+		// Set termination flag
+		{
+			auto const parkLg = std::lock_guard{ _parkLock };
+			_shouldTerminate = true;
+		}
+
+		// Notify the executor thread
+		_parkCondVar.notify_one();
+
+		// Wait for the thread to complete its pending tasks
+		if (_executorThread.joinable())
+		{
+			_executorThread.join();
+		}
+	}
+
+	virtual std::thread::id getExecutorThread() const noexcept override
+	{
+		return _executorThread.get_id();
+	}
+
+	/** Destroy method for COM-like interface */
+	virtual void destroy() noexcept override
+	{
+		delete this;
+	}
+
+	// Deleted compiler auto-generated methods
+	ExecutorWithLockFreeDispatchQueueImpl(ExecutorWithLockFreeDispatchQueueImpl const&) = delete;
+	ExecutorWithLockFreeDispatchQueueImpl(ExecutorWithLockFreeDispatchQueueImpl&&) = delete;
+	ExecutorWithLockFreeDispatchQueueImpl& operator=(ExecutorWithLockFreeDispatchQueueImpl const&) = delete;
+	ExecutorWithLockFreeDispatchQueueImpl& operator=(ExecutorWithLockFreeDispatchQueueImpl&&) = delete;
+
+private:
+	static auto constexpr CacheLineSize = size_t{ 64u };
+	static auto constexpr MinSpinCount = std::uint32_t{ 16u };
+	static auto constexpr MaxSpinCount = std::uint32_t{ 1024u };
+
+	/** A preallocated job slot. Each slot has its own cache line so producers writing adjacent slots don't contend */
+	struct alignas(CacheLineSize) Slot
+	{
+		std::atomic<size_t> sequence{ 0u };
+		Job job{};
+	};
+
+	static size_t computeCapacity(size_t const queueCapacity) noexcept
+	{
+		auto capacity = size_t{ 2u };
+		while (capacity < queueCapacity)
+		{
+			capacity <<= 1;
+		}
+		return capacity;
+	}
+
+	/** Tries to push a job in the ring (multiple producers). Returns false if the ring is full, in which case the job is left untouched */
+	bool tryPush(Job&& job) noexcept
+	{
+		auto pos = _enqueuePosition.load(std::memory_order_relaxed);
+		while (true)
+		{
+			auto& slot = _slots[pos & _mask];
+			auto const sequence = slot.sequence.load(std::memory_order_acquire);
+			auto const diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+
+			// Slot is free for this position, try to reserve it
+			if (diff == 0)
+			{
+				if (_enqueuePosition.compare_exchange_weak(pos, pos + 1u, std::memory_order_relaxed))
+				{
+					slot.job = std::move(job);
+					slot.sequence.store(pos + 1u, std::memory_order_release);
+					return true;
+				}
+			}
+			// Slot still used by the previous lap, ring is full
+			else if (diff < 0)
+			{
+				return false;
+			}
+			// Another producer reserved this position, reload
+			else
+			{
+				pos = _enqueuePosition.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	/** Returns true if the next slot of the ring is ready to be processed, or if the overflow queue can be processed (executor thread only) */
+	bool hasPendingJobs() const noexcept
+	{
+		return _slots[_dequeuePosition & _mask].sequence.load(std::memory_order_acquire) == _dequeuePosition + 1u || canProcessOverflowJobs();
+	}
+
+	/** Returns true if there are jobs in the overflow queue and all the ring positions reserved before them have been processed (executor thread only) */
+	bool canProcessOverflowJobs() const noexcept
+	{
+		// A producer may have reserved a ring slot but not published it yet, and then pushed more jobs to the overflow queue. The overflow queue must wait for that slot to preserve the producer's ordering
+		// (all pushes go to the overflow queue while it is not empty, so reserved positions cannot keep growing)
+		return _overflowCount.load(std::memory_order_acquire) != 0u && _enqueuePosition.load(std::memory_order_acquire) == _dequeuePosition;
+	}
+
+	/** Processes jobs from the ring until it is empty (executor thread only). Returns true if at least one job was processed */
+	bool processRingJobs() noexcept
+	{
+		auto processed = false;
+		while (!_shouldTerminate)
+		{
+			auto& slot = _slots[_dequeuePosition & _mask];
+			if (slot.sequence.load(std::memory_order_acquire) != _dequeuePosition + 1u)
+			{
+				break;
+			}
+
+			utils::invokeProtectedHandler(slot.job);
+			slot.job = Job{};
+
+			// Release the slot for the next lap
+			slot.sequence.store(_dequeuePosition + _mask + 1u, std::memory_order_release);
+			++_dequeuePosition;
+			processed = true;
+		}
+		return processed;
+	}
+
+	/** Processes all pending jobs (executor thread only). Returns true if at least one job was processed */
+	bool processJobs() noexcept
+	{
+		auto processed = processRingJobs();
+
+		if (!_shouldTerminate && canProcessOverflowJobs())
+		{
+			// Take the overflow jobs, new jobs can go to the ring again
+			{
+				auto const lg = std::lock_guard{ _overflowLock };
+				std::swap(_overflowJobs, _overflowJobsToProcess);
+				_overflowCount.store(0u, std::memory_order_release);
+			}
+
+			for (auto const& job : _overflowJobsToProcess)
+			{
+				if (_shouldTerminate)
+				{
+					break;
+				}
+				utils::invokeProtectedHandler(job);
+			}
+			_overflowJobsToProcess.clear();
+			processed = true;
+		}
+
+		return processed;
+	}
+
+	/** Discards all pending jobs (executor thread only) */
+	void discardJobs() noexcept
+	{
+		while (true)
+		{
+			auto& slot = _slots[_dequeuePosition & _mask];
+			if (slot.sequence.load(std::memory_order_acquire) != _dequeuePosition + 1u)
+			{
+				break;
+			}
+			slot.job = Job{};
+			slot.sequence.store(_dequeuePosition + _mask + 1u, std::memory_order_release);
+			++_dequeuePosition;
+		}
+
+		_overflowJobsToProcess.clear();
+		auto const lg = std::lock_guard{ _overflowLock };
+		_overflowJobs.clear();
+		_overflowCount.store(0u, std::memory_order_release);
+	}
+
+	// Private members
+	std::vector<Slot> _slots{}; // Ring of preallocated job slots
+	size_t const _mask{ 0u }; // Mask to convert a position to a slot index
+	alignas(CacheLineSize) std::atomic<size_t> _enqueuePosition{ 0u }; // Next position to be reserved by a producer
+	alignas(CacheLineSize) size_t _dequeuePosition{ 0u }; // Next position to be processed (only accessed by the executor thread)
+	alignas(CacheLineSize) std::atomic<size_t> _overflowCount{ 0u }; // Number of jobs in the overflow queue
+	std::mutex _overflowLock{}; // Lock to protect the overflow queue
+	std::deque<Job> _overflowJobs{}; // Jobs that could not be pushed to the ring
+	std::deque<Job> _overflowJobsToProcess{}; // Overflow jobs being processed (only accessed by the executor thread)
+	std::atomic<bool> _shouldTerminate{ false }; // Flag to indicate that the executor thread should terminate
+	bool const _canSpin{ std::thread::hardware_concurrency() > 1u }; // Spinning is only useful if producers can run in parallel
+	std::atomic<bool> _parked{ false }; // Flag to indicate that the executor thread is (or is about to be) parked, reset by the producer waking it up
+	std::mutex _parkLock{}; // Lock associated with the park condition variable
+	std::condition_variable _parkCondVar{}; // Condition variable to wake up the executor thread
+	std::mutex _flushLock{}; // Lock associated with the flush condition variable
+	std::condition_variable _flushCondVar{}; // Condition variable to notify the flushing threads
+	bool _executorStopped{ false }; // Flag to indicate that the executor thread no longer processes jobs (protected by _flushLock)
+	std::mutex _terminateLock{}; // Lock to prevent concurrent termination
+	std::thread _executorThread{}; // Thread running the executor
+};
+
+/** ExecutorWithLockFreeDispatchQueue Entry point */
+ExecutorWithLockFreeDispatchQueue* LA_AVDECC_CALL_CONVENTION ExecutorWithLockFreeDispatchQueue::createRawExecutorWithLockFreeDispatchQueue(std::optional<std::string> const& name, utils::ThreadPriority const prio, size_t const queueCapacity)
+{
+	return new ExecutorWithLockFreeDispatchQueueImpl(name, prio, queueCapacity);
+}
+
 class ExecutorManagerImpl final : public ExecutorManager
 {
 public:
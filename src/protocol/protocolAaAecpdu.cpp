@@ -25,6 +25,7 @@
 #include "la/avdecc/internals/protocolAaAecpdu.hpp"
 
 #include "logHelper.hpp"
+#include "protocolPduPool.hpp"
 
 #include <cassert>
 #include <string>
@@ -150,7 +151,7 @@ Aecpdu::UniquePointer LA_AVDECC_CALL_CONVENTION AaAecpdu::responseCopy() const
 	};
 
 	// Create a response message as a copy of this
-	auto response = UniquePointer(new AaAecpdu(*this), deleter);
+	auto response = UniquePointer(PduPool<AaAecpdu>::getInstance().create(*this), deleter);
 	auto& aa = static_cast<AaAecpdu&>(*response);
 
 	// Change the message type to be an ADDRESS_ACCESS_RESPONSE
@@ -169,13 +170,13 @@ AaAecpdu& LA_AVDECC_CALL_CONVENTION AaAecpdu::operator=(AaAecpdu&&) = default;
 /** Entry point */
 AaAecpdu* LA_AVDECC_CALL_CONVENTION AaAecpdu::createRawAaAecpdu(bool const isResponse) noexcept
 {
-	return new AaAecpdu(isResponse);
+	return PduPool<AaAecpdu>::getInstance().create(isResponse);
 }
 
 /** Destroy method for COM-like interface */
 void LA_AVDECC_CALL_CONVENTION AaAecpdu::destroy() noexcept
 {
-	delete this;
+	PduPool<AaAecpdu>::getInstance().destroy(this);
 }
 
 } // namespace protocol
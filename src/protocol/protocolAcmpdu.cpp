@@ -25,6 +25,7 @@
 #include "la/avdecc/internals/protocolAcmpdu.hpp"
 
 #include "logHelper.hpp"
+#include "protocolPduPool.hpp"
 
 #include <cassert>
 #include <string>
@@ -122,7 +123,7 @@ Acmpdu::UniquePointer LA_AVDECC_CALL_CONVENTION Acmpdu::copy() const
 	{
 		self->destroy();
 	};
-	return UniquePointer(new Acmpdu(*this), deleter);
+	return UniquePointer(PduPool<Acmpdu>::getInstance().create(*this), deleter);
 }
 
 // Defaulted compiler auto-generated methods
@@ -134,13 +135,13 @@ Acmpdu& LA_AVDECC_CALL_CONVENTION Acmpdu::operator=(Acmpdu&&) = default;
 /** Entry point */
 Acmpdu* LA_AVDECC_CALL_CONVENTION Acmpdu::createRawAcmpdu() noexcept
 {
-	return new Acmpdu();
+	return PduPool<Acmpdu>::getInstance().create();
 }
 
 /** Destroy method for COM-like interface */
 void LA_AVDECC_CALL_CONVENTION Acmpdu::destroy() noexcept
 {
-	delete this;
+	PduPool<Acmpdu>::getInstance().destroy(this);
 }
 
 } // namespace protocol
@@ -25,6 +25,7 @@
 #include "la/avdecc/internals/protocolAemAecpdu.hpp"
 
 #include "logHelper.hpp"
+#include "protocolPduPool.hpp"
 
 #include <cassert>
 #include <string>
@@ -200,7 +201,7 @@ Aecpdu::UniquePointer LA_AVDECC_CALL_CONVENTION AemAecpdu::responseCopy() const
 	};
 
 	// Create a response message as a copy of this
-	auto response = UniquePointer(new AemAecpdu(*this), deleter);
+	auto response = UniquePointer(PduPool<AemAecpdu>::getInstance().create(*this), deleter);
 	auto& aem = static_cast<AemAecpdu&>(*response);
 
 	// Change the message type to be an AEM_RESPONSE
@@ -213,13 +214,13 @@ Aecpdu::UniquePointer LA_AVDECC_CALL_CONVENTION AemAecpdu::responseCopy() const
 /** Entry point */
 AemAecpdu* LA_AVDECC_CALL_CONVENTION AemAecpdu::createRawAemAecpdu(bool const isResponse) noexcept
 {
-	return new AemAecpdu(isResponse);
+	return PduPool<AemAecpdu>::getInstance().create(isResponse);
 }
 
 /** Destroy method for COM-like interface */
 void LA_AVDECC_CALL_CONVENTION AemAecpdu::destroy() noexcept
 {
-	delete this;
+	PduPool<AemAecpdu>::getInstance().destroy(this);
 }
 
 } // namespace protocol
@@ -0,0 +1,289 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/**
+* @file protocolAemPayloadViews.cpp
+* @author Christophe Calmejane
+*/
+
+#include "protocolAemPayloadViews.hpp"
+#include "protocolAemPayloads.hpp"
+#include "logHelper.hpp"
+
+namespace la
+{
+namespace avdecc
+{
+namespace protocol
+{
+namespace aemPayload
+{
+// Offset of descriptor fields that are at a fixed position, from the end of the common READ_DESCRIPTOR header
+namespace streamDescriptorOffsets
+{
+static constexpr size_t ObjectName = 0u;
+static constexpr size_t LocalizedDescription = 64u;
+static constexpr size_t ClockDomainIndex = 66u;
+static constexpr size_t StreamFlags = 68u;
+static constexpr size_t CurrentFormat = 70u;
+static constexpr size_t FormatsOffset = 78u;
+static constexpr size_t NumberOfFormats = 80u;
+static constexpr size_t AvbInterfaceIndex = 122u;
+static constexpr size_t BufferLength = 124u;
+static constexpr size_t StaticPartEnd = 128u;
+} // namespace streamDescriptorOffsets
+
+/* ************************************************************************** */
+/* StreamDescriptorView                                                       */
+/* ************************************************************************** */
+StreamDescriptorView::StreamDescriptorView(AemAecpdu::Payload const& payload, size_t const commonSize)
+	: _payload{ payload }
+	, _commonSize{ commonSize }
+{
+	auto* const commandPayload = static_cast<std::uint8_t const*>(payload.first);
+	auto const commandPayloadLength = payload.second;
+
+	if (commandPayload == nullptr || commandPayloadLength < AecpAemReadStreamDescriptorResponsePayloadMinSize || commandPayloadLength < (commonSize + streamDescriptorOffsets::StaticPartEnd)) // Malformed packet
+		throw IncorrectPayloadSizeException();
+
+	// Compute offset for formats (Clause 7.2.6 says the formats_offset field is from the base of the descriptor, which is not where our payload starts)
+	auto formatsOffset = size_t{ unpackField<std::uint16_t>(streamDescriptorOffsets::FormatsOffset) } + sizeof(entity::model::ConfigurationIndex) + sizeof(std::uint16_t);
+	auto const numberOfFormats = size_t{ unpackField<std::uint16_t>(streamDescriptorOffsets::NumberOfFormats) };
+	auto endDescriptorOffset{ commandPayloadLength };
+	auto staticPartEndOffset = commonSize + streamDescriptorOffsets::StaticPartEnd;
+
+#ifdef ENABLE_AVDECC_FEATURE_REDUNDANCY
+	// Check if we have redundant fields (AVnu Alliance 'Network Redundancy' extension)
+	auto redundantOffset = size_t{ 0u };
+	auto numberOfRedundantStreams = size_t{ 0u };
+	if (formatsOffset >= staticPartEndOffset && (formatsOffset - staticPartEndOffset) >= (2 * sizeof(std::uint16_t)))
+	{
+		// Compute offset for redundant streams association (Clause 7.2.6 says the redundant_offset field is from the base of the descriptor, which is not where our payload starts)
+		redundantOffset = size_t{ unpackField<std::uint16_t>(streamDescriptorOffsets::StaticPartEnd) } + sizeof(entity::model::ConfigurationIndex) + sizeof(std::uint16_t);
+		numberOfRedundantStreams = size_t{ unpackField<std::uint16_t>(streamDescriptorOffsets::StaticPartEnd + sizeof(std::uint16_t)) };
+		endDescriptorOffset = redundantOffset;
+		staticPartEndOffset += 2 * sizeof(std::uint16_t);
+	}
+#endif // ENABLE_AVDECC_FEATURE_REDUNDANCY
+
+	// Check descriptor variable size
+	auto const formatsSize = sizeof(entity::model::StreamFormat::value_type) * numberOfFormats;
+	if (formatsOffset > endDescriptorOffset || formatsSize > (endDescriptorOffset - formatsOffset))
+		throw IncorrectPayloadSizeException();
+	if (formatsOffset < staticPartEndOffset)
+		throw IncorrectPayloadSizeException();
+	_formats = StreamFormatsView{ commandPayload + formatsOffset, numberOfFormats };
+
+#ifdef ENABLE_AVDECC_FEATURE_REDUNDANCY
+	if (redundantOffset > 0)
+	{
+		if (redundantOffset < staticPartEndOffset || redundantOffset > commandPayloadLength || (sizeof(entity::model::StreamIndex) * numberOfRedundantStreams) > (commandPayloadLength - redundantOffset))
+			throw IncorrectPayloadSizeException();
+		_redundantStreams = StreamIndexesView{ commandPayload + redundantOffset, numberOfRedundantStreams };
+	}
+#endif // ENABLE_AVDECC_FEATURE_REDUNDANCY
+}
+
+entity::model::AvdeccFixedString StreamDescriptorView::getObjectName() const
+{
+	return unpackField<entity::model::AvdeccFixedString>(streamDescriptorOffsets::ObjectName);
+}
+
+entity::model::LocalizedStringReference StreamDescriptorView::getLocalizedDescription() const
+{
+	return unpackField<entity::model::LocalizedStringReference>(streamDescriptorOffsets::LocalizedDescription);
+}
+
+entity::model::ClockDomainIndex StreamDescriptorView::getClockDomainIndex() const
+{
+	return unpackField<entity::model::ClockDomainIndex>(streamDescriptorOffsets::ClockDomainIndex);
+}
+
+entity::StreamFlags StreamDescriptorView::getStreamFlags() const
+{
+	return unpackField<entity::StreamFlags>(streamDescriptorOffsets::StreamFlags);
+}
+
+entity::model::StreamFormat StreamDescriptorView::getCurrentFormat() const
+{
+	return unpackField<entity::model::StreamFormat>(streamDescriptorOffsets::CurrentFormat);
+}
+
+entity::model::AvbInterfaceIndex StreamDescriptorView::getAvbInterfaceIndex() const
+{
+	return unpackField<entity::model::AvbInterfaceIndex>(streamDescriptorOffsets::AvbInterfaceIndex);
+}
+
+std::uint32_t StreamDescriptorView::getBufferLength() const
+{
+	return unpackField<std::uint32_t>(streamDescriptorOffsets::BufferLength);
+}
+
+StreamFormatsView const& StreamDescriptorView::getFormats() const noexcept
+{
+	return _formats;
+}
+
+#ifdef ENABLE_AVDECC_FEATURE_REDUNDANCY
+StreamIndexesView const& StreamDescriptorView::getRedundantStreams() const noexcept
+{
+	return _redundantStreams;
+}
+#endif // ENABLE_AVDECC_FEATURE_REDUNDANCY
+
+entity::model::StreamDescriptor StreamDescriptorView::toDescriptor() const
+{
+	auto streamDescriptor = entity::model::StreamDescriptor{};
+
+	// Unpack the static part of the descriptor in one pass
+	auto des = Deserializer{ _payload.first, _payload.second };
+	auto formatsOffset = std::uint16_t{ 0u };
+	auto numberOfFormats = std::uint16_t{ 0u };
+	des.setPosition(_commonSize); // Skip already unpacked common header
+	des >> streamDescriptor.objectName;
+	des >> streamDescriptor.localizedDescription >> streamDescriptor.clockDomainIndex >> streamDescriptor.streamFlags;
+	des >> streamDescriptor.currentFormat >> formatsOffset >> numberOfFormats;
+	des >> streamDescriptor.backupTalkerEntityID_0 >> streamDescriptor.backupTalkerUniqueID_0;
+	des >> streamDescriptor.backupTalkerEntityID_1 >> streamDescriptor.backupTalkerUniqueID_1;
+	des >> streamDescriptor.backupTalkerEntityID_2 >> streamDescriptor.backupTalkerUniqueID_2;
+	des >> streamDescriptor.backedupTalkerEntityID >> streamDescriptor.backedupTalkerUnique;
+	des >> streamDescriptor.avbInterfaceIndex >> streamDescriptor.bufferLength;
+
+	// Then the variable parts
+	for (auto const format : _formats)
+	{
+		streamDescriptor.formats.insert(format);
+	}
+#ifdef ENABLE_AVDECC_FEATURE_REDUNDANCY
+	for (auto const redundantStreamIndex : _redundantStreams)
+	{
+		streamDescriptor.redundantStreams.insert(redundantStreamIndex);
+	}
+#endif // ENABLE_AVDECC_FEATURE_REDUNDANCY
+
+	return streamDescriptor;
+}
+
+template<typename T>
+T StreamDescriptorView::unpackField(size_t const fieldOffset) const
+{
+	auto des = Deserializer{ _payload.first, _payload.second };
+	auto value = T{};
+	des.setPosition(_commonSize + fieldOffset);
+	des >> value;
+	return value;
+}
+
+/* ************************************************************************** */
+/* StringsDescriptorView                                                      */
+/* ************************************************************************** */
+StringsDescriptorView::StringsDescriptorView(AemAecpdu::Payload const& payload, size_t const commonSize)
+{
+	auto* const commandPayload = static_cast<std::uint8_t const*>(payload.first);
+	auto const commandPayloadLength = payload.second;
+	constexpr auto NumberOfStrings = std::tuple_size_v<decltype(entity::model::StringsDescriptor::strings)>;
+
+	if (commandPayload == nullptr || commandPayloadLength < AecpAemReadStringsDescriptorResponsePayloadSize || commandPayloadLength < (commonSize + NumberOfStrings * entity::model::AvdeccFixedString::MaxLength)) // Malformed packet
+		throw IncorrectPayloadSizeException();
+
+	if (commandPayloadLength > AecpAemReadStringsDescriptorResponsePayloadSize)
+	{
+		LOG_AEM_PAYLOAD_TRACE("ReadDescriptorResponse deserialize warning: Remaining bytes in buffer for READ_STRINGS_DESCRIPTOR RESPONSE: {}", commandPayloadLength - AecpAemReadStringsDescriptorResponsePayloadSize);
+	}
+
+	_strings = AvdeccFixedStringsView{ commandPayload + commonSize, NumberOfStrings };
+}
+
+AvdeccFixedStringsView const& StringsDescriptorView::getStrings() const noexcept
+{
+	return _strings;
+}
+
+entity::model::StringsDescriptor StringsDescriptorView::toDescriptor() const
+{
+	auto stringsDescriptor = entity::model::StringsDescriptor{};
+
+	auto strIndex = size_t{ 0u };
+	for (auto const& str : _strings)
+	{
+		stringsDescriptor.strings[strIndex++] = str;
+	}
+
+	return stringsDescriptor;
+}
+
+/* ************************************************************************** */
+/* AudioMapDescriptorView                                                     */
+/* ************************************************************************** */
+AudioMapDescriptorView::AudioMapDescriptorView(AemAecpdu::Payload const& payload, size_t const commonSize)
+{
+	auto* const commandPayload = static_cast<std::uint8_t const*>(payload.first);
+	auto const commandPayloadLength = payload.second;
+
+	if (commandPayload == nullptr || commandPayloadLength < AecpAemReadAudioMapDescriptorResponsePayloadMinSize) // Malformed packet
+		throw IncorrectPayloadSizeException();
+
+	// Check audio map descriptor payload - Clause 7.2.19
+	auto des = Deserializer{ commandPayload, commandPayloadLength };
+	auto mappingsOffset = std::uint16_t{ 0u };
+	auto numberOfMappings = std::uint16_t{ 0u };
+	des.setPosition(commonSize); // Skip already unpacked common header
+	des >> mappingsOffset >> numberOfMappings;
+
+	// Check descriptor variable size
+	auto const mappingsSize = entity::model::AudioMapping::size() * numberOfMappings;
+	if (des.remaining() < mappingsSize) // Malformed packet
+		throw IncorrectPayloadSizeException();
+
+	// Compute offset for mappings (Clause 7.2.19 says the mappings_offset field is from the base of the descriptor, which is not where our payload starts)
+	auto const offset = size_t{ mappingsOffset } + sizeof(entity::model::ConfigurationIndex) + sizeof(std::uint16_t);
+	if (offset < des.usedBytes() || offset > commandPayloadLength || mappingsSize > (commandPayloadLength - offset))
+		throw IncorrectPayloadSizeException();
+
+	if (commandPayloadLength - offset != mappingsSize)
+	{
+		LOG_AEM_PAYLOAD_TRACE("ReadDescriptorResponse deserialize warning: Remaining bytes in buffer for READ_AUDIO_MAP_DESCRIPTOR RESPONSE: {}", commandPayloadLength - offset - mappingsSize);
+	}
+
+	_mappings = AudioMappingsView{ commandPayload + offset, numberOfMappings };
+}
+
+AudioMappingsView const& AudioMapDescriptorView::getMappings() const noexcept
+{
+	return _mappings;
+}
+
+entity::model::AudioMapDescriptor AudioMapDescriptorView::toDescriptor() const
+{
+	auto audioMapDescriptor = entity::model::AudioMapDescriptor{};
+
+	audioMapDescriptor.mappings.reserve(_mappings.size());
+	for (auto const& mapping : _mappings)
+	{
+		audioMapDescriptor.mappings.push_back(mapping);
+	}
+
+	return audioMapDescriptor;
+}
+
+} // namespace aemPayload
+} // namespace protocol
+} // namespace avdecc
+} // namespace la
@@ -0,0 +1,229 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/**
+* @file protocolAemPayloadViews.hpp
+* @author Christophe Calmejane
+*/
+
+#pragma once
+
+#include "la/avdecc/internals/serialization.hpp"
+#include "la/avdecc/internals/entityModel.hpp"
+#include "la/avdecc/internals/protocolAemAecpdu.hpp"
+#include "la/avdecc/utils.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace la
+{
+namespace avdecc
+{
+namespace protocol
+{
+namespace aemPayload
+{
+/**
+* @brief Non-owning view over a packed array of fixed size items of an AEM payload.
+* @details Items are deserialized when accessed, the view does not allocate. The view must not outlive the payload it refers to.
+*/
+template<typename ItemType, size_t ItemSize>
+class PayloadItemsView final
+{
+public:
+	class const_iterator final
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = ItemType;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = ItemType;
+
+		const_iterator() noexcept = default;
+		explicit const_iterator(std::uint8_t const* const ptr) noexcept
+			: _ptr{ ptr }
+		{
+		}
+
+		ItemType operator*() const
+		{
+			return unpackItem(_ptr);
+		}
+
+		const_iterator& operator++() noexcept
+		{
+			_ptr += ItemSize;
+			return *this;
+		}
+
+		const_iterator operator++(int) noexcept
+		{
+			auto const it = *this;
+			_ptr += ItemSize;
+			return it;
+		}
+
+		bool operator==(const_iterator const& other) const noexcept
+		{
+			return _ptr == other._ptr;
+		}
+
+		bool operator!=(const_iterator const& other) const noexcept
+		{
+			return _ptr != other._ptr;
+		}
+
+	private:
+		std::uint8_t const* _ptr{ nullptr };
+	};
+
+	PayloadItemsView() noexcept = default;
+	PayloadItemsView(std::uint8_t const* const data, size_t const count) noexcept
+		: _data{ data }
+		, _count{ count }
+	{
+	}
+
+	size_t size() const noexcept
+	{
+		return _count;
+	}
+
+	bool empty() const noexcept
+	{
+		return _count == 0u;
+	}
+
+	/** Deserializes the item at the specified index (which must be lower than size()) */
+	ItemType operator[](size_t const index) const
+	{
+		AVDECC_ASSERT(index < _count, "Index out of range");
+		return unpackItem(_data + index * ItemSize);
+	}
+
+	const_iterator begin() const noexcept
+	{
+		return const_iterator{ _data };
+	}
+
+	const_iterator end() const noexcept
+	{
+		return const_iterator{ _data + _count * ItemSize };
+	}
+
+private:
+	static ItemType unpackItem(std::uint8_t const* const ptr)
+	{
+		auto des = Deserializer{ ptr, ItemSize };
+		auto item = ItemType{};
+		if constexpr (std::is_same_v<ItemType, entity::model::AudioMapping>)
+		{
+			des >> item.streamIndex >> item.streamChannel >> item.clusterOffset >> item.clusterChannel;
+		}
+		else
+		{
+			des >> item;
+		}
+		return item;
+	}
+
+	std::uint8_t const* _data{ nullptr };
+	size_t _count{ 0u };
+};
+
+using StreamFormatsView = PayloadItemsView<entity::model::StreamFormat, sizeof(entity::model::StreamFormat::value_type)>;
+using StreamIndexesView = PayloadItemsView<entity::model::StreamIndex, sizeof(entity::model::StreamIndex)>;
+using AudioMappingsView = PayloadItemsView<entity::model::AudioMapping, entity::model::AudioMapping::size()>;
+using AvdeccFixedStringsView = PayloadItemsView<entity::model::AvdeccFixedString, entity::model::AvdeccFixedString::MaxLength>;
+
+// All views constructors check the layout of the descriptor (without unpacking it) and throw an IncorrectPayloadSizeException if the payload is malformed
+// Views only have to be constructed for a Success status (Clause 7.4.5.2 says only the common descriptor fields are valid otherwise)
+
+/** READ_DESCRIPTOR STREAM_INPUT and STREAM_OUTPUT Response view - Clause 7.2.6 */
+class StreamDescriptorView final
+{
+public:
+	StreamDescriptorView(AemAecpdu::Payload const& payload, size_t const commonSize);
+
+	entity::model::AvdeccFixedString getObjectName() const;
+	entity::model::LocalizedStringReference getLocalizedDescription() const;
+	entity::model::ClockDomainIndex getClockDomainIndex() const;
+	entity::StreamFlags getStreamFlags() const;
+	entity::model::StreamFormat getCurrentFormat() const;
+	entity::model::AvbInterfaceIndex getAvbInterfaceIndex() const;
+	std::uint32_t getBufferLength() const;
+	StreamFormatsView const& getFormats() const noexcept;
+#ifdef ENABLE_AVDECC_FEATURE_REDUNDANCY
+	StreamIndexesView const& getRedundantStreams() const noexcept;
+#endif // ENABLE_AVDECC_FEATURE_REDUNDANCY
+
+	/** Unpacks all fields into an owning StreamDescriptor */
+	entity::model::StreamDescriptor toDescriptor() const;
+
+private:
+	template<typename T>
+	T unpackField(size_t const fieldOffset) const;
+
+	AemAecpdu::Payload _payload{ nullptr, 0u };
+	size_t _commonSize{ 0u };
+	StreamFormatsView _formats{};
+#ifdef ENABLE_AVDECC_FEATURE_REDUNDANCY
+	StreamIndexesView _redundantStreams{};
+#endif // ENABLE_AVDECC_FEATURE_REDUNDANCY
+};
+
+/** READ_DESCRIPTOR STRINGS Response view - Clause 7.2.12 */
+class StringsDescriptorView final
+{
+public:
+	StringsDescriptorView(AemAecpdu::Payload const& payload, size_t const commonSize);
+
+	AvdeccFixedStringsView const& getStrings() const noexcept;
+
+	/** Unpacks all fields into an owning StringsDescriptor */
+	entity::model::StringsDescriptor toDescriptor() const;
+
+private:
+	AvdeccFixedStringsView _strings{};
+};
+
+/** READ_DESCRIPTOR AUDIO_MAP Response view - Clause 7.2.19 */
+class AudioMapDescriptorView final
+{
+public:
+	AudioMapDescriptorView(AemAecpdu::Payload const& payload, size_t const commonSize);
+
+	AudioMappingsView const& getMappings() const noexcept;
+
+	/** Unpacks all fields into an owning AudioMapDescriptor */
+	entity::model::AudioMapDescriptor toDescriptor() const;
+
+private:
+	AudioMappingsView _mappings{};
+};
+
+} // namespace aemPayload
+} // namespace protocol
+} // namespace avdecc
+} // namespace la
@@ -26,6 +26,7 @@
 
 #include "protocolAemControlValuesPayloads.hpp"
 #include "protocolAemPayloads.hpp"
+#include "protocolAemPayloadViews.hpp"
 #include "logHelper.hpp"
 
 namespace la
@@ -366,96 +367,13 @@ entity::model::AudioUnitDescriptor deserializeReadAudioUnitDescriptorResponse(Ae
 
 entity::model::StreamDescriptor deserializeReadStreamDescriptorResponse(AemAecpdu::Payload const& payload, size_t const commonSize, AemAecpStatus const status)
 {
-	entity::model::StreamDescriptor streamDescriptor{};
-
 	// Clause 7.4.5.2 says we should only unpack common descriptor fields in case status is not Success
 	if (status == AecpStatus::Success)
 	{
-		auto* const commandPayload = payload.first;
-		auto const commandPayloadLength = payload.second;
-
-		if (commandPayload == nullptr || commandPayloadLength < AecpAemReadStreamDescriptorResponsePayloadMinSize) // Malformed packet
-			throw IncorrectPayloadSizeException();
-
-		// Check stream descriptor payload - Clause 7.2.6
-		Deserializer des(commandPayload, commandPayloadLength);
-		std::uint16_t formatsOffset{ 0u };
-		std::uint16_t numberOfFormats{ 0u };
-		auto endDescriptorOffset{ commandPayloadLength };
-		des.setPosition(commonSize); // Skip already unpacked common header
-		des >> streamDescriptor.objectName;
-		des >> streamDescriptor.localizedDescription >> streamDescriptor.clockDomainIndex >> streamDescriptor.streamFlags;
-		des >> streamDescriptor.currentFormat >> formatsOffset >> numberOfFormats;
-		des >> streamDescriptor.backupTalkerEntityID_0 >> streamDescriptor.backupTalkerUniqueID_0;
-		des >> streamDescriptor.backupTalkerEntityID_1 >> streamDescriptor.backupTalkerUniqueID_1;
-		des >> streamDescriptor.backupTalkerEntityID_2 >> streamDescriptor.backupTalkerUniqueID_2;
-		des >> streamDescriptor.backedupTalkerEntityID >> streamDescriptor.backedupTalkerUnique;
-		des >> streamDescriptor.avbInterfaceIndex >> streamDescriptor.bufferLength;
-
-		// Compute deserializer offset for formats (Clause 7.2.6 says the formats_offset field is from the base of the descriptor, which is not where our deserializer buffer starts)
-		formatsOffset += sizeof(entity::model::ConfigurationIndex) + sizeof(std::uint16_t);
-
-#ifdef ENABLE_AVDECC_FEATURE_REDUNDANCY
-		// Check if we have redundant fields (AVnu Alliance 'Network Redundancy' extension)
-		std::uint16_t redundantOffset{ 0u };
-		std::uint16_t numberOfRedundantStreams{ 0u };
-		auto const remainingBytesBeforeFormats = formatsOffset - des.usedBytes();
-		if (remainingBytesBeforeFormats >= (sizeof(redundantOffset) + sizeof(numberOfRedundantStreams)))
-		{
-			des >> redundantOffset >> numberOfRedundantStreams;
-			// Compute deserializer offset for redundant streams association (Clause 7.2.6 says the redundant_offset field is from the base of the descriptor, which is not where our deserializer buffer starts)
-			redundantOffset += sizeof(entity::model::ConfigurationIndex) + sizeof(std::uint16_t);
-			endDescriptorOffset = redundantOffset;
-		}
-#endif // ENABLE_AVDECC_FEATURE_REDUNDANCY
-		auto const staticPartEndOffset = des.usedBytes();
-
-		// Check descriptor variable size
-		constexpr size_t formatInfoSize = sizeof(std::uint64_t);
-		auto const formatsSize = formatInfoSize * numberOfFormats;
-		if (formatsSize > static_cast<decltype(formatsSize)>(endDescriptorOffset - formatsOffset))
-			throw IncorrectPayloadSizeException();
-		if (formatsOffset < staticPartEndOffset)
-			throw IncorrectPayloadSizeException();
-
-		// Read formats
-		// Set deserializer position
-		des.setPosition(formatsOffset);
-
-		// Let's loop over the formats
-		for (auto index = 0u; index < numberOfFormats; ++index)
-		{
-			entity::model::StreamFormat format{};
-			des >> format;
-			streamDescriptor.formats.insert(format);
-		}
-
-#ifdef ENABLE_AVDECC_FEATURE_REDUNDANCY
-		// Read redundant streams association
-		if (redundantOffset > 0)
-		{
-			// Set deserializer position
-			if (redundantOffset < staticPartEndOffset)
-				throw IncorrectPayloadSizeException();
-			des.setPosition(redundantOffset);
-
-			// Let's loop over the redundant streams association
-			for (auto index = 0u; index < numberOfRedundantStreams; ++index)
-			{
-				entity::model::StreamIndex redundantStreamIndex;
-				des >> redundantStreamIndex;
-				streamDescriptor.redundantStreams.insert(redundantStreamIndex);
-			}
-		}
-#endif // ENABLE_AVDECC_FEATURE_REDUNDANCY
-
-		if (des.remaining() != 0)
-		{
-			LOG_AEM_PAYLOAD_TRACE("ReadDescriptorResponse deserialize warning: Remaining bytes in buffer for READ_STREAM_DESCRIPTOR RESPONSE: {}", des.remaining());
-		}
+		return StreamDescriptorView{ payload, commonSize }.toDescriptor();
 	}
 
-	return streamDescriptor;
+	return entity::model::StreamDescriptor{};
 }
 
 entity::model::JackDescriptor deserializeReadJackDescriptorResponse(AemAecpdu::Payload const& payload, size_t const commonSize, AemAecpStatus const status)
@@ -627,34 +545,13 @@ entity::model::LocaleDescriptor deserializeReadLocaleDescriptorResponse(AemAecpd
 
 entity::model::StringsDescriptor deserializeReadStringsDescriptorResponse(AemAecpdu::Payload const& payload, size_t const commonSize, AemAecpStatus const status)
 {
-	entity::model::StringsDescriptor stringsDescriptor{};
-
 	// Clause 7.4.5.2 says we should only unpack common descriptor fields in case status is not Success
 	if (status == AecpStatus::Success)
 	{
-		auto* const commandPayload = payload.first;
-		auto const commandPayloadLength = payload.second;
-
-		if (commandPayload == nullptr || commandPayloadLength < AecpAemReadStringsDescriptorResponsePayloadSize) // Malformed packet
-			throw IncorrectPayloadSizeException();
-
-		// Check strings descriptor payload - Clause 7.2.12
-		Deserializer des(commandPayload, commandPayloadLength);
-		des.setPosition(commonSize); // Skip already unpacked common header
-		for (auto strIndex = 0u; strIndex < stringsDescriptor.strings.size(); ++strIndex)
-		{
-			des >> stringsDescriptor.strings[strIndex];
-		}
-
-		AVDECC_ASSERT(des.usedBytes() == AecpAemReadStringsDescriptorResponsePayloadSize, "Used more bytes than specified in protocol constant");
-
-		if (des.remaining() != 0)
-		{
-			LOG_AEM_PAYLOAD_TRACE("ReadDescriptorResponse deserialize warning: Remaining bytes in buffer for READ_STRINGS_DESCRIPTOR RESPONSE: {}", des.remaining());
-		}
+		return StringsDescriptorView{ payload, commonSize }.toDescriptor();
 	}
 
-	return stringsDescriptor;
+	return entity::model::StringsDescriptor{};
 }
 
 entity::model::StreamPortDescriptor deserializeReadStreamPortDescriptorResponse(AemAecpdu::Payload const& payload, size_t const commonSize, AemAecpStatus const status)
@@ -788,52 +685,13 @@ entity::model::AudioClusterDescriptor deserializeReadAudioClusterDescriptorRespo
 
 entity::model::AudioMapDescriptor deserializeReadAudioMapDescriptorResponse(AemAecpdu::Payload const& payload, size_t const commonSize, AemAecpStatus const status)
 {
-	entity::model::AudioMapDescriptor audioMapDescriptor{};
-
 	// Clause 7.4.5.2 says we should only unpack common descriptor fields in case status is not Success
 	if (status == AecpStatus::Success)
 	{
-		auto* const commandPayload = payload.first;
-		auto const commandPayloadLength = payload.second;
-
-		if (commandPayload == nullptr || commandPayloadLength < AecpAemReadAudioMapDescriptorResponsePayloadMinSize) // Malformed packet
-			throw IncorrectPayloadSizeException();
-
-		// Check audio map descriptor payload - Clause 7.2.19
-		Deserializer des(commandPayload, commandPayloadLength);
-		std::uint16_t mappingsOffset{ 0u };
-		std::uint16_t numberOfMappings{ 0u };
-		des.setPosition(commonSize); // Skip already unpacked common header
-		des >> mappingsOffset >> numberOfMappings;
-
-		// Check descriptor variable size
-		auto const mappingsSize = entity::model::AudioMapping::size() * numberOfMappings;
-		if (des.remaining() < mappingsSize) // Malformed packet
-			throw IncorrectPayloadSizeException();
-
-		// Compute deserializer offset for sampling rates (Clause 7.2.19 says the mappings_offset field is from the base of the descriptor, which is not where our deserializer buffer starts)
-		mappingsOffset += sizeof(entity::model::ConfigurationIndex) + sizeof(std::uint16_t);
-
-		// Set deserializer position
-		if (mappingsOffset < des.usedBytes())
-			throw IncorrectPayloadSizeException();
-		des.setPosition(mappingsOffset);
-
-		// Let's loop over the mappings
-		for (auto index = 0u; index < numberOfMappings; ++index)
-		{
-			entity::model::AudioMapping mapping;
-			des >> mapping.streamIndex >> mapping.streamChannel >> mapping.clusterOffset >> mapping.clusterChannel;
-			audioMapDescriptor.mappings.push_back(mapping);
-		}
-
-		if (des.remaining() != 0)
-		{
-			LOG_AEM_PAYLOAD_TRACE("ReadDescriptorResponse deserialize warning: Remaining bytes in buffer for READ_AUDIO_MAP_DESCRIPTOR RESPONSE: {}", des.remaining());
-		}
+		return AudioMapDescriptorView{ payload, commonSize }.toDescriptor();
 	}
 
-	return audioMapDescriptor;
+	return entity::model::AudioMapDescriptor{};
 }
 
 static inline void createUnpackFullControlValuesDispatchTable(std::unordered_map<entity::model::ControlValueType::Type, std::function<std::tuple<entity::model::ControlValues, entity::model::ControlValues>(Deserializer&, std::uint16_t)>>& dispatchTable)
@@ -0,0 +1,89 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/**
+* @file protocolDispatchTable.hpp
+* @author Christophe Calmejane
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace la
+{
+namespace avdecc
+{
+namespace protocol
+{
+/**
+* @brief Dense dispatch table of plain function pointers, indexed by a message type or command type value.
+* @details Finding the handler of a message is a bounds check and an array access (no hashing, no type-erased call).
+*          Keys must be lower than TableSize, the table is sized by the caller to the highest supported value.
+*/
+template<typename KeyType, typename Handler, std::size_t TableSize>
+class DispatchTable final
+{
+	static_assert(std::is_unsigned_v<KeyType>, "KeyType must be an unsigned integral type");
+	static_assert(std::is_pointer_v<Handler> && std::is_function_v<std::remove_pointer_t<Handler>>, "Handler must be a plain function pointer");
+
+public:
+	using Entry = std::pair<KeyType, Handler>;
+
+	/** Builds the table from a list of (key, handler) pairs. Non-capturing lambdas implicitly convert to Handler. */
+	constexpr DispatchTable(std::initializer_list<Entry> const entries)
+	{
+		for (auto const& entry : entries)
+		{
+			if (entry.first >= TableSize)
+			{
+				throw std::out_of_range("DispatchTable key out of range");
+			}
+			_handlers[entry.first] = entry.second;
+		}
+	}
+
+	/** Returns the handler for the specified key, or nullptr if there is none */
+	constexpr Handler find(KeyType const key) const noexcept
+	{
+		if (key >= TableSize)
+		{
+			return nullptr;
+		}
+		return _handlers[key];
+	}
+
+	static constexpr std::size_t size() noexcept
+	{
+		return TableSize;
+	}
+
+private:
+	std::array<Handler, TableSize> _handlers{};
+};
+
+} // namespace protocol
+} // namespace avdecc
+} // namespace la
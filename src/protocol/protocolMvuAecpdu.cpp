@@ -25,6 +25,7 @@
 #include "la/avdecc/internals/protocolMvuAecpdu.hpp"
 
 #include "logHelper.hpp"
+#include "protocolPduPool.hpp"
 
 #include <cassert>
 #include <string>
@@ -198,7 +199,7 @@ Aecpdu::UniquePointer LA_AVDECC_CALL_CONVENTION MvuAecpdu::responseCopy() const
 	};
 
 	// Create a response message as a copy of this
-	auto response = UniquePointer(new MvuAecpdu(*this), deleter);
+	auto response = UniquePointer(PduPool<MvuAecpdu>::getInstance().create(*this), deleter);
 	auto& mvu = static_cast<MvuAecpdu&>(*response);
 
 	// Change the message type to be an VENDOR_UNIQUE_RESPONSE
@@ -217,13 +218,13 @@ MvuAecpdu& LA_AVDECC_CALL_CONVENTION MvuAecpdu::operator=(MvuAecpdu&&) = default
 /** Entry point */
 MvuAecpdu* LA_AVDECC_CALL_CONVENTION MvuAecpdu::createRawMvuAecpdu(bool const isResponse) noexcept
 {
-	return new MvuAecpdu(isResponse);
+	return PduPool<MvuAecpdu>::getInstance().create(isResponse);
 }
 
 /** Destroy method for COM-like interface */
 void LA_AVDECC_CALL_CONVENTION MvuAecpdu::destroy() noexcept
 {
-	delete this;
+	PduPool<MvuAecpdu>::getInstance().destroy(this);
 }
 
 } // namespace protocol
@@ -0,0 +1,207 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @file protocolPduPool.hpp
+* @author Christophe Calmejane
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace la
+{
+namespace avdecc
+{
+namespace protocol
+{
+/**
+* @brief Thread-safe pool recycling the memory of heap allocated PDUs (the ones returned by the 'create' factories).
+* @details A destroyed PDU gives its memory block back to the pool, and the next created PDU of the same type reuses it,
+*          so building commands and copying messages does not allocate once the pool is warm.
+*          Each thread first uses its own cache of blocks (no lock), exchanging blocks with the shared free list (up to MaximumFreeBlocks) only when its cache is empty or full.
+*          The pool is never destroyed, so that PDUs released during static destruction are still safe.
+*/
+template<typename PduType>
+class PduPool final
+{
+public:
+	static constexpr size_t MaximumFreeBlocks = 256u;
+	static constexpr size_t ThreadCacheBlocks = 32u;
+
+	static PduPool& getInstance() noexcept
+	{
+		static auto* s_instance = new PduPool{}; // Never destroyed on purpose
+		return *s_instance;
+	}
+
+	/** Constructs a new PDU in a recycled memory block (or a newly allocated one if the pool is empty) */
+	template<typename... Args>
+	PduType* create(Args&&... args)
+	{
+		auto* const block = acquireBlock();
+		try
+		{
+			return new (block) PduType(std::forward<Args>(args)...);
+		}
+		catch (...)
+		{
+			releaseBlock(block);
+			throw;
+		}
+	}
+
+	/** Destroys a PDU previously returned by create, and keeps its memory block for a future PDU */
+	void destroy(PduType* const pdu) noexcept
+	{
+		pdu->~PduType();
+		releaseBlock(pdu);
+	}
+
+	/** Returns the number of memory blocks currently available in the shared free list (not counting the ones cached by each thread) */
+	size_t getFreeBlocksCount() const noexcept
+	{
+		auto const lg = std::lock_guard{ _lock };
+		return _freeBlocksCount;
+	}
+
+	/** Returns the number of memory blocks currently cached by the calling thread */
+	size_t getThreadCacheBlocksCount() const noexcept
+	{
+		if (s_threadCacheDestroyed)
+		{
+			return 0u;
+		}
+		return getThreadCache().count;
+	}
+
+	// Deleted compiler auto-generated methods
+	PduPool(PduPool&&) = delete;
+	PduPool(PduPool const&) = delete;
+	PduPool& operator=(PduPool const&) = delete;
+	PduPool& operator=(PduPool&&) = delete;
+
+private:
+	/** A free block stores the link to the next free block in its own memory */
+	struct FreeBlock
+	{
+		FreeBlock* next{ nullptr };
+	};
+	/** Blocks owned by a thread, given back to the shared free list when the thread exits */
+	struct ThreadCache
+	{
+		FreeBlock* blocks{ nullptr };
+		size_t count{ 0u };
+
+		~ThreadCache() noexcept
+		{
+			s_threadCacheDestroyed = true;
+			auto& pool = getInstance();
+			while (blocks != nullptr)
+			{
+				auto* const block = blocks;
+				blocks = block->next;
+				pool.releaseSharedBlock(block);
+			}
+		}
+	};
+	static_assert(sizeof(PduType) >= sizeof(FreeBlock), "PduType too small to be pooled");
+	static_assert(alignof(PduType) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "PduType requires an over-aligned allocation");
+
+	PduPool() noexcept = default;
+
+	static ThreadCache& getThreadCache() noexcept
+	{
+		static thread_local auto s_threadCache = ThreadCache{};
+		return s_threadCache;
+	}
+
+	void* acquireBlock()
+	{
+		// Fast path: a block cached by this thread
+		if (!s_threadCacheDestroyed)
+		{
+			auto& cache = getThreadCache();
+			if (auto* const block = cache.blocks; block != nullptr)
+			{
+				cache.blocks = block->next;
+				--cache.count;
+				return block;
+			}
+		}
+
+		// Then a block from the shared free list
+		{
+			auto const lg = std::lock_guard{ _lock };
+			if (auto* const block = _freeBlocks; block != nullptr)
+			{
+				_freeBlocks = block->next;
+				--_freeBlocksCount;
+				return block;
+			}
+		}
+
+		return ::operator new(sizeof(PduType));
+	}
+
+	void releaseBlock(void* const block) noexcept
+	{
+		// Fast path: keep the block in this thread's cache
+		if (!s_threadCacheDestroyed)
+		{
+			auto& cache = getThreadCache();
+			if (cache.count < ThreadCacheBlocks)
+			{
+				cache.blocks = new (block) FreeBlock{ cache.blocks };
+				++cache.count;
+				return;
+			}
+		}
+
+		releaseSharedBlock(block);
+	}
+
+	void releaseSharedBlock(void* const block) noexcept
+	{
+		{
+			auto const lg = std::lock_guard{ _lock };
+			if (_freeBlocksCount < MaximumFreeBlocks)
+			{
+				_freeBlocks = new (block) FreeBlock{ _freeBlocks };
+				++_freeBlocksCount;
+				return;
+			}
+		}
+		::operator delete(block);
+	}
+
+	// Private members
+	static thread_local inline bool s_threadCacheDestroyed{ false }; // Trivially destructible, so it can still be checked while (or after) the thread cache is destroyed
+	mutable std::mutex _lock{};
+	FreeBlock* _freeBlocks{ nullptr };
+	size_t _freeBlocksCount{ 0u };
+};
+
+} // namespace protocol
+} // namespace avdecc
+} // namespace la
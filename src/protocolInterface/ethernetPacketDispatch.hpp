@@ -32,6 +32,7 @@
 #include "la/avdecc/utils.hpp"
 #include "la/avdecc/executor.hpp"
 
+#include "protocol/protocolDispatchTable.hpp"
 #include "stateMachine/stateMachineManager.hpp"
 #include "logHelper.hpp"
 
@@ -47,6 +48,8 @@ template<class BaseClass>
 class EthernetPacketDispatcher
 {
 public:
+	static constexpr std::size_t AecpMessageTypeTableSize = 16u; // AECP message_type is a 4 bits field
+
 	EthernetPacketDispatcher(BaseClass* const self, stateMachine::Manager& stateMachineManager)
 		: _self{ self }
 		, _stateMachineManager{ stateMachineManager }
@@ -69,8 +72,8 @@ public:
 				/* ADP Message */
 				case AvtpSubType_Adp:
 				{
-					auto adpdu = Adpdu::create();
-					auto& adp = static_cast<Adpdu&>(*adpdu);
+					// Deserialize in place, the state machine doesn't keep a reference to the message (no allocation)
+					auto adp = Adpdu{};
 
 					// Fill EtherLayer2
 					adp.setSrcAddress(etherLayer2.getSrcAddress());
@@ -93,28 +96,23 @@ public:
 				{
 					auto const messageType = static_cast<AecpMessageType>(controlData);
 
-					static std::unordered_map<AecpMessageType, std::function<Aecpdu::UniquePointer(BaseClass* const pi, EtherLayer2 const& etherLayer2, Deserializer& des, std::uint8_t const* const pkt_data, size_t const pkt_len)>, AecpMessageType::Hash> s_Dispatch{
-						{ AecpMessageType::AemCommand,
-							[](BaseClass* const /*pi*/, EtherLayer2 const& /*etherLayer2*/, Deserializer& /*des*/, std::uint8_t const* const /*pkt_data*/, size_t const /*pkt_len*/)
-							{
-								return AemAecpdu::create(false);
-							} },
-						{ AecpMessageType::AemResponse,
-							[](BaseClass* const /*pi*/, EtherLayer2 const& /*etherLayer2*/, Deserializer& /*des*/, std::uint8_t const* const /*pkt_data*/, size_t const /*pkt_len*/)
-							{
-								return AemAecpdu::create(true);
-							} },
-						{ AecpMessageType::AddressAccessCommand,
-							[](BaseClass* const /*pi*/, EtherLayer2 const& /*etherLayer2*/, Deserializer& /*des*/, std::uint8_t const* const /*pkt_data*/, size_t const /*pkt_len*/)
-							{
-								return AaAecpdu::create(false);
-							} },
-						{ AecpMessageType::AddressAccessResponse,
-							[](BaseClass* const /*pi*/, EtherLayer2 const& /*etherLayer2*/, Deserializer& /*des*/, std::uint8_t const* const /*pkt_data*/, size_t const /*pkt_len*/)
-							{
-								return AaAecpdu::create(true);
-							} },
-						{ AecpMessageType::VendorUniqueCommand,
+					// AEM and AA messages are deserialized in place, the state machine doesn't keep a reference to the message (no allocation)
+					if (messageType == AecpMessageType::AemCommand || messageType == AecpMessageType::AemResponse)
+					{
+						auto aecp = AemAecpdu{ messageType == AecpMessageType::AemResponse };
+						processAecpMessage(etherLayer2, des, aecp);
+						break;
+					}
+					if (messageType == AecpMessageType::AddressAccessCommand || messageType == AecpMessageType::AddressAccessResponse)
+					{
+						auto aecp = AaAecpdu{ messageType == AecpMessageType::AddressAccessResponse };
+						processAecpMessage(etherLayer2, des, aecp);
+						break;
+					}
+
+					using DispatchHandler = Aecpdu::UniquePointer (*)(BaseClass* const pi, EtherLayer2 const& etherLayer2, Deserializer& des, std::uint8_t const* const pkt_data, size_t const pkt_len);
+					static auto const s_Dispatch = DispatchTable<AecpMessageType::value_type, DispatchHandler, AecpMessageTypeTableSize>{
+						{ AecpMessageType::VendorUniqueCommand.getValue(),
 							[](BaseClass* const pi, EtherLayer2 const& etherLayer2, Deserializer& des, std::uint8_t const* const pkt_data, size_t const pkt_len)
 							{
 								// We have to retrieve the ProtocolID to dispatch
@@ -155,7 +153,7 @@ public:
 
 								return Aecpdu::UniquePointer{ nullptr, nullptr };
 							} },
-						{ AecpMessageType::VendorUniqueResponse,
+						{ AecpMessageType::VendorUniqueResponse.getValue(),
 							[](BaseClass* const pi, EtherLayer2 const& etherLayer2, Deserializer& des, std::uint8_t const* const pkt_data, size_t const pkt_len)
 							{
 								// We have to retrieve the ProtocolID to dispatch
@@ -205,25 +203,16 @@ public:
 							} },
 					};
 
-					auto const& it = s_Dispatch.find(messageType);
-					if (it == s_Dispatch.end())
+					auto const handler = s_Dispatch.find(messageType.getValue());
+					if (handler == nullptr)
 						return; // Unsupported AECP message type
 
 					// Create aecpdu frame based on message type
-					auto aecpdu = it->second(_self, etherLayer2, des, pkt_data, pkt_len);
+					auto aecpdu = handler(_self, etherLayer2, des, pkt_data, pkt_len);
 
 					if (aecpdu != nullptr)
 					{
-						auto& aecp = static_cast<Aecpdu&>(*aecpdu);
-
-						// Deserialize the aecp message
-						deserializeAecpMessage(etherLayer2, des, aecp);
-
-						// Low level notification
-						_self->template notifyObserversMethod<ProtocolInterface::Observer>(&ProtocolInterface::Observer::onAecpduReceived, _self, aecp);
-
-						// Forward to our state machine
-						_stateMachineManager.processAecpdu(aecp);
+						processAecpMessage(etherLayer2, des, static_cast<Aecpdu&>(*aecpdu));
 					}
 					break;
 				}
@@ -231,12 +220,12 @@ public:
 				/* ACMP Message */
 				case AvtpSubType_Acmp:
 				{
-					auto acmpdu = Acmpdu::create();
-					auto& acmp = static_cast<Acmpdu&>(*acmpdu);
+					// Deserialize in place, the state machine doesn't keep a reference to the message (no allocation)
+					auto acmp = Acmpdu{};
 
 					// Fill EtherLayer2
 					acmp.setSrcAddress(etherLayer2.getSrcAddress());
-					static_cast<EtherLayer2&>(*acmpdu).setDestAddress(etherLayer2.getDestAddress()); // Fill dest address, even if we know it's always the MultiCast address
+					static_cast<EtherLayer2&>(acmp).setDestAddress(etherLayer2.getDestAddress()); // Fill dest address, even if we know it's always the MultiCast address
 					// Then deserialize Avtp control
 					deserialize<AvtpduControl>(&acmp, des);
 					// Then deserialize Acmp
@@ -271,6 +260,18 @@ public:
 	}
 
 private:
+	void processAecpMessage(EtherLayer2 const& etherLayer2, Deserializer& des, Aecpdu& aecp) const
+	{
+		// Deserialize the aecp message
+		deserializeAecpMessage(etherLayer2, des, aecp);
+
+		// Low level notification
+		_self->template notifyObserversMethod<ProtocolInterface::Observer>(&ProtocolInterface::Observer::onAecpduReceived, _self, aecp);
+
+		// Forward to our state machine
+		_stateMachineManager.processAecpdu(aecp);
+	}
+
 	static void deserializeAecpMessage(EtherLayer2 const& etherLayer2, Deserializer& des, Aecpdu& aecp)
 	{
 		// Fill EtherLayer2
@@ -0,0 +1,193 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/**
+* @file framePool.hpp
+* @author Christophe Calmejane
+*/
+
+#pragma once
+
+#include "la/avdecc/utils.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace la
+{
+namespace avdecc
+{
+namespace protocol
+{
+/** Fixed size pool of preallocated frame slots, used to carry received frames from the capture thread to the dispatcher without any memory allocation. */
+class FramePool final
+{
+public:
+	static constexpr size_t DefaultFrameCount = 128u;
+	static constexpr size_t MaximumFrameSize = 1536u; // Large enough for any non-jumbo ethernet frame (including an optional 802.1Q tag)
+
+	struct Frame
+	{
+		std::array<std::uint8_t, MaximumFrameSize> data; // Not value-initialized on purpose, only 'size' bytes are valid
+		size_t size{ 0u };
+		Frame* next{ nullptr }; // Next frame in the free list (when not in use) or in the FrameBatch (when in use)
+	};
+
+	explicit FramePool(size_t const frameCount = DefaultFrameCount)
+		: _frames(frameCount)
+	{
+		// Chain all frames in the free list
+		for (auto& frame : _frames)
+		{
+			frame.next = _freeFrames;
+			_freeFrames = &frame;
+		}
+		_freeCount = frameCount;
+	}
+
+	/** Copies the specified data into a free slot. Returns nullptr if the data doesn't fit in a slot or if all slots are in use (caller should then fallback to a regular allocation). */
+	Frame* acquire(std::uint8_t const* const data, size_t const size) noexcept
+	{
+		if (size > MaximumFrameSize)
+		{
+			return nullptr;
+		}
+
+		auto* frame = static_cast<Frame*>(nullptr);
+		{
+			auto const lg = std::lock_guard{ _lock };
+			frame = _freeFrames;
+			if (frame == nullptr)
+			{
+				return nullptr;
+			}
+			_freeFrames = frame->next;
+			--_freeCount;
+		}
+
+		std::memcpy(frame->data.data(), data, size);
+		frame->size = size;
+		frame->next = nullptr;
+
+		return frame;
+	}
+
+	/** Gives back a slot previously returned by acquire. */
+	void release(Frame* const frame) noexcept
+	{
+		AVDECC_ASSERT(frame >= _frames.data() && frame < _frames.data() + _frames.size(), "Frame does not belong to this pool");
+
+		auto const lg = std::lock_guard{ _lock };
+		frame->next = _freeFrames;
+		_freeFrames = frame;
+		++_freeCount;
+	}
+
+	/** Returns the number of slots currently available. */
+	size_t getFreeCount() const noexcept
+	{
+		auto const lg = std::lock_guard{ _lock };
+		return _freeCount;
+	}
+
+	// Deleted compiler auto-generated methods
+	FramePool(FramePool&&) = delete;
+	FramePool(FramePool const&) = delete;
+	FramePool& operator=(FramePool const&) = delete;
+	FramePool& operator=(FramePool&&) = delete;
+
+private:
+	// Private variables
+	std::vector<Frame> _frames{};
+	mutable std::mutex _lock{};
+	Frame* _freeFrames{ nullptr };
+	size_t _freeCount{ 0u };
+};
+
+/** Frames accumulated by a capture thread, to be dispatched in a single executor job. Frames are chained using Frame::next so that a whole batch can be carried by a single pointer (no allocation). */
+class FrameBatch final
+{
+public:
+	FrameBatch() noexcept = default;
+
+	/** Appends a frame (acquired from a FramePool) to the batch. */
+	void push(FramePool::Frame* const frame) noexcept
+	{
+		frame->next = nullptr;
+		if (_last == nullptr)
+		{
+			_first = frame;
+			_firstFrameTime = std::chrono::steady_clock::now();
+		}
+		else
+		{
+			_last->next = frame;
+		}
+		_last = frame;
+		++_count;
+	}
+
+	bool empty() const noexcept
+	{
+		return _count == 0u;
+	}
+
+	size_t size() const noexcept
+	{
+		return _count;
+	}
+
+	/** Returns true if the batch contains at least maxFrames frames, or if its first frame has been waiting for at least maxDelay. */
+	bool isComplete(size_t const maxFrames, std::chrono::microseconds const maxDelay) const noexcept
+	{
+		return _count >= maxFrames || (_count != 0u && (std::chrono::steady_clock::now() - _firstFrameTime) >= maxDelay);
+	}
+
+	/** Returns the first frame of the batch (following ones are chained through Frame::next) and resets the batch. */
+	FramePool::Frame* take() noexcept
+	{
+		auto* const first = _first;
+		_first = nullptr;
+		_last = nullptr;
+		_count = 0u;
+		return first;
+	}
+
+	// Deleted compiler auto-generated methods
+	FrameBatch(FrameBatch&&) = delete;
+	FrameBatch(FrameBatch const&) = delete;
+	FrameBatch& operator=(FrameBatch const&) = delete;
+	FrameBatch& operator=(FrameBatch&&) = delete;
+
+private:
+	// Private variables
+	FramePool::Frame* _first{ nullptr };
+	FramePool::Frame* _last{ nullptr };
+	size_t _count{ 0u };
+	std::chrono::steady_clock::time_point _firstFrameTime{};
+};
+
+} // namespace protocol
+} // namespace avdecc
+} // namespace la
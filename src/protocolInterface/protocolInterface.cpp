@@ -36,6 +36,9 @@
 #	error "Not implemented yet"
 #	include "protocolInterface/protocolInterface_proxy.hpp"
 #endif // HAVE_PROTOCOL_INTERFACE_PROXY
+#ifdef HAVE_PROTOCOL_INTERFACE_TPACKET
+#	include "protocolInterface/protocolInterface_tpacket.hpp"
+#endif // HAVE_PROTOCOL_INTERFACE_TPACKET
 #ifdef HAVE_PROTOCOL_INTERFACE_VIRTUAL
 #	include "protocolInterface/protocolInterface_virtual.hpp"
 #endif // HAVE_PROTOCOL_INTERFACE_VIRTUAL
@@ -121,6 +124,31 @@ ProtocolInterface::Error LA_AVDECC_CALL_CONVENTION ProtocolInterface::unregister
 	return Error::NoError;
 }
 
+ProtocolInterface::Error LA_AVDECC_CALL_CONVENTION ProtocolInterface::setIngressBatching(std::uint32_t const maxFrames, std::chrono::microseconds const maxDelay) noexcept
+{
+	if (maxFrames == 0u || maxFrames > MaximumIngressBatchFrames || maxDelay.count() < 0)
+	{
+		return Error::InvalidParameters;
+	}
+
+	_ingressBatchMaxFrames = maxFrames;
+	_ingressBatchMaxDelay = maxDelay.count();
+
+	return Error::NoError;
+}
+
+ProtocolInterface::Error LA_AVDECC_CALL_CONVENTION ProtocolInterface::setMaxAecpInflightCommands(std::uint32_t const maxInflightCommands) noexcept
+{
+	if (maxInflightCommands == 0u || maxInflightCommands > MaximumAecpInflightCommands)
+	{
+		return Error::InvalidParameters;
+	}
+
+	_maxAecpInflightCommands = maxInflightCommands;
+
+	return Error::NoError;
+}
+
 bool ProtocolInterface::isAecpResponseMessageType(AecpMessageType const messageType) noexcept
 {
 	if (messageType == protocol::AecpMessageType::AemResponse || messageType == protocol::AecpMessageType::AddressAccessResponse || messageType == protocol::AecpMessageType::AvcResponse || messageType == protocol::AecpMessageType::VendorUniqueResponse || messageType == protocol::AecpMessageType::HdcpAemResponse || messageType == protocol::AecpMessageType::ExtendedResponse)
@@ -160,6 +188,21 @@ ProtocolInterface::VendorUniqueDelegate* ProtocolInterface::getVendorUniqueDeleg
 	return vudIt->second;
 }
 
+std::uint32_t ProtocolInterface::getIngressBatchMaxFrames() const noexcept
+{
+	return _ingressBatchMaxFrames;
+}
+
+std::chrono::microseconds ProtocolInterface::getIngressBatchMaxDelay() const noexcept
+{
+	return std::chrono::microseconds{ _ingressBatchMaxDelay.load() };
+}
+
+std::uint32_t ProtocolInterface::getMaxAecpInflightCommands() const noexcept
+{
+	return _maxAecpInflightCommands;
+}
+
 ProtocolInterface* LA_AVDECC_CALL_CONVENTION ProtocolInterface::createRawProtocolInterface(Type const protocolInterfaceType, std::string const& networkInterfaceName)
 {
 	if (!isSupportedProtocolInterfaceType(protocolInterfaceType))
@@ -180,6 +223,10 @@ ProtocolInterface* LA_AVDECC_CALL_CONVENTION ProtocolInterface::createRawProtoco
 			AVDECC_ASSERT(false, "TODO: Proxy protocol interface to create");
 			break;
 #endif // HAVE_PROTOCOL_INTERFACE_PROXY
+#if defined(HAVE_PROTOCOL_INTERFACE_TPACKET)
+		case Type::TPacket:
+			return ProtocolInterfaceTPacket::createRawProtocolInterfaceTPacket(networkInterfaceName);
+#endif // HAVE_PROTOCOL_INTERFACE_TPACKET
 #if defined(HAVE_PROTOCOL_INTERFACE_VIRTUAL)
 		case Type::Virtual:
 			return ProtocolInterfaceVirtual::createRawProtocolInterfaceVirtual(networkInterfaceName, { { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05 } });
@@ -210,6 +257,8 @@ std::string LA_AVDECC_CALL_CONVENTION ProtocolInterface::typeToString(Type const
 			return "IEEE Std 1722.1 proxy";
 		case Type::Virtual:
 			return "Virtual interface";
+		case Type::TPacket:
+			return "Linux AF_PACKET (TPACKET_V3)";
 		default:
 			return "Unknown protocol interface type";
 	}
@@ -245,6 +294,14 @@ ProtocolInterface::SupportedProtocolInterfaceTypes LA_AVDECC_CALL_CONVENTION Pro
 		}
 #endif // HAVE_PROTOCOL_INTERFACE_PROXY
 
+		// TPacket (only supported on Linux)
+#if defined(HAVE_PROTOCOL_INTERFACE_TPACKET)
+		if (protocol::ProtocolInterfaceTPacket::isSupported())
+		{
+			s_supportedProtocolInterfaceTypes.set(Type::TPacket);
+		}
+#endif // HAVE_PROTOCOL_INTERFACE_TPACKET
+
 		// Virtual
 #if defined(HAVE_PROTOCOL_INTERFACE_VIRTUAL)
 		if (protocol::ProtocolInterfaceVirtual::isSupported())
@@ -614,6 +614,11 @@ private:
 		return getVuAecpCommandTimeout(protocolIdentifier, aecpdu);
 	}
 
+	virtual std::uint32_t getMaxAecpInflightCommandsCeiling() const noexcept override
+	{
+		return getMaxAecpInflightCommands();
+	}
+
 #pragma mark la::avdecc::utils::Subject overrides
 	virtual void onObserverRegistered(observer_type* const observer) noexcept override
 	{
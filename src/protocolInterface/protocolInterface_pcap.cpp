@@ -31,6 +31,7 @@
 
 #include "stateMachine/stateMachineManager.hpp"
 #include "ethernetPacketDispatch.hpp"
+#include "framePool.hpp"
 #include "protocolInterface_pcap.hpp"
 #include "pcapInterface.hpp"
 #include "logHelper.hpp"
@@ -131,12 +132,34 @@ public:
 				std::signal(SIGTERM, [](int){});
 #endif // __linux__
 
-				_pcapLibrary.loop(pcap, -1, &ProtocolInterfacePcapImpl::pcapLoopHandler, reinterpret_cast<u_char*>(this));
+				// Read packets one at a time (instead of using pcap_loop) so a pending ingress batch can be dispatched when the capture times out
+				while (!_shouldTerminate)
+				{
+					struct pcap_pkthdr* header{ nullptr };
+					u_char const* pkt_data{ nullptr };
+					auto const result = _pcapLibrary.next_ex(pcap, &header, &pkt_data);
+
+					// Packet received
+					if (result == 1)
+					{
+						onPacketCaptured(pkt_data, header->caplen);
+					}
+					// Timeout expired, no more packet in the capture buffer
+					else if (result == 0)
+					{
+						flushIngressBatch();
+					}
+					// Error or breakloop
+					else
+					{
+						break;
+					}
+				}
 
 				// Notify observers if we exited the loop because of an error
 				if (!_shouldTerminate)
 				{
-					// pcap_loop returned but we never asked for termination
+					// pcap capture returned but we never asked for termination
 					notifyObserversMethod<ProtocolInterface::Observer>(&ProtocolInterface::Observer::onTransportError, this);
 				}
 			});
@@ -180,7 +203,7 @@ private:
 		{
 			if (auto pcap = _pcap.get(); AVDECC_ASSERT_WITH_RET(pcap, "pcap should not be null if the thread exists"))
 			{
-				// Ask pcap_loop to terminate
+				// Ask the capture loop to terminate
 				_pcapLibrary.breakloop(pcap);
 			}
 #ifdef __linux__
@@ -484,6 +507,11 @@ private:
 		return getVuAecpCommandTimeout(protocolIdentifier, aecpdu);
 	}
 
+	virtual std::uint32_t getMaxAecpInflightCommandsCeiling() const noexcept override
+	{
+		return getMaxAecpInflightCommands();
+	}
+
 	/* ************************************************************ */
 	/* stateMachine::AdvertiseStateMachine::Delegate overrides      */
 	/* ************************************************************ */
@@ -609,45 +637,90 @@ private:
 		la::avdecc::ExecutorManager::getInstance().pushJob(DefaultExecutorName,
 			[this, msg = std::move(packet)]()
 			{
-				// Packet received, process it
-				auto des = DeserializationBuffer(msg);
-				EtherLayer2 etherLayer2;
-				deserialize<EtherLayer2>(&etherLayer2, des);
-
-				// Don't ignore self mac, another entity might be on the computer
-
-				// Check ether type (shouldn't be needed, pcap filter is active)
-				std::uint16_t etherType = AVDECC_UNPACK_TYPE(*((std::uint16_t*)(msg.data() + 12)), std::uint16_t);
-				if (etherType != AvtpEtherType)
-				{
-					return;
-				}
-
-				std::uint8_t const* avtpdu = msg.data() + 14; // Start of AVB Transport Protocol
-				auto avtpdu_size = msg.size() - 14;
-				// Check AVTP control bit (meaning AVDECC packet)
-				std::uint8_t avtp_sub_type_control = avtpdu[0];
-				if ((avtp_sub_type_control & 0xF0) == 0)
-				{
-					return;
-				}
+				// Try to detect possible deadlock
+				_watchDog.registerWatch(_watchDogName, std::chrono::milliseconds{ 1000u }, true);
+				dispatchRawPacket(msg.data(), msg.size());
+				_watchDog.unregisterWatch(_watchDogName, true);
+			});
+	}
 
+	void processFrames(FramePool::Frame* const frames) const noexcept
+	{
+		// Captures are stored inline in the Job (no allocation)
+		la::avdecc::ExecutorManager::getInstance().pushJob(DefaultExecutorName,
+			[this, frames]()
+			{
 				// Try to detect possible deadlock
+				_watchDog.registerWatch(_watchDogName, std::chrono::milliseconds{ 1000u }, true);
+				for (auto* frame = frames; frame != nullptr;)
 				{
-					_watchDog.registerWatch("avdecc::PCapInterface::dispatchAvdeccMessage::" + utils::toHexString(reinterpret_cast<size_t>(this)), std::chrono::milliseconds{ 1000u }, true);
-					_ethernetPacketDispatcher.dispatchAvdeccMessage(avtpdu, avtpdu_size, etherLayer2);
-					_watchDog.unregisterWatch("avdecc::PCapInterface::dispatchAvdeccMessage::" + utils::toHexString(reinterpret_cast<size_t>(this)), true);
+					auto* const nextFrame = frame->next;
+					dispatchRawPacket(frame->data.data(), frame->size);
+					_framePool.release(frame);
+					frame = nextFrame;
 				}
+				_watchDog.unregisterWatch(_watchDogName, true);
 			});
 	}
 
-	static void pcapLoopHandler(u_char* user, const struct pcap_pkthdr* header, const u_char* pkt_data)
+	void dispatchRawPacket(std::uint8_t const* const pkt_data, size_t const pkt_len) const noexcept
+	{
+		// Packet received, process it
+		auto des = DeserializationBuffer(pkt_data, pkt_len);
+		EtherLayer2 etherLayer2;
+		deserialize<EtherLayer2>(&etherLayer2, des);
+
+		// Don't ignore self mac, another entity might be on the computer
+
+		// Check ether type (shouldn't be needed, pcap filter is active)
+		std::uint16_t etherType = AVDECC_UNPACK_TYPE(*((std::uint16_t*)(pkt_data + 12)), std::uint16_t);
+		if (etherType != AvtpEtherType)
+		{
+			return;
+		}
+
+		std::uint8_t const* avtpdu = pkt_data + 14; // Start of AVB Transport Protocol
+		auto avtpdu_size = pkt_len - 14;
+		// Check AVTP control bit (meaning AVDECC packet)
+		std::uint8_t avtp_sub_type_control = avtpdu[0];
+		if ((avtp_sub_type_control & 0xF0) == 0)
+		{
+			return;
+		}
+
+		_ethernetPacketDispatcher.dispatchAvdeccMessage(avtpdu, avtpdu_size, etherLayer2);
+	}
+
+	/** Called by the capture thread for each received packet */
+	void onPacketCaptured(std::uint8_t const* const pkt_data, size_t const pkt_len) noexcept
 	{
-		auto* self = reinterpret_cast<ProtocolInterfacePcapImpl*>(user);
+		// Copy the pcap message into a preallocated frame and add it to the ingress batch
+		if (auto* const frame = _framePool.acquire(pkt_data, pkt_len); frame != nullptr)
+		{
+			_ingressBatch.push(frame);
+			if (_ingressBatch.isComplete(getIngressBatchMaxFrames(), getIngressBatchMaxDelay()))
+			{
+				flushIngressBatch();
+			}
+		}
+		// No more frame available (or frame too big), fallback to a dynamically allocated copy
+		else
+		{
+			// Preserve ordering of received packets
+			flushIngressBatch();
+
+			auto pcapMessage = la::avdecc::MemoryBuffer{ pkt_data, pkt_len };
+			processRawPacket(std::move(pcapMessage));
+		}
+	}
 
-		// Make a copy of the pcap message and forward to the processing queue
-		auto pcapMessage = la::avdecc::MemoryBuffer{ pkt_data, header->caplen };
-		self->processRawPacket(std::move(pcapMessage));
+	/** Called by the capture thread to dispatch pending frames */
+	void flushIngressBatch() noexcept
+	{
+		if (!_ingressBatch.empty())
+		{
+			processFrames(_ingressBatch.take());
+		}
 	}
 
 	Error sendPacket(SerializationBuffer const& buffer) const noexcept
@@ -678,6 +751,9 @@ private:
 	// Private variables
 	watchDog::WatchDog::SharedPointer _watchDogSharedPointer{ watchDog::WatchDog::getInstance() };
 	watchDog::WatchDog& _watchDog{ *_watchDogSharedPointer };
+	std::string const _watchDogName{ "avdecc::PCapInterface::dispatchAvdeccMessage::" + utils::toHexString(reinterpret_cast<size_t>(this)) };
+	mutable FramePool _framePool{};
+	FrameBatch _ingressBatch{}; // Only accessed from the capture thread
 	PcapInterface _pcapLibrary;
 	std::unique_ptr<pcap_t, std::function<void(pcap_t*)>> _pcap{ nullptr, nullptr };
 	int _fd{ -1 };
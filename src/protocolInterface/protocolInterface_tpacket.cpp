@@ -0,0 +1,920 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @file protocolInterface_tpacket.cpp
+* @author Christophe Calmejane
+*/
+
+
+#include "la/avdecc/internals/serialization.hpp"
+#include "la/avdecc/internals/protocolAemAecpdu.hpp"
+#include "la/avdecc/internals/protocolAaAecpdu.hpp"
+#include "la/avdecc/watchDog.hpp"
+#include "la/avdecc/utils.hpp"
+#include "la/avdecc/executor.hpp"
+
+#include "stateMachine/stateMachineManager.hpp"
+#include "ethernetPacketDispatch.hpp"
+#include "protocolInterface_tpacket.hpp"
+#include "logHelper.hpp"
+
+#include <arpa/inet.h>
+#include <linux/filter.h>
+#include <linux/if_packet.h>
+#include <net/ethernet.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace la
+{
+namespace avdecc
+{
+namespace protocol
+{
+/** Memory mapped TPACKET_V3 receive ring, shared between the capture thread and the jobs processing its blocks */
+class TPacketRing final
+{
+public:
+	static constexpr std::uint32_t BlockSize = 1u << 16; // 64 KiB per block (must be a multiple of the page size)
+	static constexpr std::uint32_t BlockCount = 64u; // 4 MiB ring
+	static constexpr std::uint32_t FrameSize = 1u << 11; // Maximum size of a single frame (only used by the kernel for sanity checks in V3)
+	static constexpr std::uint32_t BlockRetireTimeoutMsec = 2u; // Maximum time a partially filled block is held by the kernel before being handed to userspace
+
+	TPacketRing(int const fd, std::uint8_t* const map, size_t const mapSize) noexcept
+		: _fd{ fd }
+		, _map{ map }
+		, _mapSize{ mapSize }
+	{
+	}
+
+	~TPacketRing() noexcept
+	{
+		if (_map != nullptr)
+		{
+			::munmap(_map, _mapSize);
+		}
+		if (_fd != -1)
+		{
+			::close(_fd);
+		}
+	}
+
+	int getFileDescriptor() const noexcept
+	{
+		return _fd;
+	}
+
+	tpacket_block_desc* getBlock(std::uint32_t const blockIndex) const noexcept
+	{
+		return reinterpret_cast<tpacket_block_desc*>(_map + static_cast<size_t>(blockIndex) * BlockSize);
+	}
+
+	/** Returns true if the block has been filled by the kernel and is ready to be processed */
+	bool isBlockReady(std::uint32_t const blockIndex) const noexcept
+	{
+		auto const status = __atomic_load_n(&getBlock(blockIndex)->hdr.bh1.block_status, __ATOMIC_ACQUIRE);
+		return (status & TP_STATUS_USER) != 0;
+	}
+
+	/** Returns true if the block has been handed to the executor and not yet released */
+	bool isBlockInUse(std::uint32_t const blockIndex) const noexcept
+	{
+		return _blocksInUse[blockIndex].load(std::memory_order_acquire);
+	}
+
+	void acquireBlock(std::uint32_t const blockIndex) noexcept
+	{
+		_blocksInUse[blockIndex].store(true, std::memory_order_release);
+	}
+
+	/** Gives the block back to the kernel. Must be called after all the frames it contains have been processed */
+	void releaseBlock(std::uint32_t const blockIndex) noexcept
+	{
+		// Status has to be reset before the in-use flag is cleared, so the capture thread doesn't see a stale 'user' status for a block it no longer owns
+		__atomic_store_n(&getBlock(blockIndex)->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+		{
+			auto const lg = std::lock_guard{ _releaseLock };
+			_blocksInUse[blockIndex].store(false, std::memory_order_release);
+		}
+		_releaseCondVar.notify_one();
+	}
+
+	/** Waits until the specified block is released, or the timeout expires */
+	void waitBlockReleased(std::uint32_t const blockIndex, std::chrono::milliseconds const timeout) noexcept
+	{
+		auto lock = std::unique_lock{ _releaseLock };
+		_releaseCondVar.wait_for(lock, timeout,
+			[this, blockIndex]
+			{
+				return !_blocksInUse[blockIndex].load(std::memory_order_acquire);
+			});
+	}
+
+	/** Calls the handler for each frame in the specified block */
+	template<typename Handler>
+	void forEachFrame(std::uint32_t const blockIndex, Handler&& handler) const noexcept
+	{
+		auto* const block = getBlock(blockIndex);
+		auto const numberOfFrames = block->hdr.bh1.num_pkts;
+		auto* frame = reinterpret_cast<tpacket3_hdr const*>(reinterpret_cast<std::uint8_t const*>(block) + block->hdr.bh1.offset_to_first_pkt);
+
+		for (auto frameIndex = decltype(numberOfFrames){ 0u }; frameIndex < numberOfFrames; ++frameIndex)
+		{
+			handler(reinterpret_cast<std::uint8_t const*>(frame) + frame->tp_mac, static_cast<size_t>(frame->tp_snaplen));
+			frame = reinterpret_cast<tpacket3_hdr const*>(reinterpret_cast<std::uint8_t const*>(frame) + frame->tp_next_offset);
+		}
+	}
+
+	// Deleted compiler auto-generated methods
+	TPacketRing(TPacketRing&&) = delete;
+	TPacketRing(TPacketRing const&) = delete;
+	TPacketRing& operator=(TPacketRing const&) = delete;
+	TPacketRing& operator=(TPacketRing&&) = delete;
+
+private:
+	int const _fd{ -1 };
+	std::uint8_t* const _map{ nullptr };
+	size_t const _mapSize{ 0u };
+	std::array<std::atomic_bool, BlockCount> _blocksInUse{};
+	std::mutex _releaseLock{};
+	std::condition_variable _releaseCondVar{};
+};
+
+class ProtocolInterfaceTPacketImpl final : public ProtocolInterfaceTPacket, private stateMachine::ProtocolInterfaceDelegate, private stateMachine::AdvertiseStateMachine::Delegate, private stateMachine::DiscoveryStateMachine::Delegate, private stateMachine::CommandStateMachine::Delegate
+{
+public:
+	/* ************************************************************ */
+	/* Public APIs                                                  */
+	/* ************************************************************ */
+	/** Constructor */
+	ProtocolInterfaceTPacketImpl(std::string const& networkInterfaceName)
+		: ProtocolInterfaceTPacket(networkInterfaceName)
+	{
+		// Should always be supported. Cannot create a TPacket ProtocolInterface if it's not supported.
+		AVDECC_ASSERT(isSupported(), "Should always be supported. Cannot create a TPacket ProtocolInterface if it's not supported");
+
+		// Get the interface index
+		_interfaceIndex = static_cast<int>(::if_nametoindex(networkInterfaceName.c_str()));
+		if (_interfaceIndex == 0)
+		{
+			throw Exception(Error::InterfaceNotFound, "No interface found with specified name");
+		}
+
+		// Open a raw packet socket receiving all protocols, so we also get outgoing frames (another entity might be on the computer). Filtering is done by the kernel using BPF
+		auto const fd = ::socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
+		if (fd == -1)
+		{
+			throw Exception(Error::TransportError, std::string("Failed to open packet socket: ") + std::strerror(errno));
+		}
+
+		// From now on, use a guard to close the socket in case of failure
+		auto fdGuard = std::unique_ptr<int, std::function<void(int*)>>{ new int{ fd }, [](int* fd)
+			{
+				if (*fd != -1)
+				{
+					::close(*fd);
+				}
+				delete fd;
+			} };
+		auto const throwTransportError = [](std::string const& message)
+		{
+			throw Exception(Error::TransportError, message + ": " + std::strerror(errno));
+		};
+
+		// Configure kernel filtering to ignore packets of other protocols (equivalent to "ether proto 0x22f0")
+		static sock_filter s_filterCode[] = {
+			BPF_STMT(BPF_LD | BPF_H | BPF_ABS, 12), // Load EtherType
+			BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, AvtpEtherType, 0, 1), // If AVTP, go to next instruction, otherwise skip it
+			BPF_STMT(BPF_RET | BPF_K, 0x0000ffff), // Accept full frame
+			BPF_STMT(BPF_RET | BPF_K, 0x00000000), // Drop frame
+		};
+		auto const filter = sock_fprog{ static_cast<unsigned short>(sizeof(s_filterCode) / sizeof(s_filterCode[0])), s_filterCode };
+		if (::setsockopt(fd, SOL_SOCKET, SO_ATTACH_FILTER, &filter, sizeof(filter)) == -1)
+		{
+			throwTransportError("Failed to set ether filter");
+		}
+
+		// Use TPACKET_V3 (block based ring)
+		auto const version = int{ TPACKET_V3 };
+		if (::setsockopt(fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) == -1)
+		{
+			throwTransportError("Failed to set TPACKET_V3");
+		}
+
+		// Create the receive ring
+		auto req = tpacket_req3{};
+		req.tp_block_size = TPacketRing::BlockSize;
+		req.tp_block_nr = TPacketRing::BlockCount;
+		req.tp_frame_size = TPacketRing::FrameSize;
+		req.tp_frame_nr = (TPacketRing::BlockSize * TPacketRing::BlockCount) / TPacketRing::FrameSize;
+		req.tp_retire_blk_tov = TPacketRing::BlockRetireTimeoutMsec;
+		req.tp_sizeof_priv = 0;
+		req.tp_feature_req_word = 0;
+		if (::setsockopt(fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) == -1)
+		{
+			throwTransportError("Failed to create receive ring");
+		}
+
+		// Map the ring in our address space
+		auto const mapSize = static_cast<size_t>(req.tp_block_size) * req.tp_block_nr;
+		auto* const map = ::mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		if (map == MAP_FAILED)
+		{
+			throwTransportError("Failed to map receive ring");
+		}
+
+		// Try to lock the ring in memory to avoid page faults in the capture thread (best effort, RLIMIT_MEMLOCK is usually too low for unprivileged users)
+		if (::mlock(map, mapSize) == -1)
+		{
+			auto const error = errno;
+			LOG_GENERIC_WARN(std::string("Failed to lock receive ring in memory (") + std::strerror(error) + "), capture may suffer from page faults");
+		}
+
+		// Bind the socket to the network interface
+		auto address = sockaddr_ll{};
+		address.sll_family = AF_PACKET;
+		address.sll_protocol = htons(ETH_P_ALL);
+		address.sll_ifindex = _interfaceIndex;
+		if (::bind(fd, reinterpret_cast<sockaddr const*>(&address), sizeof(address)) == -1)
+		{
+			::munmap(map, mapSize);
+			throwTransportError("Failed to bind to network interface");
+		}
+
+		// Enable promiscuous mode
+		auto membership = packet_mreq{};
+		membership.mr_ifindex = _interfaceIndex;
+		membership.mr_type = PACKET_MR_PROMISC;
+		if (::setsockopt(fd, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &membership, sizeof(membership)) == -1)
+		{
+			::munmap(map, mapSize);
+			throwTransportError("Failed to enable promiscuous mode");
+		}
+
+		// The ring now owns the socket
+		*fdGuard = -1;
+		_ring = std::make_shared<TPacketRing>(fd, static_cast<std::uint8_t*>(map), mapSize);
+
+		// Start the capture thread
+		_captureThread = std::thread(
+			[this]
+			{
+				utils::setCurrentThreadName("avdecc::TPacketInterface::Capture");
+				captureLoop();
+			});
+
+		// Start the state machines
+		_stateMachineManager.startStateMachines();
+	}
+
+	/** Destructor */
+	virtual ~ProtocolInterfaceTPacketImpl() noexcept
+	{
+		shutdown();
+	}
+
+	/** Destroy method for COM-like interface */
+	virtual void destroy() noexcept override
+	{
+		delete this;
+	}
+
+	// Deleted compiler auto-generated methods
+	ProtocolInterfaceTPacketImpl(ProtocolInterfaceTPacketImpl&&) = delete;
+	ProtocolInterfaceTPacketImpl(ProtocolInterfaceTPacketImpl const&) = delete;
+	ProtocolInterfaceTPacketImpl& operator=(ProtocolInterfaceTPacketImpl const&) = delete;
+	ProtocolInterfaceTPacketImpl& operator=(ProtocolInterfaceTPacketImpl&&) = delete;
+
+private:
+	/* ************************************************************ */
+	/* ProtocolInterface overrides                                  */
+	/* ************************************************************ */
+	virtual void shutdown() noexcept override
+	{
+		// Stop the state machines
+		_stateMachineManager.stopStateMachines();
+
+		// Notify the thread we are shutting down
+		_shouldTerminate = true;
+
+		// Wait for the thread to complete its pending tasks (it polls with a timeout, so it will notice the termination flag)
+		if (_captureThread.joinable())
+		{
+			_captureThread.join();
+		}
+
+		// Release the ring (jobs still in the executor hold a reference on it, the last one will unmap it)
+		_ring.reset();
+	}
+
+	virtual UniqueIdentifier getDynamicEID() const noexcept override
+	{
+		UniqueIdentifier::value_type eid{ 0u };
+		auto const& macAddress = getMacAddress();
+
+		eid += macAddress[0];
+		eid <<= 8;
+		eid += macAddress[1];
+		eid <<= 8;
+		eid += macAddress[2];
+		eid <<= 16;
+		std::srand(static_cast<unsigned int>(std::time(0)));
+		eid += static_cast<std::uint16_t>((std::rand() % 0xFFFD) + 1);
+		eid <<= 8;
+		eid += macAddress[3];
+		eid <<= 8;
+		eid += macAddress[4];
+		eid <<= 8;
+		eid += macAddress[5];
+
+		return UniqueIdentifier{ eid };
+	}
+
+	virtual void releaseDynamicEID(UniqueIdentifier const /*entityID*/) const noexcept override
+	{
+		// Nothing to do
+	}
+
+	virtual Error registerLocalEntity(entity::LocalEntity& entity) noexcept override
+	{
+		// Checks if entity has declared an InterfaceInformation matching this ProtocolInterface
+		auto const index = _stateMachineManager.getMatchingInterfaceIndex(entity);
+
+		if (index)
+		{
+			return _stateMachineManager.registerLocalEntity(entity);
+		}
+
+		return Error::InvalidParameters;
+	}
+
+	virtual Error unregisterLocalEntity(entity::LocalEntity& entity) noexcept override
+	{
+		return _stateMachineManager.unregisterLocalEntity(entity);
+	}
+
+	virtual Error injectRawPacket(la::avdecc::MemoryBuffer&& packet) const noexcept override
+	{
+		la::avdecc::ExecutorManager::getInstance().pushJob(DefaultExecutorName,
+			[this, msg = std::move(packet)]()
+			{
+				processFrame(msg.data(), msg.size());
+			});
+		return Error::NoError;
+	}
+
+	virtual Error setEntityNeedsAdvertise(entity::LocalEntity const& entity, entity::LocalEntity::AdvertiseFlags const /*flags*/) noexcept override
+	{
+		return _stateMachineManager.setEntityNeedsAdvertise(entity);
+	}
+
+	virtual Error enableEntityAdvertising(entity::LocalEntity& entity) noexcept override
+	{
+		return _stateMachineManager.enableEntityAdvertising(entity);
+	}
+
+	virtual Error disableEntityAdvertising(entity::LocalEntity const& entity) noexcept override
+	{
+		return _stateMachineManager.disableEntityAdvertising(entity);
+	}
+
+	virtual Error discoverRemoteEntities() const noexcept override
+	{
+		return _stateMachineManager.discoverRemoteEntities();
+	}
+
+	virtual Error discoverRemoteEntity(UniqueIdentifier const entityID) const noexcept override
+	{
+		return _stateMachineManager.discoverRemoteEntity(entityID);
+	}
+
+	virtual Error setAutomaticDiscoveryDelay(std::chrono::milliseconds const delay) const noexcept override
+	{
+		return _stateMachineManager.setAutomaticDiscoveryDelay(delay);
+	}
+
+	virtual bool isDirectMessageSupported() const noexcept override
+	{
+		return true;
+	}
+
+	virtual Error sendAdpMessage(Adpdu const& adpdu) const noexcept override
+	{
+		// Directly send the message on the network
+		return sendMessage(adpdu);
+	}
+
+	virtual Error sendAecpMessage(Aecpdu const& aecpdu) const noexcept override
+	{
+		// Directly send the message on the network
+		return sendMessage(aecpdu);
+	}
+
+	virtual Error sendAcmpMessage(Acmpdu const& acmpdu) const noexcept override
+	{
+		// Directly send the message on the network
+		return sendMessage(acmpdu);
+	}
+
+	virtual Error sendAecpCommand(Aecpdu::UniquePointer&& aecpdu, AecpCommandResultHandler const& onResult) const noexcept override
+	{
+		auto const messageType = aecpdu->getMessageType();
+
+		if (!AVDECC_ASSERT_WITH_RET(!isAecpResponseMessageType(messageType), "Calling sendAecpCommand with a Response MessageType"))
+		{
+			return Error::MessageNotSupported;
+		}
+
+		// Special check for VendorUnique messages
+		if (messageType == AecpMessageType::VendorUniqueCommand)
+		{
+			auto& vuAecp = static_cast<VuAecpdu&>(*aecpdu);
+
+			auto const vuProtocolID = vuAecp.getProtocolIdentifier();
+			auto* vuDelegate = getVendorUniqueDelegate(vuProtocolID);
+
+			// No delegate, or the messages are not handled by the ControllerStateMachine
+			if (!vuDelegate || !vuDelegate->areHandledByControllerStateMachine(vuProtocolID))
+			{
+				return Error::MessageNotSupported;
+			}
+		}
+
+		// Command goes through the state machine to handle timeout, retry and response
+		return _stateMachineManager.sendAecpCommand(std::move(aecpdu), onResult);
+	}
+
+	virtual Error sendAecpResponse(Aecpdu::UniquePointer&& aecpdu) const noexcept override
+	{
+		auto const messageType = aecpdu->getMessageType();
+
+		if (!AVDECC_ASSERT_WITH_RET(isAecpResponseMessageType(messageType), "Calling sendAecpResponse with a Command MessageType"))
+		{
+			return Error::MessageNotSupported;
+		}
+
+		// Special check for VendorUnique messages
+		if (messageType == AecpMessageType::VendorUniqueResponse)
+		{
+			auto& vuAecp = static_cast<VuAecpdu&>(*aecpdu);
+
+			auto const vuProtocolID = vuAecp.getProtocolIdentifier();
+			auto* vuDelegate = getVendorUniqueDelegate(vuProtocolID);
+
+			// No delegate, or the messages are not handled by the ControllerStateMachine
+			if (!vuDelegate || !vuDelegate->areHandledByControllerStateMachine(vuProtocolID))
+			{
+				return Error::MessageNotSupported;
+			}
+		}
+
+		// Response can be directly sent
+		return sendMessage(static_cast<Aecpdu const&>(*aecpdu));
+	}
+
+	virtual Error sendAcmpCommand(Acmpdu::UniquePointer&& acmpdu, AcmpCommandResultHandler const& onResult) const noexcept override
+	{
+		// Command goes through the state machine to handle timeout, retry and response
+		return _stateMachineManager.sendAcmpCommand(std::move(acmpdu), onResult);
+	}
+
+	virtual Error sendAcmpResponse(Acmpdu::UniquePointer&& acmpdu) const noexcept override
+	{
+		// Response can be directly sent
+		return sendMessage(static_cast<Acmpdu const&>(*acmpdu));
+	}
+
+	virtual void lock() const noexcept override
+	{
+		_stateMachineManager.lock();
+	}
+
+	virtual void unlock() const noexcept override
+	{
+		_stateMachineManager.unlock();
+	}
+
+	virtual bool isSelfLocked() const noexcept override
+	{
+		return _stateMachineManager.isSelfLocked();
+	}
+
+	/* ************************************************************ */
+	/* stateMachine::ProtocolInterfaceDelegate overrides            */
+	/* ************************************************************ */
+	/* **** AECP notifications **** */
+	virtual void onAecpCommand(Aecpdu const& aecpdu) noexcept override
+	{
+		// Notify observers
+		notifyObserversMethod<ProtocolInterface::Observer>(&ProtocolInterface::Observer::onAecpCommand, this, aecpdu);
+	}
+
+	/* **** ACMP notifications **** */
+	virtual void onAcmpCommand(Acmpdu const& acmpdu) noexcept override
+	{
+		// Notify observers
+		notifyObserversMethod<ProtocolInterface::Observer>(&ProtocolInterface::Observer::onAcmpCommand, this, acmpdu);
+	}
+
+	virtual void onAcmpResponse(Acmpdu const& acmpdu) noexcept override
+	{
+		// Notify observers
+		notifyObserversMethod<ProtocolInterface::Observer>(&ProtocolInterface::Observer::onAcmpResponse, this, acmpdu);
+	}
+
+	/* **** Sending methods **** */
+	virtual Error sendMessage(Adpdu const& adpdu) const noexcept override
+	{
+		try
+		{
+			// TPacket transport requires the full frame to be built
+			SerializationBuffer buffer;
+
+			// Start with EtherLayer2
+			serialize<EtherLayer2>(adpdu, buffer);
+			// Then Avtp control
+			serialize<AvtpduControl>(adpdu, buffer);
+			// Then with Adp
+			serialize<Adpdu>(adpdu, buffer);
+
+			// Send the message
+			return sendPacket(buffer);
+		}
+		catch ([[maybe_unused]] std::exception const& e)
+		{
+			LOG_PROTOCOL_INTERFACE_DEBUG(adpdu.getSrcAddress(), adpdu.getDestAddress(), std::string("Failed to serialize ADPDU: ") + e.what());
+			return Error::InternalError;
+		}
+	}
+
+	virtual Error sendMessage(Aecpdu const& aecpdu) const noexcept override
+	{
+		try
+		{
+			// TPacket transport requires the full frame to be built
+			SerializationBuffer buffer;
+
+			// Start with EtherLayer2
+			serialize<EtherLayer2>(aecpdu, buffer);
+			// Then Avtp control
+			serialize<AvtpduControl>(aecpdu, buffer);
+			// Then with Aecp
+			serialize<Aecpdu>(aecpdu, buffer);
+
+			// Send the message
+			return sendPacket(buffer);
+		}
+		catch ([[maybe_unused]] std::exception const& e)
+		{
+			LOG_PROTOCOL_INTERFACE_DEBUG(aecpdu.getSrcAddress(), aecpdu.getDestAddress(), std::string("Failed to serialize AECPDU: ") + e.what());
+			return Error::InternalError;
+		}
+	}
+
+	virtual Error sendMessage(Acmpdu const& acmpdu) const noexcept override
+	{
+		try
+		{
+			// TPacket transport requires the full frame to be built
+			SerializationBuffer buffer;
+
+			// Start with EtherLayer2
+			serialize<EtherLayer2>(acmpdu, buffer);
+			// Then Avtp control
+			serialize<AvtpduControl>(acmpdu, buffer);
+			// Then with Acmp
+			serialize<Acmpdu>(acmpdu, buffer);
+
+			// Send the message
+			return sendPacket(buffer);
+		}
+		catch ([[maybe_unused]] std::exception const& e)
+		{
+			LOG_PROTOCOL_INTERFACE_DEBUG(acmpdu.getSrcAddress(), Acmpdu::Multicast_Mac_Address, "Failed to serialize ACMPDU: {}", e.what());
+			return Error::InternalError;
+		}
+	}
+
+	/* *** Other methods **** */
+	virtual std::uint32_t getVuAecpCommandTimeoutMsec(VuAecpdu::ProtocolIdentifier const& protocolIdentifier, VuAecpdu const& aecpdu) const noexcept override
+	{
+		return getVuAecpCommandTimeout(protocolIdentifier, aecpdu);
+	}
+
+	virtual std::uint32_t getMaxAecpInflightCommandsCeiling() const noexcept override
+	{
+		return getMaxAecpInflightCommands();
+	}
+
+	/* ************************************************************ */
+	/* stateMachine::AdvertiseStateMachine::Delegate overrides      */
+	/* ************************************************************ */
+
+	/* ************************************************************ */
+	/* stateMachine::DiscoveryStateMachine::Delegate overrides      */
+	/* ************************************************************ */
+	virtual void onLocalEntityOnline(entity::Entity const& entity) noexcept override
+	{
+		// Notify observers
+		notifyObserversMethod<ProtocolInterface::Observer>(&ProtocolInterface::Observer::onLocalEntityOnline, this, entity);
+	}
+
+	virtual void onLocalEntityOffline(UniqueIdentifier const entityID) noexcept override
+	{
+		// Notify observers
+		notifyObserversMethod<ProtocolInterface::Observer>(&ProtocolInterface::Observer::onLocalEntityOffline, this, entityID);
+	}
+
+	virtual void onLocalEntityUpdated(entity::Entity const& entity) noexcept override
+	{
+		// Notify observers
+		notifyObserversMethod<ProtocolInterface::Observer>(&ProtocolInterface::Observer::onLocalEntityUpdated, this, entity);
+	}
+
+	virtual void onRemoteEntityOnline(entity::Entity const& entity) noexcept override
+	{
+		// Notify observers
+		notifyObserversMethod<ProtocolInterface::Observer>(&ProtocolInterface::Observer::onRemoteEntityOnline, this, entity);
+	}
+
+	virtual void onRemoteEntityOffline(UniqueIdentifier const entityID) noexcept override
+	{
+		// Notify observers
+		notifyObserversMethod<ProtocolInterface::Observer>(&ProtocolInterface::Observer::onRemoteEntityOffline, this, entityID);
+	}
+
+	virtual void onRemoteEntityUpdated(entity::Entity const& entity) noexcept override
+	{
+		// Notify observers
+		notifyObserversMethod<ProtocolInterface::Observer>(&ProtocolInterface::Observer::onRemoteEntityUpdated, this, entity);
+	}
+
+	/* ************************************************************ */
+	/* stateMachine::CommandStateMachine::Delegate overrides        */
+	/* ************************************************************ */
+	virtual void onAecpAemUnsolicitedResponse(AemAecpdu const& aecpdu) noexcept override
+	{
+		// Notify observers
+		notifyObserversMethod<ProtocolInterface::Observer>(&ProtocolInterface::Observer::onAecpAemUnsolicitedResponse, this, aecpdu);
+	}
+
+	virtual void onAecpAemIdentifyNotification(AemAecpdu const& aecpdu) noexcept override
+	{
+		// Notify observers
+		notifyObserversMethod<ProtocolInterface::Observer>(&ProtocolInterface::Observer::onAecpAemIdentifyNotification, this, aecpdu);
+	}
+	virtual void onAecpRetry(UniqueIdentifier const& entityID) noexcept override
+	{
+		// Notify observers
+		notifyObserversMethod<ProtocolInterface::Observer>(&ProtocolInterface::Observer::onAecpRetry, this, entityID);
+	}
+	virtual void onAecpTimeout(UniqueIdentifier const& entityID) noexcept override
+	{
+		// Notify observers
+		notifyObserversMethod<ProtocolInterface::Observer>(&ProtocolInterface::Observer::onAecpTimeout, this, entityID);
+	}
+	virtual void onAecpUnexpectedResponse(UniqueIdentifier const& entityID) noexcept override
+	{
+		// Notify observers
+		notifyObserversMethod<ProtocolInterface::Observer>(&ProtocolInterface::Observer::onAecpUnexpectedResponse, this, entityID);
+	}
+	virtual void onAecpResponseTime(UniqueIdentifier const& entityID, std::chrono::milliseconds const& responseTime) noexcept override
+	{
+		// Notify observers
+		notifyObserversMethod<ProtocolInterface::Observer>(&ProtocolInterface::Observer::onAecpResponseTime, this, entityID, responseTime);
+	}
+
+	/* ************************************************************ */
+	/* la::avdecc::utils::Subject overrides                         */
+	/* ************************************************************ */
+	virtual void onObserverRegistered(observer_type* const observer) noexcept override
+	{
+		if (observer)
+		{
+			class DiscoveryDelegate final : public stateMachine::DiscoveryStateMachine::Delegate
+			{
+			public:
+				DiscoveryDelegate(ProtocolInterface& pi, ProtocolInterface::Observer& obs)
+					: _pi{ pi }
+					, _obs{ obs }
+				{
+				}
+
+			private:
+				virtual void onLocalEntityOnline(la::avdecc::entity::Entity const& entity) noexcept override
+				{
+					utils::invokeProtectedMethod(&ProtocolInterface::Observer::onLocalEntityOnline, &_obs, &_pi, entity);
+				}
+				virtual void onLocalEntityOffline(la::avdecc::UniqueIdentifier const /*entityID*/) noexcept override {}
+				virtual void onLocalEntityUpdated(la::avdecc::entity::Entity const& /*entity*/) noexcept override {}
+				virtual void onRemoteEntityOnline(la::avdecc::entity::Entity const& entity) noexcept override
+				{
+					utils::invokeProtectedMethod(&ProtocolInterface::Observer::onRemoteEntityOnline, &_obs, &_pi, entity);
+				}
+				virtual void onRemoteEntityOffline(la::avdecc::UniqueIdentifier const /*entityID*/) noexcept override {}
+				virtual void onRemoteEntityUpdated(la::avdecc::entity::Entity const& /*entity*/) noexcept override {}
+
+				ProtocolInterface& _pi;
+				ProtocolInterface::Observer& _obs;
+			};
+			auto discoveryDelegate = DiscoveryDelegate{ *this, static_cast<ProtocolInterface::Observer&>(*observer) };
+
+			_stateMachineManager.notifyDiscoveredEntities(discoveryDelegate);
+		}
+	}
+
+	/* ************************************************************ */
+	/* Private methods                                              */
+	/* ************************************************************ */
+	void captureLoop() noexcept
+	{
+		static constexpr auto PollTimeoutMsec = int{ 100 };
+		auto const ring = _ring;
+		auto currentBlock = std::uint32_t{ 0u };
+
+		while (!_shouldTerminate)
+		{
+			// Block is still being processed by the executor, wait for it to be released (must be checked before the block status, see TPacketRing::releaseBlock)
+			if (ring->isBlockInUse(currentBlock))
+			{
+				ring->waitBlockReleased(currentBlock, std::chrono::milliseconds{ PollTimeoutMsec });
+				continue;
+			}
+
+			// Block not filled yet, wait for the kernel
+			if (!ring->isBlockReady(currentBlock))
+			{
+				auto pfd = pollfd{};
+				pfd.fd = ring->getFileDescriptor();
+				pfd.events = POLLIN | POLLERR;
+				pfd.revents = 0;
+				auto const result = ::poll(&pfd, 1, PollTimeoutMsec);
+				if ((result == -1 && errno != EINTR) || (pfd.revents & (POLLERR | POLLHUP | POLLNVAL)) != 0)
+				{
+					break;
+				}
+				continue;
+			}
+
+			// Hand the whole block to the executor, frames will be dispatched directly from the ring (no copy) and the block given back to the kernel afterwards
+			ring->acquireBlock(currentBlock);
+			la::avdecc::ExecutorManager::getInstance().pushJob(DefaultExecutorName,
+				[this, ring, blockIndex = currentBlock]()
+				{
+					ring->forEachFrame(blockIndex,
+						[this](std::uint8_t const* const frame, size_t const frameLength)
+						{
+							processFrame(frame, frameLength);
+						});
+					ring->releaseBlock(blockIndex);
+				});
+
+			currentBlock = (currentBlock + 1u) % TPacketRing::BlockCount;
+		}
+
+		// Notify observers if we exited the loop because of an error
+		if (!_shouldTerminate)
+		{
+			// Capture loop returned but we never asked for termination
+			notifyObserversMethod<ProtocolInterface::Observer>(&ProtocolInterface::Observer::onTransportError, this);
+		}
+	}
+
+	void processFrame(std::uint8_t const* const frame, size_t const frameLength) const noexcept
+	{
+		try
+		{
+			// Packet received, process it
+			auto des = DeserializationBuffer(frame, frameLength);
+			EtherLayer2 etherLayer2;
+			deserialize<EtherLayer2>(&etherLayer2, des);
+
+			// Don't ignore self mac, another entity might be on the computer
+
+			// Check ether type (shouldn't be needed, BPF filter is active)
+			std::uint16_t etherType = AVDECC_UNPACK_TYPE(*((std::uint16_t*)(frame + 12)), std::uint16_t);
+			if (etherType != AvtpEtherType)
+			{
+				return;
+			}
+
+			std::uint8_t const* avtpdu = frame + 14; // Start of AVB Transport Protocol
+			auto avtpdu_size = frameLength - 14;
+			// Check AVTP control bit (meaning AVDECC packet)
+			std::uint8_t avtp_sub_type_control = avtpdu[0];
+			if ((avtp_sub_type_control & 0xF0) == 0)
+			{
+				return;
+			}
+
+			// Try to detect possible deadlock
+			{
+				_watchDog.registerWatch(_watchDogName, std::chrono::milliseconds{ 1000u }, true);
+				_ethernetPacketDispatcher.dispatchAvdeccMessage(avtpdu, avtpdu_size, etherLayer2);
+				_watchDog.unregisterWatch(_watchDogName, true);
+			}
+		}
+		catch (...)
+		{
+			// Truncated frame, ignore it
+		}
+	}
+
+	Error sendPacket(SerializationBuffer const& buffer) const noexcept
+	{
+		auto length = buffer.size();
+		constexpr auto minimumSize = EthernetPayloadMinimumSize + EtherLayer2::HeaderLength;
+
+		/* Check the buffer has enough bytes in it */
+		if (length < minimumSize)
+			length = minimumSize; // No need to resize nor pad the buffer, it has enough capacity and we don't care about the unused bytes. Simply increase the length of the data to send.
+
+		auto const ring = _ring;
+		AVDECC_ASSERT(ring, "Trying to send a message but the ring has been uninitialized");
+		if (ring)
+		{
+			if (::send(ring->getFileDescriptor(), buffer.data(), length, 0) == static_cast<ssize_t>(length))
+			{
+				return Error::NoError;
+			}
+		}
+		return Error::TransportError;
+	}
+
+	// Private variables
+	watchDog::WatchDog::SharedPointer _watchDogSharedPointer{ watchDog::WatchDog::getInstance() };
+	watchDog::WatchDog& _watchDog{ *_watchDogSharedPointer };
+	std::string const _watchDogName{ "avdecc::TPacketInterface::dispatchAvdeccMessage::" + utils::toHexString(reinterpret_cast<size_t>(this)) };
+	int _interfaceIndex{ 0 };
+	std::shared_ptr<TPacketRing> _ring{ nullptr };
+	std::atomic_bool _shouldTerminate{ false };
+	mutable stateMachine::Manager _stateMachineManager{ this, this, this, this, this };
+	std::thread _captureThread{};
+	friend class EthernetPacketDispatcher<ProtocolInterfaceTPacketImpl>;
+	EthernetPacketDispatcher<ProtocolInterfaceTPacketImpl> _ethernetPacketDispatcher{ this, _stateMachineManager };
+};
+
+ProtocolInterfaceTPacket::ProtocolInterfaceTPacket(std::string const& networkInterfaceName)
+	: ProtocolInterface(networkInterfaceName)
+{
+}
+
+bool ProtocolInterfaceTPacket::isSupported() noexcept
+{
+	// Check we are allowed to open a packet socket (requires CAP_NET_RAW) and the kernel supports TPACKET_V3
+	auto const fd = ::socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
+	if (fd == -1)
+	{
+		return false;
+	}
+
+	auto const version = int{ TPACKET_V3 };
+	auto const result = ::setsockopt(fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version));
+	::close(fd);
+
+	return result == 0;
+}
+
+ProtocolInterfaceTPacket* ProtocolInterfaceTPacket::createRawProtocolInterfaceTPacket(std::string const& networkInterfaceName)
+{
+	return new ProtocolInterfaceTPacketImpl(networkInterfaceName);
+}
+
+} // namespace protocol
+} // namespace avdecc
+} // namespace la
@@ -32,6 +32,7 @@
 
 #include "stateMachine/stateMachineManager.hpp"
 #include "ethernetPacketDispatch.hpp"
+#include "framePool.hpp"
 #include "protocolInterface_virtual.hpp"
 #include "logHelper.hpp"
 
@@ -108,6 +109,8 @@ public:
 	{
 	public:
 		virtual void onMessage(SerializationBuffer const& message) noexcept = 0;
+		/** Called once all pending messages have been dispatched */
+		virtual void onMessagesDispatched() noexcept = 0;
 		virtual void onTransportError() noexcept = 0;
 	};
 
@@ -182,6 +185,16 @@ public:
 								});
 							messagesToSend.pop_front();
 						}
+
+						// Notify registered observers that no more message is pending
+						if (!intfc->shouldTerminate)
+						{
+							intfc->observers.notifyObservers<Observer>(
+								[](auto* obs)
+								{
+									obs->onMessagesDispatched();
+								});
+						}
 					}
 				});
 			auto result = _interfaces.emplace(std::make_pair(networkInterfaceName, std::move(intfc)));
@@ -334,6 +347,7 @@ private:
 	virtual Error sendMessage(Aecpdu const& aecpdu) const noexcept override;
 	virtual Error sendMessage(Acmpdu const& acmpdu) const noexcept override;
 	virtual std::uint32_t getVuAecpCommandTimeoutMsec(VuAecpdu::ProtocolIdentifier const& protocolIdentifier, VuAecpdu const& aecpdu) const noexcept override;
+	virtual std::uint32_t getMaxAecpInflightCommandsCeiling() const noexcept override;
 
 	/* ************************************************************ */
 	/* stateMachine::AdvertiseStateMachine::Delegate overrides      */
@@ -363,6 +377,7 @@ private:
 	/* MessageDispatcher::Observer overrides                        */
 	/* ************************************************************ */
 	virtual void onMessage(SerializationBuffer const& message) noexcept override;
+	virtual void onMessagesDispatched() noexcept override;
 	virtual void onTransportError() noexcept override;
 
 	/* ************************************************************ */
@@ -374,9 +389,14 @@ private:
 	/* Private methods                                              */
 	/* ************************************************************ */
 	void processRawPacket(la::avdecc::MemoryBuffer&& packet) const noexcept;
+	void processFrames(FramePool::Frame* const frames) const noexcept;
+	void dispatchRawPacket(std::uint8_t const* const pkt_data, size_t const pkt_len) const noexcept;
+	void flushIngressBatch() noexcept;
 	Error sendPacket(SerializationBuffer const& buffer) const noexcept;
 
 	// Private variables
+	mutable FramePool _framePool{};
+	FrameBatch _ingressBatch{}; // Only accessed from the MessageDispatcher thread
 	mutable stateMachine::Manager _stateMachineManager{ this, this, this, this, this };
 	friend class EthernetPacketDispatcher<ProtocolInterfaceVirtualImpl>;
 	EthernetPacketDispatcher<ProtocolInterfaceVirtualImpl> _ethernetPacketDispatcher{ this, _stateMachineManager };
@@ -719,6 +739,11 @@ std::uint32_t ProtocolInterfaceVirtualImpl::getVuAecpCommandTimeoutMsec(VuAecpdu
 	return getVuAecpCommandTimeout(protocolIdentifier, aecpdu);
 }
 
+std::uint32_t ProtocolInterfaceVirtualImpl::getMaxAecpInflightCommandsCeiling() const noexcept
+{
+	return getMaxAecpInflightCommands();
+}
+
 /* ************************************************************ */
 /* stateMachine::AdvertiseStateMachine::Delegate overrides      */
 /* ************************************************************ */
@@ -808,8 +833,29 @@ void ProtocolInterfaceVirtualImpl::onAecpResponseTime(UniqueIdentifier const& en
 /* ************************************************************ */
 void ProtocolInterfaceVirtualImpl::onMessage(SerializationBuffer const& message) noexcept
 {
-	auto msg = la::avdecc::MemoryBuffer{ message.data(), message.size() };
-	processRawPacket(std::move(msg));
+	// Copy the message into a preallocated frame and add it to the ingress batch
+	if (auto* const frame = _framePool.acquire(message.data(), message.size()); frame != nullptr)
+	{
+		_ingressBatch.push(frame);
+		if (_ingressBatch.isComplete(getIngressBatchMaxFrames(), getIngressBatchMaxDelay()))
+		{
+			flushIngressBatch();
+		}
+	}
+	// No more frame available (or frame too big), fallback to a dynamically allocated copy
+	else
+	{
+		// Preserve ordering of received messages
+		flushIngressBatch();
+
+		auto msg = la::avdecc::MemoryBuffer{ message.data(), message.size() };
+		processRawPacket(std::move(msg));
+	}
+}
+
+void ProtocolInterfaceVirtualImpl::onMessagesDispatched() noexcept
+{
+	flushIngressBatch();
 }
 void ProtocolInterfaceVirtualImpl::onTransportError() noexcept
 {
@@ -864,36 +910,65 @@ void ProtocolInterfaceVirtualImpl::processRawPacket(la::avdecc::MemoryBuffer&& p
 	la::avdecc::ExecutorManager::getInstance().pushJob(DefaultExecutorName,
 		[this, msg = std::move(packet)]()
 		{
-			// Packet received, process it
-			auto des = DeserializationBuffer(msg);
-			EtherLayer2 etherLayer2;
-			deserialize<EtherLayer2>(&etherLayer2, des);
-
-			// Only accept message for my MacAddress or the broadcast address
-			auto const& destAddress = etherLayer2.getDestAddress();
-			if (destAddress == getMacAddress() || destAddress == Multicast_Mac_Address || destAddress == Identify_Mac_Address)
-			{
-				// Check ether type (shouldn't be needed, pcap filter is active)
-				std::uint16_t etherType = AVDECC_UNPACK_TYPE(*((std::uint16_t*)(msg.data() + 12)), std::uint16_t);
-				if (etherType != AvtpEtherType)
-				{
-					return;
-				}
-
-				std::uint8_t const* avtpdu = msg.data() + 14; // Start of AVB Transport Protocol
-				auto avtpdu_size = msg.size() - 14;
-				// Check AVTP control bit (meaning AVDECC packet)
-				std::uint8_t avtp_sub_type_control = avtpdu[0];
-				if ((avtp_sub_type_control & 0xF0) == 0)
-				{
-					return;
-				}
+			dispatchRawPacket(msg.data(), msg.size());
+		});
+}
 
-				_ethernetPacketDispatcher.dispatchAvdeccMessage(avtpdu, avtpdu_size, etherLayer2);
+void ProtocolInterfaceVirtualImpl::processFrames(FramePool::Frame* const frames) const noexcept
+{
+	// Captures are stored inline in the Job (no allocation)
+	la::avdecc::ExecutorManager::getInstance().pushJob(DefaultExecutorName,
+		[this, frames]()
+		{
+			for (auto* frame = frames; frame != nullptr;)
+			{
+				auto* const nextFrame = frame->next;
+				dispatchRawPacket(frame->data.data(), frame->size);
+				_framePool.release(frame);
+				frame = nextFrame;
 			}
 		});
 }
 
+void ProtocolInterfaceVirtualImpl::dispatchRawPacket(std::uint8_t const* const pkt_data, size_t const pkt_len) const noexcept
+{
+	// Packet received, process it
+	auto des = DeserializationBuffer(pkt_data, pkt_len);
+	EtherLayer2 etherLayer2;
+	deserialize<EtherLayer2>(&etherLayer2, des);
+
+	// Only accept message for my MacAddress or the broadcast address
+	auto const& destAddress = etherLayer2.getDestAddress();
+	if (destAddress == getMacAddress() || destAddress == Multicast_Mac_Address || destAddress == Identify_Mac_Address)
+	{
+		// Check ether type (shouldn't be needed, pcap filter is active)
+		std::uint16_t etherType = AVDECC_UNPACK_TYPE(*((std::uint16_t*)(pkt_data + 12)), std::uint16_t);
+		if (etherType != AvtpEtherType)
+		{
+			return;
+		}
+
+		std::uint8_t const* avtpdu = pkt_data + 14; // Start of AVB Transport Protocol
+		auto avtpdu_size = pkt_len - 14;
+		// Check AVTP control bit (meaning AVDECC packet)
+		std::uint8_t avtp_sub_type_control = avtpdu[0];
+		if ((avtp_sub_type_control & 0xF0) == 0)
+		{
+			return;
+		}
+
+		_ethernetPacketDispatcher.dispatchAvdeccMessage(avtpdu, avtpdu_size, etherLayer2);
+	}
+}
+
+void ProtocolInterfaceVirtualImpl::flushIngressBatch() noexcept
+{
+	if (!_ingressBatch.empty())
+	{
+		processFrames(_ingressBatch.take());
+	}
+}
+
 ProtocolInterface::Error ProtocolInterfaceVirtualImpl::sendPacket(SerializationBuffer const& buffer) const noexcept
 {
 	auto length = buffer.size();
@@ -29,6 +29,7 @@
 
 #include <utility>
 #include <optional>
+#include <algorithm>
 
 namespace la
 {
@@ -58,7 +59,7 @@ void AdvertiseStateMachine::checkLocalEntitiesAnnouncement() noexcept
 	auto* const protocolInterface = _manager->getProtocolInterfaceDelegate();
 
 	// Get current time
-	auto const now = std::chrono::system_clock::now();
+	auto const now = std::chrono::steady_clock::now();
 
 	// Process all Advertised Entities on the attached Protocol Interface
 	for (auto& entityKV : _advertisedEntities)
@@ -106,7 +107,7 @@ void AdvertiseStateMachine::setEntityNeedsAdvertise(entity::LocalEntity const& e
 	if (infoIt != _advertisedEntities.end())
 	{
 		// Schedule EntityAvailable message
-		infoIt->second.nextAdvertiseTime = computeDelayedAdvertiseTime(entity, *interfaceIndex);
+		scheduleAdvertise(infoIt->second, computeDelayedAdvertiseTime(entity, *interfaceIndex));
 	}
 }
 
@@ -126,8 +127,9 @@ void AdvertiseStateMachine::enableEntityAdvertising(entity::LocalEntity& entity)
 	auto const infoIt = _advertisedEntities.find(entityID);
 	if (infoIt == _advertisedEntities.end())
 	{
-		// Register LocalEntity for Advertising
-		_advertisedEntities.emplace(std::make_pair(entityID, AdvertiseEntityInfo{ entity, *interfaceIndex }));
+		// Register LocalEntity for Advertising, and schedule EntityAvailable message right away
+		auto const [it, inserted] = _advertisedEntities.emplace(std::make_pair(entityID, AdvertiseEntityInfo{ entity, *interfaceIndex }));
+		scheduleAdvertise(it->second, std::chrono::steady_clock::now());
 	}
 }
 
@@ -182,11 +184,24 @@ void AdvertiseStateMachine::handleAdpEntityDiscover(Adpdu const& adpdu) noexcept
 		if (!entityID || entityID == entity.getEntityID())
 		{
 			// Schedule EntityAvailable message
-			entityInfo.nextAdvertiseTime = computeDelayedAdvertiseTime(entity, entityInfo.interfaceIndex);
+			scheduleAdvertise(entityInfo, computeDelayedAdvertiseTime(entity, entityInfo.interfaceIndex));
 		}
 	}
 }
 
+std::chrono::steady_clock::time_point AdvertiseStateMachine::getNextDeadline() const noexcept
+{
+	auto nextDeadline = std::chrono::steady_clock::time_point::max();
+
+	// Only a few local entities are advertised, no need for a sorted structure
+	for (auto const& [entityID, entityInfo] : _advertisedEntities)
+	{
+		nextDeadline = std::min(nextDeadline, entityInfo.nextAdvertiseTime);
+	}
+
+	return nextDeadline;
+}
+
 /* ************************************************************ */
 /* Private methods                                              */
 /* ************************************************************ */
@@ -198,17 +213,22 @@ std::chrono::milliseconds AdvertiseStateMachine::computeRandomDelay(entity::Enti
 	return std::chrono::milliseconds(randomValue);
 }
 
-std::chrono::time_point<std::chrono::system_clock> AdvertiseStateMachine::computeNextAdvertiseTime(entity::Entity const& entity, entity::model::AvbInterfaceIndex const interfaceIndex) const
+std::chrono::steady_clock::time_point AdvertiseStateMachine::computeNextAdvertiseTime(entity::Entity const& entity, entity::model::AvbInterfaceIndex const interfaceIndex) const
 {
 	auto const& interfaceInfo = entity.getInterfaceInformation(interfaceIndex);
-	return std::chrono::system_clock::now() + std::chrono::milliseconds(std::max(1000u, interfaceInfo.validTime * 1000u / 2u)) + computeRandomDelay(entity, interfaceIndex);
+	return std::chrono::steady_clock::now() + std::chrono::milliseconds(std::max(1000u, interfaceInfo.validTime * 1000u / 2u)) + computeRandomDelay(entity, interfaceIndex);
 }
 
-std::chrono::time_point<std::chrono::system_clock> AdvertiseStateMachine::computeDelayedAdvertiseTime(entity::Entity const& entity, entity::model::AvbInterfaceIndex const interfaceIndex) const
+std::chrono::steady_clock::time_point AdvertiseStateMachine::computeDelayedAdvertiseTime(entity::Entity const& entity, entity::model::AvbInterfaceIndex const interfaceIndex) const
 {
-	return std::chrono::system_clock::now() + computeRandomDelay(entity, interfaceIndex);
+	return std::chrono::steady_clock::now() + computeRandomDelay(entity, interfaceIndex);
 }
 
+void AdvertiseStateMachine::scheduleAdvertise(AdvertiseEntityInfo& entityInfo, std::chrono::steady_clock::time_point const advertiseTime) noexcept
+{
+	entityInfo.nextAdvertiseTime = advertiseTime;
+	_manager->scheduleWakeUp(advertiseTime);
+}
 
 } // namespace stateMachine
 } // namespace protocol
@@ -58,6 +58,8 @@ public:
 	void enableEntityAdvertising(entity::LocalEntity& entity) noexcept;
 	void disableEntityAdvertising(entity::LocalEntity const& entity) noexcept;
 	void handleAdpEntityDiscover(Adpdu const& adpdu) noexcept;
+	/** Returns the time at which checkLocalEntitiesAnnouncement should be called next (Manager lock must be taken) */
+	std::chrono::steady_clock::time_point getNextDeadline() const noexcept;
 
 private:
 	// Private types
@@ -65,7 +67,7 @@ private:
 	{
 		entity::LocalEntity& entity;
 		entity::model::AvbInterfaceIndex interfaceIndex{ 0u };
-		std::chrono::time_point<std::chrono::system_clock> nextAdvertiseTime{};
+		std::chrono::steady_clock::time_point nextAdvertiseTime{};
 
 		/** Constructor */
 		AdvertiseEntityInfo(entity::LocalEntity& entity, entity::model::AvbInterfaceIndex const interfaceIndex) noexcept
@@ -78,8 +80,9 @@ private:
 
 	// Private methods
 	std::chrono::milliseconds computeRandomDelay(entity::Entity const& entity, entity::model::AvbInterfaceIndex const interfaceIndex) const noexcept;
-	std::chrono::time_point<std::chrono::system_clock> computeNextAdvertiseTime(entity::Entity const& entity, entity::model::AvbInterfaceIndex const interfaceIndex) const;
-	std::chrono::time_point<std::chrono::system_clock> computeDelayedAdvertiseTime(entity::Entity const& entity, entity::model::AvbInterfaceIndex const interfaceIndex) const;
+	std::chrono::steady_clock::time_point computeNextAdvertiseTime(entity::Entity const& entity, entity::model::AvbInterfaceIndex const interfaceIndex) const;
+	std::chrono::steady_clock::time_point computeDelayedAdvertiseTime(entity::Entity const& entity, entity::model::AvbInterfaceIndex const interfaceIndex) const;
+	void scheduleAdvertise(AdvertiseEntityInfo& entityInfo, std::chrono::steady_clock::time_point const advertiseTime) noexcept;
 
 	// Private members
 	Manager* _manager{ nullptr };
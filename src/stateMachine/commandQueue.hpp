@@ -0,0 +1,243 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @file commandQueue.hpp
+* @author Christophe Calmejane
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace la
+{
+namespace avdecc
+{
+namespace protocol
+{
+namespace stateMachine
+{
+/**
+* @brief FIFO of commands, stored in a pool of slots and indexed by sequence ID.
+* @details Commands are stored in a slab of slots that is only grown, never shrunk: freed slots are recycled by the next inserted command,
+*          so a steady flow of commands does not allocate. Slots are linked together (using indexes) in insertion order, and chained in
+*          a power-of-two bucket table indexed by the sequence ID, so finding and erasing a command is O(1).
+*          The CommandInfo type must be default constructible, movable and have a 'sequenceID' field.
+*          Pointers returned by front() and find() are invalidated by push_back().
+*          Not thread-safe, protected by the CommandShard lock.
+*/
+template<typename CommandInfo>
+class CommandQueue final
+{
+public:
+	using SequenceID = decltype(CommandInfo::sequenceID);
+
+	bool empty() const noexcept
+	{
+		return _size == 0u;
+	}
+
+	size_t size() const noexcept
+	{
+		return _size;
+	}
+
+	/** Appends a command to the queue */
+	void push_back(CommandInfo&& command)
+	{
+		// Grow the bucket table so chains stay short (load factor of at most 1)
+		if (_size + 1u > _buckets.size())
+		{
+			rehash(std::max(_buckets.size() * 2u, MinimumBucketsCount));
+		}
+
+		auto const index = allocateSlot();
+		auto& slot = _slots[index];
+		slot.command = std::move(command);
+
+		// Link at the end of the FIFO
+		slot.previous = _tail;
+		slot.next = InvalidIndex;
+		if (_tail != InvalidIndex)
+		{
+			_slots[_tail].next = index;
+		}
+		else
+		{
+			_head = index;
+		}
+		_tail = index;
+
+		// Chain in its bucket
+		auto& bucket = _buckets[getBucketIndex(slot.command.sequenceID)];
+		slot.nextInBucket = bucket;
+		bucket = index;
+
+		++_size;
+	}
+
+	/** Returns the oldest command of the queue (queue must not be empty) */
+	CommandInfo& front() noexcept
+	{
+		return _slots[_head].command;
+	}
+
+	/** Removes the oldest command of the queue (queue must not be empty) */
+	void pop_front() noexcept
+	{
+		releaseSlot(_head);
+	}
+
+	/** Returns the command with the specified sequenceID, or nullptr if not found */
+	CommandInfo* find(SequenceID const sequenceID) noexcept
+	{
+		auto const index = findSlot(sequenceID);
+		if (index == InvalidIndex)
+		{
+			return nullptr;
+		}
+		return &_slots[index].command;
+	}
+
+	/** Removes the command with the specified sequenceID, if found */
+	void erase(SequenceID const sequenceID) noexcept
+	{
+		auto const index = findSlot(sequenceID);
+		if (index != InvalidIndex)
+		{
+			releaseSlot(index);
+		}
+	}
+
+private:
+	using Index = std::uint32_t;
+	static constexpr auto InvalidIndex = std::numeric_limits<Index>::max();
+	static constexpr auto MinimumBucketsCount = size_t{ 8u };
+
+	struct Slot
+	{
+		CommandInfo command{};
+		Index previous{ InvalidIndex }; // Previous slot in FIFO order (or next free slot when not used)
+		Index next{ InvalidIndex }; // Next slot in FIFO order
+		Index nextInBucket{ InvalidIndex }; // Next slot in the same bucket
+	};
+
+	size_t getBucketIndex(SequenceID const sequenceID) const noexcept
+	{
+		// Sequence IDs are allocated sequentially, the low bits are a perfect hash
+		return static_cast<size_t>(sequenceID) & (_buckets.size() - 1u);
+	}
+
+	Index findSlot(SequenceID const sequenceID) const noexcept
+	{
+		if (_buckets.empty())
+		{
+			return InvalidIndex;
+		}
+		for (auto index = _buckets[getBucketIndex(sequenceID)]; index != InvalidIndex; index = _slots[index].nextInBucket)
+		{
+			if (_slots[index].command.sequenceID == sequenceID)
+			{
+				return index;
+			}
+		}
+		return InvalidIndex;
+	}
+
+	Index allocateSlot()
+	{
+		if (_freeHead != InvalidIndex)
+		{
+			auto const index = _freeHead;
+			_freeHead = _slots[index].previous;
+			return index;
+		}
+		_slots.emplace_back();
+		return static_cast<Index>(_slots.size() - 1u);
+	}
+
+	void releaseSlot(Index const index) noexcept
+	{
+		auto& slot = _slots[index];
+
+		// Unchain from its bucket
+		auto* link = &_buckets[getBucketIndex(slot.command.sequenceID)];
+		while (*link != index)
+		{
+			link = &_slots[*link].nextInBucket;
+		}
+		*link = slot.nextInBucket;
+
+		// Unlink from the FIFO
+		if (slot.previous != InvalidIndex)
+		{
+			_slots[slot.previous].next = slot.next;
+		}
+		else
+		{
+			_head = slot.next;
+		}
+		if (slot.next != InvalidIndex)
+		{
+			_slots[slot.next].previous = slot.previous;
+		}
+		else
+		{
+			_tail = slot.previous;
+		}
+
+		// Release the command resources now (the slot itself is kept for the next command)
+		slot.command = CommandInfo{};
+		slot.next = InvalidIndex;
+		slot.nextInBucket = InvalidIndex;
+		slot.previous = _freeHead;
+		_freeHead = index;
+
+		--_size;
+	}
+
+	void rehash(size_t const bucketsCount)
+	{
+		_buckets.assign(bucketsCount, InvalidIndex);
+		for (auto index = _head; index != InvalidIndex; index = _slots[index].next)
+		{
+			auto& bucket = _buckets[getBucketIndex(_slots[index].command.sequenceID)];
+			_slots[index].nextInBucket = bucket;
+			bucket = index;
+		}
+	}
+
+	// Private members
+	std::vector<Slot> _slots{};
+	std::vector<Index> _buckets{};
+	Index _head{ InvalidIndex };
+	Index _tail{ InvalidIndex };
+	Index _freeHead{ InvalidIndex };
+	size_t _size{ 0u };
+};
+
+} // namespace stateMachine
+} // namespace protocol
+} // namespace avdecc
+} // namespace la
@@ -31,6 +31,8 @@
 
 #include <utility>
 #include <optional>
+#include <algorithm>
+#include <shared_mutex>
 
 namespace la
 {
@@ -53,7 +55,6 @@ static constexpr auto AcmpGetRxStateCommandTimeoutMsec = 200u;
 static constexpr auto AcmpGetTxConnectionCommandTimeoutMsec = 200u;
 
 /* Default state machine parameters */
-static constexpr size_t DefaultMaxAecpInflightCommands = 10;
 static constexpr std::chrono::milliseconds DefaultAecpSendInterval{ 1u };
 static constexpr size_t DefaultMaxAcmpMulticastInflightCommands = 10;
 static constexpr size_t DefaultMaxAcmpUnicastInflightCommands = 10;
@@ -74,22 +75,16 @@ CommandStateMachine::~CommandStateMachine() noexcept {}
 void CommandStateMachine::registerLocalEntity(entity::LocalEntity& entity) noexcept
 {
 	// Lock
-	auto const lg = std::lock_guard{ *_manager };
+	auto const lg = std::unique_lock{ _commandEntitiesLock };
 
-	// Check if entity already registered
-	auto const entityID = entity.getEntityID();
-	auto const infoIt = _commandEntities.find(entityID);
-	if (infoIt == _commandEntities.end())
-	{
-		// Register LocalEntity for Advertising
-		_commandEntities.emplace(std::make_pair(entityID, CommandEntityInfo{ entity }));
-	}
+	// Register LocalEntity, if not already registered
+	_commandEntities.try_emplace(entity.getEntityID(), entity);
 }
 
 void CommandStateMachine::unregisterLocalEntity(entity::LocalEntity& entity) noexcept
 {
 	// Lock
-	auto const lg = std::lock_guard{ *_manager };
+	auto const lg = std::unique_lock{ _commandEntitiesLock };
 
 	// Check if entity already registered
 	auto const entityID = entity.getEntityID();
@@ -103,140 +98,31 @@ void CommandStateMachine::unregisterLocalEntity(entity::LocalEntity& entity) noe
 
 void CommandStateMachine::checkInflightCommandsTimeoutExpiracy() noexcept
 {
-	// Lock
-	auto const lg = std::lock_guard{ *_manager };
-
 	// Get current time
 	auto const now = std::chrono::steady_clock::now();
 
 	auto* const protocolInterface = _manager->getProtocolInterfaceDelegate();
 
-	// Iterate over all locally registered command entities
-	for (auto& localEntityInfoKV : _commandEntities)
+	// Only process the deadlines that actually expired
+	while (true)
 	{
-		auto& localEntityInfo = localEntityInfoKV.second;
-
-		// Check AECP commands
-		for (auto& [targetEntityID, inflight] : localEntityInfo.inflightAecpCommands)
+		auto entry = std::optional<CommandDeadlines::Entry>{};
 		{
-			// Check all inflight timeouts
-			for (auto it = inflight.inflightCommands.begin(); it != inflight.inflightCommands.end(); /* Iterate inside the loop */)
-			{
-				auto& command = *it;
-				if (now > command.timeoutTime)
-				{
-					auto error = ProtocolInterface::Error::NoError;
-					// Timeout expired, check if we retried yet
-					if (!command.retried)
-					{
-						// Let's retry
-						command.retried = true;
-
-						// Update last send time
-						inflight.lastSendTime = now;
-
-						// Ask the transport layer to send the packet
-						error = protocolInterface->sendMessage(static_cast<Aecpdu const&>(*command.command));
-
-						// Reset command timeout
-						resetAecpCommandTimeoutValue(command);
-
-						// Statistics
-						utils::invokeProtectedMethod(&Delegate::onAecpRetry, _delegate, targetEntityID);
-						LOG_CONTROLLER_STATE_MACHINE_DEBUG(targetEntityID, std::string("AECP command with sequenceID ") + std::to_string(command.sequenceID) + " timed out, trying again");
-					}
-					else
-					{
-						error = ProtocolInterface::Error::Timeout;
-						// Statistics
-						utils::invokeProtectedMethod(&Delegate::onAecpTimeout, _delegate, targetEntityID);
-						LOG_CONTROLLER_STATE_MACHINE_DEBUG(targetEntityID, std::string("AECP command with sequenceID ") + std::to_string(command.sequenceID) + " timed out 2 times");
-					}
-
-					if (!!error)
-					{
-						// Already retried, the command has been lost
-						utils::invokeProtectedHandler(command.resultHandler, nullptr, error);
-						it = removeInflight(protocolInterface, localEntityInfo, targetEntityID, inflight, it);
-					}
-				}
-				else
-				{
-					++it;
-				}
-			}
-
-			// Check if we need to empty the queue
-			checkQueue(protocolInterface, localEntityInfo, targetEntityID, inflight, inflight.inflightCommands.end());
+			// Lock
+			auto const lg = std::lock_guard{ _deadlinesLock };
+			entry = _deadlines.popExpired(now);
 		}
-
-		// Check ACMP commands
-		for (auto& [targetMacAddress, inflight] : localEntityInfo.inflightAcmpCommands)
+		if (!entry)
 		{
-			// Check all inflight timeouts
-			for (auto it = inflight.inflightCommands.begin(); it != inflight.inflightCommands.end(); /* Iterate inside the loop */)
-			{
-				auto& command = *it;
-				if (now > command.timeoutTime)
-				{
-					auto error = ProtocolInterface::Error::NoError;
-					// Timeout expired, check if we retried yet
-					if (!command.retried)
-					{
-						// Let's retry
-						command.retried = true;
-
-						// Update last send time
-						inflight.lastSendTime = now;
-
-						// Ask the transport layer to send the packet
-						error = protocolInterface->sendMessage(static_cast<Acmpdu const&>(*command.command));
-
-						// Reset command timeout
-						resetAcmpCommandTimeoutValue(command);
-					}
-					else
-					{
-						error = ProtocolInterface::Error::Timeout;
-					}
-
-					if (!!error)
-					{
-						// Already retried, the command has been lost
-						utils::invokeProtectedHandler(command.resultHandler, nullptr, error);
-						it = removeInflight(protocolInterface, localEntityInfo, targetMacAddress, inflight, it);
-					}
-				}
-				else
-				{
-					++it;
-				}
-			}
-
-			// Check if we need to empty the queue
-			checkQueue(protocolInterface, localEntityInfo, targetMacAddress, inflight, inflight.inflightCommands.end());
+			break;
 		}
 
-		// Notify scheduled errors
-		for (auto const& e : localEntityInfo.scheduledAecpErrors)
-		{
-			utils::invokeProtectedHandler(e.second, nullptr, e.first);
-		}
-		localEntityInfo.scheduledAecpErrors.clear();
-
-		for (auto const& e : localEntityInfo.scheduledAcmpErrors)
-		{
-			utils::invokeProtectedHandler(e.second, nullptr, e.first);
-		}
-		localEntityInfo.scheduledAcmpErrors.clear();
+		processDeadline(protocolInterface, *entry);
 	}
 }
 
 void CommandStateMachine::handleAecpResponse(Aecpdu const& aecpdu) noexcept
 {
-	// Lock
-	auto const lg = std::lock_guard{ *_manager };
-
 	// Get current time
 	auto const now = std::chrono::steady_clock::now();
 
@@ -249,6 +135,9 @@ void CommandStateMachine::handleAecpResponse(Aecpdu const& aecpdu) noexcept
 		// Check if it's an AEM unsolicited response
 		if (isAEMUnsolicitedResponse(aecpdu))
 		{
+			// Lock
+			auto const lg = std::lock_guard{ *_manager };
+
 			utils::invokeProtectedMethod(&Delegate::onAecpAemIdentifyNotification, _delegate, static_cast<AemAecpdu const&>(aecpdu));
 		}
 		else
@@ -257,118 +146,168 @@ void CommandStateMachine::handleAecpResponse(Aecpdu const& aecpdu) noexcept
 		}
 	}
 
-	// Only process it if it's targeted to a registered local command entity (which is set in the ControllerID field)
-	if (auto const commandEntityIt = _commandEntities.find(controllerID); commandEntityIt != _commandEntities.end())
+	auto const targetID = aecpdu.getTargetEntityID();
+	auto isUnsolicitedResponse = false;
+	auto isUnexpectedResponse = false;
+	auto aecpQuery = std::optional<AecpCommandInfo>{};
+
 	{
+		// Lock
+		auto const lg = std::shared_lock{ _commandEntitiesLock };
+
+		// Only process it if it's targeted to a registered local command entity (which is set in the ControllerID field)
+		auto const commandEntityIt = _commandEntities.find(controllerID);
+		if (commandEntityIt == _commandEntities.end())
+		{
+			return;
+		}
+
 		// Check if it's an AEM unsolicited response
 		if (isAEMUnsolicitedResponse(aecpdu))
 		{
-			utils::invokeProtectedMethod(&Delegate::onAecpAemUnsolicitedResponse, _delegate, static_cast<AemAecpdu const&>(aecpdu));
+			isUnsolicitedResponse = true;
 		}
 		else
 		{
 			auto& commandEntityInfo = commandEntityIt->second;
-			auto const targetID = aecpdu.getTargetEntityID();
-
-			if (auto inflightIt = commandEntityInfo.inflightAecpCommands.find(targetID); inflightIt != commandEntityInfo.inflightAecpCommands.end())
-			{
-				auto& inflight = inflightIt->second;
-				auto& inflightCommands = inflight.inflightCommands;
-				auto const sequenceID = aecpdu.getSequenceID();
-				auto commandIt = std::find_if(inflightCommands.begin(), inflightCommands.end(),
-					[sequenceID](AecpCommandInfo const& command)
-					{
-						return command.sequenceID == sequenceID;
-					});
-				// If the sequenceID is not found, it means the response already timed out (arriving too late)
-				if (commandIt != inflightCommands.end())
-				{
-					auto& info = *commandIt;
+			auto& shard = getShard(commandEntityInfo, targetID);
 
-					// Validate the sender
-					if (info.command->getDestAddress() != aecpdu.getSrcAddress())
-					{
-						LOG_CONTROLLER_STATE_MACHINE_WARN(targetID, "AECP response with sequenceID {} received from a different sender than recipient ({} expected but received from {}), ignoring response", sequenceID, networkInterface::NetworkInterfaceHelper::macAddressToString(info.command->getDestAddress(), true), networkInterface::NetworkInterfaceHelper::macAddressToString(aecpdu.getSrcAddress(), true));
-						return;
-					}
+			// Lock
+			auto const slg = std::lock_guard{ shard.lock };
 
-					// Check for special cases where we should re-arm the timer
-					if (shouldRearmTimer(aecpdu))
-					{
-						resetAecpCommandTimeoutValue(info);
-						return;
-					}
-
-					// Move the query (it will be deleted)
-					AecpCommandInfo aecpQuery = std::move(info);
+			auto inflightIt = shard.inflightAecpCommands.find(targetID);
+			if (inflightIt == shard.inflightAecpCommands.end())
+			{
+				return;
+			}
 
-					// Remove the command from inflight list
-					removeInflight(protocolInterface, commandEntityInfo, targetID, inflight, commandIt);
+			auto& inflight = inflightIt->second;
+			auto const sequenceID = aecpdu.getSequenceID();
+			auto* const command = inflight.inflightCommands.find(sequenceID);
+			// If the sequenceID is not found, it means the response already timed out (arriving too late)
+			if (command != nullptr)
+			{
+				auto& info = *command;
 
-					// Call completion handler
-					utils::invokeProtectedHandler(aecpQuery.resultHandler, &aecpdu, ProtocolInterface::Error::NoError);
+				// Validate the sender
+				if (info.command->getDestAddress() != aecpdu.getSrcAddress())
+				{
+					LOG_CONTROLLER_STATE_MACHINE_WARN(targetID, "AECP response with sequenceID {} received from a different sender than recipient ({} expected but received from {}), ignoring response", sequenceID, networkInterface::NetworkInterfaceHelper::macAddressToString(info.command->getDestAddress(), true), networkInterface::NetworkInterfaceHelper::macAddressToString(aecpdu.getSrcAddress(), true));
+					return;
+				}
 
-					// Statistics
-					utils::invokeProtectedMethod(&Delegate::onAecpResponseTime, _delegate, targetID, std::chrono::duration_cast<std::chrono::milliseconds>(now - aecpQuery.sendTime));
+				// Check for special cases where we should re-arm the timer
+				if (shouldRearmTimer(aecpdu))
+				{
+					resetAecpCommandTimeoutValue(info);
+					scheduleAecpCommandTimeout(commandEntityInfo.entityID, targetID, info);
+					return;
 				}
-				else
+
+				// A response to a command that did not have to be retried means the target keeps up, open the inflight window
+				if (!info.retried)
 				{
-					// Statistics
-					utils::invokeProtectedMethod(&Delegate::onAecpUnexpectedResponse, _delegate, targetID);
-					LOG_CONTROLLER_STATE_MACHINE_DEBUG(targetID, std::string("AECP response with sequenceID ") + std::to_string(sequenceID) + " unexpected (timed out already?)");
+					growAecpInflightWindow(protocolInterface, inflight);
 				}
+
+				// Move the query (it will be deleted)
+				aecpQuery = std::move(info);
+
+				// Remove the command from inflight list
+				removeInflight(protocolInterface, commandEntityInfo.entityID, shard, targetID, inflight, sequenceID);
+			}
+			else
+			{
+				isUnexpectedResponse = true;
+				LOG_CONTROLLER_STATE_MACHINE_DEBUG(targetID, std::string("AECP response with sequenceID ") + std::to_string(sequenceID) + " unexpected (timed out already?)");
 			}
 		}
 	}
+
+	// Notify with the Manager lock taken (the shard lock has been released)
+	auto const lg = std::lock_guard{ *_manager };
+
+	if (isUnsolicitedResponse)
+	{
+		utils::invokeProtectedMethod(&Delegate::onAecpAemUnsolicitedResponse, _delegate, static_cast<AemAecpdu const&>(aecpdu));
+	}
+	else if (aecpQuery)
+	{
+		// Call completion handler
+		utils::invokeProtectedHandler(aecpQuery->resultHandler, &aecpdu, ProtocolInterface::Error::NoError);
+
+		// Statistics
+		utils::invokeProtectedMethod(&Delegate::onAecpResponseTime, _delegate, targetID, std::chrono::duration_cast<std::chrono::milliseconds>(now - aecpQuery->sendTime));
+	}
+	else if (isUnexpectedResponse)
+	{
+		// Statistics
+		utils::invokeProtectedMethod(&Delegate::onAecpUnexpectedResponse, _delegate, targetID);
+	}
 }
 
 void CommandStateMachine::handleAcmpResponse(Acmpdu const& acmpdu) noexcept
 {
-	// Lock
-	auto const lg = std::lock_guard{ *_manager };
-
 	// Only process it if it's targeted to a registered local command entity
 #pragma message("TODO: This only work for CONTROLLER messages, not for LISTENER-TALKER communication. Will probably have to check command type")
 	auto* const protocolInterface = _manager->getProtocolInterfaceDelegate();
 	auto const controllerID = acmpdu.getControllerEntityID();
+	auto acmpQuery = std::optional<AcmpCommandInfo>{};
 
-	if (auto const commandEntityIt = _commandEntities.find(controllerID); commandEntityIt != _commandEntities.end())
 	{
+		// Lock
+		auto const lg = std::shared_lock{ _commandEntitiesLock };
+
+		auto const commandEntityIt = _commandEntities.find(controllerID);
+		if (commandEntityIt == _commandEntities.end())
+		{
+			return;
+		}
+
 		auto& commandEntityInfo = commandEntityIt->second;
 		auto const targetMacAddress = acmpdu.getDestAddress();
+		auto& shard = getShard(commandEntityInfo, targetMacAddress);
+
+		// Lock
+		auto const slg = std::lock_guard{ shard.lock };
 
-		if (auto inflightIt = commandEntityInfo.inflightAcmpCommands.find(targetMacAddress); inflightIt != commandEntityInfo.inflightAcmpCommands.end())
+		auto inflightIt = shard.inflightAcmpCommands.find(targetMacAddress);
+		if (inflightIt == shard.inflightAcmpCommands.end())
 		{
-			auto& inflight = inflightIt->second;
-			auto& inflightCommands = inflight.inflightCommands;
-			auto const sequenceID = acmpdu.getSequenceID();
-			auto commandIt = std::find_if(inflightCommands.begin(), inflightCommands.end(),
-				[sequenceID](AcmpCommandInfo const& command)
-				{
-					return command.sequenceID == sequenceID;
-				});
-			// If the sequenceID is not found, it either means the response already timed out (arriving too late), or it's a communication btw talker and listener (requested by us) and they did not use our sequenceID
-			if (commandIt != inflightCommands.end())
-			{
-				auto& info = *commandIt;
+			return;
+		}
 
-				// Check if it's an expected response (since the communication btw listener and talkers uses our controllerID and might use our sequenceID, we don't want to detect talker's response as ours)
-				auto const messageType = acmpdu.getMessageType().getValue();
-				auto const expectedResponseType = info.command->getMessageType().getValue() + 1; // Based on Clause 8.2.1.5, responses are always Command + 1
-				if (messageType == expectedResponseType)
-				{
-					// Move the query (it will be deleted)
-					AcmpCommandInfo acmpQuery = std::move(info);
+		auto& inflight = inflightIt->second;
+		auto const sequenceID = acmpdu.getSequenceID();
+		auto* const command = inflight.inflightCommands.find(sequenceID);
+		// If the sequenceID is not found, it either means the response already timed out (arriving too late), or it's a communication btw talker and listener (requested by us) and they did not use our sequenceID
+		if (command == nullptr)
+		{
+			return;
+		}
 
-					// Remove the command from inflight list
-					removeInflight(protocolInterface, commandEntityInfo, targetMacAddress, inflight, commandIt);
+		auto& info = *command;
 
-					// Call completion handler
-					utils::invokeProtectedHandler(acmpQuery.resultHandler, &acmpdu, ProtocolInterface::Error::NoError);
-				}
-			}
+		// Check if it's an expected response (since the communication btw listener and talkers uses our controllerID and might use our sequenceID, we don't want to detect talker's response as ours)
+		auto const messageType = acmpdu.getMessageType().getValue();
+		auto const expectedResponseType = info.command->getMessageType().getValue() + 1; // Based on Clause 8.2.1.5, responses are always Command + 1
+		if (messageType != expectedResponseType)
+		{
+			return;
 		}
+
+		// Move the query (it will be deleted)
+		acmpQuery = std::move(info);
+
+		// Remove the command from inflight list
+		removeInflight(protocolInterface, commandEntityInfo.entityID, shard, targetMacAddress, inflight, sequenceID);
 	}
+
+	// Notify with the Manager lock taken (the shard lock has been released)
+	auto const lg = std::lock_guard{ *_manager };
+
+	// Call completion handler
+	utils::invokeProtectedHandler(acmpQuery->resultHandler, &acmpdu, ProtocolInterface::Error::NoError);
 }
 
 ProtocolInterface::Error CommandStateMachine::sendAecpCommand(Aecpdu::UniquePointer&& aecpdu, ProtocolInterface::AecpCommandResultHandler const& onResult) noexcept
@@ -376,8 +315,11 @@ ProtocolInterface::Error CommandStateMachine::sendAecpCommand(Aecpdu::UniquePoin
 	auto* aecp = static_cast<Aecpdu*>(aecpdu.get());
 	auto const targetEntityID = aecp->getTargetEntityID();
 
+	// Get the timeout before locking the shard (might require the Manager lock)
+	auto const timeout = getAecpCommandTimeout(*aecp);
+
 	// Lock
-	auto const lg = std::lock_guard{ *_manager };
+	auto const lg = std::shared_lock{ _commandEntitiesLock };
 
 	// Get CommandEntityInfo matching ControllerEntityID
 	auto const& commandEntityIt = _commandEntities.find(aecp->getControllerEntityID());
@@ -394,15 +336,20 @@ ProtocolInterface::Error CommandStateMachine::sendAecpCommand(Aecpdu::UniquePoin
 	try
 	{
 		// Record the query for when we get a response (so we can send it again if it timed out)
-		AecpCommandInfo command{ sequenceID, std::move(aecpdu), onResult };
+		AecpCommandInfo command{ sequenceID, timeout, std::move(aecpdu), onResult };
 		{
-			auto& inflight = commandEntityInfo.inflightAecpCommands[targetEntityID];
+			auto& shard = getShard(commandEntityInfo, targetEntityID);
+
+			// Lock
+			auto const slg = std::lock_guard{ shard.lock };
+
+			auto& inflight = shard.inflightAecpCommands[targetEntityID];
 
 			// Add the command to the queue (to send directly, in case there is something waiting in the queue)
-			commandEntityInfo.aecpCommandsQueue[targetEntityID].queuedCommands.push_back(std::move(command));
+			shard.aecpCommandsQueue[targetEntityID].queuedCommands.push_back(std::move(command));
 
 			// Check the queue
-			checkQueue(protocolInterface, commandEntityInfo, targetEntityID, inflight, inflight.inflightCommands.end());
+			checkQueue(protocolInterface, commandEntityInfo.entityID, shard, targetEntityID, inflight);
 		}
 	}
 	catch (...)
@@ -418,7 +365,7 @@ ProtocolInterface::Error CommandStateMachine::sendAcmpCommand(Acmpdu::UniquePoin
 	auto const targetMacAddress = acmp->getDestAddress();
 
 	// Lock
-	auto const lg = std::lock_guard{ *_manager };
+	auto const lg = std::shared_lock{ _commandEntitiesLock };
 
 	// Get CommandEntityInfo matching ControllerEntityID
 	auto const& commandEntityIt = _commandEntities.find(acmp->getControllerEntityID());
@@ -437,13 +384,18 @@ ProtocolInterface::Error CommandStateMachine::sendAcmpCommand(Acmpdu::UniquePoin
 		// Record the query for when we get a response (so we can send it again if it timed out)
 		AcmpCommandInfo command{ sequenceID, std::move(acmpdu), onResult };
 		{
-			auto& inflight = commandEntityInfo.inflightAcmpCommands[targetMacAddress];
+			auto& shard = getShard(commandEntityInfo, targetMacAddress);
+
+			// Lock
+			auto const slg = std::lock_guard{ shard.lock };
+
+			auto& inflight = shard.inflightAcmpCommands[targetMacAddress];
 
 			// Add the command to the queue (to send directly, in case there is something waiting in the queue)
-			commandEntityInfo.acmpCommandsQueue[targetMacAddress].queuedCommands.push_back(std::move(command));
+			shard.acmpCommandsQueue[targetMacAddress].queuedCommands.push_back(std::move(command));
 
 			// Check the queue
-			checkQueue(protocolInterface, commandEntityInfo, targetMacAddress, inflight, inflight.inflightCommands.end());
+			checkQueue(protocolInterface, commandEntityInfo.entityID, shard, targetMacAddress, inflight);
 		}
 	}
 	catch (...)
@@ -453,6 +405,14 @@ ProtocolInterface::Error CommandStateMachine::sendAcmpCommand(Acmpdu::UniquePoin
 	return ProtocolInterface::Error::NoError;
 }
 
+std::chrono::steady_clock::time_point CommandStateMachine::getNextDeadline() const noexcept
+{
+	// Lock
+	auto const lg = std::lock_guard{ _deadlinesLock };
+
+	return _deadlines.getNextDeadline();
+}
+
 /* ************************************************************ */
 /* Private methods                                              */
 /* ************************************************************ */
@@ -487,15 +447,15 @@ bool CommandStateMachine::shouldRearmTimer(Aecpdu const& aecpdu) const noexcept
 	return false;
 }
 
-void CommandStateMachine::resetAecpCommandTimeoutValue(AecpCommandInfo& command) const noexcept
+std::chrono::milliseconds CommandStateMachine::getAecpCommandTimeout(Aecpdu const& aecpdu) const noexcept
 {
-	auto const messageType = command.command->getMessageType();
+	auto const messageType = aecpdu.getMessageType();
 	auto timeout = std::uint32_t{ 250u };
 
 	// Handle special case first, VendorUniqueCommand
 	if (messageType == AecpMessageType::VendorUniqueCommand)
 	{
-		auto const& vuAecp = static_cast<VuAecpdu const&>(*command.command);
+		auto const& vuAecp = static_cast<VuAecpdu const&>(aecpdu);
 		auto const vuProtocolID = vuAecp.getProtocolIdentifier();
 		auto* const protocolInterface = _manager->getProtocolInterfaceDelegate();
 
@@ -515,8 +475,13 @@ void CommandStateMachine::resetAecpCommandTimeoutValue(AecpCommandInfo& command)
 		}
 	}
 
+	return std::chrono::milliseconds(timeout);
+}
+
+void CommandStateMachine::resetAecpCommandTimeoutValue(AecpCommandInfo& command) const noexcept
+{
 	command.sendTime = std::chrono::steady_clock::now();
-	command.timeoutTime = command.sendTime + std::chrono::milliseconds(timeout);
+	command.timeoutTime = command.sendTime + command.timeout;
 }
 
 void CommandStateMachine::resetAcmpCommandTimeoutValue(AcmpCommandInfo& command) const noexcept
@@ -542,23 +507,311 @@ void CommandStateMachine::resetAcmpCommandTimeoutValue(AcmpCommandInfo& command)
 	command.timeoutTime = command.sendTime + std::chrono::milliseconds(timeout);
 }
 
+void CommandStateMachine::scheduleAecpCommandTimeout(UniqueIdentifier const& localEntityID, UniqueIdentifier const& targetEntityID, AecpCommandInfo const& command) noexcept
+{
+	scheduleDeadline(command.timeoutTime, CommandDeadline{ localEntityID, CommandDeadlineType::AecpTimeout, targetEntityID, {}, command.sequenceID });
+}
+
+void CommandStateMachine::scheduleAcmpCommandTimeout(UniqueIdentifier const& localEntityID, networkInterface::MacAddress const& targetMacAddress, AcmpCommandInfo const& command) noexcept
+{
+	scheduleDeadline(command.timeoutTime, CommandDeadline{ localEntityID, CommandDeadlineType::AcmpTimeout, UniqueIdentifier{}, targetMacAddress, command.sequenceID });
+}
+
+void CommandStateMachine::scheduleDeadline(std::chrono::steady_clock::time_point const deadline, CommandDeadline const& key) noexcept
+{
+	{
+		// Lock
+		auto const lg = std::lock_guard{ _deadlinesLock };
+		_deadlines.schedule(deadline, key);
+	}
+	_manager->scheduleWakeUp(deadline);
+}
+
+void CommandStateMachine::processDeadline(ProtocolInterfaceDelegate* const protocolInterface, CommandDeadlines::Entry const& deadline) noexcept
+{
+	auto const& key = deadline.key;
+	auto notifications = PendingNotifications{};
+
+	{
+		// Lock
+		auto const lg = std::shared_lock{ _commandEntitiesLock };
+
+		// Local entity might have been unregistered since the deadline was scheduled
+		auto const localEntityInfoIt = _commandEntities.find(key.localEntityID);
+		if (localEntityInfoIt == _commandEntities.end())
+		{
+			return;
+		}
+		auto& localEntityInfo = localEntityInfoIt->second;
+
+		switch (key.type)
+		{
+			case CommandDeadlineType::AecpTimeout:
+			case CommandDeadlineType::AecpQueue:
+			{
+				auto& shard = getShard(localEntityInfo, key.targetEntityID);
+
+				// Lock
+				auto const slg = std::lock_guard{ shard.lock };
+
+				if (auto inflightIt = shard.inflightAecpCommands.find(key.targetEntityID); inflightIt != shard.inflightAecpCommands.end())
+				{
+					auto& inflight = inflightIt->second;
+
+					// Check inflight timeout
+					if (key.type == CommandDeadlineType::AecpTimeout)
+					{
+						checkAecpCommandTimeout(protocolInterface, key.localEntityID, shard, key.targetEntityID, inflight, key.sequenceID, deadline.deadline, notifications);
+					}
+
+					// Check if we need to empty the queue
+					checkQueue(protocolInterface, key.localEntityID, shard, key.targetEntityID, inflight);
+				}
+
+				// Notify scheduled errors
+				collectScheduledErrors(shard, notifications);
+				break;
+			}
+			case CommandDeadlineType::AcmpTimeout:
+			case CommandDeadlineType::AcmpQueue:
+			{
+				auto& shard = getShard(localEntityInfo, key.targetMacAddress);
+
+				// Lock
+				auto const slg = std::lock_guard{ shard.lock };
+
+				if (auto inflightIt = shard.inflightAcmpCommands.find(key.targetMacAddress); inflightIt != shard.inflightAcmpCommands.end())
+				{
+					auto& inflight = inflightIt->second;
+
+					// Check inflight timeout
+					if (key.type == CommandDeadlineType::AcmpTimeout)
+					{
+						checkAcmpCommandTimeout(protocolInterface, key.localEntityID, shard, key.targetMacAddress, inflight, key.sequenceID, deadline.deadline, notifications);
+					}
+
+					// Check if we need to empty the queue
+					checkQueue(protocolInterface, key.localEntityID, shard, key.targetMacAddress, inflight);
+				}
+
+				// Notify scheduled errors
+				collectScheduledErrors(shard, notifications);
+				break;
+			}
+			default:
+				AVDECC_ASSERT(false, "Unhandled CommandDeadlineType");
+				break;
+		}
+	}
+
+	notify(notifications);
+}
+
+void CommandStateMachine::checkAecpCommandTimeout(ProtocolInterfaceDelegate* const protocolInterface, UniqueIdentifier const& localEntityID, CommandShard& shard, UniqueIdentifier const& targetEntityID, InflightAecpInfo& inflight, std::uint16_t const sequenceID, std::chrono::steady_clock::time_point const deadline, PendingNotifications& notifications) noexcept
+{
+	auto* const inflightCommand = inflight.inflightCommands.find(sequenceID);
+
+	// Command already completed, or its timeout has been re-armed since this deadline was scheduled
+	if (inflightCommand == nullptr || inflightCommand->timeoutTime != deadline)
+	{
+		return;
+	}
+
+	auto& command = *inflightCommand;
+	auto error = ProtocolInterface::Error::NoError;
+
+	// The target is not keeping up (or frames are lost), close the inflight window
+	shrinkAecpInflightWindow(inflight, command);
+
+	// Timeout expired, check if we retried yet
+	if (!command.retried)
+	{
+		// Let's retry
+		command.retried = true;
+
+		// Update last send time
+		inflight.lastSendTime = std::chrono::steady_clock::now();
+
+		// Ask the transport layer to send the packet
+		error = protocolInterface->sendMessage(static_cast<Aecpdu const&>(*command.command));
+
+		// Reset command timeout
+		resetAecpCommandTimeoutValue(command);
+		scheduleAecpCommandTimeout(localEntityID, targetEntityID, command);
+
+		// Statistics
+		notifications.push_back(
+			[this, targetEntityID]()
+			{
+				utils::invokeProtectedMethod(&Delegate::onAecpRetry, _delegate, targetEntityID);
+			});
+		LOG_CONTROLLER_STATE_MACHINE_DEBUG(targetEntityID, std::string("AECP command with sequenceID ") + std::to_string(command.sequenceID) + " timed out, trying again");
+	}
+	else
+	{
+		error = ProtocolInterface::Error::Timeout;
+		// Statistics
+		notifications.push_back(
+			[this, targetEntityID]()
+			{
+				utils::invokeProtectedMethod(&Delegate::onAecpTimeout, _delegate, targetEntityID);
+			});
+		LOG_CONTROLLER_STATE_MACHINE_DEBUG(targetEntityID, std::string("AECP command with sequenceID ") + std::to_string(command.sequenceID) + " timed out 2 times");
+	}
+
+	if (!!error)
+	{
+		// Already retried, the command has been lost
+		notifications.push_back(
+			[resultHandler = std::move(command.resultHandler), error]()
+			{
+				utils::invokeProtectedHandler(resultHandler, nullptr, error);
+			});
+		removeInflight(protocolInterface, localEntityID, shard, targetEntityID, inflight, sequenceID);
+	}
+}
+
+void CommandStateMachine::checkAcmpCommandTimeout(ProtocolInterfaceDelegate* const protocolInterface, UniqueIdentifier const& localEntityID, CommandShard& shard, networkInterface::MacAddress const& targetMacAddress, InflightAcmpInfo& inflight, std::uint16_t const sequenceID, std::chrono::steady_clock::time_point const deadline, PendingNotifications& notifications) noexcept
+{
+	auto* const inflightCommand = inflight.inflightCommands.find(sequenceID);
+
+	// Command already completed since this deadline was scheduled
+	if (inflightCommand == nullptr || inflightCommand->timeoutTime != deadline)
+	{
+		return;
+	}
+
+	auto& command = *inflightCommand;
+	auto error = ProtocolInterface::Error::NoError;
+	// Timeout expired, check if we retried yet
+	if (!command.retried)
+	{
+		// Let's retry
+		command.retried = true;
+
+		// Update last send time
+		inflight.lastSendTime = std::chrono::steady_clock::now();
+
+		// Ask the transport layer to send the packet
+		error = protocolInterface->sendMessage(static_cast<Acmpdu const&>(*command.command));
+
+		// Reset command timeout
+		resetAcmpCommandTimeoutValue(command);
+		scheduleAcmpCommandTimeout(localEntityID, targetMacAddress, command);
+	}
+	else
+	{
+		error = ProtocolInterface::Error::Timeout;
+	}
+
+	if (!!error)
+	{
+		// Already retried, the command has been lost
+		notifications.push_back(
+			[resultHandler = std::move(command.resultHandler), error]()
+			{
+				utils::invokeProtectedHandler(resultHandler, nullptr, error);
+			});
+		removeInflight(protocolInterface, localEntityID, shard, targetMacAddress, inflight, sequenceID);
+	}
+}
+
+void CommandStateMachine::collectScheduledErrors(CommandShard& shard, PendingNotifications& notifications) noexcept
+{
+	for (auto& e : shard.scheduledAecpErrors)
+	{
+		notifications.push_back(
+			[resultHandler = std::move(e.second), error = e.first]()
+			{
+				utils::invokeProtectedHandler(resultHandler, nullptr, error);
+			});
+	}
+	shard.scheduledAecpErrors.clear();
+
+	for (auto& e : shard.scheduledAcmpErrors)
+	{
+		notifications.push_back(
+			[resultHandler = std::move(e.second), error = e.first]()
+			{
+				utils::invokeProtectedHandler(resultHandler, nullptr, error);
+			});
+	}
+	shard.scheduledAcmpErrors.clear();
+}
+
+void CommandStateMachine::notify(PendingNotifications const& notifications) noexcept
+{
+	if (notifications.empty())
+	{
+		return;
+	}
+
+	// Lock
+	auto const lg = std::lock_guard{ *_manager };
+
+	for (auto const& notification : notifications)
+	{
+		notification();
+	}
+}
+
+CommandStateMachine::CommandShard& CommandStateMachine::getShard(CommandEntityInfo& info, UniqueIdentifier const& targetEntityID) noexcept
+{
+	return info.shards[UniqueIdentifier::hash{}(targetEntityID) % ShardsCount];
+}
+
+CommandStateMachine::CommandShard& CommandStateMachine::getShard(CommandEntityInfo& info, networkInterface::MacAddress const& targetMacAddress) noexcept
+{
+	return info.shards[networkInterface::MacAddressHash{}(targetMacAddress) % ShardsCount];
+}
+
 AecpSequenceID CommandStateMachine::getNextAecpSequenceID(CommandEntityInfo& info) noexcept
 {
-	auto const nextID = info.currentAecpSequenceID;
-	++info.currentAecpSequenceID;
-	return nextID;
+	return info.currentAecpSequenceID++;
 }
 
 AcmpSequenceID CommandStateMachine::getNextAcmpSequenceID(CommandEntityInfo& info) noexcept
 {
-	auto const nextID = info.currentAcmpSequenceID;
-	++info.currentAcmpSequenceID;
-	return nextID;
+	return info.currentAcmpSequenceID++;
+}
+
+void CommandStateMachine::growAecpInflightWindow(ProtocolInterfaceDelegate* const protocolInterface, InflightAecpInfo& inflight) const noexcept
+{
+	auto const ceiling = protocolInterface->getMaxAecpInflightCommandsCeiling();
+
+	// Slow start: one more command per timely response (doubling the window every round trip)
+	if (inflight.inflightWindow < inflight.slowStartThreshold)
+	{
+		++inflight.inflightWindow;
+	}
+	// Congestion avoidance: one more command per window of timely responses
+	else if (++inflight.windowGrowthCredits >= inflight.inflightWindow)
+	{
+		inflight.windowGrowthCredits = 0u;
+		++inflight.inflightWindow;
+	}
+
+	inflight.inflightWindow = std::min(inflight.inflightWindow, ceiling);
+}
+
+void CommandStateMachine::shrinkAecpInflightWindow(InflightAecpInfo& inflight, AecpCommandInfo const& command) const noexcept
+{
+	// Commands sent before the last reduction belong to the same loss event, only shrink once for all of them
+	if (command.sendTime < inflight.lastWindowReductionTime)
+	{
+		return;
+	}
+
+	inflight.slowStartThreshold = std::max(inflight.inflightWindow / 2u, 1u);
+	inflight.inflightWindow = inflight.slowStartThreshold;
+	inflight.windowGrowthCredits = 0u;
+	inflight.lastWindowReductionTime = std::chrono::steady_clock::now();
 }
 
-size_t CommandStateMachine::getMaxInflightAecpMessages(UniqueIdentifier const& /*entityID*/) const noexcept
+size_t CommandStateMachine::getMaxInflightAecpMessages(ProtocolInterfaceDelegate* const protocolInterface, InflightAecpInfo const& inflight) const noexcept
 {
-	return DefaultMaxAecpInflightCommands;
+	// The ceiling may have been lowered since the window last grew
+	return std::min(inflight.inflightWindow, protocolInterface->getMaxAecpInflightCommandsCeiling());
 }
 
 std::chrono::milliseconds CommandStateMachine::getAecpSendInterval(UniqueIdentifier const& /*entityID*/) const noexcept
@@ -27,9 +27,18 @@
 #include "la/avdecc/internals/entity.hpp"
 
 #include "protocolInterfaceDelegate.hpp"
+#include "deadlineQueue.hpp"
+#include "commandQueue.hpp"
 
 #include <chrono>
 #include <unordered_map>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
 
 namespace la
 {
@@ -41,7 +50,19 @@ namespace stateMachine
 {
 class Manager;
 
-/** State Machine for entities that need to send AECP and ACMP Commands */
+/**
+* @brief State Machine for entities that need to send AECP and ACMP Commands.
+* @details The state of each local entity is partitioned in shards (by target entity for AECP, by target MacAddress for ACMP), each with its own lock,
+*          so that commands and responses for different targets do not serialize on the Manager lock.
+*          Lock hierarchy (always taken in this order, never the other way around):
+*           - Manager lock (only taken to notify delegates and result handlers, which expect it)
+*           - _commandEntitiesLock (shared, exclusive only to register/unregister a local entity)
+*           - CommandShard::lock
+*           - _deadlinesLock, then Manager wake up lock
+*          The number of AECP commands inflight for a target adapts like a TCP congestion window: it starts at ProtocolInterface::DefaultMaxAecpInflightCommands, doubles for each window
+*          of timely responses (slow start), then grows by one (congestion avoidance), and is halved when a command times out.
+*          It never exceeds the ceiling configured on the ProtocolInterface (see ProtocolInterface::setMaxAecpInflightCommands).
+*/
 class CommandStateMachine final
 {
 public:
@@ -69,12 +90,15 @@ public:
 	void handleAcmpResponse(Acmpdu const& acmpdu) noexcept;
 	ProtocolInterface::Error sendAecpCommand(Aecpdu::UniquePointer&& aecpdu, ProtocolInterface::AecpCommandResultHandler const& onResult) noexcept;
 	ProtocolInterface::Error sendAcmpCommand(Acmpdu::UniquePointer&& acmpdu, ProtocolInterface::AcmpCommandResultHandler const& onResult) noexcept;
+	/** Returns the time at which checkInflightCommandsTimeoutExpiracy should be called next */
+	std::chrono::steady_clock::time_point getNextDeadline() const noexcept;
 
 private:
 	// Private types
 	struct AecpCommandInfo
 	{
 		AecpSequenceID sequenceID{ 0 };
+		std::chrono::milliseconds timeout{ 250u }; // Computed once when the command is queued (VendorUnique timeout can only be retrieved with the Manager lock)
 		std::chrono::time_point<std::chrono::steady_clock> sendTime{};
 		std::chrono::time_point<std::chrono::steady_clock> timeoutTime{};
 		bool retried{ false };
@@ -82,8 +106,9 @@ private:
 		ProtocolInterface::AecpCommandResultHandler resultHandler{};
 
 		AecpCommandInfo() {}
-		AecpCommandInfo(AecpSequenceID const sequenceID, Aecpdu::UniquePointer&& command, ProtocolInterface::AecpCommandResultHandler const& resultHandler)
+		AecpCommandInfo(AecpSequenceID const sequenceID, std::chrono::milliseconds const timeout, Aecpdu::UniquePointer&& command, ProtocolInterface::AecpCommandResultHandler const& resultHandler)
 			: sequenceID(sequenceID)
+			, timeout(timeout)
 			, command(std::move(command))
 			, resultHandler(resultHandler)
 		{
@@ -92,11 +117,15 @@ private:
 	struct InflightAecpInfo
 	{
 		std::chrono::time_point<std::chrono::steady_clock> lastSendTime{};
-		std::list<AecpCommandInfo> inflightCommands{};
+		CommandQueue<AecpCommandInfo> inflightCommands{};
+		std::uint32_t inflightWindow{ ProtocolInterface::DefaultMaxAecpInflightCommands }; // Number of commands currently allowed inflight for this target (grows on timely responses, shrinks on timeouts)
+		std::uint32_t slowStartThreshold{ std::numeric_limits<std::uint32_t>::max() }; // Window size above which it only grows by one for each window of timely responses
+		std::uint32_t windowGrowthCredits{ 0u }; // Timely responses received since the window last grew (when above slowStartThreshold)
+		std::chrono::time_point<std::chrono::steady_clock> lastWindowReductionTime{}; // Commands sent before this time won't shrink the window again
 	};
 	struct QueuedAecpInfo
 	{
-		std::list<AecpCommandInfo> queuedCommands{};
+		CommandQueue<AecpCommandInfo> queuedCommands{};
 	};
 	using InflightAecpCommands = std::unordered_map<UniqueIdentifier, InflightAecpInfo, UniqueIdentifier::hash>;
 	using AecpCommandsQueue = std::unordered_map<UniqueIdentifier, QueuedAecpInfo, UniqueIdentifier::hash>;
@@ -121,52 +150,85 @@ private:
 	struct InflightAcmpInfo
 	{
 		std::chrono::time_point<std::chrono::steady_clock> lastSendTime{};
-		std::list<AcmpCommandInfo> inflightCommands{};
+		CommandQueue<AcmpCommandInfo> inflightCommands{};
 	};
 	struct QueuedAcmpInfo
 	{
-		std::list<AcmpCommandInfo> queuedCommands{};
+		CommandQueue<AcmpCommandInfo> queuedCommands{};
 	};
 	using InflightAcmpCommands = std::unordered_map<networkInterface::MacAddress, InflightAcmpInfo, networkInterface::MacAddressHash>;
 	using AcmpCommandsQueue = std::unordered_map<networkInterface::MacAddress, QueuedAcmpInfo, networkInterface::MacAddressHash>;
 
-	using ScheduledAecpErrors = std::list<std::pair<ProtocolInterface::Error, ProtocolInterface::AecpCommandResultHandler>>;
-	using ScheduledAcmpErrors = std::list<std::pair<ProtocolInterface::Error, ProtocolInterface::AcmpCommandResultHandler>>;
+	using ScheduledAecpErrors = std::vector<std::pair<ProtocolInterface::Error, ProtocolInterface::AecpCommandResultHandler>>;
+	using ScheduledAcmpErrors = std::vector<std::pair<ProtocolInterface::Error, ProtocolInterface::AcmpCommandResultHandler>>;
 
-	struct CommandEntityInfo
+	static constexpr auto ShardsCount = size_t{ 16u }; // Number of partitions of the commands of a local entity
+
+	struct CommandShard
 	{
-		entity::LocalEntity& entity;
+		std::mutex lock{}; // Lock protecting this shard
 
 		// AECP variables
-		AecpSequenceID currentAecpSequenceID{ 0 };
 		InflightAecpCommands inflightAecpCommands{};
 		AecpCommandsQueue aecpCommandsQueue{};
 
 		// ACMP variables
-		AcmpSequenceID currentAcmpSequenceID{ 0 };
 		InflightAcmpCommands inflightAcmpCommands{};
 		AcmpCommandsQueue acmpCommandsQueue{};
 
 		// Other variables
 		ScheduledAecpErrors scheduledAecpErrors{};
 		ScheduledAcmpErrors scheduledAcmpErrors{};
+	};
+
+	struct CommandEntityInfo
+	{
+		entity::LocalEntity& entity;
+		UniqueIdentifier const entityID{};
+
+		// Sequence IDs
+		std::atomic<AecpSequenceID> currentAecpSequenceID{ 0 };
+		std::atomic<AcmpSequenceID> currentAcmpSequenceID{ 0 };
+
+		// Commands, partitioned by target
+		std::array<CommandShard, ShardsCount> shards{};
 
 		/** Constructor */
 		CommandEntityInfo(entity::LocalEntity& entity) noexcept
 			: entity(entity)
+			, entityID(entity.getEntityID())
 		{
 		}
 	};
 	using CommandEntities = std::unordered_map<UniqueIdentifier, CommandEntityInfo, UniqueIdentifier::hash>;
 
+	enum class CommandDeadlineType
+	{
+		AecpTimeout = 0, /**< Timeout of an inflight AECP command */
+		AecpQueue = 1, /**< AECP queue can be checked again (send interval elapsed), also notifies scheduled errors */
+		AcmpTimeout = 2, /**< Timeout of an inflight ACMP command */
+		AcmpQueue = 3, /**< ACMP queue can be checked again (send interval elapsed), also notifies scheduled errors */
+	};
+	struct CommandDeadline
+	{
+		UniqueIdentifier localEntityID{};
+		CommandDeadlineType type{ CommandDeadlineType::AecpTimeout };
+		UniqueIdentifier targetEntityID{}; // Only for AECP types
+		networkInterface::MacAddress targetMacAddress{}; // Only for ACMP types
+		std::uint16_t sequenceID{ 0u }; // Only for Timeout types
+	};
+	using CommandDeadlines = DeadlineQueue<CommandDeadline>;
+
+	/** Delegate and result handler notifications, collected while a shard is locked and called once it has been released (with the Manager lock) */
+	using PendingNotifications = std::vector<std::function<void()>>;
+
 	// Private methods
 	template<class TimeInterval>
 	constexpr bool hasExpired(std::chrono::time_point<std::chrono::steady_clock> const& currentTime, std::chrono::time_point<std::chrono::steady_clock> const& lastInterval, TimeInterval const& delay)
 	{
 		return (lastInterval + delay) < currentTime;
 	}
-	template<typename T>
-	T setCommandInflight(ProtocolInterfaceDelegate* const protocolInterface, CommandEntityInfo& info, InflightAecpInfo& inflight, T const it, AecpCommandInfo&& command)
+	void setCommandInflight(ProtocolInterfaceDelegate* const protocolInterface, UniqueIdentifier const& localEntityID, CommandShard& shard, UniqueIdentifier const& entityID, InflightAecpInfo& inflight, AecpCommandInfo&& command)
 	{
 		// Update last send time
 		inflight.lastSendTime = std::chrono::steady_clock::now();
@@ -175,51 +237,52 @@ private:
 		auto const error = protocolInterface->sendMessage(static_cast<Aecpdu const&>(*command.command));
 		if (!!error)
 		{
-			// Schedule the result handler to be called with the returned error from the delegate
-			info.scheduledAecpErrors.push_back(std::make_pair(error, command.resultHandler));
-			return it;
+			// Schedule the result handler to be called with the returned error from the delegate, and the next queued command to be sent
+			shard.scheduledAecpErrors.push_back(std::make_pair(error, command.resultHandler));
+			scheduleDeadline(inflight.lastSendTime, CommandDeadline{ localEntityID, CommandDeadlineType::AecpQueue, entityID });
+			return;
 		}
 		else
 		{
 			// Move the command to inflight queue
 			resetAecpCommandTimeoutValue(command);
-			return inflight.inflightCommands.insert(it, std::move(command));
+			scheduleAecpCommandTimeout(localEntityID, entityID, command);
+			inflight.inflightCommands.push_back(std::move(command));
 		}
 	}
-	template<typename T>
-	T checkQueue(ProtocolInterfaceDelegate* const protocolInterface, CommandEntityInfo& info, UniqueIdentifier const& entityID, InflightAecpInfo& inflight, T const it)
+	void checkQueue(ProtocolInterfaceDelegate* const protocolInterface, UniqueIdentifier const& localEntityID, CommandShard& shard, UniqueIdentifier const& entityID, InflightAecpInfo& inflight)
 	{
 		// Get current time
 		auto const now = std::chrono::steady_clock::now();
 
-		// Check if we don't have too many inflight commands or sending too fast for this destination macAddress
-		if (inflight.inflightCommands.size() >= getMaxInflightAecpMessages(entityID) || !hasExpired(now, inflight.lastSendTime, getAecpSendInterval(entityID)))
-		{
-			return it;
-		}
+		auto& queue = shard.aecpCommandsQueue[entityID].queuedCommands;
+		auto const sendInterval = getAecpSendInterval(entityID);
 
-		// Check if queue is not empty for this entity
-		auto& queue = info.aecpCommandsQueue[entityID].queuedCommands;
-		if (queue.empty())
+		// Fill the inflight window (it may have grown by more than one command since the queue was last checked)
+		// Stop if we have too many inflight commands for this destination (the queue will be checked again when an inflight command is removed), or if the queue is empty for this entity
+		while (inflight.inflightCommands.size() < getMaxInflightAecpMessages(protocolInterface, inflight) && !queue.empty())
 		{
-			return it;
+			// Check if we are not sending too fast for this destination, otherwise check the queue again as soon as the send interval elapsed
+			if (!hasExpired(now, inflight.lastSendTime, sendInterval))
+			{
+				scheduleDeadline(inflight.lastSendTime + sendInterval + std::chrono::steady_clock::duration{ 1 }, CommandDeadline{ localEntityID, CommandDeadlineType::AecpQueue, entityID });
+				return;
+			}
+
+			// Remove command from queue
+			auto command = std::move(queue.front());
+			queue.pop_front();
+
+			setCommandInflight(protocolInterface, localEntityID, shard, entityID, inflight, std::move(command));
 		}
-
-		// Remove command from queue
-		auto command = std::move(queue.front());
-		queue.pop_front();
-
-		return setCommandInflight(protocolInterface, info, inflight, it, std::move(command));
 	}
-	template<typename T>
-	T removeInflight(ProtocolInterfaceDelegate* const protocolInterface, CommandEntityInfo& info, UniqueIdentifier const& entityID, InflightAecpInfo& inflight, T const it)
+	void removeInflight(ProtocolInterfaceDelegate* const protocolInterface, UniqueIdentifier const& localEntityID, CommandShard& shard, UniqueIdentifier const& entityID, InflightAecpInfo& inflight, AecpSequenceID const sequenceID)
 	{
-		auto retIt = inflight.inflightCommands.erase(it);
-		return checkQueue(protocolInterface, info, entityID, inflight, retIt);
+		inflight.inflightCommands.erase(sequenceID);
+		checkQueue(protocolInterface, localEntityID, shard, entityID, inflight);
 	}
 
-	template<typename T>
-	T setCommandInflight(ProtocolInterfaceDelegate* const protocolInterface, CommandEntityInfo& info, InflightAcmpInfo& inflight, T const it, AcmpCommandInfo&& command)
+	void setCommandInflight(ProtocolInterfaceDelegate* const protocolInterface, UniqueIdentifier const& localEntityID, CommandShard& shard, networkInterface::MacAddress const& targetMacAddress, InflightAcmpInfo& inflight, AcmpCommandInfo&& command)
 	{
 		// Update last send time
 		inflight.lastSendTime = std::chrono::steady_clock::now();
@@ -228,56 +291,77 @@ private:
 		auto const error = protocolInterface->sendMessage(static_cast<Acmpdu const&>(*command.command));
 		if (!!error)
 		{
-			// Schedule the result handler to be called with the returned error from the delegate
-			info.scheduledAcmpErrors.push_back(std::make_pair(error, command.resultHandler));
-			return it;
+			// Schedule the result handler to be called with the returned error from the delegate, and the next queued command to be sent
+			shard.scheduledAcmpErrors.push_back(std::make_pair(error, command.resultHandler));
+			scheduleDeadline(inflight.lastSendTime, CommandDeadline{ localEntityID, CommandDeadlineType::AcmpQueue, UniqueIdentifier{}, targetMacAddress });
+			return;
 		}
 		else
 		{
 			// Move the command to inflight queue
 			resetAcmpCommandTimeoutValue(command);
-			return inflight.inflightCommands.insert(it, std::move(command));
+			scheduleAcmpCommandTimeout(localEntityID, targetMacAddress, command);
+			inflight.inflightCommands.push_back(std::move(command));
 		}
 	}
-	template<typename T>
-	T checkQueue(ProtocolInterfaceDelegate* const protocolInterface, CommandEntityInfo& info, networkInterface::MacAddress const& targetMacAddress, InflightAcmpInfo& inflight, T const it)
+	void checkQueue(ProtocolInterfaceDelegate* const protocolInterface, UniqueIdentifier const& localEntityID, CommandShard& shard, networkInterface::MacAddress const& targetMacAddress, InflightAcmpInfo& inflight)
 	{
 		// Get current time
 		auto const now = std::chrono::steady_clock::now();
 
-		// Check if we don't have too many inflight commands or sending too fast for this destination macAddress
-		if (inflight.inflightCommands.size() >= getMaxInflightAcmpMessages(targetMacAddress) || !hasExpired(now, inflight.lastSendTime, getAcmpSendInterval(targetMacAddress)))
+		// Check if we don't have too many inflight commands for this destination macAddress (the queue will be checked again when an inflight command is removed)
+		if (inflight.inflightCommands.size() >= getMaxInflightAcmpMessages(targetMacAddress))
 		{
-			return it;
+			return;
 		}
 
 		// Check if queue is not empty for this entity
-		auto& queue = info.acmpCommandsQueue[targetMacAddress].queuedCommands;
+		auto& queue = shard.acmpCommandsQueue[targetMacAddress].queuedCommands;
 		if (queue.empty())
 		{
-			return it;
+			return;
+		}
+
+		// Check if we are not sending too fast for this destination macAddress, otherwise check the queue again as soon as the send interval elapsed
+		auto const sendInterval = getAcmpSendInterval(targetMacAddress);
+		if (!hasExpired(now, inflight.lastSendTime, sendInterval))
+		{
+			scheduleDeadline(inflight.lastSendTime + sendInterval + std::chrono::steady_clock::duration{ 1 }, CommandDeadline{ localEntityID, CommandDeadlineType::AcmpQueue, UniqueIdentifier{}, targetMacAddress });
+			return;
 		}
 
 		// Remove command from queue
 		auto command = std::move(queue.front());
 		queue.pop_front();
 
-		return setCommandInflight(protocolInterface, info, inflight, it, std::move(command));
+		setCommandInflight(protocolInterface, localEntityID, shard, targetMacAddress, inflight, std::move(command));
 	}
-	template<typename T>
-	T removeInflight(ProtocolInterfaceDelegate* const protocolInterface, CommandEntityInfo& info, networkInterface::MacAddress const& macAddress, InflightAcmpInfo& inflight, T const it)
+	void removeInflight(ProtocolInterfaceDelegate* const protocolInterface, UniqueIdentifier const& localEntityID, CommandShard& shard, networkInterface::MacAddress const& macAddress, InflightAcmpInfo& inflight, AcmpSequenceID const sequenceID)
 	{
-		auto retIt = inflight.inflightCommands.erase(it);
-		return checkQueue(protocolInterface, info, macAddress, inflight, retIt);
+		inflight.inflightCommands.erase(sequenceID);
+		checkQueue(protocolInterface, localEntityID, shard, macAddress, inflight);
 	}
 
 	bool isAEMUnsolicitedResponse(Aecpdu const& aecpdu) const noexcept;
 	bool shouldRearmTimer(Aecpdu const& aecpdu) const noexcept;
+	std::chrono::milliseconds getAecpCommandTimeout(Aecpdu const& aecpdu) const noexcept;
 	void resetAecpCommandTimeoutValue(AecpCommandInfo& command) const noexcept;
 	void resetAcmpCommandTimeoutValue(AcmpCommandInfo& command) const noexcept;
+	void scheduleAecpCommandTimeout(UniqueIdentifier const& localEntityID, UniqueIdentifier const& targetEntityID, AecpCommandInfo const& command) noexcept;
+	void scheduleAcmpCommandTimeout(UniqueIdentifier const& localEntityID, networkInterface::MacAddress const& targetMacAddress, AcmpCommandInfo const& command) noexcept;
+	void scheduleDeadline(std::chrono::steady_clock::time_point const deadline, CommandDeadline const& key) noexcept;
+	void processDeadline(ProtocolInterfaceDelegate* const protocolInterface, CommandDeadlines::Entry const& deadline) noexcept;
+	void checkAecpCommandTimeout(ProtocolInterfaceDelegate* const protocolInterface, UniqueIdentifier const& localEntityID, CommandShard& shard, UniqueIdentifier const& targetEntityID, InflightAecpInfo& inflight, std::uint16_t const sequenceID, std::chrono::steady_clock::time_point const deadline, PendingNotifications& notifications) noexcept;
+	void checkAcmpCommandTimeout(ProtocolInterfaceDelegate* const protocolInterface, UniqueIdentifier const& localEntityID, CommandShard& shard, networkInterface::MacAddress const& targetMacAddress, InflightAcmpInfo& inflight, std::uint16_t const sequenceID, std::chrono::steady_clock::time_point const deadline, PendingNotifications& notifications) noexcept;
+	void collectScheduledErrors(CommandShard& shard, PendingNotifications& notifications) noexcept;
+	void notify(PendingNotifications const& notifications) noexcept;
+	CommandShard& getShard(CommandEntityInfo& info, UniqueIdentifier const& targetEntityID) noexcept;
+	CommandShard& getShard(CommandEntityInfo& info, networkInterface::MacAddress const& targetMacAddress) noexcept;
 	AecpSequenceID getNextAecpSequenceID(CommandEntityInfo& info) noexcept;
 	AcmpSequenceID getNextAcmpSequenceID(CommandEntityInfo& info) noexcept;
-	size_t getMaxInflightAecpMessages(UniqueIdentifier const& entityID) const noexcept;
+	void growAecpInflightWindow(ProtocolInterfaceDelegate* const protocolInterface, InflightAecpInfo& inflight) const noexcept;
+	void shrinkAecpInflightWindow(InflightAecpInfo& inflight, AecpCommandInfo const& command) const noexcept;
+	size_t getMaxInflightAecpMessages(ProtocolInterfaceDelegate* const protocolInterface, InflightAecpInfo const& inflight) const noexcept;
 	std::chrono::milliseconds getAecpSendInterval(UniqueIdentifier const& entityID) const noexcept;
 	size_t getMaxInflightAcmpMessages(networkInterface::MacAddress const& macAddress) const noexcept;
 	std::chrono::milliseconds getAcmpSendInterval(networkInterface::MacAddress const& macAddress) const noexcept;
@@ -285,7 +369,10 @@ private:
 	// Private members
 	Manager* _manager{ nullptr };
 	Delegate* _delegate{ nullptr };
+	mutable std::shared_mutex _commandEntitiesLock{}; // Lock protecting _commandEntities (not its content, which is protected by the shards locks)
 	CommandEntities _commandEntities{};
+	mutable std::mutex _deadlinesLock{}; // Lock protecting _deadlines
+	CommandDeadlines _deadlines{}; // Deadlines of inflight commands timeouts and queues checks, for all local entities
 };
 
 } // namespace stateMachine
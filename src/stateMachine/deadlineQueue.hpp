@@ -0,0 +1,122 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @file deadlineQueue.hpp
+* @author Christophe Calmejane
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <vector>
+
+namespace la
+{
+namespace avdecc
+{
+namespace protocol
+{
+namespace stateMachine
+{
+/**
+* @brief Min-heap of deadlines, each associated with a key.
+* @details Entries are never removed nor updated in place. When the deadline associated with a key changes, a new entry is scheduled and the previous one
+*          becomes stale. It is the responsability of the owner to ignore stale entries (by comparing the popped deadline with the current one for that key).
+*          Not thread-safe, protected by the state machine Manager lock.
+*/
+template<typename Key>
+class DeadlineQueue final
+{
+public:
+	using Clock = std::chrono::steady_clock;
+	using TimePoint = Clock::time_point;
+
+	struct Entry
+	{
+		TimePoint deadline{};
+		Key key{};
+	};
+
+	/** Schedules a new deadline for the specified key */
+	void schedule(TimePoint const deadline, Key const& key)
+	{
+		_entries.push_back(Entry{ deadline, key });
+		std::push_heap(_entries.begin(), _entries.end(), EntryCompare{});
+	}
+
+	/** Removes and returns the earliest entry, if its deadline has been reached */
+	std::optional<Entry> popExpired(TimePoint const now) noexcept
+	{
+		if (_entries.empty() || _entries.front().deadline > now)
+		{
+			return std::nullopt;
+		}
+
+		std::pop_heap(_entries.begin(), _entries.end(), EntryCompare{});
+		auto entry = std::move(_entries.back());
+		_entries.pop_back();
+		return entry;
+	}
+
+	/** Returns the earliest deadline, or TimePoint::max() if the queue is empty */
+	TimePoint getNextDeadline() const noexcept
+	{
+		if (_entries.empty())
+		{
+			return TimePoint::max();
+		}
+		return _entries.front().deadline;
+	}
+
+	bool empty() const noexcept
+	{
+		return _entries.empty();
+	}
+
+	size_t size() const noexcept
+	{
+		return _entries.size();
+	}
+
+	void clear() noexcept
+	{
+		_entries.clear();
+	}
+
+private:
+	/** Comparator for a min-heap (std heap functions build max-heaps) */
+	struct EntryCompare
+	{
+		bool operator()(Entry const& lhs, Entry const& rhs) const noexcept
+		{
+			return lhs.deadline > rhs.deadline;
+		}
+	};
+
+	// Private members
+	std::vector<Entry> _entries{};
+};
+
+} // namespace stateMachine
+} // namespace protocol
+} // namespace avdecc
+} // namespace la
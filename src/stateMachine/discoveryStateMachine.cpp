@@ -30,6 +30,8 @@
 
 #include <utility>
 #include <optional>
+#include <algorithm>
+#include <vector>
 
 namespace la
 {
@@ -54,6 +56,12 @@ void DiscoveryStateMachine::setDiscoveryDelay(std::chrono::milliseconds const de
 {
 	_discoveryDelay = delay;
 	_lastDiscovery = std::chrono::steady_clock::now();
+
+	// Wake up the state machines thread, if the new discovery time is earlier than the scheduled one
+	if (_discoveryDelay.count() != 0)
+	{
+		_manager->scheduleWakeUp(_lastDiscovery + _discoveryDelay);
+	}
 }
 
 void DiscoveryStateMachine::discoverMessageSent() noexcept
@@ -69,55 +77,60 @@ void DiscoveryStateMachine::checkRemoteEntitiesTimeoutExpiracy() noexcept
 	// Get current time
 	auto const now = std::chrono::steady_clock::now();
 
-	// Process all Discovered Entities on the attached Protocol Interface
-	for (auto discoveredEntityKV = _discoveredEntities.begin(); discoveredEntityKV != _discoveredEntities.end(); /* Iterate inside the loop */)
+	// Process all expired interfaces, but only notify once per entity
+	auto timedOutEntities = std::vector<UniqueIdentifier>{};
+	while (auto const entry = _entityTimeouts.popExpired(now))
 	{
-		auto& entity = discoveredEntityKV->second;
-		auto hasInterfaceTimeout{ false };
-		auto shouldRemoveEntity{ false };
+		auto const& [entityID, avbInterfaceIndex] = entry->key;
 
-		// Check timeout value for all interfaces
-		for (auto timeoutKV = entity.timeouts.begin(); timeoutKV != entity.timeouts.end(); /* Iterate inside the loop */)
+		// Entity might have departed since the timeout was scheduled
+		auto const discoveredEntityIt = _discoveredEntities.find(entityID);
+		if (discoveredEntityIt == _discoveredEntities.end())
 		{
-			auto const timeout = timeoutKV->second;
-			if (now > timeout)
-			{
-				hasInterfaceTimeout = true;
-				entity.entity.removeInterfaceInformation(timeoutKV->first);
-				timeoutKV = entity.timeouts.erase(timeoutKV);
-			}
-			else
-			{
-				++timeoutKV;
-			}
+			continue;
 		}
+		auto& entity = discoveredEntityIt->second;
 
-		// We had at least one interface timeout
-		if (hasInterfaceTimeout)
+		// Ignore stale entries (the interface timed out already, or its timeout has been refreshed)
+		auto const timeoutIt = entity.timeouts.find(avbInterfaceIndex);
+		if (timeoutIt == entity.timeouts.end() || timeoutIt->second != entry->deadline)
 		{
-			// No more interfaces, set the entity offline
-			if (entity.entity.getInterfacesInformation().empty())
-			{
-				// Notify this entity is offline
-				utils::invokeProtectedMethod(&Delegate::onRemoteEntityOffline, _delegate, discoveredEntityKV->first);
-				shouldRemoveEntity = true;
-			}
-			// Otherwise just notify an update
-			else
-			{
-				// Notify this entity has been updated
-				utils::invokeProtectedMethod(&Delegate::onRemoteEntityUpdated, _delegate, entity.entity);
-			}
+			continue;
 		}
 
-		// Should we remove the entity from the list of known entities
-		if (shouldRemoveEntity)
+		entity.entity.removeInterfaceInformation(avbInterfaceIndex);
+		entity.timeouts.erase(timeoutIt);
+
+		if (std::find(timedOutEntities.begin(), timedOutEntities.end(), entityID) == timedOutEntities.end())
 		{
-			discoveredEntityKV = _discoveredEntities.erase(discoveredEntityKV);
+			timedOutEntities.push_back(entityID);
 		}
+	}
+
+	// Process all entities that had at least one interface timeout
+	for (auto const& entityID : timedOutEntities)
+	{
+		auto const discoveredEntityIt = _discoveredEntities.find(entityID);
+		if (!AVDECC_ASSERT_WITH_RET(discoveredEntityIt != _discoveredEntities.end(), "Entity should still be in the list"))
+		{
+			continue;
+		}
+		auto const& entity = discoveredEntityIt->second;
+
+		// No more interfaces, set the entity offline
+		if (entity.entity.getInterfacesInformation().empty())
+		{
+			// Notify this entity is offline
+			utils::invokeProtectedMethod(&Delegate::onRemoteEntityOffline, _delegate, entityID);
+
+			// Remove the entity from the list of known entities
+			_discoveredEntities.erase(discoveredEntityIt);
+		}
+		// Otherwise just notify an update
 		else
 		{
-			++discoveredEntityKV;
+			// Notify this entity has been updated
+			utils::invokeProtectedMethod(&Delegate::onRemoteEntityUpdated, _delegate, entity.entity);
 		}
 	}
 }
@@ -187,7 +200,16 @@ void DiscoveryStateMachine::handleAdpEntityAvailable(Adpdu const& adpdu) noexcep
 	}
 
 	// Compute timeout value and always update
-	discoveredInfo->timeouts[avbInterfaceIndex] = std::chrono::steady_clock::now() + std::chrono::seconds(2 * adpdu.getValidTime());
+	auto const timeout = std::chrono::steady_clock::now() + std::chrono::seconds(2 * adpdu.getValidTime());
+	discoveredInfo->timeouts[avbInterfaceIndex] = timeout;
+
+	// Index the new timeout value, and wake up the state machines thread if it's the earliest one
+	auto const isEarliestTimeout = timeout < _entityTimeouts.getNextDeadline();
+	_entityTimeouts.schedule(timeout, std::make_pair(entityID, avbInterfaceIndex));
+	if (isEarliestTimeout)
+	{
+		_manager->scheduleWakeUp(timeout);
+	}
 
 	// Notify delegate
 	if (notify && _delegate != nullptr)
@@ -250,6 +272,17 @@ void DiscoveryStateMachine::notifyDiscoveredRemoteEntities(Delegate& delegate) c
 	}
 }
 
+std::chrono::steady_clock::time_point DiscoveryStateMachine::getNextDeadline() const noexcept
+{
+	auto nextDeadline = _entityTimeouts.getNextDeadline();
+
+	if (_discoveryDelay.count() != 0)
+	{
+		nextDeadline = std::min(nextDeadline, _lastDiscovery + _discoveryDelay);
+	}
+
+	return nextDeadline;
+}
 
 /* ************************************************************ */
 /* Private methods                                              */
@@ -27,9 +27,11 @@
 #include "la/avdecc/internals/entity.hpp"
 
 #include "protocolInterfaceDelegate.hpp"
+#include "deadlineQueue.hpp"
 
 #include <chrono>
 #include <unordered_map>
+#include <utility>
 
 namespace la
 {
@@ -68,6 +70,8 @@ public:
 	void handleAdpEntityAvailable(Adpdu const& adpdu) noexcept;
 	void handleAdpEntityDeparting(Adpdu const& adpdu) noexcept;
 	void notifyDiscoveredRemoteEntities(Delegate& delegate) const noexcept;
+	/** Returns the time at which the state machine should be checked next (Manager lock must be taken) */
+	std::chrono::steady_clock::time_point getNextDeadline() const noexcept;
 
 private:
 	// Private types
@@ -83,6 +87,7 @@ private:
 		std::unordered_map<entity::model::AvbInterfaceIndex, std::chrono::time_point<std::chrono::steady_clock>> timeouts{};
 	};
 	using DiscoveredEntities = std::unordered_map<UniqueIdentifier, DiscoveredEntityInfo, UniqueIdentifier::hash>;
+	using EntityTimeouts = DeadlineQueue<std::pair<UniqueIdentifier, entity::model::AvbInterfaceIndex>>;
 
 	// Private methods
 	entity::Entity makeEntity(Adpdu const& adpdu) const noexcept;
@@ -94,6 +99,7 @@ private:
 	DiscoveredEntities _discoveredEntities{};
 	std::chrono::milliseconds _discoveryDelay{};
 	std::chrono::time_point<std::chrono::steady_clock> _lastDiscovery{ std::chrono::steady_clock::now() };
+	EntityTimeouts _entityTimeouts{}; // Timeouts of all discovered entities interfaces, ordered by deadline (refreshed timeouts leave a stale entry that is ignored when popped)
 };
 
 } // namespace stateMachine
@@ -50,6 +50,7 @@ public:
 	virtual ProtocolInterface::Error sendMessage(la::avdecc::protocol::Acmpdu const& acmpdu) const noexcept = 0;
 	/* *** Other methods **** */
 	virtual std::uint32_t getVuAecpCommandTimeoutMsec(VuAecpdu::ProtocolIdentifier const& protocolIdentifier, la::avdecc::protocol::VuAecpdu const& aecpdu) const noexcept = 0;
+	virtual std::uint32_t getMaxAecpInflightCommandsCeiling() const noexcept = 0;
 };
 
 } // namespace stateMachine
@@ -28,9 +28,17 @@
 #include "stateMachineManager.hpp"
 #include "logHelper.hpp"
 
+#include <algorithm>
+
 // Only enable instrumentation in static library and in debug (for unit testing mainly)
 #if defined(DEBUG) && defined(la_avdecc_static_STATICS)
-#	define SEND_INSTRUMENTATION_NOTIFICATION(eventName) la::avdecc::InstrumentationNotifier::getInstance().triggerEvent(eventName)
+// Event names are stored in static strings so the instrumentation doesn't allocate memory on the lock path
+#	define SEND_INSTRUMENTATION_NOTIFICATION(eventName) \
+		do \
+		{ \
+			static auto const s_eventName = std::string{ eventName }; \
+			la::avdecc::InstrumentationNotifier::getInstance().triggerEvent(s_eventName); \
+		} while (false)
 #else // !DEBUG || !la_avdecc_static_STATICS
 #	define SEND_INSTRUMENTATION_NOTIFICATION(eventName)
 #endif // DEBUG && la_avdecc_static_STATICS
@@ -233,6 +241,12 @@ void Manager::startStateMachines() noexcept
 
 				while (!_shouldTerminate)
 				{
+					// Reset the wake up time, deadlines registered from now on will lower it
+					{
+						auto const lg = std::lock_guard{ _wakeUpLock };
+						_nextWakeUpTime = std::chrono::steady_clock::time_point::max();
+					}
+
 					// Check for local entities announcement
 					_advertiseStateMachine.checkLocalEntitiesAnnouncement();
 
@@ -248,8 +262,24 @@ void Manager::startStateMachines() noexcept
 					// Try to detect deadlocks
 					watchDog.alive("avdecc::StateMachine", true);
 
-					// Wait a little bit so we don't burn the CPU
-					std::this_thread::sleep_for(std::chrono::milliseconds(5));
+					// Get the next deadline of all state machines (never sleep too long so the watchdog doesn't trigger)
+					auto nextDeadline = std::chrono::steady_clock::now() + MaximumSleepDuration;
+					{
+						// Lock
+						auto const lg = std::lock_guard{ *this };
+
+						nextDeadline = std::min({ nextDeadline, _advertiseStateMachine.getNextDeadline(), _discoveryStateMachine.getNextDeadline(), _commandStateMachine.getNextDeadline() });
+					}
+
+					// Wait until the next deadline, or until an earlier deadline is registered
+					{
+						auto lock = std::unique_lock{ _wakeUpLock };
+						_nextWakeUpTime = std::min(_nextWakeUpTime, nextDeadline);
+						while (!_shouldTerminate && std::chrono::steady_clock::now() < _nextWakeUpTime)
+						{
+							_wakeUpCondVar.wait_until(lock, _nextWakeUpTime);
+						}
+					}
 				}
 				watchDog.unregisterWatch("avdecc::StateMachine", true);
 			});
@@ -262,13 +292,31 @@ void Manager::stopStateMachines() noexcept
 	if (_stateMachineThread.joinable())
 	{
 		// Notify the thread we are shutting down
-		_shouldTerminate = true;
+		{
+			auto const lg = std::lock_guard{ _wakeUpLock };
+			_shouldTerminate = true;
+		}
+		_wakeUpCondVar.notify_all();
 
 		// Wait for the thread to complete its pending tasks
 		_stateMachineThread.join();
 	}
 }
 
+void Manager::scheduleWakeUp(std::chrono::steady_clock::time_point const deadline) noexcept
+{
+	// Only wake up the state machine thread if the deadline is earlier than the currently scheduled one
+	{
+		auto const lg = std::lock_guard{ _wakeUpLock };
+		if (deadline >= _nextWakeUpTime)
+		{
+			return;
+		}
+		_nextWakeUpTime = deadline;
+	}
+	_wakeUpCondVar.notify_all();
+}
+
 ProtocolInterface::Error Manager::registerLocalEntity(entity::LocalEntity& entity) noexcept
 {
 	// Lock
@@ -34,7 +34,9 @@
 #include <chrono>
 #include <unordered_map>
 #include <mutex>
+#include <condition_variable>
 #include <thread>
+#include <atomic>
 #include <cstdint>
 
 namespace la
@@ -75,6 +77,8 @@ public:
 	void unlock() noexcept;
 	/** Debug method: Returns true if the whole ProtocolInterface is locked by the calling thread */
 	bool isSelfLocked() const noexcept;
+	/** Wakes up the state machines thread no later than the specified deadline (thread-safe, the Manager lock is not required) */
+	void scheduleWakeUp(std::chrono::steady_clock::time_point const deadline) noexcept;
 
 	ProtocolInterface const* getProtocolInterface() noexcept;
 	ProtocolInterfaceDelegate* getProtocolInterfaceDelegate() noexcept;
@@ -108,6 +112,11 @@ private:
 	/* ************************************************************ */
 	using LocalEntities = std::unordered_map<UniqueIdentifier, entity::LocalEntity&, UniqueIdentifier::hash>;
 
+	/* ************************************************************ */
+	/* Private constants                                            */
+	/* ************************************************************ */
+	static constexpr auto MaximumSleepDuration = std::chrono::milliseconds{ 500u }; // Maximum duration the state machines thread sleeps (must be lower than the watchdog timeout)
+
 	/* ************************************************************ */
 	/* Private methods                                              */
 	/* ************************************************************ */
@@ -118,9 +127,12 @@ private:
 	std::recursive_mutex _lock{}; /** Lock to protect the whole class */
 	std::uint32_t _lockedCount{ 0u }; // DEBUG status for BasicLockable concept
 	std::thread::id _lockingThreadID{}; // DEBUG status for BasicLockable concept
-	bool _shouldTerminate{ false };
+	std::atomic_bool _shouldTerminate{ false };
 	ProtocolInterface const* const _protocolInterface{ nullptr };
 	std::thread _stateMachineThread{}; // Can safely be declared here, will be joined during destruction
+	std::mutex _wakeUpLock{}; // Lock protecting the next wake up time of the state machines thread
+	std::condition_variable _wakeUpCondVar{}; // Condition variable to wake up the state machines thread
+	std::chrono::steady_clock::time_point _nextWakeUpTime{ std::chrono::steady_clock::time_point::max() }; // Time at which the state machines thread will wake up (protected by _wakeUpLock)
 	LocalEntities _localEntities{}; /** Local entities declared by the running program */
 
 	/* ************************************************************ */
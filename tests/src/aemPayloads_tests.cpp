@@ -30,6 +30,7 @@
 
 // Internal API
 #include "protocol/protocolAemPayloads.hpp"
+#include "protocol/protocolAemPayloadViews.hpp"
 
 #include <gtest/gtest.h>
 #include <array>
@@ -712,3 +713,118 @@ TEST(AemPayloads, DeserializeReadControlDescriptorResponse_Utf8)
 }
 
 #endif // _WIN32 || __APPLE__
+
+namespace
+{
+constexpr auto ReadDescriptorCommonSize = la::avdecc::protocol::aemPayload::AecpAemReadCommonDescriptorResponsePayloadSize;
+
+la::avdecc::Serializer<la::avdecc::protocol::AemAecpdu::MaximumPayloadBufferLength> serializeStreamDescriptor(std::uint16_t const formatsOffset, std::vector<la::avdecc::entity::model::StreamFormat> const& formats)
+{
+	auto ser = la::avdecc::Serializer<la::avdecc::protocol::AemAecpdu::MaximumPayloadBufferLength>{};
+	ser << la::avdecc::entity::model::ConfigurationIndex{ 0u } << std::uint16_t{ 0u } << la::avdecc::entity::model::DescriptorType::StreamInput << std::uint16_t{ 0u };
+	ser << la::avdecc::entity::model::AvdeccFixedString{ "Stream" };
+	ser << la::avdecc::entity::model::LocalizedStringReference{} << la::avdecc::entity::model::ClockDomainIndex{ 1u } << la::avdecc::entity::StreamFlags{ la::avdecc::entity::StreamFlag::ClassA };
+	ser << la::avdecc::entity::model::StreamFormat{ 0x00a0020440000800 } << formatsOffset << static_cast<std::uint16_t>(formats.size());
+	for (auto i = 0u; i < 4u; ++i)
+	{
+		ser << la::avdecc::UniqueIdentifier{} << std::uint16_t{ 0u }; // Backup talkers and backedup talker
+	}
+	ser << la::avdecc::entity::model::AvbInterfaceIndex{ 2u } << std::uint32_t{ 128u };
+	for (auto const& format : formats)
+	{
+		ser << format;
+	}
+	return ser;
+}
+} // namespace
+
+TEST(AemPayloads, StreamDescriptorView)
+{
+	auto const formats = std::vector<la::avdecc::entity::model::StreamFormat>{ la::avdecc::entity::model::StreamFormat{ 0x00a0020440000800 }, la::avdecc::entity::model::StreamFormat{ 0x00a0020840000800 }, la::avdecc::entity::model::StreamFormat{ 0x00a0010440000800 } };
+	auto const ser = serializeStreamDescriptor(std::uint16_t{ 132u }, formats);
+	auto const payload = la::avdecc::protocol::AemAecpdu::Payload{ ser.data(), ser.usedBytes() };
+
+	auto const view = la::avdecc::protocol::aemPayload::StreamDescriptorView{ payload, ReadDescriptorCommonSize };
+	EXPECT_EQ(std::string{ "Stream" }, view.getObjectName().str());
+	EXPECT_EQ(la::avdecc::entity::model::ClockDomainIndex{ 1u }, view.getClockDomainIndex());
+	EXPECT_EQ(la::avdecc::entity::StreamFlags{ la::avdecc::entity::StreamFlag::ClassA }, view.getStreamFlags());
+	EXPECT_EQ(la::avdecc::entity::model::StreamFormat{ 0x00a0020440000800 }, view.getCurrentFormat());
+	EXPECT_EQ(la::avdecc::entity::model::AvbInterfaceIndex{ 2u }, view.getAvbInterfaceIndex());
+	EXPECT_EQ(128u, view.getBufferLength());
+
+	ASSERT_EQ(formats.size(), view.getFormats().size());
+	EXPECT_EQ(formats, (std::vector<la::avdecc::entity::model::StreamFormat>{ view.getFormats().begin(), view.getFormats().end() }));
+	EXPECT_EQ(formats[1], view.getFormats()[1]);
+
+	// Materialized descriptor should be the same than the one from the eager deserialization
+	auto const descriptor = view.toDescriptor();
+	auto const eagerDescriptor = la::avdecc::protocol::aemPayload::deserializeReadStreamDescriptorResponse(payload, ReadDescriptorCommonSize, static_cast<la::avdecc::protocol::AemAecpStatus>(la::avdecc::protocol::AemAecpStatus::Success));
+	EXPECT_EQ(eagerDescriptor.objectName, descriptor.objectName);
+	EXPECT_EQ(eagerDescriptor.currentFormat, descriptor.currentFormat);
+	EXPECT_EQ(eagerDescriptor.bufferLength, descriptor.bufferLength);
+	EXPECT_EQ((la::avdecc::entity::model::StreamFormats{ formats.begin(), formats.end() }), descriptor.formats);
+	EXPECT_EQ(eagerDescriptor.formats, descriptor.formats);
+}
+
+TEST(AemPayloads, StreamDescriptorViewMalformed)
+{
+	// Formats offset pointing inside the static part of the descriptor
+	{
+		auto const ser = serializeStreamDescriptor(std::uint16_t{ 100u }, { la::avdecc::entity::model::StreamFormat{ 0x00a0020440000800 } });
+		EXPECT_THROW(la::avdecc::protocol::aemPayload::StreamDescriptorView({ ser.data(), ser.usedBytes() }, ReadDescriptorCommonSize), la::avdecc::protocol::aemPayload::IncorrectPayloadSizeException);
+	}
+	// More formats than the payload holds
+	{
+		auto const ser = serializeStreamDescriptor(std::uint16_t{ 132u }, { la::avdecc::entity::model::StreamFormat{ 0x00a0020440000800 } });
+		EXPECT_THROW(la::avdecc::protocol::aemPayload::StreamDescriptorView({ ser.data(), ser.usedBytes() - 1u }, ReadDescriptorCommonSize), la::avdecc::protocol::aemPayload::IncorrectPayloadSizeException);
+	}
+	// Truncated static part
+	{
+		auto const ser = serializeStreamDescriptor(std::uint16_t{ 132u }, {});
+		EXPECT_THROW(la::avdecc::protocol::aemPayload::StreamDescriptorView({ ser.data(), ser.usedBytes() - 1u }, ReadDescriptorCommonSize), la::avdecc::protocol::aemPayload::IncorrectPayloadSizeException);
+	}
+}
+
+TEST(AemPayloads, AudioMapDescriptorView)
+{
+	auto const mappings = la::avdecc::entity::model::AudioMappings{ { 0u, 1u, 2u, 3u }, { 4u, 5u, 6u, 7u } };
+	auto ser = la::avdecc::Serializer<la::avdecc::protocol::AemAecpdu::MaximumPayloadBufferLength>{};
+	ser << la::avdecc::entity::model::ConfigurationIndex{ 0u } << std::uint16_t{ 0u } << la::avdecc::entity::model::DescriptorType::AudioMap << std::uint16_t{ 0u };
+	ser << std::uint16_t{ 8u } << static_cast<std::uint16_t>(mappings.size()); // Mappings offset (from the base of the descriptor) / Number of mappings
+	for (auto const& mapping : mappings)
+	{
+		ser << mapping.streamIndex << mapping.streamChannel << mapping.clusterOffset << mapping.clusterChannel;
+	}
+	auto const payload = la::avdecc::protocol::AemAecpdu::Payload{ ser.data(), ser.usedBytes() };
+
+	auto const view = la::avdecc::protocol::aemPayload::AudioMapDescriptorView{ payload, ReadDescriptorCommonSize };
+	ASSERT_EQ(mappings.size(), view.getMappings().size());
+	EXPECT_EQ(mappings, (la::avdecc::entity::model::AudioMappings{ view.getMappings().begin(), view.getMappings().end() }));
+	EXPECT_EQ(mappings, view.toDescriptor().mappings);
+
+	// Not enough bytes for the announced number of mappings
+	EXPECT_THROW(la::avdecc::protocol::aemPayload::AudioMapDescriptorView({ ser.data(), ser.usedBytes() - 1u }, ReadDescriptorCommonSize), la::avdecc::protocol::aemPayload::IncorrectPayloadSizeException);
+}
+
+TEST(AemPayloads, StringsDescriptorView)
+{
+	auto ser = la::avdecc::Serializer<la::avdecc::protocol::AemAecpdu::MaximumPayloadBufferLength>{};
+	ser << la::avdecc::entity::model::ConfigurationIndex{ 0u } << std::uint16_t{ 0u } << la::avdecc::entity::model::DescriptorType::Strings << std::uint16_t{ 0u };
+	for (auto i = 0u; i < 7u; ++i)
+	{
+		ser << la::avdecc::entity::model::AvdeccFixedString{ "String " + std::to_string(i) };
+	}
+	auto const payload = la::avdecc::protocol::AemAecpdu::Payload{ ser.data(), ser.usedBytes() };
+
+	auto const view = la::avdecc::protocol::aemPayload::StringsDescriptorView{ payload, ReadDescriptorCommonSize };
+	ASSERT_EQ(7u, view.getStrings().size());
+	EXPECT_EQ(std::string{ "String 3" }, view.getStrings()[3].str());
+
+	auto const descriptor = view.toDescriptor();
+	for (auto i = 0u; i < 7u; ++i)
+	{
+		EXPECT_EQ("String " + std::to_string(i), descriptor.strings[i].str());
+	}
+
+	EXPECT_THROW(la::avdecc::protocol::aemPayload::StringsDescriptorView({ ser.data(), ser.usedBytes() - 1u }, ReadDescriptorCommonSize), la::avdecc::protocol::aemPayload::IncorrectPayloadSizeException);
+}
@@ -0,0 +1,124 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @file allocationCounter.cpp
+* @author Christophe Calmejane
+*/
+
+#include "allocationCounter.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// Only allocations made from threads that enabled counting are taken into account
+static thread_local bool s_countAllocations{ false };
+static std::atomic<size_t> s_allocationsCount{ 0u };
+static std::atomic<size_t> s_allocatedBytes{ 0u };
+static std::atomic<std::ptrdiff_t> s_liveBytes{ 0 };
+static std::atomic<std::ptrdiff_t> s_peakBytes{ 0 };
+static std::atomic<std::ptrdiff_t> s_baseBytes{ 0 };
+
+// Each allocation is prefixed with its size and whether it was counted, so operator delete can deduct counted allocations from the live bytes
+struct AllocationHeader
+{
+	std::size_t size{ 0u };
+	bool counted{ false };
+};
+static constexpr auto AllocationHeaderSize = alignof(std::max_align_t) >= sizeof(AllocationHeader) ? alignof(std::max_align_t) : 2 * alignof(std::max_align_t);
+
+void* operator new(std::size_t size)
+{
+	auto* const block = static_cast<std::uint8_t*>(std::malloc(AllocationHeaderSize + size));
+	if (block == nullptr)
+	{
+		throw std::bad_alloc{};
+	}
+
+	auto const* const header = new (block) AllocationHeader{ size, s_countAllocations };
+	if (header->counted)
+	{
+		++s_allocationsCount;
+		s_allocatedBytes += size;
+		auto const live = s_liveBytes += static_cast<std::ptrdiff_t>(size);
+		auto peak = s_peakBytes.load();
+		while (live > peak && !s_peakBytes.compare_exchange_weak(peak, live))
+		{
+		}
+	}
+
+	return block + AllocationHeaderSize;
+}
+
+void operator delete(void* ptr) noexcept
+{
+	if (ptr == nullptr)
+	{
+		return;
+	}
+
+	auto* const block = static_cast<std::uint8_t*>(ptr) - AllocationHeaderSize;
+	auto const* const header = reinterpret_cast<AllocationHeader const*>(block);
+	if (header->counted)
+	{
+		s_liveBytes -= static_cast<std::ptrdiff_t>(header->size);
+	}
+	std::free(block);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept
+{
+	operator delete(ptr);
+}
+
+namespace allocationCounter
+{
+void setCountingEnabled(bool const enabled) noexcept
+{
+	s_countAllocations = enabled;
+}
+
+void reset() noexcept
+{
+	s_allocationsCount = 0u;
+	s_allocatedBytes = 0u;
+	s_baseBytes = s_liveBytes.load();
+	s_peakBytes = s_baseBytes.load();
+}
+
+size_t getCount() noexcept
+{
+	return s_allocationsCount;
+}
+
+size_t getAllocatedBytes() noexcept
+{
+	return s_allocatedBytes;
+}
+
+size_t getPeakBytes() noexcept
+{
+	return static_cast<size_t>(std::max(std::ptrdiff_t{ 0 }, s_peakBytes - s_baseBytes));
+}
+
+} // namespace allocationCounter
@@ -0,0 +1,50 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @file allocationCounter.hpp
+* @author Christophe Calmejane
+*/
+
+#pragma once
+
+#include <cstddef>
+
+/**
+* @brief Counts the heap allocations, allocated bytes and peak of live bytes (global operator new/delete) made by the threads that enabled counting.
+* @details The counting operator new and delete are defined in allocationCounter.cpp, for the whole Tests executable.
+*/
+namespace allocationCounter
+{
+/** Enables or disables the counting of the allocations made by the calling thread */
+void setCountingEnabled(bool const enabled) noexcept;
+
+/** Resets the number of counted allocations */
+void reset() noexcept;
+
+/** Returns the number of allocations counted since the last reset (all threads) */
+size_t getCount() noexcept;
+
+/** Returns the number of bytes allocated since the last reset (all threads, released memory is not deducted) */
+size_t getAllocatedBytes() noexcept;
+
+/** Returns the highest amount of counted memory simultaneously allocated since the last reset (counted allocations released by any thread are deducted) */
+size_t getPeakBytes() noexcept;
+
+} // namespace allocationCounter
@@ -0,0 +1,136 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @file controller_benchmarks.cpp
+* @author Christophe Calmejane
+*/
+
+// Benchmarks are disabled by default, run them using --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+
+// Internal API
+#include "controller/avdeccControlledEntityImpl.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using LockInformation = la::avdecc::controller::ControlledEntityImpl::LockInformation;
+
+std::shared_ptr<la::avdecc::controller::ControlledEntityImpl> createEntity(std::uint64_t const entityID, LockInformation::SharedPointer const& lockInformation)
+{
+	auto const commonInformation = la::avdecc::entity::Entity::CommonInformation{ la::avdecc::UniqueIdentifier{ entityID }, la::avdecc::UniqueIdentifier{ 0x1122334455667788 }, la::avdecc::entity::EntityCapabilities{ la::avdecc::entity::EntityCapability::AemSupported }, 0u, la::avdecc::entity::TalkerCapabilities{}, 0u, la::avdecc::entity::ListenerCapabilities{}, la::avdecc::entity::ControllerCapabilities{}, std::nullopt, std::nullopt };
+	auto const interfaceInfo = la::avdecc::entity::Entity::InterfaceInformation{ la::networkInterface::MacAddress{}, 31u, 0u, std::nullopt, std::nullopt };
+	return std::make_shared<la::avdecc::controller::ControlledEntityImpl>(la::avdecc::entity::Entity{ commonInformation, la::avdecc::entity::Entity::InterfacesInformation{ { la::avdecc::entity::Entity::GlobalAvbInterfaceIndex, interfaceInfo } } }, lockInformation, false);
+}
+
+/** Simulates some work while an entity is locked */
+void holdLock(std::chrono::nanoseconds const duration)
+{
+	auto const start = std::chrono::steady_clock::now();
+	while (std::chrono::steady_clock::now() - start < duration)
+	{
+	}
+}
+
+/** Readers continuously lock random entities while a writer updates all the entities in turn, prints the writer lock latency distribution */
+void measureContention(char const* const lockName, std::vector<std::shared_ptr<la::avdecc::controller::ControlledEntityImpl>> const& entities, size_t const readersCount, size_t const writesCount)
+{
+	static constexpr auto ReaderHoldTime = std::chrono::microseconds{ 100 }; // Readers (UI threads) sleep while holding the lock, so the benchmark measures lock contention and not CPU contention
+	static constexpr auto WriterHoldTime = std::chrono::microseconds{ 1 };
+
+	auto shouldTerminate = std::atomic_bool{ false };
+	auto readsCount = std::atomic<size_t>{ 0u };
+	auto readers = std::vector<std::thread>{};
+	for (auto r = size_t{ 0u }; r < readersCount; ++r)
+	{
+		readers.emplace_back(
+			[&entities, &shouldTerminate, &readsCount, r]()
+			{
+				auto index = r;
+				while (!shouldTerminate)
+				{
+					auto& entity = *entities[index % entities.size()];
+					entity.lock();
+					std::this_thread::sleep_for(ReaderHoldTime);
+					entity.unlock();
+					++readsCount;
+					index += 7u;
+				}
+			});
+	}
+
+	auto latencies = std::vector<std::chrono::steady_clock::duration>{};
+	latencies.reserve(writesCount);
+	auto const startTime = std::chrono::steady_clock::now();
+	for (auto i = size_t{ 0u }; i < writesCount; ++i)
+	{
+		auto& entity = *entities[i % entities.size()];
+		auto const lockTime = std::chrono::steady_clock::now();
+		entity.lock();
+		latencies.push_back(std::chrono::steady_clock::now() - lockTime);
+		holdLock(WriterHoldTime);
+		entity.unlock();
+	}
+	auto const duration = std::chrono::steady_clock::now() - startTime;
+	shouldTerminate = true;
+	for (auto& reader : readers)
+	{
+		reader.join();
+	}
+
+	std::sort(latencies.begin(), latencies.end());
+	auto const percentile = [&latencies](double const p)
+	{
+		auto const index = std::min(latencies.size() - 1u, static_cast<size_t>(p * latencies.size()));
+		return std::chrono::duration_cast<std::chrono::microseconds>(latencies[index]).count();
+	};
+	auto const seconds = std::chrono::duration<double>(duration).count();
+	std::printf("%-10s readers=%2zu: writer %9.0f updates/s (lock latency p50=%lldus p99=%lldus max=%lldus), readers %9.0f reads/s\n", lockName, readersCount, writesCount / seconds, static_cast<long long>(percentile(0.5)), static_cast<long long>(percentile(0.99)), static_cast<long long>(percentile(1.0)), readsCount / seconds);
+}
+} // namespace
+
+TEST(ControllerBenchmark, DISABLED_EntityLockContention)
+{
+	static constexpr auto EntitiesCount = size_t{ 64u };
+	static constexpr auto WritesCount = size_t{ 5000u };
+
+	// All entities sharing the same lock (previous behavior) vs one lock per entity
+	auto sharedLockEntities = std::vector<std::shared_ptr<la::avdecc::controller::ControlledEntityImpl>>{};
+	auto perEntityLockEntities = std::vector<std::shared_ptr<la::avdecc::controller::ControlledEntityImpl>>{};
+	auto const sharedLock = std::make_shared<LockInformation>();
+	for (auto i = size_t{ 0u }; i < EntitiesCount; ++i)
+	{
+		sharedLockEntities.push_back(createEntity(0x001B92FFFF000000 + i, sharedLock));
+		perEntityLockEntities.push_back(createEntity(0x001B92FFFF000000 + i, std::make_shared<LockInformation>()));
+	}
+
+	for (auto const readersCount : { size_t{ 1u }, size_t{ 4u }, size_t{ 16u } })
+	{
+		measureContention("Shared", sharedLockEntities, readersCount, WritesCount);
+		measureContention("PerEntity", perEntityLockEntities, readersCount, WritesCount);
+	}
+}
@@ -0,0 +1,475 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/**
+* @file entityModel_benchmarks.cpp
+* @author Christophe Calmejane
+*/
+
+// Benchmarks are disabled by default, run them using --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+
+// Public API
+#include <la/avdecc/controller/avdeccController.hpp>
+
+// Internal API
+#include "controller/avdeccControlledEntityImpl.hpp"
+
+#include "../allocationCounter.hpp"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+static constexpr auto Iterations = size_t{ 200000u };
+static constexpr auto VirtualEntityID = la::avdecc::UniqueIdentifier{ 0x001B92FFFF000003 };
+
+/** Runs 'Iterations' times the specified method, returns the mean time per iteration */
+template<typename Method>
+double measure(Method&& method)
+{
+	auto const start = std::chrono::steady_clock::now();
+	for (auto i = size_t{ 0u }; i < Iterations; ++i)
+	{
+		method();
+	}
+	auto const duration = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+	return duration / Iterations;
+}
+
+la::avdecc::controller::Controller::UniquePointer loadVirtualEntity()
+{
+	auto const flags = la::avdecc::entity::model::jsonSerializer::Flags{ la::avdecc::entity::model::jsonSerializer::Flag::IgnoreAEMSanityChecks, la::avdecc::entity::model::jsonSerializer::Flag::ProcessADP, la::avdecc::entity::model::jsonSerializer::Flag::ProcessCompatibility, la::avdecc::entity::model::jsonSerializer::Flag::ProcessDynamicModel, la::avdecc::entity::model::jsonSerializer::Flag::ProcessMilan, la::avdecc::entity::model::jsonSerializer::Flag::ProcessState, la::avdecc::entity::model::jsonSerializer::Flag::ProcessStaticModel, la::avdecc::entity::model::jsonSerializer::Flag::ProcessStatistics };
+	auto controller = la::avdecc::controller::Controller::create(la::avdecc::protocol::ProtocolInterface::Type::Virtual, "VirtualInterface", 0x0001, la::avdecc::UniqueIdentifier{}, "en");
+	auto const [error, message] = controller->loadVirtualEntityFromJson("data/TalkerListener.json", flags);
+	EXPECT_EQ(la::avdecc::jsonSerializer::DeserializationError::NoError, error) << message;
+	return controller;
+}
+
+class CountingVisitor final : public la::avdecc::controller::model::EntityModelVisitor
+{
+public:
+	size_t getCount() const noexcept
+	{
+		return _count;
+	}
+
+private:
+	virtual void visit(la::avdecc::controller::ControlledEntity const* const /*entity*/, la::avdecc::controller::model::ConfigurationNode const* const /*parent*/, la::avdecc::controller::model::StreamInputNode const& node) noexcept override
+	{
+		_count += node.descriptorIndex;
+	}
+	virtual void visit(la::avdecc::controller::ControlledEntity const* const /*entity*/, la::avdecc::controller::model::ConfigurationNode const* const /*grandGrandParent*/, la::avdecc::controller::model::AudioUnitNode const* const /*grandParent*/, la::avdecc::controller::model::StreamPortNode const* const /*parent*/, la::avdecc::controller::model::AudioClusterNode const& node) noexcept override
+	{
+		_count += node.descriptorIndex;
+	}
+	virtual void visit(la::avdecc::controller::ControlledEntity const* const /*entity*/, la::avdecc::controller::model::ConfigurationNode const* const /*parent*/, la::avdecc::controller::model::ControlNode const& node) noexcept override
+	{
+		_count += node.descriptorIndex;
+	}
+
+	size_t _count{ 0u };
+};
+
+/** Forces a private copy of all the static models of the tree (the same memory layout than a deep copy of the tree) */
+void unshareStaticModels(la::avdecc::entity::model::EntityTree& tree)
+{
+	auto const unshare = [](auto& models)
+	{
+		for (auto& [index, model] : models)
+		{
+			static_cast<void>(model.staticModel.getMutable());
+		}
+	};
+
+	tree.staticModel.getMutable();
+	for (auto& [configIndex, configTree] : tree.configurationTrees)
+	{
+		configTree.staticModel.getMutable();
+		unshare(configTree.audioUnitModels);
+		unshare(configTree.streamInputModels);
+		unshare(configTree.streamOutputModels);
+		unshare(configTree.avbInterfaceModels);
+		unshare(configTree.clockSourceModels);
+		unshare(configTree.memoryObjectModels);
+		unshare(configTree.localeModels);
+		unshare(configTree.stringsModels);
+		unshare(configTree.streamPortInputModels);
+		unshare(configTree.streamPortOutputModels);
+		unshare(configTree.audioClusterModels);
+		unshare(configTree.audioMapModels);
+		unshare(configTree.controlModels);
+		unshare(configTree.clockDomainModels);
+	}
+}
+
+/** Returns a copy of the tree with the top level descriptor counts the EntityModelCache validates (they are not part of a virtual entity loaded from JSON) */
+la::avdecc::entity::model::EntityTree makeCacheableTree(la::avdecc::entity::model::EntityTree const& entityTree)
+{
+	auto tree = entityTree;
+	for (auto& [configIndex, configTree] : tree.configurationTrees)
+	{
+		auto& descriptorCounts = configTree.staticModel.getMutable().descriptorCounts;
+		auto const setCount = [&descriptorCounts](la::avdecc::entity::model::DescriptorType const descriptorType, auto const& models)
+		{
+			if (!models.empty())
+			{
+				descriptorCounts[descriptorType] = static_cast<std::uint16_t>(models.size());
+			}
+		};
+
+		setCount(la::avdecc::entity::model::DescriptorType::AudioUnit, configTree.audioUnitModels);
+		setCount(la::avdecc::entity::model::DescriptorType::StreamInput, configTree.streamInputModels);
+		setCount(la::avdecc::entity::model::DescriptorType::StreamOutput, configTree.streamOutputModels);
+		setCount(la::avdecc::entity::model::DescriptorType::AvbInterface, configTree.avbInterfaceModels);
+		setCount(la::avdecc::entity::model::DescriptorType::ClockSource, configTree.clockSourceModels);
+		setCount(la::avdecc::entity::model::DescriptorType::MemoryObject, configTree.memoryObjectModels);
+		setCount(la::avdecc::entity::model::DescriptorType::Locale, configTree.localeModels);
+		setCount(la::avdecc::entity::model::DescriptorType::Control, configTree.controlModels);
+		setCount(la::avdecc::entity::model::DescriptorType::ClockDomain, configTree.clockDomainModels);
+	}
+	return tree;
+}
+} // namespace
+
+TEST(EntityModelBenchmark, DISABLED_ConfigurationTreeContainer)
+{
+	static constexpr auto NodesCount = std::uint16_t{ 32u };
+
+	auto sink = size_t{ 0u };
+	auto const measureContainer = [&sink](auto container)
+	{
+		for (auto i = std::uint16_t{ 0u }; i < NodesCount; ++i)
+		{
+			container[i].staticModel.getMutable().bufferLength = i;
+		}
+		auto index = size_t{ 0u };
+		auto const lookup = measure(
+			[&]()
+			{
+				sink += container.find(static_cast<la::avdecc::entity::model::StreamIndex>(++index % NodesCount))->second.staticModel->bufferLength;
+			});
+		auto const traversal = measure(
+			[&]()
+			{
+				for (auto const& [streamIndex, models] : container)
+				{
+					sink += models.staticModel->bufferLength;
+				}
+			});
+		return std::make_pair(lookup, traversal);
+	};
+
+	auto const [mapLookup, mapTraversal] = measureContainer(std::map<la::avdecc::entity::model::StreamIndex, la::avdecc::entity::model::StreamInputNodeModels>{});
+	auto const [indexedLookup, indexedTraversal] = measureContainer(la::avdecc::IndexedMap<la::avdecc::entity::model::StreamIndex, la::avdecc::entity::model::StreamInputNodeModels>{});
+
+	std::printf("ConfigurationTreeContainer %u nodes lookup:    std::map %5.1f ns, IndexedMap %5.1f ns\n", NodesCount, mapLookup, indexedLookup);
+	std::printf("ConfigurationTreeContainer %u nodes traversal: std::map %5.1f ns, IndexedMap %5.1f ns\n", NodesCount, mapTraversal, indexedTraversal);
+	EXPECT_NE(0u, sink);
+}
+
+TEST(EntityModelBenchmark, DISABLED_NodeModelLookup)
+{
+	auto const controller = loadVirtualEntity();
+	auto const entityGuard = controller->getControlledEntityGuard(VirtualEntityID);
+	ASSERT_TRUE(!!entityGuard);
+	auto const& entity = static_cast<la::avdecc::controller::ControlledEntityImpl const&>(*entityGuard);
+	auto const configurationIndex = entity.getCurrentConfigurationIndex();
+	auto const& configTree = entity.getConfigurationTree(configurationIndex);
+	auto const streamInputsCount = configTree.streamInputModels.size();
+	auto const clustersCount = configTree.audioClusterModels.size();
+	ASSERT_NE(0u, streamInputsCount);
+	ASSERT_NE(0u, clustersCount);
+
+	auto sink = size_t{ 0u };
+	auto index = size_t{ 0u };
+	auto const streamLookup = measure(
+		[&]()
+		{
+			sink += entity.getNodeStaticModel(configurationIndex, static_cast<la::avdecc::entity::model::StreamIndex>(++index % streamInputsCount), &la::avdecc::entity::model::ConfigurationTree::streamInputModels).formats.size();
+		});
+	auto const clusterLookup = measure(
+		[&]()
+		{
+			sink += entity.getNodeStaticModel(configurationIndex, static_cast<la::avdecc::entity::model::ClusterIndex>(++index % clustersCount), &la::avdecc::entity::model::ConfigurationTree::audioClusterModels).channelCount;
+		});
+
+	std::printf("NodeModelLookup getNodeStaticModel: StreamInput (%zu nodes) %5.1f ns, AudioCluster (%zu nodes) %5.1f ns\n", streamInputsCount, streamLookup, clustersCount, clusterLookup);
+	EXPECT_NE(0u, sink);
+}
+
+TEST(EntityModelBenchmark, DISABLED_EntityModelVisitor)
+{
+	auto const controller = loadVirtualEntity();
+	auto const entityGuard = controller->getControlledEntityGuard(VirtualEntityID);
+	ASSERT_TRUE(!!entityGuard);
+
+	auto visitor = CountingVisitor{};
+	auto const traversal = measure(
+		[&]()
+		{
+			entityGuard->accept(&visitor, true);
+		});
+
+	std::printf("EntityModelVisitor full traversal: %7.1f ns\n", traversal);
+	EXPECT_NE(0u, visitor.getCount());
+}
+
+TEST(EntityModelBenchmark, DISABLED_StaticModelSharingFootprint)
+{
+	static constexpr auto EntitiesCount = size_t{ 200u };
+	static constexpr auto UpdatesCount = size_t{ 10u };
+
+	auto const controller = loadVirtualEntity();
+	auto const entityGuard = controller->getControlledEntityGuard(VirtualEntityID);
+	ASSERT_TRUE(!!entityGuard);
+	auto const& virtualEntity = static_cast<la::avdecc::controller::ControlledEntityImpl const&>(*entityGuard);
+	auto const cachedTree = makeCacheableTree(virtualEntity.getEntityTree());
+	auto const configurationIndex = virtualEntity.getCurrentConfigurationIndex();
+	auto const& configTree = cachedTree.configurationTrees.at(configurationIndex);
+
+	auto descriptor = la::avdecc::entity::model::EntityDescriptor{};
+	descriptor.vendorNameString = cachedTree.staticModel->vendorNameString;
+	descriptor.modelNameString = cachedTree.staticModel->modelNameString;
+	descriptor.configurationsCount = static_cast<std::uint16_t>(cachedTree.configurationTrees.size());
+	descriptor.currentConfiguration = configurationIndex;
+
+	// Heap memory used by EntitiesCount identical entities enumerated using the EntityModelCache, then receiving some unsolicited updates
+	auto const measureEntities = [&](bool const unshare)
+	{
+		auto entities = std::vector<std::shared_ptr<la::avdecc::controller::ControlledEntityImpl>>{};
+		entities.reserve(EntitiesCount);
+
+		allocationCounter::reset();
+		allocationCounter::setCountingEnabled(true);
+		for (auto i = size_t{ 0u }; i < EntitiesCount; ++i)
+		{
+			auto& entity = *entities.emplace_back(std::make_shared<la::avdecc::controller::ControlledEntityImpl>(virtualEntity.getEntity(), std::make_shared<la::avdecc::controller::ControlledEntityImpl::LockInformation>(), false));
+			entity.lock();
+
+			// What the controller does when the EntityModel is found in the cache (a deep copy of the cached tree before static models were shared)
+			if (unshare)
+			{
+				auto tree = cachedTree;
+				unshareStaticModels(tree);
+				EXPECT_TRUE(entity.setCachedEntityTree(tree, descriptor, false));
+			}
+			else
+			{
+				EXPECT_TRUE(entity.setCachedEntityTree(cachedTree, descriptor, false));
+			}
+			entity.onEntityFullyLoaded();
+
+			// What the controller does when receiving unsolicited GET_CONTROL and GET_AVB_INFO
+			for (auto update = size_t{ 0u }; update < UpdatesCount; ++update)
+			{
+				for (auto const& [controlIndex, controlModels] : configTree.controlModels)
+				{
+					auto const& controlStaticModel = entity.getNodeStaticModel(configurationIndex, controlIndex, &la::avdecc::entity::model::ConfigurationTree::controlModels);
+					static_cast<void>(controlStaticModel.controlValueType);
+					if (controlModels.dynamicModel.values)
+					{
+						entity.setControlValues(controlIndex, controlModels.dynamicModel.values);
+					}
+				}
+				for (auto const& [avbInterfaceIndex, avbInterfaceModels] : configTree.avbInterfaceModels)
+				{
+					static_cast<void>(entity.getNodeStaticModel(configurationIndex, avbInterfaceIndex, &la::avdecc::entity::model::ConfigurationTree::avbInterfaceModels).macAddress);
+					entity.setAvbInterfaceInfo(avbInterfaceIndex, avbInterfaceModels.dynamicModel.avbInterfaceInfo ? *avbInterfaceModels.dynamicModel.avbInterfaceInfo : la::avdecc::entity::model::AvbInterfaceInfo{});
+				}
+			}
+
+			entity.unlock();
+		}
+		allocationCounter::setCountingEnabled(false);
+
+		// The entity model graph must reference the static models of the entity tree, which must still be the ones of the cache when not unshared
+		for (auto const& entity : entities)
+		{
+			auto const& entityTree = entity->getEntityTree();
+			auto const& configNode = entity->getEntityNode().configurations.at(configurationIndex);
+			for (auto const& [controlIndex, controlNode] : configNode.controls)
+			{
+				auto const& controlModels = entityTree.configurationTrees.at(configurationIndex).controlModels.at(controlIndex);
+				EXPECT_EQ(&controlModels.staticModel.get(), controlNode.staticModel);
+				EXPECT_EQ(!unshare, controlModels.staticModel.isSharedWith(configTree.controlModels.at(controlIndex).staticModel));
+			}
+			for (auto const& [avbInterfaceIndex, avbInterfaceNode] : configNode.avbInterfaces)
+			{
+				auto const& avbInterfaceModels = entityTree.configurationTrees.at(configurationIndex).avbInterfaceModels.at(avbInterfaceIndex);
+				EXPECT_EQ(&avbInterfaceModels.staticModel.get(), avbInterfaceNode.staticModel);
+				EXPECT_EQ(!unshare, avbInterfaceModels.staticModel.isSharedWith(configTree.avbInterfaceModels.at(avbInterfaceIndex).staticModel));
+			}
+		}
+
+		return allocationCounter::getPeakBytes();
+	};
+
+	auto const deepBytes = measureEntities(true);
+	auto const sharedBytes = measureEntities(false);
+
+	std::printf("StaticModelSharingFootprint %zu enumerated entities: private static models %7.1f KiB (%5.1f KiB/entity), shared static models %7.1f KiB (%5.1f KiB/entity)\n", EntitiesCount, deepBytes / 1024.0, deepBytes / 1024.0 / EntitiesCount, sharedBytes / 1024.0, sharedBytes / 1024.0 / EntitiesCount);
+	EXPECT_LT(sharedBytes, deepBytes);
+}
+
+TEST(EntityModelBenchmark, DISABLED_NetworkStateSnapshot)
+{
+	static constexpr auto EntitiesCount = size_t{ 100u };
+
+	auto const flags = la::avdecc::entity::model::jsonSerializer::Flags{ la::avdecc::entity::model::jsonSerializer::Flag::IgnoreAEMSanityChecks, la::avdecc::entity::model::jsonSerializer::Flag::ProcessADP, la::avdecc::entity::model::jsonSerializer::Flag::ProcessCompatibility, la::avdecc::entity::model::jsonSerializer::Flag::ProcessDynamicModel, la::avdecc::entity::model::jsonSerializer::Flag::ProcessMilan, la::avdecc::entity::model::jsonSerializer::Flag::ProcessState, la::avdecc::entity::model::jsonSerializer::Flag::ProcessStaticModel, la::avdecc::entity::model::jsonSerializer::Flag::ProcessStatistics };
+	auto const createController = []()
+	{
+		return la::avdecc::controller::Controller::create(la::avdecc::protocol::ProtocolInterface::Type::Virtual, "VirtualInterface", 0x0001, la::avdecc::UniqueIdentifier{}, "en");
+	};
+
+	// Load EntitiesCount copies of the same entity, each with its own EntityID
+	auto controller = createController();
+	{
+		auto const entityJson = std::string{ std::istreambuf_iterator<char>{ std::ifstream{ "data/TalkerListener.json" }.rdbuf() }, std::istreambuf_iterator<char>{} };
+		ASSERT_FALSE(entityJson.empty());
+		auto const entityIDString = std::string{ "0x001B92FFFF000003" };
+		auto const entityFilePath = std::string{ "NetworkStateSnapshotEntity.json" };
+		for (auto i = size_t{ 0u }; i < EntitiesCount; ++i)
+		{
+			auto json = entityJson;
+			char newID[19];
+			std::snprintf(newID, sizeof(newID), "0x001B92FFFF%06zX", i + 1u);
+			for (auto pos = json.find(entityIDString); pos != std::string::npos; pos = json.find(entityIDString, pos + entityIDString.size()))
+			{
+				json.replace(pos, entityIDString.size(), newID);
+			}
+			std::ofstream{ entityFilePath } << json;
+			auto const [error, message] = controller->loadVirtualEntityFromJson(entityFilePath, flags);
+			ASSERT_EQ(la::avdecc::jsonSerializer::DeserializationError::NoError, error) << message;
+		}
+		std::remove(entityFilePath.c_str());
+	}
+
+	struct Result
+	{
+		double saveTime{ 0.0 };
+		size_t savePeakBytes{ 0u };
+		size_t fileSize{ 0u };
+		double loadTime{ 0.0 };
+		size_t loadPeakBytes{ 0u };
+	};
+	auto const measure = [](auto&& action, double& time, size_t& peakBytes)
+	{
+		allocationCounter::reset();
+		allocationCounter::setCountingEnabled(true);
+		auto const start = std::chrono::steady_clock::now();
+		auto const result = action();
+		time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		allocationCounter::setCountingEnabled(false);
+		peakBytes = allocationCounter::getPeakBytes();
+		return result;
+	};
+
+	auto const jsonFlags = flags;
+	auto binaryFlags = flags;
+	binaryFlags.set(la::avdecc::entity::model::jsonSerializer::Flag::BinaryFormat);
+	auto const jsonFilePath = std::string{ "NetworkStateSnapshot.json" };
+	auto const msgpackFilePath = std::string{ "NetworkStateSnapshot.msgpack" };
+	auto const snapshotFilePath = std::string{ "NetworkStateSnapshot.avns" };
+	auto json = Result{};
+	auto msgpack = Result{};
+	auto snapshot = Result{};
+
+	// Save all formats from the same controller
+	auto const save = [&measure](auto&& action, std::string const& filePath, Result& result)
+	{
+		auto const [error, message] = measure(action, result.saveTime, result.savePeakBytes);
+		EXPECT_EQ(la::avdecc::jsonSerializer::SerializationError::NoError, error) << message;
+		result.fileSize = static_cast<size_t>(std::ifstream{ filePath, std::ios::binary | std::ios::ate }.tellg());
+	};
+	save(
+		[&]()
+		{
+			return controller->serializeAllControlledEntitiesAsJson(jsonFilePath, jsonFlags, "Benchmark", false);
+		},
+		jsonFilePath, json);
+	save(
+		[&]()
+		{
+			return controller->serializeAllControlledEntitiesAsJson(msgpackFilePath, binaryFlags, "Benchmark", false);
+		},
+		msgpackFilePath, msgpack);
+	save(
+		[&]()
+		{
+			return controller->serializeAllControlledEntitiesAsSnapshot(snapshotFilePath, flags, "Benchmark", false);
+		},
+		snapshotFilePath, snapshot);
+	// Only one controller can exist at a time
+	controller.reset();
+
+	// Load each format in a fresh controller
+	auto const load = [&measure, &createController](auto&& action, std::string const& filePath, Result& result)
+	{
+		auto loadController = createController();
+		auto const [error, message] = measure(
+			[&]()
+			{
+				return action(*loadController);
+			},
+			result.loadTime, result.loadPeakBytes);
+		EXPECT_EQ(la::avdecc::jsonSerializer::DeserializationError::NoError, error) << message;
+		std::remove(filePath.c_str());
+	};
+	load(
+		[&](auto& c)
+		{
+			return c.loadVirtualEntitiesFromJsonNetworkState(jsonFilePath, jsonFlags, false);
+		},
+		jsonFilePath, json);
+	load(
+		[&](auto& c)
+		{
+			return c.loadVirtualEntitiesFromJsonNetworkState(msgpackFilePath, binaryFlags, false);
+		},
+		msgpackFilePath, msgpack);
+	load(
+		[&](auto& c)
+		{
+			return c.loadVirtualEntitiesFromSnapshot(snapshotFilePath, flags, false);
+		},
+		snapshotFilePath, snapshot);
+
+	std::printf("NetworkStateSnapshot %zu entities:\n", EntitiesCount);
+	std::printf("  Format   | File size | Save time | Save peak memory | Load time | Load peak memory\n");
+	auto const printResult = [](char const* const name, Result const& result)
+	{
+		std::printf("  %-8s | %5.0f KiB | %6.1f ms | %12.1f KiB | %6.1f ms | %12.1f KiB\n", name, result.fileSize / 1024.0, result.saveTime, result.savePeakBytes / 1024.0, result.loadTime, result.loadPeakBytes / 1024.0);
+	};
+	printResult("JSON", json);
+	printResult("MsgPack", msgpack);
+	printResult("Snapshot", snapshot);
+
+	EXPECT_LT(snapshot.savePeakBytes, json.savePeakBytes);
+	EXPECT_LT(snapshot.loadPeakBytes, json.loadPeakBytes);
+}
@@ -0,0 +1,104 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @file executor_benchmarks.cpp
+* @author Christophe Calmejane
+*/
+
+// Benchmarks are disabled by default, run them using --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+
+// Public API
+#include <la/avdecc/executor.hpp>
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace
+{
+struct LatencyStatistics
+{
+	std::vector<std::chrono::steady_clock::duration> latencies{};
+	size_t count{ 0u }; // Only accessed from the executor thread
+};
+
+/** Pushes jobs from multiple threads and prints the push-to-execution latency distribution */
+void measureLatency(char const* const executorName, la::avdecc::Executor::UniquePointer const& executor, size_t const producersCount, size_t const jobsPerProducer)
+{
+	auto stats = LatencyStatistics{};
+	stats.latencies.resize(producersCount * jobsPerProducer);
+
+	auto const startTime = std::chrono::steady_clock::now();
+	auto producers = std::vector<std::thread>{};
+	for (auto p = size_t{ 0u }; p < producersCount; ++p)
+	{
+		producers.emplace_back(
+			[&executor, &stats, jobsPerProducer]()
+			{
+				for (auto i = size_t{ 0u }; i < jobsPerProducer; ++i)
+				{
+					auto const pushTime = std::chrono::steady_clock::now();
+					executor->pushJob(
+						[&stats, pushTime]()
+						{
+							stats.latencies[stats.count++] = std::chrono::steady_clock::now() - pushTime;
+						});
+				}
+			});
+	}
+	for (auto& producer : producers)
+	{
+		producer.join();
+	}
+	executor->flush();
+	auto const duration = std::chrono::steady_clock::now() - startTime;
+
+	ASSERT_EQ(stats.latencies.size(), stats.count);
+
+	std::sort(stats.latencies.begin(), stats.latencies.end());
+	auto const percentile = [&stats](double const p)
+	{
+		auto const index = std::min(stats.latencies.size() - 1u, static_cast<size_t>(p * stats.latencies.size()));
+		return std::chrono::duration_cast<std::chrono::microseconds>(stats.latencies[index]).count();
+	};
+	auto const jobsPerSecond = static_cast<double>(stats.count) / std::chrono::duration<double>(duration).count();
+	std::printf("%-9s producers=%zu: %10.0f jobs/s, latency p50=%lldus p99=%lldus p99.9=%lldus max=%lldus\n", executorName, producersCount, jobsPerSecond, static_cast<long long>(percentile(0.5)), static_cast<long long>(percentile(0.99)), static_cast<long long>(percentile(0.999)), static_cast<long long>(percentile(1.0)));
+}
+} // namespace
+
+TEST(ExecutorBenchmark, DISABLED_MultipleProducers)
+{
+	static constexpr auto JobsCount = size_t{ 400000u };
+
+	for (auto const producersCount : { size_t{ 1u }, size_t{ 2u }, size_t{ 4u }, size_t{ 8u } })
+	{
+		{
+			auto const executor = la::avdecc::ExecutorWithDispatchQueue::create("Benchmark", la::avdecc::utils::ThreadPriority::Highest);
+			measureLatency("Locked", executor, producersCount, JobsCount / producersCount);
+		}
+		{
+			auto const executor = la::avdecc::ExecutorWithLockFreeDispatchQueue::create("Benchmark", la::avdecc::utils::ThreadPriority::Highest);
+			measureLatency("LockFree", executor, producersCount, JobsCount / producersCount);
+		}
+	}
+}
@@ -0,0 +1,106 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @file protocolInterface_benchmarks.cpp
+* @author Christophe Calmejane
+*/
+
+// Benchmarks are disabled by default, run them using --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+
+// Public API
+#include <la/avdecc/executor.hpp>
+#include <la/avdecc/internals/protocolAdpdu.hpp>
+
+// Internal API
+#include "protocolInterface/protocolInterface_virtual.hpp"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+namespace
+{
+/** Sends a burst of messages between 2 virtual interfaces and returns the time it took for all of them to be processed by the receiver */
+std::chrono::nanoseconds measureIngress(std::uint32_t const maxFrames, std::chrono::microseconds const maxDelay, size_t const messagesCount)
+{
+	class Observer : public la::avdecc::protocol::ProtocolInterface::Observer
+	{
+	public:
+		size_t getReceivedCount() const noexcept
+		{
+			return _receivedCount;
+		}
+
+	private:
+		virtual void onAdpduReceived(la::avdecc::protocol::ProtocolInterface* const /*pi*/, la::avdecc::protocol::Adpdu const& /*adpdu*/) noexcept override
+		{
+			++_receivedCount;
+		}
+		std::atomic<size_t> _receivedCount{ 0u };
+		DECLARE_AVDECC_OBSERVER_GUARD(Observer);
+	};
+
+	auto obs = Observer{};
+	auto intfc1 = std::unique_ptr<la::avdecc::protocol::ProtocolInterfaceVirtual>(la::avdecc::protocol::ProtocolInterfaceVirtual::createRawProtocolInterfaceVirtual("BenchmarkInterface", { { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05 } }));
+	auto intfc2 = std::unique_ptr<la::avdecc::protocol::ProtocolInterfaceVirtual>(la::avdecc::protocol::ProtocolInterfaceVirtual::createRawProtocolInterfaceVirtual("BenchmarkInterface", { { 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b } }));
+	intfc2->registerObserver(&obs);
+	intfc2->setIngressBatching(maxFrames, maxDelay);
+
+	// Build an EntityDiscover adpdu (not changing the state of the receiving interface)
+	auto adpdu = la::avdecc::protocol::Adpdu{};
+	adpdu.setSrcAddress(intfc1->getMacAddress());
+	adpdu.setDestAddress(la::avdecc::protocol::Adpdu::Multicast_Mac_Address);
+	adpdu.setMessageType(la::avdecc::protocol::AdpMessageType::EntityDiscover);
+	adpdu.setEntityID(la::avdecc::UniqueIdentifier::getNullUniqueIdentifier());
+
+	auto const startTime = std::chrono::steady_clock::now();
+	for (auto i = size_t{ 0u }; i < messagesCount; ++i)
+	{
+		intfc1->sendAdpMessage(adpdu);
+	}
+	auto const timeout = startTime + std::chrono::seconds(30);
+	while (obs.getReceivedCount() < messagesCount && std::chrono::steady_clock::now() < timeout)
+	{
+		std::this_thread::yield();
+	}
+	auto const duration = std::chrono::steady_clock::now() - startTime;
+
+	EXPECT_EQ(messagesCount, obs.getReceivedCount());
+
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(duration);
+}
+} // namespace
+
+TEST(ProtocolInterfaceBenchmark, DISABLED_IngressBatching)
+{
+	static constexpr auto MessagesCount = size_t{ 200000u };
+
+	auto const executorWrapper = la::avdecc::ExecutorManager::getInstance().registerExecutor(la::avdecc::protocol::ProtocolInterface::DefaultExecutorName, la::avdecc::ExecutorWithDispatchQueue::create(la::avdecc::protocol::ProtocolInterface::DefaultExecutorName, la::avdecc::utils::ThreadPriority::Highest));
+
+	for (auto const maxFrames : { 1u, 8u, 32u, la::avdecc::protocol::ProtocolInterface::MaximumIngressBatchFrames })
+	{
+		auto const duration = measureIngress(maxFrames, std::chrono::microseconds{ 500 }, MessagesCount);
+		auto const perMessage = static_cast<double>(duration.count()) / MessagesCount;
+		std::printf("IngressBatching maxFrames=%2u: %8.1f ns/message, %10.0f messages/s\n", static_cast<unsigned>(maxFrames), perMessage, 1e9 / perMessage);
+	}
+}
@@ -0,0 +1,291 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @file protocol_benchmarks.cpp
+* @author Christophe Calmejane
+*/
+
+// Benchmarks are disabled by default, run them using --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+
+// Public API
+#include <la/avdecc/internals/protocolAemAecpdu.hpp>
+#include <la/avdecc/internals/protocolAdpdu.hpp>
+#include <la/avdecc/internals/protocolAcmpdu.hpp>
+
+// Internal API
+#include "protocol/protocolAemPayloads.hpp"
+#include "protocol/protocolAemPayloadViews.hpp"
+#include "protocol/protocolDispatchTable.hpp"
+#include "../allocationCounter.hpp"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <set>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+/** Creates and destroys 'windowSize' PDUs at a time (like commands waiting for their response), returns the mean time and allocations count per PDU */
+template<typename CreateMethod>
+std::pair<double, double> measureCreateDestroy(size_t const windowSize, CreateMethod&& create)
+{
+	static constexpr auto Iterations = size_t{ 200000u };
+
+	using PointerType = decltype(create());
+	auto window = std::vector<PointerType>{};
+	window.reserve(windowSize);
+
+	// Warmup
+	for (auto i = size_t{ 0u }; i < windowSize; ++i)
+	{
+		window.push_back(create());
+	}
+	window.clear();
+
+	allocationCounter::reset();
+	allocationCounter::setCountingEnabled(true);
+	auto const start = std::chrono::steady_clock::now();
+	for (auto i = size_t{ 0u }; i < Iterations; i += windowSize)
+	{
+		for (auto j = size_t{ 0u }; j < windowSize; ++j)
+		{
+			window.push_back(create());
+		}
+		window.clear();
+	}
+	auto const duration = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	allocationCounter::setCountingEnabled(false);
+
+	return { duration / Iterations, static_cast<double>(allocationCounter::getCount()) / Iterations };
+}
+
+/** Dispatches 'Iterations' messages of the same type, returns the mean time per message */
+template<typename DispatchMethod>
+double measureDispatch(DispatchMethod&& dispatch)
+{
+	static constexpr auto Iterations = size_t{ 2000000u };
+
+	auto const start = std::chrono::steady_clock::now();
+	for (auto i = size_t{ 0u }; i < Iterations; ++i)
+	{
+		dispatch();
+	}
+	auto const duration = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+	return duration / Iterations;
+}
+} // namespace
+
+TEST(ProtocolBenchmark, DISABLED_PduCreateDestroy)
+{
+	for (auto const windowSize : { size_t{ 1u }, size_t{ 64u } })
+	{
+		auto const [aemTime, aemAllocs] = measureCreateDestroy(windowSize,
+			[]()
+			{
+				return la::avdecc::protocol::AemAecpdu::create(false);
+			});
+		auto const [responseTime, responseAllocs] = measureCreateDestroy(windowSize,
+			[command = la::avdecc::protocol::AemAecpdu::create(false)]()
+			{
+				return command->responseCopy();
+			});
+		auto const [adpTime, adpAllocs] = measureCreateDestroy(windowSize,
+			[]()
+			{
+				return la::avdecc::protocol::Adpdu::create();
+			});
+		auto const [acmpTime, acmpAllocs] = measureCreateDestroy(windowSize,
+			[]()
+			{
+				return la::avdecc::protocol::Acmpdu::create();
+			});
+
+		std::printf("PduCreateDestroy window=%2zu: AemAecpdu %6.1f ns (%.2f allocs), AemAecpdu::responseCopy %6.1f ns (%.2f allocs), Adpdu %6.1f ns (%.2f allocs), Acmpdu %6.1f ns (%.2f allocs)\n", windowSize, aemTime, aemAllocs, responseTime, responseAllocs, adpTime, adpAllocs, acmpTime, acmpAllocs);
+	}
+}
+
+namespace
+{
+static auto s_processedSequenceIDs = std::uint64_t{ 0u };
+
+void processAemResponse(la::avdecc::protocol::AemAecpdu const& aem)
+{
+	s_processedSequenceIDs += aem.getSequenceID();
+}
+} // namespace
+
+TEST(ProtocolBenchmark, DISABLED_AemResponseDispatch)
+{
+	using la::avdecc::protocol::AemCommandType;
+	using Handler = void (*)(la::avdecc::protocol::AemAecpdu const& aem);
+
+	auto const commandTypes = std::vector<AemCommandType>{ AemCommandType::AcquireEntity, AemCommandType::ReadDescriptor, AemCommandType::SetStreamFormat, AemCommandType::GetStreamInfo, AemCommandType::SetName, AemCommandType::GetAudioMap, AemCommandType::GetCounters, AemCommandType::GetMemoryObjectLength };
+
+	// Same handlers registered in a hash map of std::function (previous implementation) and in a DispatchTable
+	auto mapDispatch = std::unordered_map<AemCommandType::value_type, std::function<void(la::avdecc::protocol::AemAecpdu const& aem)>>{};
+	for (auto const commandType : commandTypes)
+	{
+		mapDispatch.emplace(commandType.getValue(), &processAemResponse);
+	}
+	auto const tableDispatch = la::avdecc::protocol::DispatchTable<AemCommandType::value_type, Handler, 0x004b>{
+		{ AemCommandType::AcquireEntity.getValue(), &processAemResponse },
+		{ AemCommandType::ReadDescriptor.getValue(), &processAemResponse },
+		{ AemCommandType::SetStreamFormat.getValue(), &processAemResponse },
+		{ AemCommandType::GetStreamInfo.getValue(), &processAemResponse },
+		{ AemCommandType::SetName.getValue(), &processAemResponse },
+		{ AemCommandType::GetAudioMap.getValue(), &processAemResponse },
+		{ AemCommandType::GetCounters.getValue(), &processAemResponse },
+		{ AemCommandType::GetMemoryObjectLength.getValue(), &processAemResponse },
+	};
+
+	auto aem = la::avdecc::protocol::AemAecpdu{ true };
+	aem.setSequenceID(1u);
+	for (auto const commandType : commandTypes)
+	{
+		aem.setCommandType(commandType);
+		auto const mapTime = measureDispatch(
+			[&mapDispatch, &aem]()
+			{
+				auto const it = mapDispatch.find(aem.getCommandType().getValue());
+				if (it != mapDispatch.end())
+				{
+					it->second(aem);
+				}
+			});
+		auto const tableTime = measureDispatch(
+			[&tableDispatch, &aem]()
+			{
+				auto const handler = tableDispatch.find(aem.getCommandType().getValue());
+				if (handler != nullptr)
+				{
+					handler(aem);
+				}
+			});
+
+		std::printf("AemResponseDispatch %-24s: unordered_map<std::function> %5.2f ns, DispatchTable %5.2f ns\n", std::string(commandType).c_str(), mapTime, tableTime);
+	}
+}
+
+TEST(ProtocolBenchmark, DISABLED_ReadDescriptorResponseViews)
+{
+	static constexpr auto CommonSize = la::avdecc::protocol::aemPayload::AecpAemReadCommonDescriptorResponsePayloadSize;
+	auto const Status = static_cast<la::avdecc::protocol::AemAecpStatus>(la::avdecc::protocol::AemAecpStatus::Success);
+
+	// STREAM_INPUT descriptor with 32 formats
+	auto streamSer = la::avdecc::Serializer<la::avdecc::protocol::AemAecpdu::MaximumPayloadBufferLength>{};
+	streamSer << la::avdecc::entity::model::ConfigurationIndex{ 0u } << std::uint16_t{ 0u } << la::avdecc::entity::model::DescriptorType::StreamInput << std::uint16_t{ 0u };
+	streamSer << la::avdecc::entity::model::AvdeccFixedString{ "Stream" } << la::avdecc::entity::model::LocalizedStringReference{} << la::avdecc::entity::model::ClockDomainIndex{ 0u } << la::avdecc::entity::StreamFlags{};
+	streamSer << la::avdecc::entity::model::StreamFormat{ 0x00a0020440000800 } << std::uint16_t{ 132u } << std::uint16_t{ 32u };
+	for (auto i = 0u; i < 4u; ++i)
+	{
+		streamSer << la::avdecc::UniqueIdentifier{} << std::uint16_t{ 0u };
+	}
+	streamSer << la::avdecc::entity::model::AvbInterfaceIndex{ 0u } << std::uint32_t{ 0u };
+	for (auto i = 0u; i < 32u; ++i)
+	{
+		streamSer << la::avdecc::entity::model::StreamFormat{ 0x00a0020440000800 + (std::uint64_t{ i } << 32) };
+	}
+	auto const streamPayload = la::avdecc::protocol::AemAecpdu::Payload{ streamSer.data(), streamSer.usedBytes() };
+
+	// AUDIO_MAP descriptor with 63 mappings
+	auto mapSer = la::avdecc::Serializer<la::avdecc::protocol::AemAecpdu::MaximumPayloadBufferLength>{};
+	mapSer << la::avdecc::entity::model::ConfigurationIndex{ 0u } << std::uint16_t{ 0u } << la::avdecc::entity::model::DescriptorType::AudioMap << std::uint16_t{ 0u };
+	mapSer << std::uint16_t{ 8u } << std::uint16_t{ 63u };
+	for (auto i = std::uint16_t{ 0u }; i < 63u; ++i)
+	{
+		mapSer << std::uint16_t{ 0u } << i << std::uint16_t{ 0u } << i;
+	}
+	auto const mapPayload = la::avdecc::protocol::AemAecpdu::Payload{ mapSer.data(), mapSer.usedBytes() };
+
+	auto sink = size_t{ 0u };
+	auto const streamEager = measureDispatch(
+		[&]()
+		{
+			sink += la::avdecc::protocol::aemPayload::deserializeReadStreamDescriptorResponse(streamPayload, CommonSize, Status).formats.size();
+		});
+	auto const streamView = measureDispatch(
+		[&]()
+		{
+			auto const view = la::avdecc::protocol::aemPayload::StreamDescriptorView{ streamPayload, CommonSize };
+			sink += view.getFormats().size() + static_cast<size_t>(view.getCurrentFormat().getValue() & 0x1);
+		});
+	auto const mapEager = measureDispatch(
+		[&]()
+		{
+			sink += la::avdecc::protocol::aemPayload::deserializeReadAudioMapDescriptorResponse(mapPayload, CommonSize, Status).mappings.size();
+		});
+	auto const mapView = measureDispatch(
+		[&]()
+		{
+			sink += la::avdecc::protocol::aemPayload::AudioMapDescriptorView{ mapPayload, CommonSize }.getMappings().size();
+		});
+
+	std::printf("ReadDescriptorResponse STREAM_INPUT (32 formats): eager %7.1f ns, view %5.1f ns\n", streamEager, streamView);
+	std::printf("ReadDescriptorResponse AUDIO_MAP (63 mappings):   eager %7.1f ns, view %5.1f ns\n", mapEager, mapView);
+	EXPECT_NE(0u, sink);
+}
+
+TEST(ProtocolBenchmark, DISABLED_DescriptorContainers)
+{
+	// Typical STREAM_INPUT descriptor: 8 supported formats
+	auto formats = std::vector<la::avdecc::entity::model::StreamFormat>{};
+	for (auto i = 0u; i < 8u; ++i)
+	{
+		formats.push_back(la::avdecc::entity::model::StreamFormat{ 0x00a0020440000800 + (std::uint64_t{ 7u - i } << 32) });
+	}
+	auto const lookedUpFormat = formats[5];
+
+	auto sink = size_t{ 0u };
+	auto const measure = [&sink](auto const& formats, auto const& lookedUpFormat, auto container)
+	{
+		using Container = decltype(container);
+		allocationCounter::reset();
+		allocationCounter::setCountingEnabled(true);
+		auto const buildTime = measureDispatch(
+			[&]()
+			{
+				auto const c = Container{ formats.begin(), formats.end() };
+				auto const copy = c;
+				sink += copy.size();
+			});
+		allocationCounter::setCountingEnabled(false);
+		auto const allocs = static_cast<double>(allocationCounter::getCount()) / 2000000.0;
+
+		auto const c = Container{ formats.begin(), formats.end() };
+		auto const lookupTime = measureDispatch(
+			[&]()
+			{
+				sink += c.count(lookedUpFormat);
+			});
+		return std::make_tuple(buildTime, allocs, lookupTime);
+	};
+
+	auto const [setBuild, setAllocs, setLookup] = measure(formats, lookedUpFormat, std::set<la::avdecc::entity::model::StreamFormat>{});
+	auto const [flatBuild, flatAllocs, flatLookup] = measure(formats, lookedUpFormat, la::avdecc::entity::model::StreamFormats{});
+
+	std::printf("DescriptorContainers 8 formats build+copy: std::set %6.1f ns (%.2f allocs), StreamFormats %6.1f ns (%.2f allocs)\n", setBuild, setAllocs, flatBuild, flatAllocs);
+	std::printf("DescriptorContainers 8 formats lookup:     std::set %6.1f ns, StreamFormats %6.1f ns\n", setLookup, flatLookup);
+	EXPECT_NE(0u, sink);
+}
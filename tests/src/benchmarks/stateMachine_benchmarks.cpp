@@ -0,0 +1,487 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @file stateMachine_benchmarks.cpp
+* @author Christophe Calmejane
+*/
+
+// Benchmarks are disabled by default, run them using --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+
+// Public API
+#include <la/avdecc/executor.hpp>
+#include <la/avdecc/internals/protocolAdpdu.hpp>
+#include <la/avdecc/internals/protocolAemAecpdu.hpp>
+#include <la/avdecc/internals/serialization.hpp>
+
+// Internal API
+#include "entity/controllerEntityImpl.hpp"
+#include "protocolInterface/protocolInterface_virtual.hpp"
+#include "stateMachine/commandQueue.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+la::avdecc::MemoryBuffer makeEntityAvailableFrame(la::avdecc::UniqueIdentifier const entityID, std::uint8_t const validTime)
+{
+	auto adpdu = la::avdecc::protocol::Adpdu{};
+	// Set Ether2 fields
+	adpdu.setSrcAddress({ 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b });
+	adpdu.setDestAddress(la::avdecc::protocol::Adpdu::Multicast_Mac_Address);
+	// Set ADP fields
+	adpdu.setMessageType(la::avdecc::protocol::AdpMessageType::EntityAvailable);
+	adpdu.setValidTime(validTime);
+	adpdu.setEntityID(entityID);
+	adpdu.setEntityModelID(la::avdecc::UniqueIdentifier::getNullUniqueIdentifier());
+	adpdu.setEntityCapabilities({});
+	adpdu.setTalkerStreamSources(0);
+	adpdu.setTalkerCapabilities({});
+	adpdu.setListenerStreamSinks(0);
+	adpdu.setListenerCapabilities({});
+	adpdu.setControllerCapabilities({});
+	adpdu.setAvailableIndex(1);
+	adpdu.setGptpGrandmasterID(la::avdecc::UniqueIdentifier::getNullUniqueIdentifier());
+	adpdu.setGptpDomainNumber(0);
+	adpdu.setIdentifyControlIndex(0);
+	adpdu.setInterfaceIndex(0);
+	adpdu.setAssociationID(la::avdecc::UniqueIdentifier{});
+
+	auto buffer = la::avdecc::protocol::SerializationBuffer{};
+	la::avdecc::protocol::serialize<la::avdecc::protocol::EtherLayer2>(adpdu, buffer);
+	la::avdecc::protocol::serialize<la::avdecc::protocol::AvtpduControl>(adpdu, buffer);
+	la::avdecc::protocol::serialize<la::avdecc::protocol::Adpdu>(adpdu, buffer);
+
+	return la::avdecc::MemoryBuffer{ buffer.data(), buffer.size() };
+}
+} // namespace
+
+TEST(StateMachineBenchmark, DISABLED_IdleAndTimeoutPrecision)
+{
+	static constexpr auto EntitiesCount = size_t{ 2000u };
+	static constexpr auto ValidTime = std::uint8_t{ 2u }; // Entities will timeout after 2 * ValidTime seconds
+	static constexpr auto IdleMeasureDuration = std::chrono::seconds{ 2 };
+
+	auto const executorWrapper = la::avdecc::ExecutorManager::getInstance().registerExecutor(la::avdecc::protocol::ProtocolInterface::DefaultExecutorName, la::avdecc::ExecutorWithDispatchQueue::create(la::avdecc::protocol::ProtocolInterface::DefaultExecutorName, la::avdecc::utils::ThreadPriority::Highest));
+
+	class Observer : public la::avdecc::protocol::ProtocolInterface::Observer
+	{
+	public:
+		std::vector<std::chrono::steady_clock::duration> getLateness() const noexcept
+		{
+			auto const lg = std::lock_guard{ _lock };
+			return _lateness;
+		}
+
+	private:
+		virtual void onRemoteEntityOnline(la::avdecc::protocol::ProtocolInterface* const /*pi*/, la::avdecc::entity::Entity const& entity) noexcept override
+		{
+			auto const lg = std::lock_guard{ _lock };
+			_expectedOffline[entity.getEntityID()] = std::chrono::steady_clock::now() + std::chrono::seconds{ 2u * ValidTime };
+		}
+		virtual void onRemoteEntityOffline(la::avdecc::protocol::ProtocolInterface* const /*pi*/, la::avdecc::UniqueIdentifier const entityID) noexcept override
+		{
+			auto const now = std::chrono::steady_clock::now();
+			auto const lg = std::lock_guard{ _lock };
+			if (auto const it = _expectedOffline.find(entityID); it != _expectedOffline.end())
+			{
+				_lateness.push_back(now - it->second);
+			}
+		}
+
+		mutable std::mutex _lock{};
+		std::unordered_map<la::avdecc::UniqueIdentifier, std::chrono::steady_clock::time_point, la::avdecc::UniqueIdentifier::hash> _expectedOffline{};
+		std::vector<std::chrono::steady_clock::duration> _lateness{};
+		DECLARE_AVDECC_OBSERVER_GUARD(Observer);
+	};
+
+	auto obs = Observer{};
+	auto intfc = std::unique_ptr<la::avdecc::protocol::ProtocolInterfaceVirtual>(la::avdecc::protocol::ProtocolInterfaceVirtual::createRawProtocolInterfaceVirtual("BenchmarkInterface", { { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05 } }));
+	intfc->registerObserver(&obs);
+	// Disable automatic discovery, we only want to measure the state machines
+	intfc->setAutomaticDiscoveryDelay(std::chrono::milliseconds{ 0 });
+
+	// Discover the entities
+	for (auto i = size_t{ 0u }; i < EntitiesCount; ++i)
+	{
+		intfc->injectRawPacket(makeEntityAvailableFrame(la::avdecc::UniqueIdentifier{ 0x0001020300000000 + i }, ValidTime));
+	}
+	la::avdecc::ExecutorManager::getInstance().flush(la::avdecc::protocol::ProtocolInterface::DefaultExecutorName);
+
+	// Measure the CPU used by the process while nothing happens on the network
+	auto const cpuStart = std::clock();
+	std::this_thread::sleep_for(IdleMeasureDuration);
+	auto const cpuDuration = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+	std::printf("Idle CPU with %zu entities: %.2f%%\n", EntitiesCount, 100.0 * cpuDuration / std::chrono::duration<double>(IdleMeasureDuration).count());
+
+	// Wait for all entities to timeout
+	std::this_thread::sleep_for(std::chrono::seconds{ 2u * ValidTime } - IdleMeasureDuration + std::chrono::seconds{ 1 });
+
+	auto lateness = obs.getLateness();
+	ASSERT_EQ(EntitiesCount, lateness.size());
+
+	std::sort(lateness.begin(), lateness.end());
+	auto const percentile = [&lateness](double const p)
+	{
+		auto const index = std::min(lateness.size() - 1u, static_cast<size_t>(p * lateness.size()));
+		return std::chrono::duration<double, std::milli>(lateness[index]).count();
+	};
+	std::printf("Timeout lateness: p50=%.2fms p99=%.2fms max=%.2fms\n", percentile(0.5), percentile(0.99), percentile(1.0));
+}
+
+TEST(StateMachineBenchmark, DISABLED_CommandsContention)
+{
+	static constexpr auto CommandsPerThread = size_t{ 2000u };
+	static constexpr auto ControllerEntityID = la::avdecc::UniqueIdentifier{ 0x0102030405060708 };
+	static constexpr auto ControllerMacAddress = la::networkInterface::MacAddress{ 0x00, 0x01, 0x02, 0x03, 0x04, 0x05 };
+	static constexpr auto ResponderMacAddress = la::networkInterface::MacAddress{ 0x06, 0x05, 0x04, 0x03, 0x02, 0x01 };
+
+	auto const executorWrapper = la::avdecc::ExecutorManager::getInstance().registerExecutor(la::avdecc::protocol::ProtocolInterface::DefaultExecutorName, la::avdecc::ExecutorWithDispatchQueue::create(la::avdecc::protocol::ProtocolInterface::DefaultExecutorName, la::avdecc::utils::ThreadPriority::Highest));
+
+	// Responder answering all AEM commands, whatever the target entity
+	class Responder final : public la::avdecc::protocol::ProtocolInterface::Observer
+	{
+	private:
+		virtual void onAecpduReceived(la::avdecc::protocol::ProtocolInterface* const pi, la::avdecc::protocol::Aecpdu const& aecpdu) noexcept override
+		{
+			if (aecpdu.getMessageType() != la::avdecc::protocol::AecpMessageType::AemCommand)
+			{
+				return;
+			}
+			auto const& aem = static_cast<la::avdecc::protocol::AemAecpdu const&>(aecpdu);
+			auto response = la::avdecc::protocol::AemAecpdu{ true };
+			response.setSrcAddress(aem.getDestAddress());
+			response.setDestAddress(aem.getSrcAddress());
+			response.setStatus(la::avdecc::protocol::AecpStatus::Success);
+			response.setTargetEntityID(aem.getTargetEntityID());
+			response.setControllerEntityID(aem.getControllerEntityID());
+			response.setSequenceID(aem.getSequenceID());
+			response.setUnsolicited(false);
+			response.setCommandType(aem.getCommandType());
+			pi->sendAecpMessage(response);
+		}
+		DECLARE_AVDECC_OBSERVER_GUARD(Responder);
+	};
+
+	auto responder = Responder{};
+	auto responderInterface = std::unique_ptr<la::avdecc::protocol::ProtocolInterfaceVirtual>(la::avdecc::protocol::ProtocolInterfaceVirtual::createRawProtocolInterfaceVirtual("ContentionInterface", ResponderMacAddress));
+	responderInterface->registerObserver(&responder);
+
+	// Controller sending the commands
+	auto controllerInterface = std::unique_ptr<la::avdecc::protocol::ProtocolInterfaceVirtual>(la::avdecc::protocol::ProtocolInterfaceVirtual::createRawProtocolInterfaceVirtual("ContentionInterface", ControllerMacAddress));
+	controllerInterface->setAutomaticDiscoveryDelay(std::chrono::milliseconds{ 0 });
+	auto const commonInformation = la::avdecc::entity::Entity::CommonInformation{ ControllerEntityID, la::avdecc::UniqueIdentifier{ 0x1122334455667788 }, la::avdecc::entity::EntityCapabilities{}, 0u, la::avdecc::entity::TalkerCapabilities{}, 0u, la::avdecc::entity::ListenerCapabilities{}, la::avdecc::entity::ControllerCapabilities{ la::avdecc::entity::ControllerCapability::Implemented }, std::nullopt, std::nullopt };
+	auto const interfaceInfo = la::avdecc::entity::Entity::InterfaceInformation{ ControllerMacAddress, 31u, 0u, std::nullopt, std::nullopt };
+	auto controllerGuard = std::make_unique<la::avdecc::entity::LocalEntityGuard<la::avdecc::entity::ControllerEntityImpl>>(controllerInterface.get(), commonInformation, la::avdecc::entity::Entity::InterfacesInformation{ { la::avdecc::entity::Entity::GlobalAvbInterfaceIndex, interfaceInfo } }, nullptr);
+
+	for (auto const threadsCount : { size_t{ 1u }, size_t{ 2u }, size_t{ 4u }, size_t{ 8u } })
+	{
+		auto const totalCommands = threadsCount * CommandsPerThread;
+		auto completedCommands = std::atomic_size_t{ 0u };
+		auto failedCommands = std::atomic_size_t{ 0u };
+		auto sendDurationNs = std::atomic<std::int64_t>{ 0 }; // Time spent by the controller threads in sendAecpCommand (mostly waiting for locks)
+		auto completedLock = std::mutex{};
+		auto completedCondVar = std::condition_variable{};
+
+		auto const start = std::chrono::steady_clock::now();
+
+		// Each thread sends its commands to a different target entity
+		auto threads = std::vector<std::thread>{};
+		for (auto t = size_t{ 0u }; t < threadsCount; ++t)
+		{
+			threads.emplace_back(
+				[&, t]()
+				{
+					auto const targetEntityID = la::avdecc::UniqueIdentifier{ 0x0001020300000000 + t };
+					for (auto i = size_t{ 0u }; i < CommandsPerThread; ++i)
+					{
+						auto aecpdu = la::avdecc::protocol::AemAecpdu::create(false);
+						auto& aem = static_cast<la::avdecc::protocol::AemAecpdu&>(*aecpdu);
+						aem.setSrcAddress(ControllerMacAddress);
+						aem.setDestAddress(ResponderMacAddress);
+						aem.setStatus(la::avdecc::protocol::AecpStatus::Success);
+						aem.setTargetEntityID(targetEntityID);
+						aem.setControllerEntityID(ControllerEntityID);
+						aem.setUnsolicited(false);
+						aem.setCommandType(la::avdecc::protocol::AemCommandType::EntityAvailable);
+						auto const sendStart = std::chrono::steady_clock::now();
+						controllerInterface->sendAecpCommand(std::move(aecpdu),
+							[&](la::avdecc::protocol::Aecpdu const* const /*response*/, la::avdecc::protocol::ProtocolInterface::Error const error)
+							{
+								if (!!error)
+								{
+									++failedCommands;
+								}
+								if (++completedCommands == totalCommands)
+								{
+									auto const lg = std::lock_guard{ completedLock };
+									completedCondVar.notify_all();
+								}
+							});
+						sendDurationNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - sendStart).count();
+					}
+				});
+		}
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		// Wait for all responses
+		{
+			auto lock = std::unique_lock{ completedLock };
+			ASSERT_TRUE(completedCondVar.wait_for(lock, std::chrono::seconds{ 60 },
+				[&]()
+				{
+					return completedCommands == totalCommands;
+				}));
+		}
+
+		auto const duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::printf("Commands contention threads=%zu: %8.0f commands/s, %8.2f us/sendAecpCommand (%zu timed out)\n", threadsCount, totalCommands / duration, sendDurationNs.load() / 1000.0 / totalCommands, failedCommands.load());
+	}
+}
+
+TEST(StateMachineBenchmark, DISABLED_AdaptiveInflightWindow)
+{
+	static constexpr auto CommandsCount = size_t{ 500u };
+	static constexpr auto ResponseLatency = std::chrono::milliseconds{ 5 }; // Time the entity takes to process each command (commands are processed concurrently)
+	static constexpr auto ControllerEntityID = la::avdecc::UniqueIdentifier{ 0x0102030405060708 };
+	static constexpr auto ControllerMacAddress = la::networkInterface::MacAddress{ 0x00, 0x01, 0x02, 0x03, 0x04, 0x05 };
+	static constexpr auto ResponderMacAddress = la::networkInterface::MacAddress{ 0x06, 0x05, 0x04, 0x03, 0x02, 0x01 };
+
+	auto const executorWrapper = la::avdecc::ExecutorManager::getInstance().registerExecutor(la::avdecc::protocol::ProtocolInterface::DefaultExecutorName, la::avdecc::ExecutorWithDispatchQueue::create(la::avdecc::protocol::ProtocolInterface::DefaultExecutorName, la::avdecc::utils::ThreadPriority::Highest));
+
+	// Responder answering all AEM commands after ResponseLatency (from its own thread, so the dispatch thread is not blocked)
+	class Responder final : public la::avdecc::protocol::ProtocolInterface::Observer
+	{
+	public:
+		Responder(la::avdecc::protocol::ProtocolInterface& pi)
+			: _pi{ pi }
+			, _thread{ [this]()
+					{
+						run();
+					} }
+		{
+		}
+		~Responder() noexcept
+		{
+			{
+				auto const lg = std::lock_guard{ _lock };
+				_shouldTerminate = true;
+			}
+			_condVar.notify_all();
+			_thread.join();
+		}
+
+	private:
+		void run() noexcept
+		{
+			auto lock = std::unique_lock{ _lock };
+			while (!_shouldTerminate)
+			{
+				if (_pending.empty())
+				{
+					_condVar.wait(lock);
+					continue;
+				}
+				auto const dueTime = _pending.front().first;
+				if (std::chrono::steady_clock::now() < dueTime)
+				{
+					_condVar.wait_until(lock, dueTime);
+					continue;
+				}
+				auto response = std::move(_pending.front().second);
+				_pending.erase(_pending.begin());
+				lock.unlock();
+				_pi.sendAecpMessage(response);
+				lock.lock();
+			}
+		}
+		virtual void onAecpduReceived(la::avdecc::protocol::ProtocolInterface* const /*pi*/, la::avdecc::protocol::Aecpdu const& aecpdu) noexcept override
+		{
+			if (aecpdu.getMessageType() != la::avdecc::protocol::AecpMessageType::AemCommand)
+			{
+				return;
+			}
+			auto const& aem = static_cast<la::avdecc::protocol::AemAecpdu const&>(aecpdu);
+			auto response = la::avdecc::protocol::AemAecpdu{ true };
+			response.setSrcAddress(aem.getDestAddress());
+			response.setDestAddress(aem.getSrcAddress());
+			response.setStatus(la::avdecc::protocol::AecpStatus::Success);
+			response.setTargetEntityID(aem.getTargetEntityID());
+			response.setControllerEntityID(aem.getControllerEntityID());
+			response.setSequenceID(aem.getSequenceID());
+			response.setUnsolicited(false);
+			response.setCommandType(aem.getCommandType());
+			{
+				auto const lg = std::lock_guard{ _lock };
+				_pending.emplace_back(std::chrono::steady_clock::now() + ResponseLatency, std::move(response));
+			}
+			_condVar.notify_all();
+		}
+		DECLARE_AVDECC_OBSERVER_GUARD(Responder);
+
+		la::avdecc::protocol::ProtocolInterface& _pi;
+		std::mutex _lock{};
+		std::condition_variable _condVar{};
+		std::vector<std::pair<std::chrono::steady_clock::time_point, la::avdecc::protocol::AemAecpdu>> _pending{};
+		bool _shouldTerminate{ false };
+		std::thread _thread{};
+	};
+
+	auto responderInterface = std::unique_ptr<la::avdecc::protocol::ProtocolInterfaceVirtual>(la::avdecc::protocol::ProtocolInterfaceVirtual::createRawProtocolInterfaceVirtual("InflightWindowInterface", ResponderMacAddress));
+	auto responder = Responder{ *responderInterface };
+	responderInterface->registerObserver(&responder);
+
+	// Controller sending the commands
+	auto controllerInterface = std::unique_ptr<la::avdecc::protocol::ProtocolInterfaceVirtual>(la::avdecc::protocol::ProtocolInterfaceVirtual::createRawProtocolInterfaceVirtual("InflightWindowInterface", ControllerMacAddress));
+	controllerInterface->setAutomaticDiscoveryDelay(std::chrono::milliseconds{ 0 });
+	auto const commonInformation = la::avdecc::entity::Entity::CommonInformation{ ControllerEntityID, la::avdecc::UniqueIdentifier{ 0x1122334455667788 }, la::avdecc::entity::EntityCapabilities{}, 0u, la::avdecc::entity::TalkerCapabilities{}, 0u, la::avdecc::entity::ListenerCapabilities{}, la::avdecc::entity::ControllerCapabilities{ la::avdecc::entity::ControllerCapability::Implemented }, std::nullopt, std::nullopt };
+	auto const interfaceInfo = la::avdecc::entity::Entity::InterfaceInformation{ ControllerMacAddress, 31u, 0u, std::nullopt, std::nullopt };
+	auto controllerGuard = std::make_unique<la::avdecc::entity::LocalEntityGuard<la::avdecc::entity::ControllerEntityImpl>>(controllerInterface.get(), commonInformation, la::avdecc::entity::Entity::InterfacesInformation{ { la::avdecc::entity::Entity::GlobalAvbInterfaceIndex, interfaceInfo } }, nullptr);
+
+	for (auto const maxInflight : { std::uint32_t{ 1u }, std::uint32_t{ 4u }, la::avdecc::protocol::ProtocolInterface::DefaultMaxAecpInflightCommands, std::uint32_t{ 32u } })
+	{
+		ASSERT_EQ(la::avdecc::protocol::ProtocolInterface::Error::NoError, controllerInterface->setMaxAecpInflightCommands(maxInflight));
+		auto const targetEntityID = la::avdecc::UniqueIdentifier{ 0x0001020300000000 + maxInflight }; // Use a different target for each run, so its inflight window starts from scratch
+
+		auto completedCommands = std::atomic_size_t{ 0u };
+		auto failedCommands = std::atomic_size_t{ 0u };
+		auto completedLock = std::mutex{};
+		auto completedCondVar = std::condition_variable{};
+
+		auto const start = std::chrono::steady_clock::now();
+
+		// Queue all the commands at once, like an enumeration of an entity with hundreds of descriptors
+		for (auto i = size_t{ 0u }; i < CommandsCount; ++i)
+		{
+			auto aecpdu = la::avdecc::protocol::AemAecpdu::create(false);
+			auto& aem = static_cast<la::avdecc::protocol::AemAecpdu&>(*aecpdu);
+			aem.setSrcAddress(ControllerMacAddress);
+			aem.setDestAddress(ResponderMacAddress);
+			aem.setStatus(la::avdecc::protocol::AecpStatus::Success);
+			aem.setTargetEntityID(targetEntityID);
+			aem.setControllerEntityID(ControllerEntityID);
+			aem.setUnsolicited(false);
+			aem.setCommandType(la::avdecc::protocol::AemCommandType::EntityAvailable);
+			controllerInterface->sendAecpCommand(std::move(aecpdu),
+				[&](la::avdecc::protocol::Aecpdu const* const /*response*/, la::avdecc::protocol::ProtocolInterface::Error const error)
+				{
+					if (!!error)
+					{
+						++failedCommands;
+					}
+					if (++completedCommands == CommandsCount)
+					{
+						auto const lg = std::lock_guard{ completedLock };
+						completedCondVar.notify_all();
+					}
+				});
+		}
+
+		// Wait for all responses
+		{
+			auto lock = std::unique_lock{ completedLock };
+			ASSERT_TRUE(completedCondVar.wait_for(lock, std::chrono::seconds{ 60 },
+				[&]()
+				{
+					return completedCommands == CommandsCount;
+				}));
+		}
+
+		auto const duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::printf("Adaptive inflight window maxInflight=%2u: %6.0f msec for %zu commands, %6.0f commands/s (%zu timed out)\n", maxInflight, duration * 1000.0, CommandsCount, CommandsCount / duration, failedCommands.load());
+	}
+}
+
+TEST(StateMachineBenchmark, DISABLED_InflightCommandsContainer)
+{
+	static constexpr auto Iterations = size_t{ 1000000u };
+
+	struct CommandInfo
+	{
+		std::uint16_t sequenceID{ 0u };
+		std::chrono::steady_clock::time_point timeoutTime{};
+		std::function<void()> resultHandler{};
+	};
+
+	// Simulate the inflight commands of a target: a window of commands, the oldest one being matched with its response and replaced with a new one
+	auto const run = [](auto const windowSize, auto& container, auto&& push, auto&& matchAndErase)
+	{
+		auto nextSequenceID = std::uint16_t{ 0u };
+		for (auto i = 0u; i < windowSize; ++i)
+		{
+			push(container, CommandInfo{ nextSequenceID++ });
+		}
+		auto const start = std::chrono::steady_clock::now();
+		for (auto i = size_t{ 0u }; i < Iterations; ++i)
+		{
+			matchAndErase(container, static_cast<std::uint16_t>(nextSequenceID - windowSize));
+			push(container, CommandInfo{ nextSequenceID++ });
+		}
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / Iterations;
+	};
+
+	for (auto const windowSize : { 1u, 10u, 64u })
+	{
+		auto list = std::list<CommandInfo>{};
+		auto const listDuration = run(
+			windowSize, list,
+			[](auto& l, CommandInfo&& command)
+			{
+				l.push_back(std::move(command));
+			},
+			[](auto& l, std::uint16_t const sequenceID)
+			{
+				auto it = std::find_if(l.begin(), l.end(),
+					[sequenceID](CommandInfo const& command)
+					{
+						return command.sequenceID == sequenceID;
+					});
+				l.erase(it);
+			});
+
+		auto queue = la::avdecc::protocol::stateMachine::CommandQueue<CommandInfo>{};
+		auto const queueDuration = run(
+			windowSize, queue,
+			[](auto& q, CommandInfo&& command)
+			{
+				q.push_back(std::move(command));
+			},
+			[](auto& q, std::uint16_t const sequenceID)
+			{
+				q.erase(sequenceID);
+			});
+
+		std::printf("Inflight commands window=%2u: std::list %6.1f ns/command, CommandQueue %6.1f ns/command\n", windowSize, listDuration, queueDuration);
+	}
+}
@@ -22,7 +22,241 @@
 * @author Christophe Calmejane
 */
 
+// Public API
+#include <la/avdecc/executor.hpp>
+#include <la/avdecc/internals/protocolAemAecpdu.hpp>
+
 // Internal API
 #include "stateMachine/commandStateMachine.hpp"
+#include "stateMachine/commandQueue.hpp"
+#include "entity/controllerEntityImpl.hpp"
+#include "protocolInterface/protocolInterface_virtual.hpp"
 
 #include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+struct TestCommandInfo
+{
+	std::uint16_t sequenceID{ 0u };
+	std::unique_ptr<int> payload{}; // Move-only resource, to check it's released when the command is removed
+};
+using TestCommandQueue = la::avdecc::protocol::stateMachine::CommandQueue<TestCommandInfo>;
+} // namespace
+
+TEST(CommandQueue, FifoOrder)
+{
+	auto queue = TestCommandQueue{};
+	EXPECT_TRUE(queue.empty());
+
+	for (auto i = std::uint16_t{ 0u }; i < 20u; ++i)
+	{
+		queue.push_back(TestCommandInfo{ i, std::make_unique<int>(i) });
+	}
+	EXPECT_EQ(20u, queue.size());
+
+	for (auto i = std::uint16_t{ 0u }; i < 20u; ++i)
+	{
+		ASSERT_FALSE(queue.empty());
+		EXPECT_EQ(i, queue.front().sequenceID);
+		EXPECT_EQ(i, *queue.front().payload);
+		queue.pop_front();
+	}
+	EXPECT_TRUE(queue.empty());
+}
+
+TEST(CommandQueue, FindAndErase)
+{
+	auto queue = TestCommandQueue{};
+
+	// Sequence IDs wrapping around, and colliding in the buckets
+	for (auto const sequenceID : { std::uint16_t{ 0xFFFE }, std::uint16_t{ 0xFFFF }, std::uint16_t{ 0u }, std::uint16_t{ 1u }, std::uint16_t{ 8u }, std::uint16_t{ 16u } })
+	{
+		queue.push_back(TestCommandInfo{ sequenceID, std::make_unique<int>(sequenceID) });
+	}
+
+	EXPECT_EQ(nullptr, queue.find(2u));
+	auto* const command = queue.find(16u);
+	ASSERT_NE(nullptr, command);
+	EXPECT_EQ(16, *command->payload);
+
+	// Erase from the middle, the head and the tail
+	queue.erase(8u);
+	queue.erase(0xFFFE);
+	queue.erase(16u);
+	queue.erase(2u); // Not found, no effect
+	EXPECT_EQ(3u, queue.size());
+	EXPECT_EQ(nullptr, queue.find(8u));
+	EXPECT_EQ(nullptr, queue.find(0xFFFE));
+	EXPECT_EQ(nullptr, queue.find(16u));
+
+	// Remaining commands are still in order
+	auto expected = std::vector<std::uint16_t>{ 0xFFFF, 0u, 1u };
+	for (auto const sequenceID : expected)
+	{
+		ASSERT_NE(nullptr, queue.find(sequenceID));
+		EXPECT_EQ(sequenceID, queue.front().sequenceID);
+		queue.pop_front();
+	}
+	EXPECT_TRUE(queue.empty());
+}
+
+TEST(CommandQueue, SlotsReused)
+{
+	auto queue = TestCommandQueue{};
+
+	// Simulate a steady flow of commands (never more than 4 at once), each slot being recycled
+	auto nextSequenceID = std::uint16_t{ 0u };
+	for (auto i = 0u; i < 4u; ++i)
+	{
+		queue.push_back(TestCommandInfo{ nextSequenceID++, std::make_unique<int>(0) });
+	}
+	for (auto i = 0u; i < 1000u; ++i)
+	{
+		auto const oldest = queue.front().sequenceID;
+		queue.erase(oldest);
+		queue.push_back(TestCommandInfo{ nextSequenceID++, std::make_unique<int>(0) });
+		EXPECT_EQ(4u, queue.size());
+		EXPECT_EQ(static_cast<std::uint16_t>(oldest + 1u), queue.front().sequenceID);
+		EXPECT_NE(nullptr, queue.find(static_cast<std::uint16_t>(nextSequenceID - 1u)));
+	}
+}
+
+namespace
+{
+static constexpr auto ControllerEntityID = la::avdecc::UniqueIdentifier{ 0x0102030405060708 };
+static constexpr auto TargetEntityID = la::avdecc::UniqueIdentifier{ 0x0001020304050607 };
+static constexpr auto ControllerMacAddress = la::networkInterface::MacAddress{ 0x00, 0x01, 0x02, 0x03, 0x04, 0x05 };
+static constexpr auto TargetMacAddress = la::networkInterface::MacAddress{ 0x06, 0x05, 0x04, 0x03, 0x02, 0x01 };
+
+// Target receiving the commands, only responding when asked to
+class InflightWindowTarget final : public la::avdecc::protocol::ProtocolInterface::Observer
+{
+public:
+	size_t getReceivedCommands() const noexcept
+	{
+		auto const lg = std::lock_guard{ _lock };
+		return _receivedCommands;
+	}
+
+	/** Responds to all the commands received so far */
+	void respondToPendingCommands(la::avdecc::protocol::ProtocolInterface& pi) noexcept
+	{
+		auto pendingCommands = decltype(_pendingCommands){};
+		{
+			auto const lg = std::lock_guard{ _lock };
+			pendingCommands.swap(_pendingCommands);
+		}
+		for (auto const& command : pendingCommands)
+		{
+			auto response = la::avdecc::protocol::AemAecpdu{ true };
+			response.setSrcAddress(TargetMacAddress);
+			response.setDestAddress(ControllerMacAddress);
+			response.setStatus(la::avdecc::protocol::AecpStatus::Success);
+			response.setTargetEntityID(TargetEntityID);
+			response.setControllerEntityID(ControllerEntityID);
+			response.setSequenceID(command.first);
+			response.setUnsolicited(false);
+			response.setCommandType(command.second);
+			pi.sendAecpMessage(response);
+		}
+	}
+
+private:
+	virtual void onAecpduReceived(la::avdecc::protocol::ProtocolInterface* const /*pi*/, la::avdecc::protocol::Aecpdu const& aecpdu) noexcept override
+	{
+		if (aecpdu.getMessageType() == la::avdecc::protocol::AecpMessageType::AemCommand)
+		{
+			auto const& aem = static_cast<la::avdecc::protocol::AemAecpdu const&>(aecpdu);
+			auto const lg = std::lock_guard{ _lock };
+			++_receivedCommands;
+			_pendingCommands.emplace_back(aem.getSequenceID(), aem.getCommandType());
+		}
+	}
+	DECLARE_AVDECC_OBSERVER_GUARD(InflightWindowTarget);
+
+	mutable std::mutex _lock{};
+	size_t _receivedCommands{ 0u };
+	std::vector<std::pair<la::avdecc::protocol::AecpSequenceID, la::avdecc::protocol::AemCommandType>> _pendingCommands{};
+};
+
+void queueEntityAvailableCommands(la::avdecc::protocol::ProtocolInterface& pi, size_t const count)
+{
+	for (auto i = size_t{ 0u }; i < count; ++i)
+	{
+		auto aecpdu = la::avdecc::protocol::AemAecpdu::create(false);
+		auto& aem = static_cast<la::avdecc::protocol::AemAecpdu&>(*aecpdu);
+		aem.setSrcAddress(ControllerMacAddress);
+		aem.setDestAddress(TargetMacAddress);
+		aem.setStatus(la::avdecc::protocol::AecpStatus::Success);
+		aem.setTargetEntityID(TargetEntityID);
+		aem.setControllerEntityID(ControllerEntityID);
+		aem.setUnsolicited(false);
+		aem.setCommandType(la::avdecc::protocol::AemCommandType::EntityAvailable);
+		pi.sendAecpCommand(std::move(aecpdu), nullptr);
+	}
+}
+
+std::unique_ptr<la::avdecc::entity::LocalEntityGuard<la::avdecc::entity::ControllerEntityImpl>> createInflightWindowController(la::avdecc::protocol::ProtocolInterface* const pi)
+{
+	auto const commonInformation = la::avdecc::entity::Entity::CommonInformation{ ControllerEntityID, la::avdecc::UniqueIdentifier{ 0x1122334455667788 }, la::avdecc::entity::EntityCapabilities{}, 0u, la::avdecc::entity::TalkerCapabilities{}, 0u, la::avdecc::entity::ListenerCapabilities{}, la::avdecc::entity::ControllerCapabilities{ la::avdecc::entity::ControllerCapability::Implemented }, std::nullopt, std::nullopt };
+	auto const interfaceInfo = la::avdecc::entity::Entity::InterfaceInformation{ ControllerMacAddress, 31u, 0u, std::nullopt, std::nullopt };
+	return std::make_unique<la::avdecc::entity::LocalEntityGuard<la::avdecc::entity::ControllerEntityImpl>>(pi, commonInformation, la::avdecc::entity::Entity::InterfacesInformation{ { la::avdecc::entity::Entity::GlobalAvbInterfaceIndex, interfaceInfo } }, nullptr);
+}
+} // namespace
+
+/*
+ * The AECP inflight window of a target starts at the default number of inflight commands, the other commands wait for a response
+ */
+TEST(CommandStateMachine, AecpInflightWindowStartsAtDefault)
+{
+	auto const executorWrapper = la::avdecc::ExecutorManager::getInstance().registerExecutor(la::avdecc::protocol::ProtocolInterface::DefaultExecutorName, la::avdecc::ExecutorWithDispatchQueue::create(la::avdecc::protocol::ProtocolInterface::DefaultExecutorName, la::avdecc::utils::ThreadPriority::Highest));
+
+	auto target = InflightWindowTarget{};
+	auto targetInterface = std::unique_ptr<la::avdecc::protocol::ProtocolInterfaceVirtual>(la::avdecc::protocol::ProtocolInterfaceVirtual::createRawProtocolInterfaceVirtual("InflightWindowInterface", TargetMacAddress));
+	targetInterface->registerObserver(&target);
+
+	auto controllerInterface = std::unique_ptr<la::avdecc::protocol::ProtocolInterfaceVirtual>(la::avdecc::protocol::ProtocolInterfaceVirtual::createRawProtocolInterfaceVirtual("InflightWindowInterface", ControllerMacAddress));
+	auto const controllerGuard = createInflightWindowController(controllerInterface.get());
+
+	queueEntityAvailableCommands(*controllerInterface, la::avdecc::protocol::ProtocolInterface::DefaultMaxAecpInflightCommands + 5u);
+
+	// Wait less than the command timeout: only a full window of commands should have been sent, the others wait for a response
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	EXPECT_EQ(la::avdecc::protocol::ProtocolInterface::DefaultMaxAecpInflightCommands, target.getReceivedCommands());
+}
+
+/*
+ * The number of AECP commands inflight for a target grows with its inflight window when it responds in time
+ */
+TEST(CommandStateMachine, AecpInflightCommandsGrowWithWindow)
+{
+	static constexpr auto Ceiling = la::avdecc::protocol::ProtocolInterface::DefaultMaxAecpInflightCommands * 2u;
+
+	auto const executorWrapper = la::avdecc::ExecutorManager::getInstance().registerExecutor(la::avdecc::protocol::ProtocolInterface::DefaultExecutorName, la::avdecc::ExecutorWithDispatchQueue::create(la::avdecc::protocol::ProtocolInterface::DefaultExecutorName, la::avdecc::utils::ThreadPriority::Highest));
+
+	auto target = InflightWindowTarget{};
+	auto targetInterface = std::unique_ptr<la::avdecc::protocol::ProtocolInterfaceVirtual>(la::avdecc::protocol::ProtocolInterfaceVirtual::createRawProtocolInterfaceVirtual("InflightWindowInterface", TargetMacAddress));
+	targetInterface->registerObserver(&target);
+
+	auto controllerInterface = std::unique_ptr<la::avdecc::protocol::ProtocolInterfaceVirtual>(la::avdecc::protocol::ProtocolInterfaceVirtual::createRawProtocolInterfaceVirtual("InflightWindowInterface", ControllerMacAddress));
+	ASSERT_FALSE(!!controllerInterface->setMaxAecpInflightCommands(Ceiling));
+	auto const controllerGuard = createInflightWindowController(controllerInterface.get());
+
+	queueEntityAvailableCommands(*controllerInterface, Ceiling * 3u);
+
+	// First window
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	ASSERT_EQ(la::avdecc::protocol::ProtocolInterface::DefaultMaxAecpInflightCommands, target.getReceivedCommands());
+
+	// Each timely response opens the window by one command (slow start), so it doubles up to the ceiling and the whole window is sent
+	target.respondToPendingCommands(*targetInterface);
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	EXPECT_EQ(la::avdecc::protocol::ProtocolInterface::DefaultMaxAecpInflightCommands + Ceiling, target.getReceivedCommands());
+}
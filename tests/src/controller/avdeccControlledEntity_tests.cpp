@@ -85,6 +85,157 @@ TEST(ControlledEntity, VirtualEntityLoad)
 	}
 }
 
+TEST(ControlledEntity, PerEntityLock)
+{
+	using LockInformation = la::avdecc::controller::ControlledEntityImpl::LockInformation;
+	auto first = LockInformation{};
+	auto second = LockInformation{};
+
+	// Locking an entity does not lock the others
+	first.lock();
+	EXPECT_TRUE(first.isSelfLocked());
+	EXPECT_FALSE(second.isSelfLocked());
+	EXPECT_TRUE(LockInformation::isAnySelfLocked());
+	{
+		auto fut = std::async(std::launch::async,
+			[&second]()
+			{
+				second.lock();
+				auto const isSelfLocked = second.isSelfLocked();
+				second.unlock();
+				return isSelfLocked;
+			});
+		ASSERT_EQ(std::future_status::ready, fut.wait_for(std::chrono::seconds(5)));
+		EXPECT_TRUE(fut.get());
+	}
+
+	// Releasing and restoring all the locks of the thread keeps the locked counts
+	second.lock();
+	second.lock();
+	auto selfLocks = LockInformation::unlockAllSelfLocked();
+	EXPECT_EQ(2u, selfLocks.size());
+	EXPECT_FALSE(LockInformation::isAnySelfLocked());
+	EXPECT_FALSE(first.isSelfLocked());
+	EXPECT_FALSE(second.isSelfLocked());
+	LockInformation::lockAllSelfLocked(std::move(selfLocks));
+	EXPECT_EQ(1u, first._lockedCount);
+	EXPECT_EQ(2u, second._lockedCount);
+
+	second.unlockAll();
+	first.unlock();
+	EXPECT_FALSE(LockInformation::isAnySelfLocked());
+}
+
+TEST(ControlledEntity, PerEntityTryLock)
+{
+	using LockInformation = la::avdecc::controller::ControlledEntityImpl::LockInformation;
+	auto first = LockInformation{};
+	auto second = LockInformation{};
+
+	// Trying to lock an entity held by another thread fails, without releasing the locks already held
+	second.lock();
+	auto fut = std::async(std::launch::async,
+		[&first, &second]()
+		{
+			first.lock();
+			auto const result = !second.tryLock() && first.isSelfLocked() && first._lockedCount == 1u && !second.isSelfLocked();
+			first.unlock();
+			return result;
+		});
+	ASSERT_EQ(std::future_status::ready, fut.wait_for(std::chrono::seconds(5)));
+	EXPECT_TRUE(fut.get());
+
+	// Recursive try lock always succeeds
+	EXPECT_TRUE(second.tryLock());
+	EXPECT_EQ(2u, second._lockedCount);
+	second.unlockAll();
+	EXPECT_FALSE(LockInformation::isAnySelfLocked());
+}
+
+TEST(ControlledEntity, PerEntityLockOrder)
+{
+	using LockInformation = la::avdecc::controller::ControlledEntityImpl::LockInformation;
+	static constexpr auto Iterations = 10000u;
+	auto first = LockInformation{};
+	auto second = LockInformation{};
+
+	// Lock the same entities in opposite orders from 2 threads, then release and restore them: restoring should never deadlock
+	auto const lockBoth = [](LockInformation& outer, LockInformation& inner)
+	{
+		for (auto i = 0u; i < Iterations; ++i)
+		{
+			outer.lock();
+			outer.lock();
+			while (!inner.tryLock())
+			{
+				outer.unlockAll();
+				std::this_thread::yield();
+				outer.lockAll(2u);
+			}
+			LockInformation::lockAllSelfLocked(LockInformation::unlockAllSelfLocked());
+			if (outer._lockedCount != 2u || inner._lockedCount != 1u || !outer.isSelfLocked() || !inner.isSelfLocked())
+			{
+				return false;
+			}
+			inner.unlock();
+			outer.unlockAll();
+		}
+		return true;
+	};
+	auto inOrder = std::async(std::launch::async, lockBoth, std::ref(first), std::ref(second));
+	auto outOfOrder = std::async(std::launch::async, lockBoth, std::ref(second), std::ref(first));
+	ASSERT_EQ(std::future_status::ready, inOrder.wait_for(std::chrono::seconds(30)));
+	ASSERT_EQ(std::future_status::ready, outOfOrder.wait_for(std::chrono::seconds(30)));
+	EXPECT_TRUE(inOrder.get());
+	EXPECT_TRUE(outOfOrder.get());
+}
+
+TEST(ControlledEntity, ConcurrentEnumerationSteps)
+{
+	using EnumerationStep = la::avdecc::controller::ControlledEntityImpl::EnumerationStep;
+	using EnumerationSteps = la::avdecc::controller::ControlledEntityImpl::EnumerationSteps;
+	auto const commonInformation = la::avdecc::entity::Entity::CommonInformation{ la::avdecc::UniqueIdentifier{ 0x0102030405060708 }, la::avdecc::UniqueIdentifier{ 0x1122334455667788 }, la::avdecc::entity::EntityCapabilities{ la::avdecc::entity::EntityCapability::AemSupported }, 0u, la::avdecc::entity::TalkerCapabilities{}, 0u, la::avdecc::entity::ListenerCapabilities{}, la::avdecc::entity::ControllerCapabilities{ la::avdecc::entity::ControllerCapability::Implemented }, std::nullopt, std::nullopt };
+	auto const interfaceInfo = la::avdecc::entity::Entity::InterfaceInformation{ la::networkInterface::MacAddress{}, 31u, 0u, std::nullopt, std::nullopt };
+	auto entity = la::avdecc::controller::ControlledEntityImpl{ la::avdecc::entity::Entity{ commonInformation, la::avdecc::entity::Entity::InterfacesInformation{ { la::avdecc::entity::Entity::GlobalAvbInterfaceIndex, interfaceInfo } } }, std::make_shared<la::avdecc::controller::ControlledEntityImpl::LockInformation>(), false };
+
+	entity.setEnumerationSteps(EnumerationSteps{ EnumerationStep::GetMilanInfo, EnumerationStep::RegisterUnsol, EnumerationStep::GetStaticModel, EnumerationStep::GetDynamicInfo });
+
+	// MilanInfo, unsolicited notifications and static model are retrieved concurrently
+	EXPECT_EQ((EnumerationSteps{ EnumerationStep::GetMilanInfo, EnumerationStep::RegisterUnsol, EnumerationStep::GetStaticModel }), entity.getReadyEnumerationSteps());
+	entity.setEnumerationStepStarted(EnumerationStep::GetMilanInfo);
+	entity.setEnumerationStepStarted(EnumerationStep::RegisterUnsol);
+	entity.setEnumerationStepStarted(EnumerationStep::GetStaticModel);
+	EXPECT_TRUE(entity.getReadyEnumerationSteps().empty());
+
+	// Model found in the cache: descriptors dynamic information will be retrieved
+	entity.addEnumerationStep(EnumerationStep::GetDescriptorDynamicInfo);
+	entity.clearEnumerationStep(EnumerationStep::GetStaticModel);
+	entity.clearEnumerationStep(EnumerationStep::RegisterUnsol);
+	EXPECT_TRUE(entity.getReadyEnumerationSteps().empty());
+
+	// A step that has not been started cannot complete
+	entity.clearEnumerationStep(EnumerationStep::GetDescriptorDynamicInfo);
+	EXPECT_TRUE(entity.getEnumerationSteps().test(EnumerationStep::GetDescriptorDynamicInfo));
+
+	// Descriptors dynamic information and other dynamic information are retrieved concurrently
+	entity.clearEnumerationStep(EnumerationStep::GetMilanInfo);
+	EXPECT_EQ((EnumerationSteps{ EnumerationStep::GetDescriptorDynamicInfo, EnumerationStep::GetDynamicInfo }), entity.getReadyEnumerationSteps());
+	entity.setEnumerationStepStarted(EnumerationStep::GetDescriptorDynamicInfo);
+	entity.setEnumerationStepStarted(EnumerationStep::GetDynamicInfo);
+
+	// Falling back to full static model enumeration restarts dynamic information retrieval once the model is known
+	entity.addEnumerationStep(EnumerationStep::GetStaticModel);
+	entity.addEnumerationStep(EnumerationStep::GetDynamicInfo);
+	entity.clearEnumerationStep(EnumerationStep::GetDescriptorDynamicInfo);
+	EXPECT_EQ(EnumerationSteps{ EnumerationStep::GetStaticModel }, entity.getReadyEnumerationSteps());
+	entity.setEnumerationStepStarted(EnumerationStep::GetStaticModel);
+	entity.clearEnumerationStep(EnumerationStep::GetStaticModel);
+	EXPECT_EQ(EnumerationSteps{ EnumerationStep::GetDynamicInfo }, entity.getReadyEnumerationSteps());
+	entity.setEnumerationStepStarted(EnumerationStep::GetDynamicInfo);
+	entity.clearEnumerationStep(EnumerationStep::GetDynamicInfo);
+	EXPECT_TRUE(entity.getEnumerationSteps().empty());
+}
+
 TEST(ControlledEntity, AddChannelMappings)
 {
 	auto const flags = la::avdecc::entity::model::jsonSerializer::Flags{ la::avdecc::entity::model::jsonSerializer::Flag::IgnoreAEMSanityChecks, la::avdecc::entity::model::jsonSerializer::Flag::ProcessADP, la::avdecc::entity::model::jsonSerializer::Flag::ProcessCompatibility, la::avdecc::entity::model::jsonSerializer::Flag::ProcessDynamicModel, la::avdecc::entity::model::jsonSerializer::Flag::ProcessMilan, la::avdecc::entity::model::jsonSerializer::Flag::ProcessState, la::avdecc::entity::model::jsonSerializer::Flag::ProcessStaticModel, la::avdecc::entity::model::jsonSerializer::Flag::ProcessStatistics };
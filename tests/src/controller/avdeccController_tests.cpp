@@ -30,7 +30,9 @@
 
 // Internal API
 #include "controller/avdeccControlledEntityImpl.hpp"
+#include "controller/avdeccControlledEntityJsonSerializer.hpp"
 #include "controller/avdeccControllerImpl.hpp"
+#include "controller/avdeccEntityModelCache.hpp"
 #include "entity/controllerEntityImpl.hpp"
 #include "protocolInterface/protocolInterface_virtual.hpp"
 
@@ -41,6 +43,13 @@
 #include <future>
 #include <vector>
 #include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <mutex>
+#include <optional>
 
 namespace
 {
@@ -842,3 +851,575 @@ TEST(Controller, InvalidControlValues)
 		ASSERT_FALSE(true) << "ControlNode not found";
 	}
 }
+
+TEST(Controller, EntityModelCachePersistence)
+{
+	auto const flags = la::avdecc::entity::model::jsonSerializer::Flags{ la::avdecc::entity::model::jsonSerializer::Flag::IgnoreAEMSanityChecks, la::avdecc::entity::model::jsonSerializer::Flag::ProcessADP, la::avdecc::entity::model::jsonSerializer::Flag::ProcessCompatibility, la::avdecc::entity::model::jsonSerializer::Flag::ProcessDynamicModel, la::avdecc::entity::model::jsonSerializer::Flag::ProcessMilan, la::avdecc::entity::model::jsonSerializer::Flag::ProcessState, la::avdecc::entity::model::jsonSerializer::Flag::ProcessStaticModel, la::avdecc::entity::model::jsonSerializer::Flag::ProcessStatistics };
+	// Load entity
+	auto controller = la::avdecc::controller::Controller::create(la::avdecc::protocol::ProtocolInterface::Type::Virtual, "VirtualInterface", 0x0001, la::avdecc::UniqueIdentifier{}, "en");
+	auto const [error, message] = controller->loadVirtualEntityFromJson("data/TalkerListener.json", flags);
+	ASSERT_EQ(la::avdecc::jsonSerializer::DeserializationError::NoError, error) << message;
+
+	auto constexpr EntityID = la::avdecc::UniqueIdentifier{ 0x001B92FFFF000003 };
+	auto constexpr EntityModelID = la::avdecc::UniqueIdentifier{ 0x001B92FFFE000003 };
+	auto const& entityTree = static_cast<la::avdecc::controller::ControlledEntityImpl const&>(*controller->getControlledEntityGuard(EntityID)).getEntityTree();
+	auto const filePath = la::avdecc::controller::EntityModelCache::getPersistentFilePath(".", EntityModelID);
+	std::remove(filePath.c_str());
+
+	// Cache the model, it should be written in the background
+	{
+		auto cache = la::avdecc::controller::EntityModelCache{};
+		cache.enableCache();
+		ASSERT_TRUE(cache.enablePersistence("."));
+		cache.cacheEntityTree(EntityModelID, entityTree);
+		cache.flushPersistentStore();
+		ASSERT_TRUE(std::ifstream{ filePath }.is_open());
+	}
+
+	// A new cache (as after a restart) should load the model from the persistent store in the background, when requested
+	{
+		auto cache = la::avdecc::controller::EntityModelCache{};
+		cache.enableCache();
+		ASSERT_TRUE(cache.enablePersistence("."));
+		EXPECT_EQ(nullptr, cache.getCachedEntityTree(EntityModelID));
+		cache.preloadEntityTree(EntityModelID);
+		cache.flushPersistentStore();
+		auto const cachedTree = cache.getCachedEntityTree(EntityModelID);
+		ASSERT_NE(nullptr, cachedTree);
+		EXPECT_EQ(entityTree.staticModel.get().modelNameString, cachedTree->staticModel->modelNameString);
+		ASSERT_EQ(entityTree.configurationTrees.size(), cachedTree->configurationTrees.size());
+		auto const& configTree = entityTree.configurationTrees.at(0u);
+		auto const& cachedConfigTree = cachedTree->configurationTrees.at(0u);
+		EXPECT_EQ(configTree.streamInputModels.size(), cachedConfigTree.streamInputModels.size());
+		EXPECT_EQ(configTree.streamOutputModels.size(), cachedConfigTree.streamOutputModels.size());
+		EXPECT_EQ(configTree.audioUnitModels.size(), cachedConfigTree.audioUnitModels.size());
+		EXPECT_TRUE(la::avdecc::controller::EntityModelCache::isModelValidForConfiguration(cachedConfigTree));
+
+		// Same tree should be returned from memory
+		EXPECT_EQ(cachedTree, cache.getCachedEntityTree(EntityModelID));
+	}
+
+	// Not the expected EntityModelID
+	EXPECT_EQ(nullptr, la::avdecc::controller::EntityModelCache::readPersistentFile(filePath, la::avdecc::UniqueIdentifier{ 0x001B92FFFE000004 }));
+
+	// Corrupt the payload, the checksum should not match anymore
+	{
+		auto fs = std::fstream{ filePath, std::ios::binary | std::ios::in | std::ios::out };
+		ASSERT_TRUE(fs.is_open());
+		fs.seekg(-1, std::ios::end);
+		auto const lastByte = static_cast<char>(fs.get());
+		fs.seekp(-1, std::ios::end);
+		fs.put(static_cast<char>(~lastByte));
+	}
+	EXPECT_EQ(nullptr, la::avdecc::controller::EntityModelCache::readPersistentFile(filePath, EntityModelID));
+
+	std::remove(filePath.c_str());
+}
+
+TEST(Controller, NetworkStateSnapshot)
+{
+	// Statistics are not compared, the enumeration time of loaded virtual entities is measured again
+	auto const flags = la::avdecc::entity::model::jsonSerializer::Flags{ la::avdecc::entity::model::jsonSerializer::Flag::IgnoreAEMSanityChecks, la::avdecc::entity::model::jsonSerializer::Flag::ProcessADP, la::avdecc::entity::model::jsonSerializer::Flag::ProcessCompatibility, la::avdecc::entity::model::jsonSerializer::Flag::ProcessDynamicModel, la::avdecc::entity::model::jsonSerializer::Flag::ProcessMilan, la::avdecc::entity::model::jsonSerializer::Flag::ProcessState, la::avdecc::entity::model::jsonSerializer::Flag::ProcessStaticModel };
+	auto const readFile = [](std::string const& filePath)
+	{
+		return std::string{ std::istreambuf_iterator<char>{ std::ifstream{ filePath, std::ios::binary }.rdbuf() }, std::istreambuf_iterator<char>{} };
+	};
+
+	// Load entities and save them as a snapshot (and as JSON for comparison)
+	{
+		auto controller = la::avdecc::controller::Controller::create(la::avdecc::protocol::ProtocolInterface::Type::Virtual, "VirtualInterface", 0x0001, la::avdecc::UniqueIdentifier{}, "en");
+		{
+			auto const [error, message] = controller->loadVirtualEntityFromJson("data/TalkerListener.json", flags);
+			ASSERT_EQ(la::avdecc::jsonSerializer::DeserializationError::NoError, error) << message;
+		}
+		{
+			auto const [error, message] = controller->loadVirtualEntityFromJson("data/SimpleEntity.json", flags);
+			ASSERT_EQ(la::avdecc::jsonSerializer::DeserializationError::NoError, error) << message;
+		}
+		{
+			auto const [error, message] = controller->serializeAllControlledEntitiesAsSnapshot("NetworkStateSnapshot.avns", flags, "Tests", false);
+			ASSERT_EQ(la::avdecc::jsonSerializer::SerializationError::NoError, error) << message;
+		}
+		{
+			auto const [error, message] = controller->serializeAllControlledEntitiesAsJson("NetworkStateSnapshot_Original.json", flags, "Tests", false);
+			ASSERT_EQ(la::avdecc::jsonSerializer::SerializationError::NoError, error) << message;
+		}
+	}
+
+	// Load the snapshot in a new controller, it should produce the same network state
+	{
+		auto controller = la::avdecc::controller::Controller::create(la::avdecc::protocol::ProtocolInterface::Type::Virtual, "VirtualInterface", 0x0001, la::avdecc::UniqueIdentifier{}, "en");
+		{
+			auto const [error, message] = controller->loadVirtualEntitiesFromSnapshot("NetworkStateSnapshot.avns", flags, false);
+			ASSERT_EQ(la::avdecc::jsonSerializer::DeserializationError::NoError, error) << message;
+		}
+		{
+			auto const [error, message] = controller->serializeAllControlledEntitiesAsJson("NetworkStateSnapshot_Loaded.json", flags, "Tests", false);
+			ASSERT_EQ(la::avdecc::jsonSerializer::SerializationError::NoError, error) << message;
+		}
+		auto const original = readFile("NetworkStateSnapshot_Original.json");
+		EXPECT_FALSE(original.empty());
+		EXPECT_EQ(original, readFile("NetworkStateSnapshot_Loaded.json"));
+
+		// A JSON file is not a valid snapshot
+		{
+			auto const [error, message] = controller->loadVirtualEntitiesFromSnapshot("NetworkStateSnapshot_Original.json", flags, false);
+			EXPECT_EQ(la::avdecc::jsonSerializer::DeserializationError::ParseError, error) << message;
+		}
+	}
+
+	// Truncated and corrupt snapshots are rejected (without trying to allocate the corrupt record size)
+	{
+		auto const snapshot = readFile("NetworkStateSnapshot.avns");
+		ASSERT_GT(snapshot.size(), 16u);
+		{
+			auto ofs = std::ofstream{ "NetworkStateSnapshot_Truncated.avns", std::ios::binary };
+			ofs.write(snapshot.data(), snapshot.size() / 2u);
+		}
+		{
+			// Valid header, followed by a record size larger than the file
+			auto ofs = std::ofstream{ "NetworkStateSnapshot_Corrupt.avns", std::ios::binary };
+			ofs.write(snapshot.data(), 8u);
+			ofs.write("\xFF\xFF\xFF\xF0\x81\xA0\x00", 7u);
+		}
+		auto controller = la::avdecc::controller::Controller::create(la::avdecc::protocol::ProtocolInterface::Type::Virtual, "VirtualInterface", 0x0001, la::avdecc::UniqueIdentifier{}, "en");
+		{
+			auto const [error, message] = controller->loadVirtualEntitiesFromSnapshot("NetworkStateSnapshot_Truncated.avns", flags, false);
+			EXPECT_EQ(la::avdecc::jsonSerializer::DeserializationError::FileReadError, error) << message;
+		}
+		{
+			auto const [error, message] = controller->loadVirtualEntitiesFromSnapshot("NetworkStateSnapshot_Corrupt.avns", flags, false);
+			EXPECT_EQ(la::avdecc::jsonSerializer::DeserializationError::ParseError, error) << message;
+		}
+	}
+
+	std::remove("NetworkStateSnapshot.avns");
+	std::remove("NetworkStateSnapshot_Original.json");
+	std::remove("NetworkStateSnapshot_Loaded.json");
+	std::remove("NetworkStateSnapshot_Truncated.avns");
+	std::remove("NetworkStateSnapshot_Corrupt.avns");
+}
+
+TEST(Controller, SerializeAllControlledEntitiesAsJsonStreamed)
+{
+	auto const flags = la::avdecc::entity::model::jsonSerializer::Flags{ la::avdecc::entity::model::jsonSerializer::Flag::IgnoreAEMSanityChecks, la::avdecc::entity::model::jsonSerializer::Flag::ProcessADP, la::avdecc::entity::model::jsonSerializer::Flag::ProcessCompatibility, la::avdecc::entity::model::jsonSerializer::Flag::ProcessDynamicModel, la::avdecc::entity::model::jsonSerializer::Flag::ProcessMilan, la::avdecc::entity::model::jsonSerializer::Flag::ProcessState, la::avdecc::entity::model::jsonSerializer::Flag::ProcessStaticModel, la::avdecc::entity::model::jsonSerializer::Flag::ProcessStatistics, la::avdecc::entity::model::jsonSerializer::Flag::ProcessDiagnostics };
+	auto controller = la::avdecc::controller::Controller::create(la::avdecc::protocol::ProtocolInterface::Type::Virtual, "VirtualInterface", 0x0001, la::avdecc::UniqueIdentifier{}, "en");
+
+	auto const expectedDump = [&controller, &flags]()
+	{
+		auto object = nlohmann::json{};
+		object["dump_version"] = 1;
+		object["_dump_source (informative)"] = "Tests";
+		auto const entityIDs = std::vector<la::avdecc::UniqueIdentifier>{ la::avdecc::UniqueIdentifier{ 0x001B92FFFF000001 }, la::avdecc::UniqueIdentifier{ 0x001B92FFFF000003 } };
+		for (auto const entityID : entityIDs)
+		{
+			if (auto const entity = controller->getControlledEntityGuard(entityID))
+			{
+				object["entities"].push_back(la::avdecc::controller::jsonSerializer::createJsonObject(static_cast<la::avdecc::controller::ControlledEntityImpl const&>(*entity), flags));
+			}
+		}
+		auto ss = std::stringstream{};
+		ss << std::setw(4) << object << std::endl;
+		return ss.str();
+	};
+	auto const readFile = [](std::string const& filePath)
+	{
+		return std::string{ std::istreambuf_iterator<char>{ std::ifstream{ filePath, std::ios::binary }.rdbuf() }, std::istreambuf_iterator<char>{} };
+	};
+
+	// No entity
+	{
+		auto const [error, message] = controller->serializeAllControlledEntitiesAsJson("StreamedDump.json", flags, "Tests", false);
+		ASSERT_EQ(la::avdecc::jsonSerializer::SerializationError::NoError, error) << message;
+		EXPECT_EQ(expectedDump(), readFile("StreamedDump.json"));
+	}
+
+	// Multiple entities, streamed output should be the same than the full JSON object
+	{
+		auto const [error, message] = controller->loadVirtualEntityFromJson("data/TalkerListener.json", flags);
+		ASSERT_EQ(la::avdecc::jsonSerializer::DeserializationError::NoError, error) << message;
+	}
+	{
+		auto const [error, message] = controller->loadVirtualEntityFromJson("data/SimpleEntity.json", flags);
+		ASSERT_EQ(la::avdecc::jsonSerializer::DeserializationError::NoError, error) << message;
+	}
+	{
+		auto const [error, message] = controller->serializeAllControlledEntitiesAsJson("StreamedDump.json", flags, "Tests", false);
+		ASSERT_EQ(la::avdecc::jsonSerializer::SerializationError::NoError, error) << message;
+		EXPECT_EQ(expectedDump(), readFile("StreamedDump.json"));
+	}
+
+	std::remove("StreamedDump.json");
+}
+
+TEST(Controller, ControlledEntitySnapshot)
+{
+	auto const flags = la::avdecc::entity::model::jsonSerializer::Flags{ la::avdecc::entity::model::jsonSerializer::Flag::IgnoreAEMSanityChecks, la::avdecc::entity::model::jsonSerializer::Flag::ProcessADP, la::avdecc::entity::model::jsonSerializer::Flag::ProcessCompatibility, la::avdecc::entity::model::jsonSerializer::Flag::ProcessDynamicModel, la::avdecc::entity::model::jsonSerializer::Flag::ProcessMilan, la::avdecc::entity::model::jsonSerializer::Flag::ProcessState, la::avdecc::entity::model::jsonSerializer::Flag::ProcessStaticModel, la::avdecc::entity::model::jsonSerializer::Flag::ProcessStatistics };
+	auto controller = la::avdecc::controller::Controller::create(la::avdecc::protocol::ProtocolInterface::Type::Virtual, "VirtualInterface", 0x0001, la::avdecc::UniqueIdentifier{}, "en");
+	{
+		auto const [error, message] = controller->loadVirtualEntityFromJson("data/SimpleEntity.json", flags);
+		ASSERT_EQ(la::avdecc::jsonSerializer::DeserializationError::NoError, error) << message;
+	}
+
+	auto constexpr EntityID = la::avdecc::UniqueIdentifier{ 0x001B92FFFF000001 };
+
+	// Unknown entity
+	EXPECT_EQ(nullptr, controller->getControlledEntitySnapshot(la::avdecc::UniqueIdentifier{ 0x0102030405060708 }));
+
+	// Initial snapshot
+	auto const snapshot = controller->getControlledEntitySnapshot(EntityID);
+	ASSERT_NE(nullptr, snapshot);
+	EXPECT_EQ(EntityID, snapshot->entity.getEntityID());
+	EXPECT_TRUE(snapshot->isVirtual);
+	ASSERT_FALSE(snapshot->entityTree.configurationTrees.empty());
+	auto const entityName = snapshot->entityTree.dynamicModel.entityName;
+
+	// No update, same snapshot
+	EXPECT_EQ(snapshot, controller->getControlledEntitySnapshot(EntityID));
+
+	// Reading a snapshot never waits for the entity lock
+	{
+		auto const guard = controller->getControlledEntityGuard(EntityID);
+		ASSERT_TRUE(!!guard);
+		auto fut = std::async(std::launch::async,
+			[&controller, EntityID]()
+			{
+				return controller->getControlledEntitySnapshot(EntityID);
+			});
+		ASSERT_EQ(std::future_status::ready, fut.wait_for(std::chrono::seconds(1)));
+		EXPECT_EQ(snapshot, fut.get());
+	}
+
+	// Update the entity and publish a new snapshot
+	{
+		auto guard = controller->getControlledEntityGuard(EntityID);
+		auto& entity = const_cast<la::avdecc::controller::ControlledEntityImpl&>(static_cast<la::avdecc::controller::ControlledEntityImpl const&>(*guard));
+		entity.setEntityName(la::avdecc::entity::model::AvdeccFixedString{ "Snapshot name" });
+		entity.publishSnapshot();
+	}
+	auto const newSnapshot = controller->getControlledEntitySnapshot(EntityID);
+	ASSERT_NE(nullptr, newSnapshot);
+	EXPECT_LT(snapshot->version, newSnapshot->version);
+	EXPECT_EQ(la::avdecc::entity::model::AvdeccFixedString{ "Snapshot name" }, newSnapshot->entityTree.dynamicModel.entityName);
+	// Previous snapshot is left untouched, and shares the static model with the new one
+	EXPECT_EQ(entityName, snapshot->entityTree.dynamicModel.entityName);
+	EXPECT_TRUE(snapshot->entityTree.staticModel.isSharedWith(newSnapshot->entityTree.staticModel));
+
+	// Releasing an entity that was not modified does not publish a new snapshot
+	{
+		auto guard = controller->getControlledEntityGuard(EntityID);
+		auto& entity = const_cast<la::avdecc::controller::ControlledEntityImpl&>(static_cast<la::avdecc::controller::ControlledEntityImpl const&>(*guard));
+		entity.publishSnapshotIfDirty();
+	}
+	EXPECT_EQ(newSnapshot, controller->getControlledEntitySnapshot(EntityID));
+
+	// Updates made under nested locks are published once, when the outermost lock is released
+	{
+		auto guard = controller->getControlledEntityGuard(EntityID);
+		auto& entity = const_cast<la::avdecc::controller::ControlledEntityImpl&>(static_cast<la::avdecc::controller::ControlledEntityImpl const&>(*guard));
+		entity.lock();
+		entity.setEntityName(la::avdecc::entity::model::AvdeccFixedString{ "Nested name" });
+		entity.publishSnapshotIfDirty();
+		entity.unlock();
+		EXPECT_EQ(newSnapshot, controller->getControlledEntitySnapshot(EntityID));
+		entity.setEntityGroupName(la::avdecc::entity::model::AvdeccFixedString{ "Nested group" });
+		entity.publishSnapshotIfDirty();
+	}
+	auto const batchSnapshot = controller->getControlledEntitySnapshot(EntityID);
+	ASSERT_NE(nullptr, batchSnapshot);
+	EXPECT_EQ(newSnapshot->version + 1u, batchSnapshot->version);
+	EXPECT_EQ(la::avdecc::entity::model::AvdeccFixedString{ "Nested name" }, batchSnapshot->entityTree.dynamicModel.entityName);
+	EXPECT_EQ(la::avdecc::entity::model::AvdeccFixedString{ "Nested group" }, batchSnapshot->entityTree.dynamicModel.groupName);
+}
+
+TEST(Controller, ControlledEntitySnapshotNested)
+{
+	auto const flags = la::avdecc::entity::model::jsonSerializer::Flags{ la::avdecc::entity::model::jsonSerializer::Flag::IgnoreAEMSanityChecks, la::avdecc::entity::model::jsonSerializer::Flag::ProcessADP, la::avdecc::entity::model::jsonSerializer::Flag::ProcessCompatibility, la::avdecc::entity::model::jsonSerializer::Flag::ProcessDynamicModel, la::avdecc::entity::model::jsonSerializer::Flag::ProcessMilan, la::avdecc::entity::model::jsonSerializer::Flag::ProcessState, la::avdecc::entity::model::jsonSerializer::Flag::ProcessStaticModel, la::avdecc::entity::model::jsonSerializer::Flag::ProcessStatistics };
+	auto controller = la::avdecc::controller::Controller::create(la::avdecc::protocol::ProtocolInterface::Type::Virtual, "VirtualInterface", 0x0001, la::avdecc::UniqueIdentifier{}, "en");
+	{
+		auto const [error, message] = controller->loadVirtualEntityFromJson("data/SimpleEntity.json", flags);
+		ASSERT_EQ(la::avdecc::jsonSerializer::DeserializationError::NoError, error) << message;
+	}
+
+	auto constexpr EntityID = la::avdecc::UniqueIdentifier{ 0x001B92FFFF000001 };
+
+	// First snapshot requested while already holding the entity
+	{
+		auto const guard = controller->getControlledEntityGuard(EntityID);
+		ASSERT_TRUE(!!guard);
+		auto const snapshot = controller->getControlledEntitySnapshot(EntityID);
+		ASSERT_NE(nullptr, snapshot);
+		EXPECT_EQ(EntityID, snapshot->entity.getEntityID());
+	}
+}
+
+TEST(Controller, ControlledEntitySnapshotControlValues)
+{
+	auto const flags = la::avdecc::entity::model::jsonSerializer::Flags{ la::avdecc::entity::model::jsonSerializer::Flag::IgnoreAEMSanityChecks, la::avdecc::entity::model::jsonSerializer::Flag::ProcessADP, la::avdecc::entity::model::jsonSerializer::Flag::ProcessCompatibility, la::avdecc::entity::model::jsonSerializer::Flag::ProcessDynamicModel, la::avdecc::entity::model::jsonSerializer::Flag::ProcessMilan, la::avdecc::entity::model::jsonSerializer::Flag::ProcessState, la::avdecc::entity::model::jsonSerializer::Flag::ProcessStaticModel, la::avdecc::entity::model::jsonSerializer::Flag::ProcessStatistics };
+	auto controller = la::avdecc::controller::Controller::create(la::avdecc::protocol::ProtocolInterface::Type::Virtual, "VirtualInterface", 0x0001, la::avdecc::UniqueIdentifier{}, "en");
+	{
+		auto const [error, message] = controller->loadVirtualEntityFromJson("data/SimpleEntity.json", flags);
+		ASSERT_EQ(la::avdecc::jsonSerializer::DeserializationError::NoError, error) << message;
+	}
+
+	auto constexpr EntityID = la::avdecc::UniqueIdentifier{ 0x001B92FFFF000001 };
+	auto constexpr ConfigurationIndex = la::avdecc::entity::model::ConfigurationIndex{ 0u };
+	auto constexpr ControlIndex = la::avdecc::entity::model::ControlIndex{ 0u };
+	auto& c = static_cast<la::avdecc::controller::ControllerImpl&>(*controller);
+
+	ASSERT_NE(nullptr, controller->getControlledEntitySnapshot(EntityID));
+
+	// Each unsolicited notification publishes a new snapshot (sharing the static models of the entity)
+	controller->lock();
+	for (auto const value : { std::uint8_t{ 0u }, std::uint8_t{ 255u } })
+	{
+		c.onControlValuesChanged(nullptr, EntityID, ControlIndex, la::avdecc::MemoryBuffer{ std::vector<std::uint8_t>{ value } });
+	}
+	controller->unlock();
+
+	auto const snapshot = controller->getControlledEntitySnapshot(EntityID);
+	ASSERT_NE(nullptr, snapshot);
+	auto const& snapshotControlModels = snapshot->entityTree.configurationTrees.at(ConfigurationIndex).controlModels.at(ControlIndex);
+	EXPECT_TRUE(snapshotControlModels.dynamicModel.values.isEqualTo<la::avdecc::entity::model::LinearValues<la::avdecc::entity::model::LinearValueDynamic<std::uint8_t>>>(la::avdecc::entity::model::ControlValues{ la::avdecc::entity::model::LinearValues<la::avdecc::entity::model::LinearValueDynamic<std::uint8_t>>{ { { 255u } } } }));
+
+	// The entity model graph still references the static model of the entity
+	auto const guard = controller->getControlledEntityGuard(EntityID);
+	ASSERT_TRUE(!!guard);
+	auto const& entity = static_cast<la::avdecc::controller::ControlledEntityImpl const&>(*guard);
+	auto const& controlNode = entity.getControlNode(ConfigurationIndex, ControlIndex);
+	EXPECT_EQ(&entity.getNodeStaticModel(ConfigurationIndex, ControlIndex, &la::avdecc::entity::model::ConfigurationTree::controlModels), controlNode.staticModel);
+	EXPECT_EQ(&snapshotControlModels.staticModel.get(), controlNode.staticModel);
+	EXPECT_EQ(1u, controlNode.staticModel->values.size());
+}
+
+TEST(Controller, ControlledEntityGuardNested)
+{
+	auto const flags = la::avdecc::entity::model::jsonSerializer::Flags{ la::avdecc::entity::model::jsonSerializer::Flag::IgnoreAEMSanityChecks, la::avdecc::entity::model::jsonSerializer::Flag::ProcessADP, la::avdecc::entity::model::jsonSerializer::Flag::ProcessCompatibility, la::avdecc::entity::model::jsonSerializer::Flag::ProcessDynamicModel, la::avdecc::entity::model::jsonSerializer::Flag::ProcessMilan, la::avdecc::entity::model::jsonSerializer::Flag::ProcessState, la::avdecc::entity::model::jsonSerializer::Flag::ProcessStaticModel, la::avdecc::entity::model::jsonSerializer::Flag::ProcessStatistics };
+	auto controller = la::avdecc::controller::Controller::create(la::avdecc::protocol::ProtocolInterface::Type::Virtual, "VirtualInterface", 0x0001, la::avdecc::UniqueIdentifier{}, "en");
+	for (auto const* const fileName : { "data/SimpleEntity.json", "data/Talker.json" })
+	{
+		auto const [error, message] = controller->loadVirtualEntityFromJson(fileName, flags);
+		ASSERT_EQ(la::avdecc::jsonSerializer::DeserializationError::NoError, error) << message;
+	}
+
+	auto constexpr FirstEntityID = la::avdecc::UniqueIdentifier{ 0x001B92FFFF000001 };
+	auto constexpr SecondEntityID = la::avdecc::UniqueIdentifier{ 0x001B92FFFF000002 };
+
+	// Another thread holds the second entity for a while
+	auto locked = std::promise<void>{};
+	auto holder = std::async(std::launch::async,
+		[&controller, &locked]()
+		{
+			auto const guard = controller->getControlledEntityGuard(SecondEntityID);
+			locked.set_value();
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			return !!guard;
+		});
+	locked.get_future().wait();
+
+	// Requesting it while holding the first entity waits for it (and does not pretend it is offline)
+	{
+		auto const firstGuard = controller->getControlledEntityGuard(FirstEntityID);
+		ASSERT_TRUE(!!firstGuard);
+		auto const secondGuard = controller->getControlledEntityGuard(SecondEntityID);
+		ASSERT_TRUE(!!secondGuard);
+		EXPECT_EQ(SecondEntityID, secondGuard->getEntity().getEntityID());
+		EXPECT_NE(nullptr, controller->getControlledEntitySnapshot(SecondEntityID));
+	}
+	ASSERT_EQ(std::future_status::ready, holder.wait_for(std::chrono::seconds(5)));
+	EXPECT_TRUE(holder.get());
+}
+
+TEST(Controller, ControlledEntityGuardsLockOrder)
+{
+	static constexpr auto Iterations = 2000u;
+	auto const flags = la::avdecc::entity::model::jsonSerializer::Flags{ la::avdecc::entity::model::jsonSerializer::Flag::IgnoreAEMSanityChecks, la::avdecc::entity::model::jsonSerializer::Flag::ProcessADP, la::avdecc::entity::model::jsonSerializer::Flag::ProcessCompatibility, la::avdecc::entity::model::jsonSerializer::Flag::ProcessDynamicModel, la::avdecc::entity::model::jsonSerializer::Flag::ProcessMilan, la::avdecc::entity::model::jsonSerializer::Flag::ProcessState, la::avdecc::entity::model::jsonSerializer::Flag::ProcessStaticModel, la::avdecc::entity::model::jsonSerializer::Flag::ProcessStatistics };
+	auto controller = la::avdecc::controller::Controller::create(la::avdecc::protocol::ProtocolInterface::Type::Virtual, "VirtualInterface", 0x0001, la::avdecc::UniqueIdentifier{}, "en");
+	for (auto const* const fileName : { "data/SimpleEntity.json", "data/Talker.json" })
+	{
+		auto const [error, message] = controller->loadVirtualEntityFromJson(fileName, flags);
+		ASSERT_EQ(la::avdecc::jsonSerializer::DeserializationError::NoError, error) << message;
+	}
+
+	auto constexpr FirstEntityID = la::avdecc::UniqueIdentifier{ 0x001B92FFFF000001 };
+	auto constexpr SecondEntityID = la::avdecc::UniqueIdentifier{ 0x001B92FFFF000002 };
+
+	// Lock the same entities, requested in opposite orders, from 2 threads: should never deadlock
+	auto const lockBoth = [&controller](la::avdecc::UniqueIdentifier const outerEntityID, la::avdecc::UniqueIdentifier const innerEntityID)
+	{
+		for (auto i = 0u; i < Iterations; ++i)
+		{
+			auto const guards = controller->getControlledEntityGuards({ outerEntityID, innerEntityID, la::avdecc::UniqueIdentifier{ 0x0102030405060708 } });
+			if (guards.size() != 3u || !guards[0] || !guards[1] || !!guards[2] || guards[0]->getEntity().getEntityID() != outerEntityID || guards[1]->getEntity().getEntityID() != innerEntityID)
+			{
+				return false;
+			}
+		}
+		return true;
+	};
+	auto inOrder = std::async(std::launch::async, lockBoth, FirstEntityID, SecondEntityID);
+	auto outOfOrder = std::async(std::launch::async, lockBoth, SecondEntityID, FirstEntityID);
+	ASSERT_EQ(std::future_status::ready, inOrder.wait_for(std::chrono::seconds(30)));
+	ASSERT_EQ(std::future_status::ready, outOfOrder.wait_for(std::chrono::seconds(30)));
+	EXPECT_TRUE(inOrder.get());
+	EXPECT_TRUE(outOfOrder.get());
+}
+
+TEST(Controller, ControlledEntityDeferredWhileHolding)
+{
+	auto const flags = la::avdecc::entity::model::jsonSerializer::Flags{ la::avdecc::entity::model::jsonSerializer::Flag::IgnoreAEMSanityChecks, la::avdecc::entity::model::jsonSerializer::Flag::ProcessADP, la::avdecc::entity::model::jsonSerializer::Flag::ProcessCompatibility, la::avdecc::entity::model::jsonSerializer::Flag::ProcessDynamicModel, la::avdecc::entity::model::jsonSerializer::Flag::ProcessMilan, la::avdecc::entity::model::jsonSerializer::Flag::ProcessState, la::avdecc::entity::model::jsonSerializer::Flag::ProcessStaticModel, la::avdecc::entity::model::jsonSerializer::Flag::ProcessStatistics };
+	auto controller = la::avdecc::controller::Controller::create(la::avdecc::protocol::ProtocolInterface::Type::Virtual, "VirtualInterface", 0x0001, la::avdecc::UniqueIdentifier{}, "en");
+	for (auto const* const fileName : { "data/SimpleEntity.json", "data/Talker.json" })
+	{
+		auto const [error, message] = controller->loadVirtualEntityFromJson(fileName, flags);
+		ASSERT_EQ(la::avdecc::jsonSerializer::DeserializationError::NoError, error) << message;
+	}
+
+	auto constexpr FirstEntityID = la::avdecc::UniqueIdentifier{ 0x001B92FFFF000001 };
+	auto constexpr SecondEntityID = la::avdecc::UniqueIdentifier{ 0x001B92FFFF000002 };
+	auto& c = static_cast<la::avdecc::controller::ControllerImpl&>(*controller);
+	auto handledCount = 0u;
+	auto const handler = [&handledCount](la::avdecc::controller::ControllerImpl::ControlledEntityImplGuards& entities)
+	{
+		if (entities.size() == 2u && entities[0] && entities[1] && la::avdecc::controller::ControlledEntityImpl::LockInformation::isAnySelfLocked())
+		{
+			++handledCount;
+		}
+	};
+
+	// Not contended, run right away
+	{
+		auto const firstGuard = c.getControlledEntityImplGuard(FirstEntityID);
+		c.runWithControlledEntityImplGuards({ FirstEntityID, SecondEntityID }, handler);
+		EXPECT_EQ(1u, handledCount);
+	}
+
+	// Second entity held by another thread: never wait for it while holding the first one, run once the first one is released
+	auto locked = std::promise<void>{};
+	auto release = std::promise<void>{};
+	auto holder = std::async(std::launch::async,
+		[&c, &locked, releaseFuture = release.get_future()]()
+		{
+			auto const guard = c.getControlledEntityImplGuard(SecondEntityID);
+			locked.set_value();
+			releaseFuture.wait();
+		});
+	locked.get_future().wait();
+	{
+		auto firstGuard = c.getControlledEntityImplGuard(FirstEntityID);
+		c.runWithControlledEntityImplGuards({ FirstEntityID, SecondEntityID }, handler);
+		EXPECT_EQ(1u, handledCount);
+		release.set_value();
+		ASSERT_EQ(std::future_status::ready, holder.wait_for(std::chrono::seconds(5)));
+		EXPECT_EQ(1u, handledCount);
+	}
+	EXPECT_EQ(2u, handledCount);
+}
+
+TEST(Controller, DeltaEnumerationReusesStaticModel)
+{
+	auto const flags = la::avdecc::entity::model::jsonSerializer::Flags{ la::avdecc::entity::model::jsonSerializer::Flag::IgnoreAEMSanityChecks, la::avdecc::entity::model::jsonSerializer::Flag::ProcessADP, la::avdecc::entity::model::jsonSerializer::Flag::ProcessCompatibility, la::avdecc::entity::model::jsonSerializer::Flag::ProcessDynamicModel, la::avdecc::entity::model::jsonSerializer::Flag::ProcessMilan, la::avdecc::entity::model::jsonSerializer::Flag::ProcessState, la::avdecc::entity::model::jsonSerializer::Flag::ProcessStaticModel, la::avdecc::entity::model::jsonSerializer::Flag::ProcessStatistics };
+	auto controller = la::avdecc::controller::Controller::create(la::avdecc::protocol::ProtocolInterface::Type::Virtual, "VirtualInterface", 0x0001, la::avdecc::UniqueIdentifier{}, "en");
+	auto& c = static_cast<la::avdecc::controller::ControllerImpl&>(*controller);
+	auto constexpr EntityID = la::avdecc::UniqueIdentifier{ 0x001B92FFFF000003 };
+	auto constexpr ConfigurationIndex = la::avdecc::entity::model::ConfigurationIndex{ 0u };
+
+	// Only the model of the entity before it went offline can be reused (not the AEM cache)
+	auto& entityModelCache = la::avdecc::controller::EntityModelCache::getInstance();
+	auto const wasCacheEnabled = entityModelCache.isCacheEnabled();
+	controller->disableEntityModelCache();
+	controller->enableDeltaEnumeration(std::chrono::seconds{ 10 });
+
+	// Get the ADP information and the model of a "physical" entity from a virtual one
+	auto adpEntity = std::optional<la::avdecc::entity::Entity>{};
+	auto entityTree = la::avdecc::entity::model::EntityTree{};
+	{
+		auto const [error, message, virtualEntity] = la::avdecc::controller::ControllerImpl::deserializeControlledEntityFromJson("data/TalkerListener.json", flags);
+		ASSERT_EQ(la::avdecc::jsonSerializer::DeserializationError::NoError, error) << message;
+		adpEntity = virtualEntity->getEntity();
+		entityTree = static_cast<la::avdecc::controller::ControlledEntityImpl const&>(*virtualEntity).getEntityTree();
+	}
+	// A model loaded from JSON does not have the descriptor counts an enumeration gets from the CONFIGURATION descriptors
+	for (auto& [configurationIndex, configurationTree] : entityTree.configurationTrees)
+	{
+		auto& descriptorCounts = configurationTree.staticModel.getMutable().descriptorCounts;
+		auto const setCount = [&descriptorCounts](la::avdecc::entity::model::DescriptorType const descriptorType, auto const& models)
+		{
+			if (!models.empty())
+			{
+				descriptorCounts[descriptorType] = static_cast<std::uint16_t>(models.size());
+			}
+		};
+		setCount(la::avdecc::entity::model::DescriptorType::AudioUnit, configurationTree.audioUnitModels);
+		setCount(la::avdecc::entity::model::DescriptorType::StreamInput, configurationTree.streamInputModels);
+		setCount(la::avdecc::entity::model::DescriptorType::StreamOutput, configurationTree.streamOutputModels);
+		setCount(la::avdecc::entity::model::DescriptorType::AvbInterface, configurationTree.avbInterfaceModels);
+		setCount(la::avdecc::entity::model::DescriptorType::ClockSource, configurationTree.clockSourceModels);
+		setCount(la::avdecc::entity::model::DescriptorType::MemoryObject, configurationTree.memoryObjectModels);
+		setCount(la::avdecc::entity::model::DescriptorType::Locale, configurationTree.localeModels);
+		setCount(la::avdecc::entity::model::DescriptorType::Control, configurationTree.controlModels);
+		setCount(la::avdecc::entity::model::DescriptorType::ClockDomain, configurationTree.clockDomainModels);
+	}
+	ASSERT_TRUE(adpEntity->getEntityCapabilities().test(la::avdecc::entity::EntityCapability::AemSupported));
+
+	auto const makeEntity = [&adpEntity](std::uint32_t const availableIndex)
+	{
+		auto entity = *adpEntity;
+		for (auto& [avbInterfaceIndex, information] : entity.getInterfacesInformation())
+		{
+			information.availableIndex = availableIndex;
+		}
+		return std::make_shared<la::avdecc::controller::ControlledEntityImpl>(entity, std::make_shared<la::avdecc::controller::ControlledEntityImpl::LockInformation>(), false);
+	};
+
+	auto descriptor = la::avdecc::entity::model::EntityDescriptor{};
+	descriptor.entityID = EntityID;
+	descriptor.entityModelID = adpEntity->getEntityModelID();
+	descriptor.vendorNameString = entityTree.staticModel.get().vendorNameString;
+	descriptor.modelNameString = entityTree.staticModel.get().modelNameString;
+	descriptor.entityName = la::avdecc::entity::model::AvdeccFixedString{ "Back Online" };
+	descriptor.configurationsCount = static_cast<std::uint16_t>(entityTree.configurationTrees.size());
+	descriptor.currentConfiguration = ConfigurationIndex;
+
+	// Entity goes offline, then comes back online and returns its ENTITY descriptor: returns true if the static model had to be enumerated again
+	auto const goesOfflineAndBackOnline = [&c, &controller, &descriptor, &entityTree, &makeEntity, EntityID](std::uint32_t const availableIndex)
+	{
+		auto offlineEntity = makeEntity(10u);
+		offlineEntity->setEntityTree(entityTree);
+		c.retainOfflineEntity(offlineEntity);
+
+		auto const onlineEntity = makeEntity(availableIndex);
+		onlineEntity->setEnumerationSteps(la::avdecc::controller::ControlledEntityImpl::EnumerationSteps{ la::avdecc::controller::ControlledEntityImpl::EnumerationStep::GetStaticModel });
+		onlineEntity->setEnumerationStepStarted(la::avdecc::controller::ControlledEntityImpl::EnumerationStep::GetStaticModel);
+		onlineEntity->setDescriptorExpected(0u, la::avdecc::entity::model::DescriptorType::Entity, 0u);
+		{
+			auto const lg = std::lock_guard{ c._lock };
+			c._controlledEntities[EntityID] = onlineEntity;
+		}
+
+		controller->lock();
+		c.onEntityDescriptorResult(nullptr, EntityID, la::avdecc::entity::ControllerEntity::AemCommandStatus::Success, descriptor);
+		controller->unlock();
+
+		{
+			auto const lg = std::lock_guard{ c._lock };
+			c._controlledEntities.erase(EntityID);
+		}
+
+		auto const guard = la::avdecc::controller::ControllerImpl::ControlledEntityImplGuard{ la::avdecc::controller::ControllerImpl::SharedControlledEntityImpl{ onlineEntity }, true };
+		EXPECT_EQ(la::avdecc::entity::model::AvdeccFixedString{ "Back Online" }, guard->getEntityTree().dynamicModel.entityName);
+		return !guard->gotAllExpectedDescriptors();
+	};
+
+	// Entity kept on running while offline (its available_index kept on incrementing): no descriptor other than the ENTITY one is queried, only its dynamic information
+	EXPECT_FALSE(goesOfflineAndBackOnline(1000u));
+
+	// Entity restarted while offline (its available_index was reset): full enumeration
+	EXPECT_TRUE(goesOfflineAndBackOnline(1u));
+
+	controller->disableDeltaEnumeration();
+	if (wasCacheEnabled)
+	{
+		controller->enableEntityModelCache();
+	}
+}
@@ -0,0 +1,157 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @file avdeccEnumerationScheduler_tests.cpp
+* @author Christophe Calmejane
+*/
+
+// Internal API
+#include "controller/avdeccEnumerationScheduler.hpp"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+auto const EntityA = la::avdecc::UniqueIdentifier{ 0x000000000000000A };
+auto const EntityB = la::avdecc::UniqueIdentifier{ 0x000000000000000B };
+auto const EntityC = la::avdecc::UniqueIdentifier{ 0x000000000000000C };
+auto const EntityD = la::avdecc::UniqueIdentifier{ 0x000000000000000D };
+auto const ModelX = la::avdecc::UniqueIdentifier{ 0x0000000000010000 };
+auto const ModelY = la::avdecc::UniqueIdentifier{ 0x0000000000020000 };
+} // namespace
+
+TEST(EnumerationScheduler, NoLimit)
+{
+	auto scheduler = la::avdecc::controller::EnumerationScheduler{};
+
+	EXPECT_TRUE(scheduler.requestEnumeration(EntityA, ModelX));
+	EXPECT_TRUE(scheduler.requestEnumeration(EntityB, ModelX));
+	EXPECT_TRUE(scheduler.requestEnumeration(EntityC, ModelY));
+	EXPECT_EQ(3u, scheduler.getEnumeratingCount());
+	EXPECT_EQ(0u, scheduler.getQueuedCount());
+
+	// Timeouts never limit anything
+	EXPECT_TRUE(scheduler.onEnumerationEnded(EntityA, true).empty());
+	EXPECT_EQ(0u, scheduler.getConcurrentEnumerationsLimit());
+}
+
+TEST(EnumerationScheduler, LimitAndQueue)
+{
+	auto scheduler = la::avdecc::controller::EnumerationScheduler{};
+	EXPECT_TRUE(scheduler.setMaxConcurrentEnumerations(2u).empty());
+
+	EXPECT_TRUE(scheduler.requestEnumeration(EntityA, ModelX));
+	EXPECT_TRUE(scheduler.requestEnumeration(EntityB, ModelX));
+	EXPECT_FALSE(scheduler.requestEnumeration(EntityC, ModelX));
+	EXPECT_FALSE(scheduler.requestEnumeration(EntityD, ModelX));
+	EXPECT_EQ(2u, scheduler.getEnumeratingCount());
+	EXPECT_EQ(2u, scheduler.getQueuedCount());
+
+	// Queued entities are admitted in request order
+	EXPECT_EQ(la::avdecc::controller::EnumerationScheduler::EntityIDs{ EntityC }, scheduler.onEnumerationEnded(EntityA, false));
+	EXPECT_EQ(la::avdecc::controller::EnumerationScheduler::EntityIDs{ EntityD }, scheduler.onEnumerationEnded(EntityB, false));
+	EXPECT_EQ(2u, scheduler.getEnumeratingCount());
+	EXPECT_EQ(0u, scheduler.getQueuedCount());
+
+	// Unknown entity
+	EXPECT_TRUE(scheduler.onEnumerationEnded(EntityA, false).empty());
+	EXPECT_EQ(2u, scheduler.getEnumeratingCount());
+
+	// Removing the limit admits everything
+	EXPECT_FALSE(scheduler.requestEnumeration(EntityA, ModelX));
+	EXPECT_FALSE(scheduler.requestEnumeration(EntityB, ModelX));
+	EXPECT_EQ((la::avdecc::controller::EnumerationScheduler::EntityIDs{ EntityA, EntityB }), scheduler.setMaxConcurrentEnumerations(0u));
+	EXPECT_EQ(4u, scheduler.getEnumeratingCount());
+}
+
+TEST(EnumerationScheduler, QueuedEntityGoesOffline)
+{
+	auto scheduler = la::avdecc::controller::EnumerationScheduler{};
+	scheduler.setMaxConcurrentEnumerations(1u);
+
+	EXPECT_TRUE(scheduler.requestEnumeration(EntityA, ModelX));
+	EXPECT_FALSE(scheduler.requestEnumeration(EntityB, ModelX));
+	EXPECT_FALSE(scheduler.requestEnumeration(EntityC, ModelX));
+
+	// Going offline while queued doesn't release anything
+	EXPECT_TRUE(scheduler.onEnumerationEnded(EntityB, false).empty());
+	EXPECT_EQ(1u, scheduler.getQueuedCount());
+
+	EXPECT_EQ(la::avdecc::controller::EnumerationScheduler::EntityIDs{ EntityC }, scheduler.onEnumerationEnded(EntityA, false));
+	EXPECT_EQ(0u, scheduler.getQueuedCount());
+}
+
+TEST(EnumerationScheduler, Priorities)
+{
+	auto scheduler = la::avdecc::controller::EnumerationScheduler{};
+	scheduler.setMaxConcurrentEnumerations(1u);
+
+	EXPECT_TRUE(scheduler.requestEnumeration(EntityA, ModelX));
+	EXPECT_FALSE(scheduler.requestEnumeration(EntityB, ModelX));
+	EXPECT_FALSE(scheduler.requestEnumeration(EntityC, ModelY));
+	EXPECT_FALSE(scheduler.requestEnumeration(EntityD, ModelX));
+
+	// EntityModelID priority, applied to already queued entities
+	scheduler.setPriorities({ ModelY });
+	EXPECT_EQ(la::avdecc::controller::EnumerationScheduler::EntityIDs{ EntityC }, scheduler.onEnumerationEnded(EntityA, false));
+
+	// EntityID takes precedence over EntityModelID (even when ranked lower)
+	scheduler.setPriorities({ ModelX, EntityD });
+	EXPECT_EQ(la::avdecc::controller::EnumerationScheduler::EntityIDs{ EntityB }, scheduler.onEnumerationEnded(EntityC, false));
+	EXPECT_EQ(la::avdecc::controller::EnumerationScheduler::EntityIDs{ EntityD }, scheduler.onEnumerationEnded(EntityB, false));
+}
+
+TEST(EnumerationScheduler, AdaptiveLimit)
+{
+	auto scheduler = la::avdecc::controller::EnumerationScheduler{};
+	scheduler.setMaxConcurrentEnumerations(4u);
+	EXPECT_EQ(4u, scheduler.getConcurrentEnumerationsLimit());
+
+	EXPECT_TRUE(scheduler.requestEnumeration(EntityA, ModelX));
+	EXPECT_TRUE(scheduler.requestEnumeration(EntityB, ModelX));
+	EXPECT_TRUE(scheduler.requestEnumeration(EntityC, ModelX));
+	EXPECT_TRUE(scheduler.requestEnumeration(EntityD, ModelX));
+
+	// First enumeration with timeouts halves the limit
+	scheduler.onEnumerationEnded(EntityA, true);
+	EXPECT_EQ(2u, scheduler.getConcurrentEnumerationsLimit());
+
+	// Concurrent enumerations probably got the same timeouts, only decrease once per window
+	scheduler.onEnumerationEnded(EntityB, true);
+	EXPECT_EQ(2u, scheduler.getConcurrentEnumerationsLimit());
+	scheduler.onEnumerationEnded(EntityC, true);
+	EXPECT_EQ(1u, scheduler.getConcurrentEnumerationsLimit());
+
+	// Never below 1
+	scheduler.onEnumerationEnded(EntityD, true);
+	EXPECT_EQ(1u, scheduler.getConcurrentEnumerationsLimit());
+
+	// Grows back after a window of enumerations without timeout
+	EXPECT_TRUE(scheduler.requestEnumeration(EntityA, ModelX));
+	EXPECT_FALSE(scheduler.requestEnumeration(EntityB, ModelX));
+	EXPECT_FALSE(scheduler.requestEnumeration(EntityC, ModelX));
+	EXPECT_FALSE(scheduler.requestEnumeration(EntityD, ModelX));
+	EXPECT_EQ((la::avdecc::controller::EnumerationScheduler::EntityIDs{ EntityB, EntityC }), scheduler.onEnumerationEnded(EntityA, false));
+	EXPECT_EQ(2u, scheduler.getConcurrentEnumerationsLimit());
+	EXPECT_EQ(la::avdecc::controller::EnumerationScheduler::EntityIDs{ EntityD }, scheduler.onEnumerationEnded(EntityB, false));
+	EXPECT_EQ(2u, scheduler.getConcurrentEnumerationsLimit());
+	scheduler.onEnumerationEnded(EntityC, false);
+	EXPECT_EQ(3u, scheduler.getConcurrentEnumerationsLimit());
+}
@@ -0,0 +1,124 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/**
+* @file copyOnWrite_tests.cpp
+* @author Christophe Calmejane
+*/
+
+// Public API
+#include <la/avdecc/copyOnWrite.hpp>
+
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+
+namespace
+{
+using Value = la::avdecc::CopyOnWrite<std::string>;
+} // namespace
+
+TEST(CopyOnWrite, DefaultConstructor)
+{
+	auto const v1 = Value{};
+	auto const v2 = Value{};
+	EXPECT_TRUE(v1->empty());
+	// All default constructed instances share the same value
+	EXPECT_TRUE(v1.isSharedWith(v2));
+}
+
+TEST(CopyOnWrite, CopySharesValue)
+{
+	auto const v1 = Value{ "value" };
+	EXPECT_FALSE(v1.isShared());
+
+	auto const v2 = v1;
+	EXPECT_TRUE(v1.isShared());
+	EXPECT_TRUE(v1.isSharedWith(v2));
+	EXPECT_EQ(&v1.get(), &v2.get());
+	EXPECT_EQ("value", *v2);
+}
+
+TEST(CopyOnWrite, GetMutableCopiesSharedValue)
+{
+	auto v1 = Value{ "value" };
+	auto const* const unsharedAddress = &v1.get();
+
+	// Not shared: modified in place
+	v1.getMutable() = "modified";
+	EXPECT_EQ(unsharedAddress, &v1.get());
+
+	// Shared: private copy made before modification, other instance not affected
+	auto const v2 = v1;
+	v1.getMutable() += " again";
+	EXPECT_FALSE(v1.isSharedWith(v2));
+	EXPECT_FALSE(v1.isShared());
+	EXPECT_TRUE(v2.isShared()); // v2 cannot know v1 no longer shares its value
+	EXPECT_EQ("modified again", *v1);
+	EXPECT_EQ("modified", *v2);
+	EXPECT_EQ(unsharedAddress, &v2.get());
+}
+
+TEST(CopyOnWrite, CopiedValueNeverModifiedInPlace)
+{
+	auto v1 = Value{ "value" };
+	auto const* const sharedAddress = &v1.get();
+
+	// Once copied, the value is never modified in place again, even if the copy has been released since (it could have been copied again by another thread)
+	{
+		auto const v2 = v1;
+	}
+	EXPECT_TRUE(v1.isShared());
+	v1.getMutable() = "modified";
+	EXPECT_NE(sharedAddress, &v1.get());
+
+	// The private copy is then modified in place
+	auto const* const privateAddress = &v1.get();
+	v1.getMutable() += " again";
+	EXPECT_EQ(privateAddress, &v1.get());
+	EXPECT_EQ("modified again", *v1);
+}
+
+TEST(CopyOnWrite, AssignValue)
+{
+	auto v1 = Value{ "value" };
+	auto const v2 = v1;
+
+	v1 = std::string{ "other" };
+	EXPECT_FALSE(v1.isSharedWith(v2));
+	EXPECT_EQ("other", *v1);
+	EXPECT_EQ("value", *v2);
+}
+
+TEST(CopyOnWrite, Move)
+{
+	auto v1 = Value{ "value" };
+	auto const* const address = &v1.get();
+
+	auto v2 = std::move(v1);
+	EXPECT_EQ(address, &v2.get());
+	// Moved-from instance is left with the default value
+	EXPECT_TRUE(v1->empty());
+	EXPECT_TRUE(v1.isSharedWith(Value{}));
+
+	v1 = std::move(v2);
+	EXPECT_EQ(address, &v1.get());
+	EXPECT_TRUE(v2->empty());
+}
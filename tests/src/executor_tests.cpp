@@ -0,0 +1,332 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @file executor_tests.cpp
+* @author Christophe Calmejane
+*/
+
+// Public API
+#include <la/avdecc/executor.hpp>
+#include <la/avdecc/memoryBuffer.hpp>
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <array>
+#include <functional>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+TEST(ExecutorJob, InlineStorage)
+{
+	auto const* const self = static_cast<void const*>(nullptr);
+	auto msg = la::avdecc::MemoryBuffer{};
+	auto const receiveJob = [self, msg = std::move(msg)]()
+	{
+		(void)self;
+		(void)msg;
+	};
+	auto const bigJob = [data = std::array<std::uint8_t, la::avdecc::ExecutorJob::InlineCaptureSize + 1u>{}]()
+	{
+		(void)data;
+	};
+
+	// A typical receive job (MemoryBuffer plus 'this') is stored inline
+	EXPECT_TRUE(la::avdecc::ExecutorJob::IsStoredInline<std::decay_t<decltype(receiveJob)>>);
+	EXPECT_FALSE(la::avdecc::ExecutorJob::IsStoredInline<std::decay_t<decltype(bigJob)>>);
+}
+
+TEST(ExecutorJob, Empty)
+{
+	auto job = la::avdecc::ExecutorJob{};
+	EXPECT_FALSE(job);
+	EXPECT_TRUE(job == nullptr);
+
+	job = la::avdecc::ExecutorJob{ std::function<void()>{} };
+	EXPECT_FALSE(job);
+
+	job = la::avdecc::ExecutorJob{ static_cast<void (*)()>(nullptr) };
+	EXPECT_FALSE(job);
+
+	job = []() {};
+	EXPECT_TRUE(job);
+	EXPECT_TRUE(job != nullptr);
+
+	job = nullptr;
+	EXPECT_FALSE(job);
+}
+
+TEST(ExecutorJob, MoveOnlyCapture)
+{
+	auto value = std::make_unique<int>(42);
+	auto result = 0;
+	auto job = la::avdecc::ExecutorJob{ [&result, value = std::move(value)]()
+		{
+			result = *value;
+		} };
+
+	auto movedJob = std::move(job);
+	EXPECT_FALSE(job);
+	ASSERT_TRUE(movedJob);
+
+	movedJob();
+	EXPECT_EQ(42, result);
+}
+
+TEST(ExecutorJob, CaptureLifetime)
+{
+	auto const value = std::make_shared<int>(0);
+
+	// Inline storage
+	{
+		auto job = la::avdecc::ExecutorJob{ [value]() {} };
+		EXPECT_EQ(2, value.use_count());
+		auto movedJob = la::avdecc::ExecutorJob{ std::move(job) };
+		EXPECT_EQ(2, value.use_count());
+		movedJob = nullptr;
+		EXPECT_EQ(1, value.use_count());
+	}
+
+	// Heap storage
+	{
+		auto job = la::avdecc::ExecutorJob{ [value, data = std::array<std::uint8_t, la::avdecc::ExecutorJob::InlineCaptureSize>{}]()
+			{
+				(void)data;
+			} };
+		EXPECT_EQ(2, value.use_count());
+		auto movedJob = la::avdecc::ExecutorJob{ std::move(job) };
+		EXPECT_EQ(2, value.use_count());
+	}
+	EXPECT_EQ(1, value.use_count());
+}
+
+TEST(ExecutorJob, ExecutorProxy)
+{
+	auto executedCount = 0;
+	auto const executor = la::avdecc::ExecutorProxy::create(
+		[](la::avdecc::Executor::Job&& job)
+		{
+			job();
+		},
+		[]() {}, [](bool) {},
+		[]()
+		{
+			return std::this_thread::get_id();
+		});
+
+	executor->pushJob(
+		[&executedCount, value = std::make_unique<int>(1)]()
+		{
+			executedCount += *value;
+		});
+	EXPECT_EQ(1, executedCount);
+}
+
+namespace
+{
+class Executor_F : public ::testing::TestWithParam<bool>
+{
+public:
+	/** Creates the executor to test (lock-free or not, depending on the test parameter) */
+	la::avdecc::Executor::UniquePointer createExecutor(size_t const queueCapacity = la::avdecc::ExecutorWithLockFreeDispatchQueue::DefaultQueueCapacity) const
+	{
+		if (GetParam())
+		{
+			return la::avdecc::ExecutorWithLockFreeDispatchQueue::create("TestExecutor", la::avdecc::utils::ThreadPriority::Normal, queueCapacity);
+		}
+		return la::avdecc::ExecutorWithDispatchQueue::create("TestExecutor");
+	}
+};
+} // namespace
+
+TEST_P(Executor_F, ExecutesInOrder)
+{
+	static constexpr auto JobsCount = size_t{ 10000u };
+	auto executor = createExecutor();
+	auto executed = std::vector<size_t>{};
+
+	for (auto i = size_t{ 0u }; i < JobsCount; ++i)
+	{
+		executor->pushJob(
+			[&executed, i]()
+			{
+				executed.push_back(i);
+			});
+	}
+	executor->flush();
+
+	ASSERT_EQ(JobsCount, executed.size());
+	for (auto i = size_t{ 0u }; i < JobsCount; ++i)
+	{
+		EXPECT_EQ(i, executed[i]);
+	}
+}
+
+TEST_P(Executor_F, ExecutesOnExecutorThread)
+{
+	auto executor = createExecutor();
+	auto executorThread = std::thread::id{};
+
+	executor->pushJob(
+		[&executorThread]()
+		{
+			executorThread = std::this_thread::get_id();
+		});
+	executor->flush();
+
+	EXPECT_EQ(executor->getExecutorThread(), executorThread);
+	EXPECT_NE(std::this_thread::get_id(), executorThread);
+}
+
+TEST_P(Executor_F, MultipleProducers)
+{
+	static constexpr auto ProducersCount = size_t{ 4u };
+	static constexpr auto JobsCount = size_t{ 20000u };
+	// Small queue so that the overflow queue is also used
+	auto executor = createExecutor(64u);
+	auto lastValues = std::vector<size_t>(ProducersCount, 0u);
+	auto outOfOrderCount = size_t{ 0u };
+	auto executedCount = size_t{ 0u };
+
+	auto producers = std::vector<std::thread>{};
+	for (auto p = size_t{ 0u }; p < ProducersCount; ++p)
+	{
+		producers.emplace_back(
+			[&, p]()
+			{
+				for (auto i = size_t{ 1u }; i <= JobsCount; ++i)
+				{
+					executor->pushJob(
+						[&, p, i]()
+						{
+							// Jobs pushed by the same thread must be executed in order
+							if (lastValues[p] + 1u != i)
+							{
+								++outOfOrderCount;
+							}
+							lastValues[p] = i;
+							++executedCount;
+						});
+				}
+			});
+	}
+	for (auto& producer : producers)
+	{
+		producer.join();
+	}
+	executor->flush();
+
+	EXPECT_EQ(ProducersCount * JobsCount, executedCount);
+	EXPECT_EQ(0u, outOfOrderCount);
+}
+
+TEST_P(Executor_F, PushFromExecutorThread)
+{
+	static constexpr auto JobsCount = size_t{ 100u };
+	// Queue smaller than the number of jobs pushed from a single job, overflowing the ring
+	auto executor = createExecutor(8u);
+	auto executed = std::vector<size_t>{};
+
+	executor->pushJob(
+		[&executor, &executed]()
+		{
+			for (auto i = size_t{ 0u }; i < JobsCount; ++i)
+			{
+				executor->pushJob(
+					[&executed, i]()
+					{
+						executed.push_back(i);
+					});
+			}
+		});
+	// Wait for the first job to be executed, then for the jobs it pushed
+	executor->flush();
+	executor->flush();
+
+	ASSERT_EQ(JobsCount, executed.size());
+	for (auto i = size_t{ 0u }; i < JobsCount; ++i)
+	{
+		EXPECT_EQ(i, executed[i]);
+	}
+}
+
+TEST_P(Executor_F, TerminateWithFlush)
+{
+	static constexpr auto JobsCount = size_t{ 100u };
+	auto executor = createExecutor();
+	auto executedCount = std::atomic<size_t>{ 0u };
+
+	for (auto i = size_t{ 0u }; i < JobsCount; ++i)
+	{
+		executor->pushJob(
+			[&executedCount]()
+			{
+				std::this_thread::sleep_for(std::chrono::microseconds(10));
+				++executedCount;
+			});
+	}
+	executor->terminate(true);
+
+	EXPECT_EQ(JobsCount, executedCount);
+
+	// Jobs pushed after termination are ignored
+	executor->pushJob(
+		[&executedCount]()
+		{
+			++executedCount;
+		});
+	EXPECT_EQ(JobsCount, executedCount);
+}
+
+TEST_P(Executor_F, TerminateWithoutFlush)
+{
+	static constexpr auto JobsCount = size_t{ 100u };
+	auto executor = createExecutor();
+	auto executedCount = std::atomic<size_t>{ 0u };
+	auto firstJobStarted = std::promise<void>{};
+
+	// Block the executor thread so the following jobs stay in the queue
+	executor->pushJob(
+		[&firstJobStarted]()
+		{
+			firstJobStarted.set_value();
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		});
+	firstJobStarted.get_future().wait();
+	for (auto i = size_t{ 0u }; i < JobsCount; ++i)
+	{
+		executor->pushJob(
+			[&executedCount]()
+			{
+				++executedCount;
+			});
+	}
+	executor->terminate(false);
+
+	EXPECT_EQ(0u, executedCount);
+}
+
+INSTANTIATE_TEST_SUITE_P(Test, Executor_F, ::testing::Values(false, true),
+	[](auto const& info)
+	{
+		return info.param ? "LockFree" : "Locked";
+	});
@@ -0,0 +1,152 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/**
+* @file framePool_tests.cpp
+* @author Christophe Calmejane
+*/
+
+// Public API
+#include <la/avdecc/executor.hpp>
+#include <la/avdecc/internals/protocolAdpdu.hpp>
+
+// Internal API
+#include "protocolInterface/framePool.hpp"
+#include "protocolInterface/protocolInterface_virtual.hpp"
+#include "allocationCounter.hpp"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+TEST(FramePool, AcquireRelease)
+{
+	auto pool = la::avdecc::protocol::FramePool{ 2u };
+	auto const data = std::vector<std::uint8_t>(64u, 0x42);
+
+	EXPECT_EQ(2u, pool.getFreeCount());
+
+	auto* const frame1 = pool.acquire(data.data(), data.size());
+	ASSERT_NE(nullptr, frame1);
+	EXPECT_EQ(data.size(), frame1->size);
+	EXPECT_EQ(0x42, frame1->data[63]);
+
+	auto* const frame2 = pool.acquire(data.data(), data.size());
+	ASSERT_NE(nullptr, frame2);
+	EXPECT_NE(frame1, frame2);
+	EXPECT_EQ(0u, pool.getFreeCount());
+
+	// Pool exhausted
+	EXPECT_EQ(nullptr, pool.acquire(data.data(), data.size()));
+
+	// Released frames are recycled
+	pool.release(frame1);
+	EXPECT_EQ(1u, pool.getFreeCount());
+	EXPECT_EQ(frame1, pool.acquire(data.data(), data.size()));
+
+	pool.release(frame1);
+	pool.release(frame2);
+	EXPECT_EQ(2u, pool.getFreeCount());
+}
+
+TEST(FramePool, FrameTooBig)
+{
+	auto pool = la::avdecc::protocol::FramePool{ 1u };
+	auto const data = std::vector<std::uint8_t>(la::avdecc::protocol::FramePool::MaximumFrameSize + 1u);
+
+	EXPECT_EQ(nullptr, pool.acquire(data.data(), data.size()));
+	EXPECT_EQ(1u, pool.getFreeCount());
+}
+
+TEST(FramePool, AllocationFreeReceivePath)
+{
+	static constexpr auto WarmupCount = size_t{ 10u };
+	static constexpr auto MessagesCount = size_t{ 200u };
+
+	auto const executorWrapper = la::avdecc::ExecutorManager::getInstance().registerExecutor(la::avdecc::protocol::ProtocolInterface::DefaultExecutorName, la::avdecc::ExecutorWithDispatchQueue::create(la::avdecc::protocol::ProtocolInterface::DefaultExecutorName, la::avdecc::utils::ThreadPriority::Highest));
+
+	class Observer : public la::avdecc::protocol::ProtocolInterface::Observer
+	{
+	public:
+		size_t getReceivedCount() const noexcept
+		{
+			return _receivedCount;
+		}
+
+	private:
+		virtual void onAdpduReceived(la::avdecc::protocol::ProtocolInterface* const /*pi*/, la::avdecc::protocol::Adpdu const& /*adpdu*/) noexcept override
+		{
+			++_receivedCount;
+		}
+		std::atomic<size_t> _receivedCount{ 0u };
+		DECLARE_AVDECC_OBSERVER_GUARD(Observer);
+	};
+
+	auto obs = Observer{};
+	auto intfc1 = std::unique_ptr<la::avdecc::protocol::ProtocolInterfaceVirtual>(la::avdecc::protocol::ProtocolInterfaceVirtual::createRawProtocolInterfaceVirtual("AllocationFreeInterface", { { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05 } }));
+	auto intfc2 = std::unique_ptr<la::avdecc::protocol::ProtocolInterfaceVirtual>(la::avdecc::protocol::ProtocolInterfaceVirtual::createRawProtocolInterfaceVirtual("AllocationFreeInterface", { { 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b } }));
+	intfc2->registerObserver(&obs);
+
+	// Build an EntityDiscover adpdu (not changing the state of the receiving interface)
+	auto adpdu = la::avdecc::protocol::Adpdu{};
+	adpdu.setSrcAddress(intfc1->getMacAddress());
+	adpdu.setDestAddress(la::avdecc::protocol::Adpdu::Multicast_Mac_Address);
+	adpdu.setMessageType(la::avdecc::protocol::AdpMessageType::EntityDiscover);
+	adpdu.setEntityID(la::avdecc::UniqueIdentifier::getNullUniqueIdentifier());
+
+	// Send messages one at a time, waiting for each to be processed
+	auto const sendAndWait = [&intfc1, &obs, &adpdu](size_t const count)
+	{
+		for (auto i = size_t{ 0u }; i < count; ++i)
+		{
+			auto const expected = obs.getReceivedCount() + 1u;
+			intfc1->sendAdpMessage(adpdu);
+			auto const timeout = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+			while (obs.getReceivedCount() < expected && std::chrono::steady_clock::now() < timeout)
+			{
+				std::this_thread::yield();
+			}
+			ASSERT_EQ(expected, obs.getReceivedCount());
+		}
+	};
+	auto const setCounting = [](bool const enabled)
+	{
+		la::avdecc::ExecutorManager::getInstance().pushJob(la::avdecc::protocol::ProtocolInterface::DefaultExecutorName,
+			[enabled]()
+			{
+				allocationCounter::setCountingEnabled(enabled);
+			});
+		la::avdecc::ExecutorManager::getInstance().flush(la::avdecc::protocol::ProtocolInterface::DefaultExecutorName);
+	};
+
+	// Warmup (lazy initializations)
+	sendAndWait(WarmupCount);
+
+	// Count allocations made by the PI executor thread while processing received messages
+	allocationCounter::reset();
+	setCounting(true);
+	sendAndWait(MessagesCount);
+	setCounting(false);
+
+	EXPECT_EQ(0u, allocationCounter::getCount());
+}
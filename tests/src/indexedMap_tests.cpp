@@ -0,0 +1,158 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/**
+* @file indexedMap_tests.cpp
+* @author Christophe Calmejane
+*/
+
+// Public API
+#include <la/avdecc/indexedMap.hpp>
+
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+using Map = la::avdecc::IndexedMap<std::uint16_t, std::string, 8>;
+
+std::vector<std::pair<std::uint16_t, std::string>> toVector(Map const& map)
+{
+	auto v = std::vector<std::pair<std::uint16_t, std::string>>{};
+	for (auto const& [key, value] : map)
+	{
+		v.emplace_back(key, value);
+	}
+	return v;
+}
+} // namespace
+
+TEST(IndexedMap, DefaultConstructor)
+{
+	auto const m = Map{};
+	EXPECT_TRUE(m.empty());
+	EXPECT_EQ(0u, m.size());
+	EXPECT_EQ(m.begin(), m.end());
+	EXPECT_EQ(m.end(), m.find(0));
+}
+
+TEST(IndexedMap, DenseAndSparseKeys)
+{
+	auto m = Map{};
+	m[3] = "three";
+	m[0] = "zero";
+	m[100] = "hundred";
+	m[8] = "eight";
+	m[1] = "one";
+
+	EXPECT_EQ(5u, m.size());
+	EXPECT_EQ((std::vector<std::pair<std::uint16_t, std::string>>{ { 0, "zero" }, { 1, "one" }, { 3, "three" }, { 8, "eight" }, { 100, "hundred" } }), toVector(m));
+
+	EXPECT_EQ("three", m.at(3));
+	EXPECT_EQ("hundred", m.at(100));
+	EXPECT_THROW(m.at(2), std::out_of_range);
+	EXPECT_THROW(m.at(50), std::out_of_range);
+	EXPECT_EQ(1u, m.count(8));
+	EXPECT_EQ(0u, m.count(9));
+	EXPECT_TRUE(m.contains(0));
+	EXPECT_FALSE(m.contains(2));
+
+	auto const it = m.find(100);
+	ASSERT_NE(m.end(), it);
+	EXPECT_EQ(100u, it->first);
+	EXPECT_EQ("hundred", it->second);
+}
+
+TEST(IndexedMap, Emplace)
+{
+	auto m = Map{};
+	auto const [it, inserted] = m.emplace(2, "two");
+	EXPECT_TRUE(inserted);
+	EXPECT_EQ(2u, it->first);
+
+	auto const [it2, inserted2] = m.try_emplace(2, "other");
+	EXPECT_FALSE(inserted2);
+	EXPECT_EQ("two", it2->second);
+
+	auto const [it3, inserted3] = m.insert_or_assign(2, "deux");
+	EXPECT_FALSE(inserted3);
+	EXPECT_EQ("deux", it3->second);
+
+	auto const [it4, inserted4] = m.insert({ 20, "twenty" });
+	EXPECT_TRUE(inserted4);
+	EXPECT_EQ(20u, it4->first);
+	EXPECT_EQ(2u, m.size());
+}
+
+TEST(IndexedMap, ReferencesStability)
+{
+	auto m = Map{};
+	auto& first = m[0];
+	auto const* const firstAddress = &first;
+	for (auto i = std::uint16_t{ 1u }; i < 64u; ++i)
+	{
+		m[i] = std::to_string(i);
+	}
+	EXPECT_EQ(firstAddress, &m.at(0));
+}
+
+TEST(IndexedMap, Erase)
+{
+	auto m = Map{ { 0, "zero" }, { 1, "one" }, { 2, "two" }, { 10, "ten" }, { 11, "eleven" } };
+
+	EXPECT_EQ(1u, m.erase(1));
+	EXPECT_EQ(0u, m.erase(1));
+	EXPECT_EQ(1u, m.erase(10));
+	EXPECT_EQ(3u, m.size());
+
+	// Erase by iterator returns the next element (crossing from dense to sparse storage)
+	auto it = m.erase(m.find(2));
+	ASSERT_NE(m.end(), it);
+	EXPECT_EQ(11u, it->first);
+	it = m.erase(it);
+	EXPECT_EQ(m.end(), it);
+
+	EXPECT_EQ((std::vector<std::pair<std::uint16_t, std::string>>{ { 0, "zero" } }), toVector(m));
+
+	m.clear();
+	EXPECT_TRUE(m.empty());
+	EXPECT_EQ(m.begin(), m.end());
+}
+
+TEST(IndexedMap, CopyMoveCompare)
+{
+	auto const m = Map{ { 4, "four" }, { 1, "one" }, { 9, "nine" } };
+
+	auto copy = m;
+	EXPECT_EQ(m, copy);
+	EXPECT_NE(&m.at(4), &copy.at(4));
+
+	copy[4] = "FOUR";
+	EXPECT_NE(m, copy);
+
+	auto moved = std::move(copy);
+	EXPECT_TRUE(copy.empty());
+	EXPECT_EQ("FOUR", moved.at(4));
+
+	moved = m;
+	EXPECT_EQ(m, moved);
+}
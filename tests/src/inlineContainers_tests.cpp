@@ -0,0 +1,228 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/**
+* @file inlineContainers_tests.cpp
+* @author Christophe Calmejane
+*/
+
+// Public API
+#include <la/avdecc/inlineContainers.hpp>
+#include <la/avdecc/internals/entityModelTypes.hpp>
+
+// Internal API
+#include "allocationCounter.hpp"
+
+#include <gtest/gtest.h>
+#include <iterator>
+#include <set>
+#include <vector>
+
+TEST(SmallVector, DefaultConstructor)
+{
+	auto const v = la::avdecc::SmallVector<int, 4>{};
+	EXPECT_TRUE(v.empty());
+	EXPECT_EQ(0u, v.size());
+	EXPECT_EQ(4u, v.capacity());
+	EXPECT_TRUE(v.is_inline());
+	EXPECT_EQ(v.begin(), v.end());
+}
+
+TEST(SmallVector, InlineStorageDoesNotAllocate)
+{
+	allocationCounter::reset();
+	allocationCounter::setCountingEnabled(true);
+	{
+		auto v = la::avdecc::SmallVector<int, 4>{};
+		v.push_back(1);
+		v.emplace_back(2);
+		v.insert(v.begin(), 0);
+		v.push_back(3);
+		auto copy = v;
+		auto moved = std::move(copy);
+		EXPECT_TRUE(moved.is_inline());
+		EXPECT_EQ(v, moved);
+	}
+	allocationCounter::setCountingEnabled(false);
+	EXPECT_EQ(0u, allocationCounter::getCount());
+}
+
+TEST(SmallVector, GrowsToHeap)
+{
+	auto v = la::avdecc::SmallVector<int, 2>{ 1, 2 };
+	EXPECT_TRUE(v.is_inline());
+
+	v.push_back(3);
+	EXPECT_FALSE(v.is_inline());
+	EXPECT_LE(3u, v.capacity());
+	EXPECT_EQ((std::vector<int>{ 1, 2, 3 }), (std::vector<int>{ v.begin(), v.end() }));
+
+	// Moving a heap backed container steals its storage
+	auto const* const data = v.data();
+	auto moved = std::move(v);
+	EXPECT_EQ(data, moved.data());
+	EXPECT_TRUE(v.empty());
+	EXPECT_TRUE(v.is_inline());
+
+	// Shrinking back to inline storage
+	moved.pop_back();
+	moved.shrink_to_fit();
+	EXPECT_TRUE(moved.is_inline());
+	EXPECT_EQ((la::avdecc::SmallVector<int, 2>{ 1, 2 }), moved);
+}
+
+TEST(SmallVector, InsertErase)
+{
+	auto v = la::avdecc::SmallVector<int, 4>{ 1, 5 };
+	auto const values = std::vector<int>{ 2, 3, 4 };
+
+	auto it = v.insert(v.begin() + 1, values.begin(), values.end());
+	EXPECT_EQ(v.begin() + 1, it);
+	EXPECT_EQ((la::avdecc::SmallVector<int, 4>{ 1, 2, 3, 4, 5 }), v);
+
+	it = v.erase(v.begin() + 1, v.begin() + 3);
+	EXPECT_EQ(4, *it);
+	EXPECT_EQ((la::avdecc::SmallVector<int, 4>{ 1, 4, 5 }), v);
+
+	it = v.erase(v.end() - 1);
+	EXPECT_EQ(v.end(), it);
+	EXPECT_EQ((la::avdecc::SmallVector<int, 4>{ 1, 4 }), v);
+
+	v.insert(v.end(), 3u, 9);
+	EXPECT_EQ((la::avdecc::SmallVector<int, 4>{ 1, 4, 9, 9, 9 }), v);
+}
+
+TEST(SmallVector, InsertSelfElements)
+{
+	auto v = la::avdecc::SmallVector<int, 3>{ 1, 2, 3 };
+
+	// Inserting an element of the container itself, while growing
+	v.push_back(v[0]);
+	v.insert(v.begin(), v.back());
+	EXPECT_EQ((la::avdecc::SmallVector<int, 3>{ 1, 1, 2, 3, 1 }), v);
+
+	// Inserting a range of the container itself
+	v.insert(v.begin(), v.begin() + 2, v.begin() + 4);
+	EXPECT_EQ((la::avdecc::SmallVector<int, 3>{ 2, 3, 1, 1, 2, 3, 1 }), v);
+}
+
+TEST(SmallVector, ResizeAssign)
+{
+	auto v = la::avdecc::SmallVector<int, 2>{};
+	v.resize(3u, 7);
+	EXPECT_EQ((la::avdecc::SmallVector<int, 2>{ 7, 7, 7 }), v);
+	v.resize(1u);
+	EXPECT_EQ((la::avdecc::SmallVector<int, 2>{ 7 }), v);
+	v.resize(2u);
+	EXPECT_EQ((la::avdecc::SmallVector<int, 2>{ 7, 0 }), v);
+
+	v.assign({ 4, 5, 6, 7 });
+	EXPECT_EQ(4u, v.size());
+	EXPECT_EQ(4, v.front());
+	EXPECT_EQ(7, v.back());
+	EXPECT_EQ(5, v.at(1));
+	EXPECT_THROW(v.at(4), std::out_of_range);
+
+	v.clear();
+	EXPECT_TRUE(v.empty());
+}
+
+TEST(SmallVector, Swap)
+{
+	auto inlineVector = la::avdecc::SmallVector<int, 2>{ 1 };
+	auto heapVector = la::avdecc::SmallVector<int, 2>{ 1, 2, 3 };
+
+	inlineVector.swap(heapVector);
+	EXPECT_EQ((la::avdecc::SmallVector<int, 2>{ 1, 2, 3 }), inlineVector);
+	EXPECT_EQ((la::avdecc::SmallVector<int, 2>{ 1 }), heapVector);
+	EXPECT_FALSE(inlineVector.is_inline());
+	EXPECT_TRUE(heapVector.is_inline());
+}
+
+TEST(SmallVector, Comparison)
+{
+	using Vector = la::avdecc::SmallVector<int, 2>;
+	EXPECT_EQ((Vector{ 1, 2, 3 }), (Vector{ 1, 2, 3 }));
+	EXPECT_NE((Vector{ 1, 2, 3 }), (Vector{ 1, 2 }));
+	EXPECT_LT((Vector{ 1, 2 }), (Vector{ 1, 2, 3 }));
+	EXPECT_LT((Vector{ 1, 2, 3 }), (Vector{ 1, 3 }));
+}
+
+TEST(FlatSet, SortedUniqueElements)
+{
+	auto s = la::avdecc::FlatSet<int, 4>{ 5, 1, 3, 1, 5 };
+	EXPECT_EQ(3u, s.size());
+	EXPECT_EQ((std::vector<int>{ 1, 3, 5 }), (std::vector<int>{ s.begin(), s.end() }));
+
+	auto const [it, inserted] = s.insert(2);
+	EXPECT_TRUE(inserted);
+	EXPECT_EQ(2, *it);
+
+	auto const [it2, inserted2] = s.insert(3);
+	EXPECT_FALSE(inserted2);
+	EXPECT_EQ(3, *it2);
+
+	EXPECT_EQ((std::vector<int>{ 1, 2, 3, 5 }), (std::vector<int>{ s.begin(), s.end() }));
+}
+
+TEST(FlatSet, Lookup)
+{
+	auto const s = la::avdecc::FlatSet<int, 4>{ 10, 20, 30 };
+	EXPECT_NE(s.end(), s.find(20));
+	EXPECT_EQ(20, *s.find(20));
+	EXPECT_EQ(s.end(), s.find(25));
+	EXPECT_EQ(1u, s.count(30));
+	EXPECT_EQ(0u, s.count(0));
+	EXPECT_TRUE(s.contains(10));
+	EXPECT_FALSE(s.contains(40));
+	EXPECT_EQ(30, *s.lower_bound(25));
+	EXPECT_EQ(30, *s.upper_bound(20));
+}
+
+TEST(FlatSet, Erase)
+{
+	auto s = la::avdecc::FlatSet<int, 4>{ 1, 2, 3, 4 };
+	EXPECT_EQ(1u, s.erase(2));
+	EXPECT_EQ(0u, s.erase(2));
+	auto const it = s.erase(s.find(3));
+	EXPECT_EQ(4, *it);
+	EXPECT_EQ((la::avdecc::FlatSet<int, 4>{ 1, 4 }), s);
+}
+
+TEST(FlatSet, RangeInsert)
+{
+	auto s = la::avdecc::FlatSet<int, 2>{ 4, 2 };
+	auto const values = std::vector<int>{ 3, 2, 8, 3, 1 };
+	s.insert(values.begin(), values.end());
+	EXPECT_EQ((std::vector<int>{ 1, 2, 3, 4, 8 }), (std::vector<int>{ s.begin(), s.end() }));
+
+	// std::inserter compatibility
+	auto other = la::avdecc::FlatSet<int, 2>{};
+	std::copy(values.begin(), values.end(), std::inserter(other, other.end()));
+	EXPECT_EQ((la::avdecc::FlatSet<int, 2>{ 1, 2, 3, 8 }), other);
+}
+
+TEST(FlatSet, SameOrderingThanStdSet)
+{
+	auto const formats = std::vector<la::avdecc::entity::model::StreamFormat>{ la::avdecc::entity::model::StreamFormat{ 0x00A0020840000800 }, la::avdecc::entity::model::StreamFormat{ 0x0205022000406000 }, la::avdecc::entity::model::StreamFormat{ 0x00A0020140000100 }, la::avdecc::entity::model::StreamFormat{ 0x0205022000406000 } };
+	auto const flatSet = la::avdecc::entity::model::StreamFormats{ formats.begin(), formats.end() };
+	auto const set = std::set<la::avdecc::entity::model::StreamFormat>{ formats.begin(), formats.end() };
+	EXPECT_EQ((std::vector<la::avdecc::entity::model::StreamFormat>{ set.begin(), set.end() }), (std::vector<la::avdecc::entity::model::StreamFormat>{ flatSet.begin(), flatSet.end() }));
+}
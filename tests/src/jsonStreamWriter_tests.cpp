@@ -0,0 +1,99 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/**
+* @file jsonStreamWriter_tests.cpp
+* @author Christophe Calmejane
+*/
+
+// Public API
+#include <la/avdecc/internals/jsonStreamWriter.hpp>
+
+#include <gtest/gtest.h>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+namespace
+{
+std::string prettyPrint(nlohmann::json const& object)
+{
+	auto ss = std::stringstream{};
+	ss << std::setw(4) << object;
+	return ss.str();
+}
+} // namespace
+
+TEST(JsonStreamWriter, SameOutputAsPrettyPrint)
+{
+	auto const object = nlohmann::json::parse(R"({ "a": 1, "b": { "c": [1, 2, { "d": "text\nwith line feed" }], "e": {}, "f": [] }, "g": null, "h": [[], {}, 1.5] })");
+
+	auto ss = std::stringstream{};
+	auto writer = la::avdecc::jsonSerializer::StreamWriter{ ss };
+	writer.beginObject();
+	writer.writeKey("a");
+	writer.writeValue(1);
+	writer.writeKey("b");
+	writer.beginObject();
+	writer.writeKey("c");
+	writer.beginArray();
+	writer.writeValue(1);
+	writer.writeValue(2);
+	writer.writeValue(object["b"]["c"][2]);
+	writer.endArray();
+	writer.writeKey("e");
+	writer.beginObject();
+	writer.endObject();
+	writer.writeKey("f");
+	writer.writeValue(nlohmann::json::array());
+	writer.endObject();
+	writer.writeMembers(nlohmann::json{ { "g", nullptr }, { "h", object["h"] } });
+	writer.endObject();
+
+	EXPECT_EQ(prettyPrint(object), ss.str());
+}
+
+TEST(JsonStreamWriter, StreamedMember)
+{
+	auto const object = nlohmann::json::parse(R"({ "a": 1, "b": [{ "x": true }, { "y": false }], "c": "3" })");
+	auto partial = object;
+	partial.erase("b");
+
+	auto ss = std::stringstream{};
+	auto writer = la::avdecc::jsonSerializer::StreamWriter{ ss };
+	writer.beginObject();
+	writer.writeMembers(partial, "b",
+		[&writer, &object]()
+		{
+			writer.beginArray();
+			for (auto const& element : object["b"])
+			{
+				// Element written separately, then inserted
+				auto elementStream = std::stringstream{};
+				auto elementWriter = la::avdecc::jsonSerializer::StreamWriter{ elementStream, 4u, writer.getDepth() };
+				elementWriter.writeValue(element);
+				writer.writeFormattedValue(elementStream.str());
+			}
+			writer.endArray();
+		});
+	writer.endObject();
+
+	EXPECT_EQ(prettyPrint(object), ss.str());
+}
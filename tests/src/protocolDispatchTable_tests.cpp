@@ -0,0 +1,75 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/**
+* @file protocolDispatchTable_tests.cpp
+* @author Christophe Calmejane
+*/
+
+// Internal API
+#include "protocol/protocolDispatchTable.hpp"
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <stdexcept>
+
+namespace
+{
+int handlerOne() noexcept
+{
+	return 1;
+}
+int handlerTwo() noexcept
+{
+	return 2;
+}
+using Handler = int (*)();
+using Table = la::avdecc::protocol::DispatchTable<std::uint8_t, Handler, 16u>;
+} // namespace
+
+TEST(DispatchTable, FindRegisteredHandlers)
+{
+	auto const table = Table{ { std::uint8_t{ 0u }, &handlerOne }, { std::uint8_t{ 15u }, &handlerTwo }, { std::uint8_t{ 7u }, []() { return 7; } } };
+
+	ASSERT_NE(nullptr, table.find(0u));
+	EXPECT_EQ(1, table.find(0u)());
+	ASSERT_NE(nullptr, table.find(15u));
+	EXPECT_EQ(2, table.find(15u)());
+	ASSERT_NE(nullptr, table.find(7u));
+	EXPECT_EQ(7, table.find(7u)());
+	EXPECT_EQ(nullptr, table.find(1u));
+	EXPECT_EQ(nullptr, table.find(16u)); // Out of the table
+	EXPECT_EQ(nullptr, table.find(255u)); // Out of the table
+}
+
+TEST(DispatchTable, ConstantExpression)
+{
+	static constexpr auto table = Table{ { std::uint8_t{ 3u }, &handlerOne } };
+
+	static_assert(table.find(3u) == &handlerOne, "Handler should be found at compile time");
+	static_assert(table.find(4u) == nullptr, "Unregistered key should have no handler");
+	static_assert(table.find(200u) == nullptr, "Out of range key should have no handler");
+	EXPECT_EQ(1, table.find(3u)());
+}
+
+TEST(DispatchTable, KeyOutOfRange)
+{
+	EXPECT_THROW(Table({ { std::uint8_t{ 16u }, &handlerOne } }), std::out_of_range);
+}
@@ -0,0 +1,54 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/**
+* @file protocolInterface_tpacket_tests.cpp
+* @author Christophe Calmejane
+*/
+
+// Public API
+#include <la/avdecc/executor.hpp>
+
+// Internal API
+#include "protocolInterface/protocolInterface_tpacket.hpp"
+
+#include <gtest/gtest.h>
+#include <memory>
+
+TEST(ProtocolInterfaceTPacket, InvalidName)
+{
+	if (!la::avdecc::protocol::ProtocolInterfaceTPacket::isSupported())
+	{
+		GTEST_SKIP() << "TPacket protocol interface not supported (missing CAP_NET_RAW capability?)";
+	}
+
+	auto const executorWrapper = la::avdecc::ExecutorManager::getInstance().registerExecutor(la::avdecc::protocol::ProtocolInterface::DefaultExecutorName, la::avdecc::ExecutorWithDispatchQueue::create(la::avdecc::protocol::ProtocolInterface::DefaultExecutorName, la::avdecc::utils::ThreadPriority::Highest));
+
+	// Not using EXPECT_THROW, we want to check the error code inside our custom exception
+	try
+	{
+		std::unique_ptr<la::avdecc::protocol::ProtocolInterfaceTPacket>(la::avdecc::protocol::ProtocolInterfaceTPacket::createRawProtocolInterfaceTPacket(""));
+		EXPECT_FALSE(true); // We expect an exception to have been raised
+	}
+	catch (la::avdecc::protocol::ProtocolInterface::Exception const& e)
+	{
+		EXPECT_EQ(la::avdecc::protocol::ProtocolInterface::Error::InterfaceNotFound, e.getError());
+	}
+}
@@ -246,3 +246,69 @@ TEST(ProtocolInterfaceVirtual, InjectPacket)
 	auto const status = entityOnlinePromise.get_future().wait_for(std::chrono::milliseconds(10));
 	ASSERT_NE(std::future_status::timeout, status);
 }
+
+TEST(ProtocolInterfaceVirtual, IngressBatchingInvalidParameters)
+{
+	auto intfc = std::unique_ptr<la::avdecc::protocol::ProtocolInterfaceVirtual>(la::avdecc::protocol::ProtocolInterfaceVirtual::createRawProtocolInterfaceVirtual("IngressBatchingInterface", { { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05 } }));
+
+	EXPECT_EQ(la::avdecc::protocol::ProtocolInterface::Error::InvalidParameters, intfc->setIngressBatching(0u, std::chrono::microseconds{ 0 }));
+	EXPECT_EQ(la::avdecc::protocol::ProtocolInterface::Error::InvalidParameters, intfc->setIngressBatching(la::avdecc::protocol::ProtocolInterface::MaximumIngressBatchFrames + 1u, std::chrono::microseconds{ 0 }));
+	EXPECT_EQ(la::avdecc::protocol::ProtocolInterface::Error::InvalidParameters, intfc->setIngressBatching(1u, std::chrono::microseconds{ -1 }));
+	EXPECT_EQ(la::avdecc::protocol::ProtocolInterface::Error::NoError, intfc->setIngressBatching(la::avdecc::protocol::ProtocolInterface::MaximumIngressBatchFrames, std::chrono::microseconds{ 500 }));
+	EXPECT_EQ(la::avdecc::protocol::ProtocolInterface::Error::NoError, intfc->setIngressBatching(1u, std::chrono::microseconds{ 0 }));
+}
+
+TEST(ProtocolInterfaceVirtual, MaxAecpInflightCommandsInvalidParameters)
+{
+	auto intfc = std::unique_ptr<la::avdecc::protocol::ProtocolInterfaceVirtual>(la::avdecc::protocol::ProtocolInterfaceVirtual::createRawProtocolInterfaceVirtual("InflightCommandsInterface", { { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05 } }));
+
+	EXPECT_EQ(la::avdecc::protocol::ProtocolInterface::Error::InvalidParameters, intfc->setMaxAecpInflightCommands(0u));
+	EXPECT_EQ(la::avdecc::protocol::ProtocolInterface::Error::InvalidParameters, intfc->setMaxAecpInflightCommands(la::avdecc::protocol::ProtocolInterface::MaximumAecpInflightCommands + 1u));
+	EXPECT_EQ(la::avdecc::protocol::ProtocolInterface::Error::NoError, intfc->setMaxAecpInflightCommands(la::avdecc::protocol::ProtocolInterface::MaximumAecpInflightCommands));
+	EXPECT_EQ(la::avdecc::protocol::ProtocolInterface::Error::NoError, intfc->setMaxAecpInflightCommands(1u));
+}
+
+TEST(ProtocolInterfaceVirtual, IngressBatching)
+{
+	static constexpr auto MessagesCount = size_t{ 100u };
+
+	auto const executorWrapper = la::avdecc::ExecutorManager::getInstance().registerExecutor(la::avdecc::protocol::ProtocolInterface::DefaultExecutorName, la::avdecc::ExecutorWithDispatchQueue::create(la::avdecc::protocol::ProtocolInterface::DefaultExecutorName, la::avdecc::utils::ThreadPriority::Highest));
+	static std::promise<void> allReceivedPromise;
+
+	class Observer : public la::avdecc::protocol::ProtocolInterface::Observer
+	{
+	private:
+		virtual void onAdpduReceived(la::avdecc::protocol::ProtocolInterface* const /*pi*/, la::avdecc::protocol::Adpdu const& /*adpdu*/) noexcept override
+		{
+			if (++_receivedCount == MessagesCount)
+			{
+				allReceivedPromise.set_value();
+			}
+		}
+		size_t _receivedCount{ 0u }; // Only accessed from the PI executor thread
+		DECLARE_AVDECC_OBSERVER_GUARD(Observer);
+	};
+
+	Observer obs;
+	auto intfc1 = std::unique_ptr<la::avdecc::protocol::ProtocolInterfaceVirtual>(la::avdecc::protocol::ProtocolInterfaceVirtual::createRawProtocolInterfaceVirtual("IngressBatchingInterface", { { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05 } }));
+	auto intfc2 = std::unique_ptr<la::avdecc::protocol::ProtocolInterfaceVirtual>(la::avdecc::protocol::ProtocolInterfaceVirtual::createRawProtocolInterfaceVirtual("IngressBatchingInterface", { { 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b } }));
+	intfc2->registerObserver(&obs);
+
+	// Use a batch size that doesn't divide the messages count and a long delay, pending frames must be flushed as soon as the interface is idle
+	ASSERT_EQ(la::avdecc::protocol::ProtocolInterface::Error::NoError, intfc2->setIngressBatching(32u, std::chrono::seconds{ 10 }));
+
+	// Build an EntityDiscover adpdu (not changing the state of the receiving interface)
+	auto adpdu = la::avdecc::protocol::Adpdu{};
+	adpdu.setSrcAddress(intfc1->getMacAddress());
+	adpdu.setDestAddress(la::avdecc::protocol::Adpdu::Multicast_Mac_Address);
+	adpdu.setMessageType(la::avdecc::protocol::AdpMessageType::EntityDiscover);
+	adpdu.setEntityID(la::avdecc::UniqueIdentifier::getNullUniqueIdentifier());
+
+	for (auto i = size_t{ 0u }; i < MessagesCount; ++i)
+	{
+		intfc1->sendAdpMessage(adpdu);
+	}
+
+	auto const status = allReceivedPromise.get_future().wait_for(std::chrono::seconds(1));
+	ASSERT_NE(std::future_status::timeout, status);
+}
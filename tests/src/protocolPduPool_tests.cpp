@@ -0,0 +1,133 @@
+/*
+* Copyright (C) 2016-2022, L-Acoustics and its contributors
+
+* This file is part of LA_avdecc.
+
+* LA_avdecc is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+
+* LA_avdecc is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+
+* You should have received a copy of the GNU Lesser General Public License
+* along with LA_avdecc.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+* @file protocolPduPool_tests.cpp
+* @author Christophe Calmejane
+*/
+
+// Public API
+#include <la/avdecc/internals/protocolAemAecpdu.hpp>
+#include <la/avdecc/internals/protocolAdpdu.hpp>
+#include <la/avdecc/internals/protocolAcmpdu.hpp>
+
+// Internal API
+#include "protocol/protocolPduPool.hpp"
+#include "allocationCounter.hpp"
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+TEST(PduPool, MemoryRecycled)
+{
+	auto& pool = la::avdecc::protocol::PduPool<la::avdecc::protocol::AemAecpdu>::getInstance();
+
+	// Make sure this thread has at least one cached block
+	la::avdecc::protocol::AemAecpdu::create(false).reset();
+	auto const cachedCount = pool.getThreadCacheBlocksCount();
+	ASSERT_LT(0u, cachedCount);
+
+	auto aecpdu = la::avdecc::protocol::AemAecpdu::create(true);
+	EXPECT_EQ(cachedCount - 1u, pool.getThreadCacheBlocksCount());
+	EXPECT_EQ(la::avdecc::protocol::AecpMessageType::AemResponse, aecpdu->getMessageType());
+
+	aecpdu.reset();
+	EXPECT_EQ(cachedCount, pool.getThreadCacheBlocksCount());
+}
+
+TEST(PduPool, AllocationFreeOnceWarm)
+{
+	static constexpr auto Count = size_t{ 100u };
+
+	auto const createAll = []()
+	{
+		auto aems = std::vector<la::avdecc::protocol::Aecpdu::UniquePointer>{};
+		auto adps = std::vector<la::avdecc::protocol::Adpdu::UniquePointer>{};
+		auto acmps = std::vector<la::avdecc::protocol::Acmpdu::UniquePointer>{};
+		aems.reserve(Count * 2u);
+		adps.reserve(Count * 2u);
+		acmps.reserve(Count * 2u);
+
+		allocationCounter::reset();
+		allocationCounter::setCountingEnabled(true);
+		for (auto i = size_t{ 0u }; i < Count; ++i)
+		{
+			auto command = la::avdecc::protocol::AemAecpdu::create(false);
+			auto response = command->responseCopy();
+			aems.push_back(std::move(command));
+			aems.push_back(std::move(response));
+			auto adpdu = la::avdecc::protocol::Adpdu::create();
+			auto adpduCopy = adpdu->copy();
+			adps.push_back(std::move(adpdu));
+			adps.push_back(std::move(adpduCopy));
+			auto acmpdu = la::avdecc::protocol::Acmpdu::create();
+			auto acmpduCopy = acmpdu->copy();
+			acmps.push_back(std::move(acmpdu));
+			acmps.push_back(std::move(acmpduCopy));
+		}
+		allocationCounter::setCountingEnabled(false);
+		return allocationCounter::getCount();
+	};
+
+	// Warmup, fill the pools
+	createAll();
+
+	// All PDUs are now built in recycled memory
+	EXPECT_EQ(0u, createAll());
+}
+
+TEST(PduPool, ConcurrentCreateDestroy)
+{
+	static constexpr auto ThreadsCount = size_t{ 4u };
+	static constexpr auto Iterations = size_t{ 10000u };
+
+	auto threads = std::vector<std::thread>{};
+	for (auto t = size_t{ 0u }; t < ThreadsCount; ++t)
+	{
+		threads.emplace_back(
+			[]()
+			{
+				auto kept = std::vector<la::avdecc::protocol::Aecpdu::UniquePointer>{};
+				for (auto i = size_t{ 0u }; i < Iterations; ++i)
+				{
+					auto aecpdu = la::avdecc::protocol::AemAecpdu::create(false);
+					static_cast<la::avdecc::protocol::AemAecpdu&>(*aecpdu).setCommandType(la::avdecc::protocol::AemCommandType::ReadDescriptor);
+					// Keep a few PDUs alive so blocks are released in a different order than acquired
+					if (i % 7u == 0u)
+					{
+						kept.push_back(std::move(aecpdu));
+					}
+					if (kept.size() > 16u)
+					{
+						kept.erase(kept.begin());
+					}
+				}
+			});
+	}
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	// Blocks cached by the exited threads have been given back to the shared free list
+	auto const freeCount = la::avdecc::protocol::PduPool<la::avdecc::protocol::AemAecpdu>::getInstance().getFreeBlocksCount();
+	EXPECT_LT(0u, freeCount);
+	EXPECT_GE(la::avdecc::protocol::PduPool<la::avdecc::protocol::AemAecpdu>::MaximumFreeBlocks, freeCount);
+}